@@ -25,8 +25,12 @@
 #define SHCORE_OUTPUT_FORMAT "outputFormat"
 #define SHCORE_INTERACTIVE "interactive"
 #define SHCORE_SHOW_WARNINGS "showWarnings"
+#define SHCORE_SHOW_TIMING "showTiming"
 #define SHCORE_BATCH_CONTINUE_ON_ERROR "batchContinueOnError"
 #define SHCORE_USE_WIZARDS "useWizards"
+// Byte budget for grouping the statements of the SQL mode into a single query
+// on classic sessions, 0 executes them one by one.
+#define SHCORE_SQL_BATCH_SIZE "sqlBatchSize"
 // This option controls the management of globals/locals namespace when running python scripts
 // ie. if several runs of Python scripts inside shell must be considered part of the same instance.
 #define SHCORE_MULTIPLE_INSTANCES "multipleInstances"
@@ -26,6 +26,14 @@
 #include <boost/system/error_code.hpp>
 #include <stack>
 
+namespace mysh
+{
+  namespace mysql
+  {
+    class ClassicSession;
+  };
+};
+
 namespace shcore
 {
   class SHCORE_PUBLIC Shell_sql : public Shell_language
@@ -50,6 +58,9 @@ namespace shcore
     std::stack<std::string> _parsing_context_stack;
 
     void cmd_process_file(const std::vector<std::string>& params);
+    bool statement_failed(const shcore::Exception &exc, boost::function<void(shcore::Value)> result_processor);
+    bool execute_batched(mysh::mysql::ClassicSession &session, const std::vector<std::string> &statements, size_t batch_size,
+                         boost::function<void(shcore::Value)> result_processor, Value &ret_val);
   };
 };
 
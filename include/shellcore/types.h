@@ -26,8 +26,10 @@
 #include <map>
 #include <string>
 #include <stdexcept>
+#include <utility>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 #include <boost/function.hpp>
 
 #include "shellcore/common.h"
@@ -142,24 +144,33 @@ namespace shcore {
     typedef boost::shared_ptr<Map_type> Map_type_ref;
 
     Value_type type;
-    union
+
+    // Strings and references are constructed in place, the active member
+    // is given by type. Short strings are kept inline by std::string, so
+    // most column values don't need any allocation.
+    union Storage
     {
+      Storage() {}
+      ~Storage() {}
+
       bool b;
-      std::string *s;
+      std::string s;
       int64_t i;
       uint64_t ui;
       double d;
-      boost::shared_ptr<class Object_bridge> *o;
-      boost::shared_ptr<Array_type> *array;
-      boost::shared_ptr<Map_type> *map;
-      boost::weak_ptr<Map_type> *mapref;
-      boost::shared_ptr<class Function_base> *func;
+      boost::shared_ptr<class Object_bridge> o;
+      boost::shared_ptr<Array_type> array;
+      boost::shared_ptr<Map_type> map;
+      boost::weak_ptr<Map_type> mapref;
+      boost::shared_ptr<class Function_base> func;
     } value;
 
     Value() : type(Undefined) {}
     Value(const Value &copy);
+    Value(Value &&other);
 
     explicit Value(const std::string &s);
+    explicit Value(std::string &&s);
     explicit Value(const char *);
     explicit Value(const char *, size_t n);
     explicit Value(int i);
@@ -189,9 +200,15 @@ namespace shcore {
     //! parse a string returned by repr() back into a Value
     static Value parse(const std::string &s);
 
+    //! parse a JSON document, such as the ones sent by the server, into a Value
+    static Value parse_json(const char *data, size_t length);
+    //! same as parse_json() but decodes strings in the given null terminated buffer, which gets modified
+    static Value parse_json_in_situ(char *data);
+
     ~Value();
 
     Value &operator= (const Value &other);
+    Value &operator= (Value &&other);
 
     bool operator == (const Value &other) const;
 
@@ -221,15 +238,19 @@ namespace shcore {
     int64_t as_int() const;
     uint64_t as_uint() const;
     double as_double() const;
-    const std::string &as_string() const { check_type(String); return *value.s; }
+    const std::string &as_string() const { check_type(String); return value.s; }
     template<class C>
-    boost::shared_ptr<C> as_object() const { check_type(Object); return boost::static_pointer_cast<C>(*value.o); }
-    boost::shared_ptr<Object_bridge> as_object() const { check_type(Object); return boost::static_pointer_cast<Object_bridge>(*value.o); }
-    boost::shared_ptr<Map_type> as_map() const { check_type(Map); return *value.map; }
-    boost::shared_ptr<Array_type> as_array() const { check_type(Array); return *value.array; }
-    boost::shared_ptr<Function_base> as_function() const { check_type(Function); return boost::static_pointer_cast<Function_base>(*value.func); }
+    boost::shared_ptr<C> as_object() const { check_type(Object); return boost::static_pointer_cast<C>(value.o); }
+    boost::shared_ptr<Object_bridge> as_object() const { check_type(Object); return value.o; }
+    boost::shared_ptr<Map_type> as_map() const { check_type(Map); return value.map; }
+    boost::shared_ptr<Array_type> as_array() const { check_type(Array); return value.array; }
+    boost::shared_ptr<Function_base> as_function() const { check_type(Function); return value.func; }
 
   private:
+    void copy_from(const Value &other);
+    void move_from(Value &other);
+    void release();
+
     static Value parse(char **pc);
     static Value parse_map(char **pc);
     static Value parse_array(char **pc);
@@ -256,6 +277,7 @@ namespace shcore {
     void ensure_at_least(unsigned int minc, const char *context) const;
 
     void push_back(const Value &value) { _args.push_back(value); }
+    void push_back(Value &&value) { _args.push_back(std::move(value)); }
     size_t size() const { return _args.size(); }
     const Value &at(size_t i) const { return _args.at(i); }
     Value &operator [](size_t i) { return _args[i]; }
@@ -61,7 +61,7 @@ Value AdminSession::connect(const Argument_list &args)
     // Retrieves the connection data, whatever the source is
     load_connection_data(args);
 
-    _session.open(_host, _port, _schema, _user, _password, _ssl_ca, _ssl_cert, _ssl_key, 10000, _auth_method, true);
+    _session.open(_host, _port, _sock, _schema, _user, _password, _ssl_ca, _ssl_cert, _ssl_key, 10000, _auth_method, true, _compression);
   }
   CATCH_AND_TRANSLATE();
 
@@ -219,6 +219,7 @@ shcore::Value AdminSession::get_status(const shcore::Argument_list &args)
     (*status)["NODE_TYPE"] = node_type;
 
   (*status)["DEFAULT_CLUSTER"] = shcore::Value(_default_cluster);
+  (*status)["METRICS"] = get_metrics();
 
   return shcore::Value(status);
 }
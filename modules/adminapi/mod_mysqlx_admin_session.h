@@ -58,6 +58,8 @@ namespace mysh
       virtual bool is_connected() const;
       virtual shcore::Value get_status(const shcore::Argument_list &args);
       virtual shcore::Value get_capability(const std::string& name);
+      virtual shcore::Value get_metrics() { return _session.get_metrics(); }
+      virtual void reset_metrics() { _session.reset_metrics(); }
 
       shcore::Value create_cluster(const shcore::Argument_list &args);
       shcore::Value get_cluster(const shcore::Argument_list &args) const;
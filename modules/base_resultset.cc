@@ -24,6 +24,7 @@
 #include "shellcore/lang_base.h"
 #include "shellcore/common.h"
 #include "utils/utils_general.h"
+#include "mysqlxtest/mysqlx_metrics.h"
 
 #include <boost/bind.hpp>
 #include <boost/pointer_cast.hpp>
@@ -270,6 +271,19 @@ shcore::Value ShellBaseResult::get_member_method(const shcore::Argument_list &ar
   return get_member(prop);
 }
 
+shcore::Value ShellBaseResult::get_timing(const ::mysqlx::Result_timing &timing)
+{
+  shcore::Value::Map_type_ref phases(new shcore::Value::Map_type);
+
+  for (int phase = 0; phase < ::mysqlx::Result_timing::Phase_count; phase++)
+  {
+    ::mysqlx::Result_timing::Phase current = static_cast< ::mysqlx::Result_timing::Phase>(phase);
+    (*phases)[::mysqlx::Result_timing::get_phase_name(current)] = shcore::Value(timing.usec(current));
+  }
+
+  return shcore::Value(phases);
+}
+
 bool ShellBaseResult::has_member(const std::string &prop) const
 {
   std::vector<std::string> members = get_members();
@@ -584,5 +598,5 @@ shcore::Value Row::get_member(size_t index) const
 
 void Row::add_item(const std::string &key, shcore::Value value)
 {
-  value_iterators.push_back(values.insert(values.end(), std::pair<std::string, shcore::Value>(key, value)));
+  value_iterators.push_back(values.insert(values.end(), std::pair<std::string, shcore::Value>(key, std::move(value))));
 }
\ No newline at end of file
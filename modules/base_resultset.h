@@ -27,6 +27,11 @@
 #include "shellcore/types.h"
 #include "shellcore/types_cpp.h"
 
+namespace mysqlx
+{
+  class Result_timing;
+}
+
 namespace mysh
 {
   // This is the Shell Common Base Class for all the resultset classes
@@ -44,6 +49,10 @@ namespace mysh
     virtual bool rewind(){ return false; }
     virtual bool tell(size_t &dataset, size_t &record){ return false; }
     virtual bool seek(size_t dataset, size_t record){ return false; }
+
+  protected:
+    // Duration of each phase of the result in microseconds, for the timing property
+    static shcore::Value get_timing(const ::mysqlx::Result_timing &timing);
   };
 
   class SHCORE_PUBLIC Charset
@@ -77,15 +77,39 @@ boost::shared_ptr<mysh::ShellDevelopmentSession> mysh::connect_session(const shc
   return ret_val;
 }
 
+shcore::Value mysh::describe_latency(const ::mysqlx::Latency_histogram &histogram)
+{
+  shcore::Value::Map_type_ref latency(new shcore::Value::Map_type);
+  shcore::Value::Map_type_ref buckets(new shcore::Value::Map_type);
+
+  (*latency)["count"] = shcore::Value(histogram.count());
+  (*latency)["total_us"] = shcore::Value(histogram.total_usec());
+  (*latency)["avg_us"] = shcore::Value(histogram.count() ? double(histogram.total_usec()) / histogram.count() : 0.0);
+  (*latency)["p50_us"] = shcore::Value(histogram.percentile_usec(50));
+  (*latency)["p90_us"] = shcore::Value(histogram.percentile_usec(90));
+  (*latency)["p99_us"] = shcore::Value(histogram.percentile_usec(99));
+  (*latency)["max_us"] = shcore::Value(histogram.max_usec());
+
+  for (int index = 0; index < ::mysqlx::Latency_histogram::BUCKETS; index++)
+  {
+    if (histogram.bucket(index))
+      (*buckets)[boost::lexical_cast<std::string>(::mysqlx::Latency_histogram::bucket_upper_bound(index))] = shcore::Value(histogram.bucket(index));
+  }
+
+  (*latency)["buckets"] = shcore::Value(buckets);
+
+  return shcore::Value(latency);
+}
+
 ShellBaseSession::ShellBaseSession() :
-_port(0)
+_port(0), _compression(false)
 {
   init();
 }
 
 ShellBaseSession::ShellBaseSession(const ShellBaseSession& s) :
 _user(s._user), _password(s._password), _host(s._host), _port(s._port), _sock(s._sock), _schema(s._schema),
-_ssl_ca(s._ssl_ca), _ssl_cert(s._ssl_cert), _ssl_key(s._ssl_key)
+_ssl_ca(s._ssl_ca), _ssl_cert(s._ssl_cert), _ssl_key(s._ssl_key), _compression(s._compression)
 {
   init();
 }
@@ -270,6 +294,9 @@ void ShellBaseSession::load_connection_data(const shcore::Argument_list &args)
 
     if (options->has_key("authMethod"))
       _auth_method = (*options)["authMethod"].as_string();
+
+    if (options->has_key("compression"))
+      _compression = (*options)["compression"].as_bool();
   }
 
   // If password is received as parameter, then it overwrites
@@ -282,6 +309,10 @@ void ShellBaseSession::load_connection_data(const shcore::Argument_list &args)
 
   std::string sock_port = (_port == 0) ? _sock : boost::lexical_cast<std::string>(_port);
 
+  // Keeps the URI parseable when the socket path contains '/'
+  if (_port == 0 && _sock.find('/') != std::string::npos)
+    sock_port = "(" + _sock + ")";
+
   if (_schema.empty())
     _uri = (boost::format("%1%@%2%:%3%") % _user % _host % sock_port).str();
   else
@@ -27,6 +27,7 @@
 #include "shellcore/types.h"
 #include "shellcore/types_cpp.h"
 #include "shellcore/ishell_core.h"
+#include "mysqlxtest/mysqlx_metrics.h"
 
 namespace mysh
 {
@@ -54,6 +55,10 @@ namespace mysh
     virtual bool is_connected() const = 0;
     virtual shcore::Value get_status(const shcore::Argument_list &args) = 0;
     virtual shcore::Value get_capability(const std::string &name) { return shcore::Value(); }
+
+    // Client side protocol counters and latencies of the session
+    virtual shcore::Value get_metrics() { return shcore::Value::Null(); }
+    virtual void reset_metrics() {}
     std::string uri() { return _uri; };
 
     virtual std::string db_object_exists(std::string &type, const std::string &name, const std::string& owner) const = 0;
@@ -80,6 +85,7 @@ namespace mysh
     std::string _ssl_cert;
     std::string _ssl_key;
     std::string _auth_method;
+    bool _compression;
     std::string _uri;
 
     void load_connection_data(const shcore::Argument_list &args);
@@ -129,6 +135,10 @@ namespace mysh
     mutable boost::shared_ptr<shcore::Value::Map_type> _clusters;
   };
 
+  // Latency histogram as a map: sample count, average, percentiles and the
+  // non empty buckets indexed by their upper bound in microseconds
+  shcore::Value SHCORE_PUBLIC describe_latency(const ::mysqlx::Latency_histogram &histogram);
+
   boost::shared_ptr<mysh::ShellDevelopmentSession> SHCORE_PUBLIC connect_session(const shcore::Argument_list &args, SessionType session_type);
 };
 
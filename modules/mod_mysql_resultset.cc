@@ -46,6 +46,7 @@ ClassicResult::ClassicResult(boost::shared_ptr<Result> result)
   add_method("getWarningCount", boost::bind(&ShellBaseResult::get_member_method, this, _1, "getWarningCount", "warningCount"), NULL);
   add_method("getWarnings", boost::bind(&ShellBaseResult::get_member_method, this, _1, "getWarnings", "warnings"), NULL);
   add_method("getExecutionTime", boost::bind(&ShellBaseResult::get_member_method, this, _1, "getExecutionTime", "executionTime"), NULL);
+  add_method("getTiming", boost::bind(&ShellBaseResult::get_member_method, this, _1, "getTiming", "timing"), NULL);
   add_method("getAutoIncrementValue", boost::bind(&ShellBaseResult::get_member_method, this, _1, "getAutoIncrementValue", "autoIncrementValue"), NULL);
   add_method("getInfo", boost::bind(&ShellBaseResult::get_member_method, this, _1, "getInfo", "info"), NULL);
 }
@@ -60,6 +61,7 @@ std::vector<std::string> ClassicResult::get_members() const
   members.push_back("warnings");
   members.push_back("warningCount");
   members.push_back("executionTime");
+  members.push_back("timing");
   members.push_back("autoIncrementValue");
   members.push_back("info");
   return members;
@@ -75,6 +77,7 @@ bool ClassicResult::has_member(const std::string &prop) const
     prop == "warnings" ||
     prop == "warningCount" ||
     prop == "executionTime" ||
+    prop == "timing" ||
     prop == "autoIncrementValue" ||
     prop == "info";
 }
@@ -130,7 +133,7 @@ shcore::Value ClassicResult::fetch_all(const shcore::Argument_list &args) const
 
   while (record)
   {
-    array->push_back(record);
+    array->push_back(std::move(record));
     record = fetch_one(args);
   }
 
@@ -184,6 +187,18 @@ List ClassicResult::getColumns(){}
 */
 String ClassicResult::getExecutionTime(){}
 
+/**
+* Retrieves the time spent on each phase of the executed statement, measured on the client.
+* \return A map with the duration of each phase in microseconds.
+*
+* The phases are:
+* - send: the statement being sent to the server.
+* - firstMetadata: waiting for the server response, including the column metadata.
+* - firstRow: fetching the first row.
+* - streaming: fetching the rest of the rows.
+*/
+Map ClassicResult::getTiming(){}
+
 /**
 * Retrieves a string providing information about the most recently executed statement.
 * \return a string with the execution information
@@ -244,6 +259,9 @@ shcore::Value ClassicResult::get_member(const std::string &prop) const
   if (prop == "executionTime")
     return shcore::Value(MySQL_timer::format_legacy(_result->execution_time(), 2));
 
+  if (prop == "timing")
+    return get_timing(_result->timing());
+
   if (prop == "autoIncrementValue")
     return shcore::Value((int)_result->last_insert_id());
 
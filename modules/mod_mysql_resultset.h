@@ -63,6 +63,7 @@ namespace mysh
       List columnNames; //!< Same as getColumnNames()
       List columns; //!< Same as getColumns()
       String executionTime; //!< Same as getExecutionTime()
+      Map timing; //!< Same as getTiming()
       String info; //!< Same as getInfo()
       Integer autoIncrementValue; //!< Same as getAutoIncrementValue()
       List warnings; //!< Same as getWarnings()
@@ -75,6 +76,7 @@ namespace mysh
       List getColumnNames();
       List getColumns();
       String getExecutionTime();
+      Map getTiming();
       Bool hasData();
       String getInfo();
       Integer getAutoIncrementValue();
@@ -76,6 +76,10 @@ void ClassicSession::init()
   add_method("runSql", boost::bind(&ClassicSession::run_sql, this, _1),
     "stmt", shcore::String,
     NULL);
+  add_method("loadLocalInfile", boost::bind(&ClassicSession::load_local_infile, this, _1),
+    "stmt", shcore::String,
+    "source", shcore::Map,
+    NULL);
   add_method("setCurrentSchema", boost::bind(&ClassicSession::set_current_schema, this, _1), "name", shcore::String, NULL);
   add_method("getCurrentSchema", boost::bind(&ShellDevelopmentSession::get_member_method, this, _1, "getCurrentSchema", "currentSchema"), NULL);
   add_method("startTransaction", boost::bind(&ClassicSession::startTransaction, this, _1), "data");
@@ -107,7 +111,7 @@ Value ClassicSession::connect(const Argument_list &args)
     load_connection_data(args);
 
     // Performs the connection
-    _conn.reset(new Connection(_host, _port, _sock, _user, _password, _schema, _ssl_ca, _ssl_cert, _ssl_key));
+    _conn.reset(new Connection(_host, _port, _sock, _user, _password, _schema, _ssl_ca, _ssl_cert, _ssl_key, _compression));
 
     _default_schema = _retrieve_current_schema();
   }
@@ -169,6 +173,80 @@ Value ClassicSession::run_sql(const shcore::Argument_list &args) const
   return ret_val;
 }
 
+#ifdef DOXYGEN
+/**
+* Executes a LOAD DATA LOCAL INFILE statement sending the data from the given source.
+* \param query the LOAD DATA LOCAL INFILE statement, the file name on it is ignored.
+* \param source a dictionary with the data source.
+* \return A ClassicResult object.
+* \exception An exception is thrown if an error occurs on the SQL execution or reading the source.
+*
+* The data is streamed to the server as it parses it, the source is one of:
+*
+* - file: the path of a file to read.
+* - data: a string with the data.
+* - generator: a function called until it returns null, each call returns the next chunk of data as a string.
+*
+* On Python a generator is passed as a function returning its next value, i.e. lambda: next(gen, None).
+*
+* The server requests for local files are refused out of this function, the local_infile
+* system variable must be enabled on the server.
+*/
+ClassicResult ClassicSession::loadLocalInfile(String query, Dictionary source){}
+#endif
+Value ClassicSession::load_local_infile(const shcore::Argument_list &args)
+{
+  args.ensure_count(2, "ClassicSession.loadLocalInfile");
+
+  if (!_conn)
+    throw Exception::logic_error("Not connected.");
+
+  std::string statement = args.string_at(0);
+  shcore::Value::Map_type_ref options = args.map_at(1);
+  boost::shared_ptr<Local_infile_source> source;
+
+  if (statement.empty())
+    throw Exception::argument_error("No query specified.");
+
+  if (options->size() != 1)
+    throw Exception::argument_error("The source must have one of file, data or generator");
+
+  if (options->has_key("file"))
+    source.reset(new Local_infile_file(options->get_string("file")));
+  else if (options->has_key("data"))
+    source.reset(new Local_infile_buffer(options->get_string("data")));
+  else if (options->has_key("generator"))
+  {
+    shcore::Value generator = (*options)["generator"];
+
+    if (generator.type != shcore::Function)
+      throw Exception::argument_error("The generator source must be a function");
+
+    source.reset(new Local_infile_function(generator.as_function()));
+  }
+  else
+    throw Exception::argument_error("Invalid source '" + options->begin()->first + "', allowed values are file, data and generator");
+
+  Value ret_val;
+
+  // The source is only valid for this statement
+  _conn->set_local_infile_source(source);
+
+  try
+  {
+    ret_val = Value::wrap(new ClassicResult(boost::shared_ptr<Result>(_conn->run_sql(statement))));
+  }
+  catch (...)
+  {
+    _conn->set_local_infile_source(boost::shared_ptr<Local_infile_source>());
+    throw;
+  }
+
+  _conn->set_local_infile_source(boost::shared_ptr<Local_infile_source>());
+
+  return ret_val;
+}
+
 #ifdef DOXYGEN
 /**
 * Creates a schema on the database and returns the corresponding object.
@@ -606,10 +684,39 @@ shcore::Value ClassicSession::rollback(const shcore::Argument_list &args)
   return Value::wrap(new ClassicResult(boost::shared_ptr<Result>(_conn->run_sql("rollback"))));
 }
 
+shcore::Value ClassicSession::get_metrics()
+{
+  if (!_conn)
+    return shcore::Value::Null();
+
+  const Connection_metrics &metrics = _conn->metrics();
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type);
+  shcore::Value::Map_type_ref latency(new shcore::Value::Map_type);
+
+  (*ret_val)["queries_sent"] = shcore::Value(metrics.queries_sent);
+  (*ret_val)["query_bytes_sent"] = shcore::Value(metrics.query_bytes_sent);
+  (*ret_val)["rows_decoded"] = shcore::Value(metrics.rows_fetched);
+  (*ret_val)["bytes_decoded"] = shcore::Value(metrics.row_bytes_fetched);
+
+  (*latency)["sql"] = describe_latency(metrics.query_latency);
+  (*ret_val)["latency"] = shcore::Value(latency);
+
+  return shcore::Value(ret_val);
+}
+
+void ClassicSession::reset_metrics()
+{
+  if (_conn)
+    _conn->metrics().reset();
+}
+
 shcore::Value ClassicSession::get_status(const shcore::Argument_list &args)
 {
   shcore::Value::Map_type_ref status(new shcore::Value::Map_type);
 
+  // Taken before the queries below are accounted
+  (*status)["METRICS"] = get_metrics();
+
   Result *result;
   Row *row;
 
@@ -646,12 +753,13 @@ shcore::Value ClassicSession::get_status(const shcore::Argument_list &args)
 
   (*status)["SERVER_STATS"] = shcore::Value(_conn->get_stats());
 
+  (*status)["PROTOCOL_COMPRESSED"] = shcore::Value(_conn->is_compressed());
+
   // TODO: Review retrieval from charset_info, mysql connection
 
   // TODO: Embedded library stuff
   //(*status)["TCP_PORT"] = row->get_value(1);
   //(*status)["UNIX_SOCKET"] = row->get_value(2);
-  //(*status)["PROTOCOL_COMPRESSED"] = row->get_value(3);
 
   // STATUS
 
@@ -83,6 +83,7 @@ namespace mysh
       virtual shcore::Value connect(const shcore::Argument_list &args);
       virtual shcore::Value close(const shcore::Argument_list &args);
       virtual shcore::Value run_sql(const shcore::Argument_list &args) const;
+      shcore::Value load_local_infile(const shcore::Argument_list &args);
       virtual shcore::Value create_schema(const shcore::Argument_list &args);
       virtual shcore::Value startTransaction(const shcore::Argument_list &args);
       virtual shcore::Value commit(const shcore::Argument_list &args);
@@ -92,6 +93,8 @@ namespace mysh
 
       virtual bool is_connected() const { return _conn ? true : false; }
       virtual shcore::Value get_status(const shcore::Argument_list &args);
+      virtual shcore::Value get_metrics();
+      virtual void reset_metrics();
 
       virtual shcore::Value get_schema(const shcore::Argument_list &args) const;
 
@@ -120,6 +123,7 @@ namespace mysh
       List getSchemas();
       String getUri();
       ClassicResult runSql(String query);
+      ClassicResult loadLocalInfile(String query, Dictionary source);
       Undefined close();
       ClassicResult startTransaction();
       ClassicResult commit();
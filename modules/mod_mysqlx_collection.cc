@@ -53,6 +53,7 @@ void Collection::init()
   add_method("find", boost::bind(&Collection::find_, this, _1), "searchCriteria", shcore::String, NULL);
   add_method("remove", boost::bind(&Collection::remove_, this, _1), "searchCriteria", shcore::String, NULL);
   add_method("createIndex", boost::bind(&Collection::create_index_, this, _1), "searchCriteria", shcore::String, NULL);
+  add_method("createIndexes", boost::bind(&Collection::create_indexes_, this, _1), "indexes", shcore::Array, "options", shcore::Map, NULL);
   add_method("dropIndex", boost::bind(&Collection::drop_index_, this, _1), "searchCriteria", shcore::String, NULL);
 }
 
@@ -213,6 +214,48 @@ shcore::Value Collection::create_index_(const shcore::Argument_list &args)
   return createIndex->create_index(args);
 }
 
+#ifdef DOXYGEN
+/**
+* Creates several indexes on a collection with a single statement.
+* \param indexes A list with the definitions of the indexes to be created.
+* \return A Result object.
+*
+* Each index definition is a dictionary with the following elements:
+*
+* - name: the name of the index.
+* - unique: optional flag to create a unique index, false by default.
+* - fields: a non empty list of dictionaries with the field, type and required
+*   elements, with the same meaning as the parameters of CollectionCreateIndex.field().
+*
+* Unlike createIndex(), all the indexes are added in a single ALTER TABLE so the
+* collection is rebuilt once no matter how many indexes are created.
+*
+* \sa CollectionCreateIndex
+*/
+Result Collection::createIndexes(List indexes){}
+
+/**
+* Creates several indexes on a collection with a single statement.
+* \param indexes A list with the definitions of the indexes to be created.
+* \param options A dictionary with options for the index creation.
+* \return A Result object.
+*
+* The only available option is showProgress, which prints the stage and the
+* completion of the statement every second while it runs. It is true by default
+* in interactive mode.
+*
+* The progress is read from performance_schema on a second session, when the
+* stage instruments are disabled only the elapsed time is printed.
+*/
+Result Collection::createIndexes(List indexes, Dictionary options){}
+#endif
+shcore::Value Collection::create_indexes_(const shcore::Argument_list &args)
+{
+  boost::shared_ptr<CollectionCreateIndex> createIndex(new CollectionCreateIndex(shared_from_this()));
+
+  return createIndex->create_indexes(args);
+}
+
 #ifdef DOXYGEN
 /**
 * Drops an index from a collection.
@@ -59,6 +59,8 @@ namespace mysh
       CollectionModify modify(String searchCondition);
       CollectionCreateIndex createIndex(String name);
       CollectionCreateIndex createIndex(String name, IndexType type);
+      Result createIndexes(List indexes);
+      Result createIndexes(List indexes, Dictionary options);
       CollectionDropIndex dropIndex(String name);
 #endif
     private:
@@ -67,6 +69,7 @@ namespace mysh
       shcore::Value modify_(const shcore::Argument_list &args);
       shcore::Value remove_(const shcore::Argument_list &args);
       shcore::Value create_index_(const shcore::Argument_list &args);
+      shcore::Value create_indexes_(const shcore::Argument_list &args);
       shcore::Value drop_index_(const shcore::Argument_list &args);
 
       void init();
@@ -24,9 +24,22 @@
 #include "base_constants.h"
 #include "uuid_gen.h"
 #include "mysqlx_parser.h"
+#include "shellcore/shell_core_options.h"
+#include "utils/utils_sqlstring.h"
+#include "utils/utils_time.h"
+#include "my_global.h"
+#include "mysql41_hash.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <iomanip>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 
 using namespace mysh::mysqlx;
@@ -185,5 +198,453 @@ shcore::Value CollectionCreateIndex::execute(const shcore::Argument_list &args)
 
   update_functions("execute");
 
+  return result;
+}
+
+namespace
+{
+  struct Index_field
+  {
+    std::string column;
+    std::string column_definition;
+    std::string key_part;
+  };
+
+  struct Index_definition
+  {
+    std::string name;
+    bool unique;
+    std::vector<Index_field> fields;
+  };
+
+  // Upper case hex SHA1 of the document path, as the X Plugin names its columns
+  std::string get_path_hash(const std::string &path)
+  {
+    static const char digits[] = "0123456789ABCDEF";
+    uint8 hash[MYSQL41_HASH_SIZE];
+    std::string result;
+
+    compute_mysql41_hash(hash, path.data(), path.size());
+
+    for (int i = 0; i < MYSQL41_HASH_SIZE; ++i)
+    {
+      result.push_back(digits[hash[i] >> 4]);
+      result.push_back(digits[hash[i] & 0x0F]);
+    }
+
+    return result;
+  }
+
+  // Column name tags used by the X Plugin for each type
+  const char *get_type_prefix(const std::string &base_type)
+  {
+    static const char *prefixes[][2] = {
+      { "TINYINT", "it" }, { "SMALLINT", "is" }, { "MEDIUMINT", "im" }, { "INT", "i" }, { "INTEGER", "i" },
+      { "BIGINT", "ib" }, { "REAL", "fr" }, { "FLOAT", "f" }, { "DOUBLE", "fd" }, { "DECIMAL", "xd" },
+      { "NUMERIC", "xn" }, { "DATE", "d" }, { "TIME", "dt" }, { "TIMESTAMP", "ds" }, { "DATETIME", "dd" },
+      { "YEAR", "dy" }, { "TEXT", "t" }, { NULL, NULL } };
+
+    for (int i = 0; prefixes[i][0]; ++i)
+    {
+      if (base_type == prefixes[i][0])
+        return prefixes[i][1];
+    }
+
+    return NULL;
+  }
+
+  /*
+  * Builds the generated column holding the value of a document field. It is
+  * named as the X Plugin does, $ix_<type><length>[_<scale>][u]_[r_]<SHA1 of
+  * the path>, so createIndex and createIndexes share the columns of the same
+  * field and dropIndex cleans them up as well.
+  */
+  Index_field get_index_field(const std::string &field, const std::string &column_type, bool required)
+  {
+    const std::string invalid_type = "Invalid index column type '" + column_type + "'";
+    std::string type = boost::to_upper_copy(boost::trim_copy(column_type));
+
+    if (type.empty() || type.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789(), ") != std::string::npos)
+      throw shcore::Exception::argument_error(invalid_type);
+
+    // <base type>[(<length>[,<scale>])][ UNSIGNED]
+    std::string::size_type end = type.find_first_of("( ");
+    const std::string base_type = type.substr(0, end);
+    std::string length;
+    std::string scale;
+    bool is_unsigned = false;
+
+    if (end != std::string::npos && type[end] == '(')
+    {
+      std::string::size_type close = type.find(')', end);
+      if (close == std::string::npos)
+        throw shcore::Exception::argument_error(invalid_type);
+
+      std::string arguments = boost::erase_all_copy(type.substr(end + 1, close - end - 1), " ");
+      std::string::size_type comma = arguments.find(',');
+
+      length = arguments.substr(0, comma);
+      if (comma != std::string::npos)
+        scale = arguments.substr(comma + 1);
+
+      if (length.empty() || length.find_first_not_of("0123456789") != std::string::npos ||
+          (comma != std::string::npos && (scale.empty() || scale.find_first_not_of("0123456789") != std::string::npos)))
+        throw shcore::Exception::argument_error(invalid_type);
+
+      end = close + 1;
+    }
+
+    const std::string rest = boost::trim_copy(type.substr(std::min(end, type.size())));
+    if (rest == "UNSIGNED")
+      is_unsigned = true;
+    else if (!rest.empty())
+      throw shcore::Exception::argument_error(invalid_type);
+
+    const char *type_prefix = get_type_prefix(base_type);
+    if (!type_prefix)
+      throw shcore::Exception::argument_error(invalid_type);
+
+    // TEXT columns can only be indexed by a prefix, the length goes to the key part
+    std::string key_length;
+    if (base_type == "TEXT")
+    {
+      if (length.empty() || !scale.empty() || is_unsigned)
+        throw shcore::Exception::argument_error("Index column type TEXT requires a length, as in TEXT(n)");
+
+      key_length = "(" + length + ")";
+      type = "TEXT";
+    }
+
+    const std::string path = "$." + field;
+
+    Index_field index_field;
+    index_field.column = std::string("$ix_") + type_prefix + length + (scale.empty() ? "" : "_" + scale) +
+      (is_unsigned ? "u" : "") + (required ? "_r_" : "_") + get_path_hash(path);
+
+    // Numbers are compared as such, everything else goes through the unquoted string
+    static const char *numeric_types[] = { "TINYINT", "SMALLINT", "MEDIUMINT", "INT", "INTEGER", "BIGINT",
+                                           "DECIMAL", "NUMERIC", "FLOAT", "DOUBLE", "REAL", NULL };
+    bool numeric = false;
+    for (const char **numeric_type = numeric_types; *numeric_type && !numeric; ++numeric_type)
+      numeric = (base_type == *numeric_type);
+
+    std::string value = sqlstring("JSON_EXTRACT(doc, ?)", 0) << path;
+    if (!numeric)
+      value = "JSON_UNQUOTE(" + value + ")";
+
+    index_field.column_definition = quote_identifier(index_field.column, '`') + " " + type +
+      " GENERATED ALWAYS AS (" + value + (required ? ") STORED NOT NULL" : ") VIRTUAL");
+    index_field.key_part = quote_identifier(index_field.column, '`') + key_length;
+
+    return index_field;
+  }
+
+  Index_definition get_index_definition(const shcore::Value &value)
+  {
+    if (value.type != shcore::Map)
+      throw shcore::Exception::argument_error("Index definitions are expected to be dictionaries");
+
+    shcore::Value::Map_type_ref map = value.as_map();
+    Index_definition index;
+    index.unique = false;
+
+    for (shcore::Value::Map_type::const_iterator option = map->begin(); option != map->end(); ++option)
+    {
+      if (option->first == "name")
+        index.name = map->get_string("name");
+      else if (option->first == "unique")
+        index.unique = map->get_bool("unique");
+      else if (option->first != "fields")
+        throw shcore::Exception::argument_error("Invalid index definition element '" + option->first + "'");
+    }
+
+    if (index.name.empty())
+      throw shcore::Exception::argument_error("Index definitions require a name");
+
+    shcore::Value::Array_type_ref fields;
+    if (map->has_key("fields"))
+      fields = map->get_array("fields");
+
+    if (!fields || fields->empty())
+      throw shcore::Exception::argument_error("Index '" + index.name + "' requires at least one field");
+
+    for (shcore::Value::Array_type::const_iterator item = fields->begin(); item != fields->end(); ++item)
+    {
+      if (item->type != shcore::Map)
+        throw shcore::Exception::argument_error("Fields of index '" + index.name + "' are expected to be dictionaries");
+
+      shcore::Value::Map_type_ref field = item->as_map();
+      std::string path;
+      std::string type;
+      bool required = false;
+
+      for (shcore::Value::Map_type::const_iterator option = field->begin(); option != field->end(); ++option)
+      {
+        if (option->first == "field")
+          path = field->get_string("field");
+        else if (option->first == "type")
+          type = field->get_string("type");
+        else if (option->first == "required")
+          required = field->get_bool("required");
+        else
+          throw shcore::Exception::argument_error("Invalid index field element '" + option->first + "'");
+      }
+
+      if (path.empty() || type.empty())
+        throw shcore::Exception::argument_error("Fields of index '" + index.name + "' require a field and a type");
+
+      index.fields.push_back(get_index_field(path, type, required));
+    }
+
+    return index;
+  }
+
+  /*
+  * Runs the ALTER TABLE printing its progress once per second. The statement
+  * runs on a thread of its own while the current stage is polled from
+  * performance_schema using a second session.
+  */
+  boost::shared_ptr< ::mysqlx::Result> execute_with_progress(BaseSession &session, const std::string &statement, size_t index_count)
+  {
+    boost::shared_ptr< ::mysqlx::Session> connection(session.session_obj());
+    boost::shared_ptr< ::mysqlx::Result> result;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+
+    std::thread worker([&]()
+    {
+      boost::shared_ptr< ::mysqlx::Result> statement_result;
+
+      try
+      {
+        statement_result = connection->executeSql(statement);
+        statement_result->wait();
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      result = statement_result;
+      done = true;
+      finished.notify_one();
+    });
+
+    const std::string stage_query = (boost::format("SELECT s.EVENT_NAME, s.WORK_COMPLETED, s.WORK_ESTIMATED "
+                                                   "FROM performance_schema.events_stages_current s "
+                                                   "JOIN performance_schema.threads t ON s.THREAD_ID = t.THREAD_ID "
+                                                   "WHERE t.PROCESSLIST_ID = %1%") % session.get_connection_id()).str();
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    boost::shared_ptr< ::mysqlx::Session> monitor;
+    size_t last_length = 0;
+
+    try
+    {
+      monitor = session.open_new_session();
+    }
+    catch (...)
+    {
+      // No progress other than the elapsed time
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!finished.wait_for(lock, std::chrono::seconds(1), [&done]() { return done; }))
+    {
+      lock.unlock();
+
+      std::string stage;
+      if (monitor)
+      {
+        try
+        {
+          boost::shared_ptr< ::mysqlx::Result> stage_result(monitor->executeSql(stage_query));
+          boost::shared_ptr< ::mysqlx::Row> row(stage_result->next());
+
+          if (row)
+          {
+            stage = ", " + row->stringField(0);
+
+            if (!row->isNullField(1) && !row->isNullField(2) && row->uInt64Field(2) > 0)
+              stage += (boost::format(" %1%%%") % (row->uInt64Field(1) * 100 / row->uInt64Field(2))).str();
+          }
+
+          stage_result->flush();
+        }
+        catch (...)
+        {
+          monitor.reset();
+        }
+      }
+
+      const int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - start).count();
+      std::string progress = (boost::format("Creating %1% indexes%2%, %3% sec") % index_count % stage % seconds).str();
+      const size_t length = progress.size();
+
+      // Clears what is left of a longer previous line
+      if (length < last_length)
+        progress.append(last_length - length, ' ');
+
+      shcore::print("\r" + progress);
+      last_length = length;
+
+      lock.lock();
+    }
+    lock.unlock();
+
+    worker.join();
+
+    if (monitor)
+      monitor->close();
+
+    if (error)
+    {
+      if (last_length)
+        shcore::print("\n");
+
+      std::rethrow_exception(error);
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::string progress = (boost::format("Created %1% indexes in %2$.2f sec") % index_count % seconds).str();
+
+    if (progress.size() < last_length)
+      progress.append(last_length - progress.size(), ' ');
+
+    shcore::print("\r" + progress + "\n");
+
+    return result;
+  }
+}
+
+#ifdef DOXYGEN
+/**
+* Creates several indexes with a single ALTER TABLE statement.
+* \param indexes A list with the definitions of the indexes to be created.
+* \param options A dictionary with the showProgress option.
+* \return A Result object.
+*
+* This function is called through Collection.createIndexes(), the statement is
+* executed right away.
+*/
+Result CollectionCreateIndex::createIndexes(List indexes, Dictionary options){}
+#endif
+shcore::Value CollectionCreateIndex::create_indexes(const shcore::Argument_list &args)
+{
+  Value result;
+  std::vector<Index_definition> indexes;
+  bool show_progress = (*Shell_core_options::get())[SHCORE_INTERACTIVE].as_bool();
+
+  args.ensure_count(1, 2, "Collection.createIndexes");
+
+  try
+  {
+    shcore::Value::Array_type_ref definitions = args.array_at(0);
+
+    if (definitions->empty())
+      throw shcore::Exception::argument_error("Argument #1 is expected to be a non empty list of index definitions");
+
+    std::set<std::string> names;
+    for (shcore::Value::Array_type::const_iterator definition = definitions->begin(); definition != definitions->end(); ++definition)
+    {
+      indexes.push_back(get_index_definition(*definition));
+
+      if (!names.insert(indexes.back().name).second)
+        throw shcore::Exception::argument_error("Duplicate index name '" + indexes.back().name + "'");
+    }
+
+    if (args.size() == 2)
+    {
+      shcore::Value::Map_type_ref options = args.map_at(1);
+
+      for (shcore::Value::Map_type::const_iterator option = options->begin(); option != options->end(); ++option)
+      {
+        if (option->first == "showProgress")
+          show_progress = options->get_bool("showProgress");
+        else
+          throw shcore::Exception::argument_error("Invalid option '" + option->first + "'");
+      }
+    }
+  }
+  CATCH_AND_TRANSLATE_CRUD_EXCEPTION("Collection.createIndexes");
+
+  boost::shared_ptr<Collection> raw_owner(_owner.lock());
+
+  if (raw_owner)
+  {
+    Value session = raw_owner->get_member("session");
+    boost::shared_ptr<BaseSession> session_obj = boost::static_pointer_cast<BaseSession>(session.as_object());
+    const std::string schema = raw_owner->get_member("schema").as_object()->get_member("name").as_string();
+    const std::string collection = raw_owner->get_member("name").as_string();
+
+    try
+    {
+      // Generated columns are shared by the indexes on the same field and type,
+      // the ones created by previous indexes are reused
+      std::set<std::string> columns;
+      boost::shared_ptr< ::mysqlx::Result> columns_result(session_obj->session_obj()->executeSql(
+        sqlstring("SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+                  "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? AND COLUMN_NAME LIKE '$ix%'", 0) << schema << collection));
+      boost::shared_ptr< ::mysqlx::Row> row;
+
+      while ((row = columns_result->next()))
+        columns.insert(row->stringField(0));
+      columns_result->flush();
+
+      std::string statement = "ALTER TABLE " + quote_identifier(schema, '`') + "." + quote_identifier(collection, '`');
+      const char *separator = " ";
+
+      for (std::vector<Index_definition>::const_iterator index = indexes.begin(); index != indexes.end(); ++index)
+      {
+        for (std::vector<Index_field>::const_iterator field = index->fields.begin(); field != index->fields.end(); ++field)
+        {
+          if (columns.insert(field->column).second)
+          {
+            statement.append(separator).append("ADD COLUMN ").append(field->column_definition);
+            separator = ", ";
+          }
+        }
+      }
+
+      for (std::vector<Index_definition>::const_iterator index = indexes.begin(); index != indexes.end(); ++index)
+      {
+        statement.append(separator).append(index->unique ? "ADD UNIQUE INDEX " : "ADD INDEX ");
+        statement.append(quote_identifier(index->name, '`')).append(" (");
+
+        for (std::vector<Index_field>::const_iterator field = index->fields.begin(); field != index->fields.end(); ++field)
+        {
+          if (field != index->fields.begin())
+            statement.append(", ");
+          statement.append(field->key_part);
+        }
+
+        statement.append(")");
+        separator = ", ";
+      }
+
+      MySQL_timer timer;
+      boost::shared_ptr< ::mysqlx::Result> exec_result;
+
+      timer.start();
+
+      if (show_progress)
+        exec_result = execute_with_progress(*session_obj, statement, indexes.size());
+      else
+      {
+        exec_result = session_obj->session_obj()->executeSql(statement);
+        exec_result->wait();
+      }
+
+      timer.end();
+
+      Result *index_result;
+      result = shcore::Value::wrap(index_result = new Result(exec_result));
+      index_result->set_execution_time(timer.raw_duration());
+    }
+    CATCH_AND_TRANSLATE_CRUD_EXCEPTION("Collection.createIndexes");
+  }
+
   return result;
 }
\ No newline at end of file
@@ -51,6 +51,9 @@ namespace mysh
       shcore::Value field(const shcore::Argument_list &args);
       virtual shcore::Value execute(const shcore::Argument_list &args);
 
+      // Creates several indexes at once, the entry point of Collection.createIndexes
+      shcore::Value create_indexes(const shcore::Argument_list &args);
+
 #ifdef DOXYGEN
       CollectionCreateIndex createIndex(String name);
       CollectionCreateIndex createIndex(String name, IndexType type);
@@ -38,12 +38,14 @@ _result(result), _execution_time(0)
   add_method("getExecutionTime", boost::bind(&BaseResult::get_member_method, this, _1, "getExecutionTime", "executionTime"), NULL);
   add_method("getWarnings", boost::bind(&BaseResult::get_member_method, this, _1, "getWarnings", "warnings"), NULL);
   add_method("getWarningCount", boost::bind(&BaseResult::get_member_method, this, _1, "getWarningCount", "warningCount"), NULL);
+  add_method("getTiming", boost::bind(&BaseResult::get_member_method, this, _1, "getTiming", "timing"), NULL);
 }
 
 std::vector<std::string> BaseResult::get_members() const
 {
   std::vector<std::string> members(ShellBaseResult::get_members());
   members.push_back("executionTime");
+  members.push_back("timing");
   members.push_back("warningCount");
   members.push_back("warnings");
   return members;
@@ -53,6 +55,7 @@ bool BaseResult::has_member(const std::string &prop) const
 {
   return ShellBaseResult::has_member(prop) ||
     prop == "executionTime" ||
+    prop == "timing" ||
     prop == "warningCount" ||
     prop == "warnings";
 }
@@ -81,6 +84,18 @@ List BaseResult::getWarnings(){};
 */
 String BaseResult::getExecutionTime(){};
 
+/**
+* Retrieves the time spent on each phase of the operation, measured on the client.
+* \return A map with the duration of each phase in microseconds.
+*
+* The phases are:
+* - send: the request being sent to the server.
+* - firstMetadata: waiting for the first response from the server.
+* - firstRow: reading the rest of the column metadata until the first row arrives.
+* - streaming: reading the rows until the server reports the operation as finished.
+*/
+Map BaseResult::getTiming(){};
+
 #endif
 shcore::Value BaseResult::get_member(const std::string &prop) const
 {
@@ -89,6 +104,9 @@ shcore::Value BaseResult::get_member(const std::string &prop) const
   if (prop == "executionTime")
     return shcore::Value(get_execution_time());
 
+  else if (prop == "timing")
+    ret_val = get_timing(_result->timing());
+
   else if (prop == "warningCount")
     ret_val = Value(get_warning_count());
 
@@ -135,6 +153,12 @@ void BaseResult::buffer()
   _result->buffer();
 }
 
+// Reads the rest of the result, the rows are skipped without parsing them
+void BaseResult::flush()
+{
+  _result->flush();
+}
+
 bool BaseResult::rewind()
 {
   return _result->rewind();
@@ -325,7 +349,19 @@ shcore::Value DocResult::fetch_one(const shcore::Argument_list &args) const
   {
     boost::shared_ptr< ::mysqlx::Row> r(_result->next());
     if (r.get())
-      return Value::parse(r->stringField(0));
+    {
+      size_t length;
+
+      // Buffered rows can be read again, otherwise the row is only
+      // referenced here and the document is decoded in place
+      if (_result->is_buffered())
+      {
+        const char *data = r->stringField(0, length);
+        return Value::parse_json(data, length);
+      }
+      else
+        return Value::parse_json_in_situ(r->mutableStringField(0, length));
+    }
   }
   return shcore::Value();
 }
@@ -351,7 +387,7 @@ shcore::Value DocResult::fetch_all(const shcore::Argument_list &args) const
   Value record = fetch_one(args);
   while (record)
   {
-    array->push_back(record);
+    array->push_back(std::move(record));
     record = fetch_one(args);
   }
 
@@ -715,7 +751,7 @@ shcore::Value RowResult::fetch_one(const shcore::Argument_list &args) const
               break;
           }
         }
-        value_row->add_item(metadata->at(index).name, field_value);
+        value_row->add_item(metadata->at(index).name, std::move(field_value));
       }
 
       return shcore::Value::wrap(value_row);
@@ -741,7 +777,7 @@ shcore::Value RowResult::fetch_all(const shcore::Argument_list &args) const
   Value record = fetch_one(args);
   while (record)
   {
-    array->push_back(record);
+    array->push_back(std::move(record));
     record = fetch_one(args);
   }
 
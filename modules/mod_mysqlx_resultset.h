@@ -56,6 +56,7 @@ namespace mysh
       std::string get_execution_time() const;
       uint64_t get_warning_count() const;
       virtual void buffer();
+      virtual void flush();
       virtual bool rewind();
       virtual bool tell(size_t &dataset, size_t &record);
       virtual bool seek(size_t dataset, size_t record);
@@ -64,10 +65,12 @@ namespace mysh
       Integer warningCount; //!< Same as getwarningCount()
       List warnings; //!< Same as getWarnings()
       String executionTime; //!< Same as getExecutionTime()
+      Map timing; //!< Same as getTiming()
 
       Integer getWarningCount();
       List getWarnings();
       String getExecutionTime();
+      Map getTiming();
 #endif
 
     protected:
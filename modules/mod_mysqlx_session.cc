@@ -123,7 +123,7 @@ Value BaseSession::connect(const Argument_list &args)
     // Retrieves the connection data, whatever the source is
     load_connection_data(args);
 
-    _session.open(_host, _port, _schema, _user, _password, _ssl_ca, _ssl_cert, _ssl_key, 10000, _auth_method, true);
+    _session.open(_host, _port, _sock, _schema, _user, _password, _ssl_ca, _ssl_cert, _ssl_key, 10000, _auth_method, true, _compression);
 
     int case_sesitive_table_names = 0;
     _retrieve_session_info(_default_schema, case_sesitive_table_names);
@@ -137,6 +137,15 @@ Value BaseSession::connect(const Argument_list &args)
   return Value::Null();
 }
 
+boost::shared_ptr< ::mysqlx::Session> BaseSession::open_new_session() const
+{
+  SessionHandle session;
+
+  session.open(_host, _port, _sock, _schema, _user, _password, _ssl_ca, _ssl_cert, _ssl_key, 10000, _auth_method, true, _compression);
+
+  return session.get();
+}
+
 void BaseSession::set_connection_id()
 {
   if (_session.is_connected())
@@ -624,7 +633,7 @@ std::string BaseSession::db_object_exists(std::string &type, const std::string &
       ret_val = row->get_member(0).as_string();
     }
 
-    my_res->fetch_all(shcore::Argument_list());
+    my_res->flush();
   }
   else
   {
@@ -656,7 +665,7 @@ std::string BaseSession::db_object_exists(std::string &type, const std::string &
           ret_val = object_name;
       }
     }
-    my_res->fetch_all(shcore::Argument_list());
+    my_res->flush();
   }
 
   return ret_val;
@@ -682,6 +691,9 @@ shcore::Value BaseSession::get_status(const shcore::Argument_list &args)
 
   (*status)["DEFAULT_SCHEMA"] = shcore::Value(_default_schema);
 
+  // Taken before the queries below are accounted
+  (*status)["METRICS"] = get_metrics();
+
   boost::shared_ptr< ::mysqlx::Result> result;
   boost::shared_ptr< ::mysqlx::Row>row;
   result = _session.execute_sql("select DATABASE(), USER() limit 1");
@@ -694,6 +706,12 @@ shcore::Value BaseSession::get_status(const shcore::Argument_list &args)
   (*status)["CURRENT_SCHEMA"] = shcore::Value(current_schema);
   (*status)["CURRENT_USER"] = shcore::Value(row->isNullField(1) ? "" : row->stringField(1));
   (*status)["CONNECTION_ID"] = shcore::Value(_session.get_client_id());
+
+  // The X Plugin refuses compression, the reason is shown when it was asked for
+  boost::shared_ptr< ::mysqlx::Connection> connection = _session.get()->connection();
+  (*status)["PROTOCOL_COMPRESSED"] = shcore::Value(connection->is_compression_active());
+  if (connection->is_compression_requested() && !connection->is_compression_active())
+    (*status)["COMPRESSION_REFUSED"] = shcore::Value(connection->compression_refusal());
   //(*status)["SSL_CIPHER"] = shcore::Value(_conn->get_ssl_cipher());
   //(*status)["SKIP_UPDATES"] = shcore::Value(???);
   //(*status)["DELIMITER"] = shcore::Value(???);
@@ -719,7 +737,6 @@ shcore::Value BaseSession::get_status(const shcore::Argument_list &args)
   // TODO: Embedded library stuff
   //(*status)["TCP_PORT"] = row->get_value(1);
   //(*status)["UNIX_SOCKET"] = row->get_value(2);
-  //(*status)["PROTOCOL_COMPRESSED"] = row->get_value(3);
 
   // STATUS
 
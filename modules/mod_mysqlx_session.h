@@ -89,6 +89,8 @@ namespace mysh
       virtual bool is_connected() const;
       virtual shcore::Value get_status(const shcore::Argument_list &args);
       virtual shcore::Value get_capability(const std::string& name);
+      virtual shcore::Value get_metrics() { return _session.get_metrics(); }
+      virtual void reset_metrics() { _session.reset_metrics(); }
 
       virtual shcore::Value get_schema(const shcore::Argument_list &args) const;
 
@@ -100,6 +102,10 @@ namespace mysh
 
       boost::shared_ptr< ::mysqlx::Session> session_obj() const;
 
+      // Opens another session with the connection data of this one, for the
+      // operations that spread their work across several connections
+      boost::shared_ptr< ::mysqlx::Session> open_new_session() const;
+
       static boost::shared_ptr<shcore::Object_bridge> create(const shcore::Argument_list &args);
 
       bool table_name_compare(const std::string &n1, const std::string &n2);
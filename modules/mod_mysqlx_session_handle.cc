@@ -21,17 +21,20 @@
 #include "mysqlxtest_utils.h"
 #include "mysqlx_connection.h"
 #include "utils/utils_general.h"
+#include "base_session.h"
+
+#include <boost/lexical_cast.hpp>
 
 using namespace mysh;
 using namespace shcore;
 using namespace mysh::mysqlx;
 
-void SessionHandle::open(const std::string &host, int port, const std::string &schema,
-                          const std::string &user, const std::string &pass,
-                          const std::string &ssl_ca, const std::string &ssl_cert,
-                          const std::string &ssl_key, const std::size_t timeout,
-                          const std::string &auth_method, const bool get_caps)
-{
+void SessionHandle::open(const std::string &host, int port, const std::string &socket_path, const std::string &schema,
+                          const std::string &user, const std::string &pass,
+                          const std::string &ssl_ca, const std::string &ssl_cert,
+                          const std::string &ssl_key, const std::size_t timeout,
+                          const std::string &auth_method, const bool get_caps, const bool compression)
+{
   ::mysqlx::Ssl_config ssl;
   memset(&ssl, 0, sizeof(ssl));
 
@@ -45,7 +48,7 @@ void SessionHandle::open(const std::string &host, int port, const std::string &s
   ssl.ca_path = my_ssl_ca_path.c_str();
 
   // TODO: Define a proper timeout for the session creation
-  _session = ::mysqlx::openSession(host, port, schema, user, pass, ssl, 10000, auth_method, true);
+  _session = ::mysqlx::openSession(host, port, socket_path, schema, user, pass, ssl, 10000, auth_method, true, compression);
 }
 
 boost::shared_ptr< ::mysqlx::Result> SessionHandle::execute_sql(const std::string &sql) const
@@ -167,4 +170,99 @@ uint64_t SessionHandle::get_client_id()
   }
   else
     return 0;
-}
\ No newline at end of file
+}
+
+static shcore::Value describe_messages(const ::mysqlx::Protocol_metrics &metrics, bool sent)
+{
+  shcore::Value::Map_type_ref messages(new shcore::Value::Map_type);
+
+  for (int mid = 0; mid < ::mysqlx::Protocol_metrics::MESSAGE_TYPES; mid++)
+  {
+    const ::mysqlx::Protocol_metrics::Counter &counter = sent ? metrics.sent(mid) : metrics.received(mid);
+
+    if (0 == counter.messages)
+      continue;
+
+    std::string name;
+    if (sent && Mysqlx::ClientMessages::Type_IsValid(mid))
+      name = Mysqlx::ClientMessages::Type_Name(static_cast<Mysqlx::ClientMessages::Type>(mid));
+    else if (!sent && Mysqlx::ServerMessages::Type_IsValid(mid))
+      name = Mysqlx::ServerMessages::Type_Name(static_cast<Mysqlx::ServerMessages::Type>(mid));
+    else
+      name = boost::lexical_cast<std::string>(mid);
+
+    shcore::Value::Map_type_ref entry(new shcore::Value::Map_type);
+    (*entry)["count"] = shcore::Value(counter.messages);
+    (*entry)["bytes"] = shcore::Value(counter.bytes);
+
+    (*messages)[name] = shcore::Value(entry);
+  }
+
+  return shcore::Value(messages);
+}
+
+static shcore::Value describe_compression(const ::mysqlx::Connection &connection)
+{
+  const ::mysqlx::Compression_statistics &statistics = connection.compression_statistics();
+  shcore::Value::Map_type_ref compression(new shcore::Value::Map_type);
+
+  (*compression)["requested"] = shcore::Value(connection.is_compression_requested());
+  (*compression)["enabled"] = shcore::Value(connection.is_compression_active());
+
+  if (!connection.is_compression_active())
+  {
+    if (connection.is_compression_requested())
+      (*compression)["refused"] = shcore::Value(connection.compression_refusal());
+
+    return shcore::Value(compression);
+  }
+
+  (*compression)["algorithm"] = shcore::Value(connection.compression_algorithm());
+  (*compression)["bytes_sent"] = shcore::Value(statistics.payload_bytes_sent());
+  (*compression)["wire_bytes_sent"] = shcore::Value(statistics.wire_bytes_sent());
+  (*compression)["bytes_received"] = shcore::Value(statistics.payload_bytes_received());
+  (*compression)["wire_bytes_received"] = shcore::Value(statistics.wire_bytes_received());
+  (*compression)["ratio"] = shcore::Value(statistics.ratio());
+  (*compression)["compress_mb_per_sec"] = shcore::Value(statistics.compress_mb_per_sec());
+  (*compression)["uncompress_mb_per_sec"] = shcore::Value(statistics.uncompress_mb_per_sec());
+
+  return shcore::Value(compression);
+}
+
+shcore::Value SessionHandle::get_metrics() const
+{
+  if (!_session)
+    return shcore::Value::Null();
+
+  const ::mysqlx::Protocol_metrics &metrics = _session->connection()->metrics();
+  shcore::Value::Map_type_ref ret_val(new shcore::Value::Map_type);
+  shcore::Value::Map_type_ref latency(new shcore::Value::Map_type);
+
+  (*ret_val)["messages_sent"] = describe_messages(metrics, true);
+  (*ret_val)["messages_received"] = describe_messages(metrics, false);
+  (*ret_val)["rows_decoded"] = shcore::Value(metrics.rows_decoded());
+  (*ret_val)["bytes_decoded"] = shcore::Value(metrics.bytes_decoded());
+
+  for (int op = 0; op < ::mysqlx::Protocol_metrics::Op_count; op++)
+  {
+    ::mysqlx::Protocol_metrics::Operation operation = static_cast< ::mysqlx::Protocol_metrics::Operation>(op);
+    (*latency)[::mysqlx::Protocol_metrics::get_operation_name(operation)] = describe_latency(metrics.latency(operation));
+  }
+
+  (*ret_val)["latency"] = shcore::Value(latency);
+
+  ngs::Tls_handshake_statistics handshakes = ::mysqlx::Mysqlx_sync_connection::get_tls_handshake_statistics();
+  shcore::Value::Map_type_ref tls(new shcore::Value::Map_type);
+  (*tls)["full_handshakes"] = shcore::Value(int64_t(handshakes.full_handshakes));
+  (*tls)["resumed_handshakes"] = shcore::Value(int64_t(handshakes.resumed_handshakes));
+  (*ret_val)["tls"] = shcore::Value(tls);
+  (*ret_val)["compression"] = describe_compression(*_session->connection());
+
+  return shcore::Value(ret_val);
+}
+
+void SessionHandle::reset_metrics()
+{
+  if (_session)
+    _session->connection()->reset_metrics();
+}
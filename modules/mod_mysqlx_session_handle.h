@@ -40,11 +40,13 @@ namespace mysh
     public:
       bool is_connected() const { return _session ? true : false; }
       boost::shared_ptr< ::mysqlx::Session> get() const { return _session; }
-      void open(const std::string &host, int port, const std::string &schema,
+      // The session connects through the socket when socket_path isn't empty
+      void open(const std::string &host, int port, const std::string &socket_path, const std::string &schema,
                 const std::string &user, const std::string &pass,
                 const std::string &ssl_ca, const std::string &ssl_cert,
                 const std::string &ssl_key, const std::size_t timeout,
-                const std::string &auth_method = "", const bool get_caps = false);
+                const std::string &auth_method = "", const bool get_caps = false,
+                const bool compression = false);
 
       boost::shared_ptr< ::mysqlx::Result> execute_sql(const std::string &sql) const;
       void enable_protocol_trace(bool value);
@@ -54,6 +56,9 @@ namespace mysh
       shcore::Value get_capability(const std::string& name);
       uint64_t get_client_id();
 
+      shcore::Value get_metrics() const;
+      void reset_metrics();
+
     private:
       mutable boost::shared_ptr< ::mysqlx::Result> _last_result;
       boost::shared_ptr< ::mysqlx::Session> _session;
@@ -0,0 +1,1593 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "mod_utils.h"
+#include "mod_utils_import.h"
+#include "mod_mysqlx_session.h"
+#include "mod_mysqlx_table.h"
+#include "mysqlxtest_utils.h"
+#include "mysqlx_connection.h"
+#include "shellcore/shell_core_options.h"
+#include "utils/utils_format.h"
+#include "utils/utils_sqlstring.h"
+#include "uuid_gen.h"
+
+#include <boost/bind.hpp>
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/error/en.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+using namespace shcore;
+using namespace mysh;
+
+namespace
+{
+  enum Export_format
+  {
+    Csv,
+    Tsv,
+    Ndjson
+  };
+
+  // Encoded rows are handed over to the writer in pieces of about this size
+  const size_t BUFFER_SIZE = 1024 * 1024;
+
+  // Frames of a chunk read from the server while the previous rows are encoded
+  const size_t READ_AHEAD_SIZE = 4 * 1024 * 1024;
+
+  // Keys of signed columns are mapped to unsigned values keeping their order,
+  // so both kinds of columns are split in ranges the same way
+  const uint64_t SIGN_BIT = 0x8000000000000000ULL;
+
+  // Upper bound of the chunks of a table, the ranges grow past chunkSize rows
+  // when the key span is too wide for the row count estimate, e.g. when the
+  // estimate is 0 because the statistics are stale
+  const uint64_t MAX_CHUNKS = 10000;
+
+  void append_padded(std::string &out, uint32_t value, size_t width)
+  {
+    char digits[10];
+    size_t length = 0;
+
+    do
+    {
+      digits[length++] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    } while (value);
+
+    if (width > length)
+      out.append(width - length, '0');
+
+    while (length)
+      out.push_back(digits[--length]);
+  }
+
+  // Fractional seconds without the trailing zeros, nothing if there are none
+  void append_useconds(std::string &out, uint32_t useconds)
+  {
+    if (useconds == 0)
+      return;
+
+    size_t width = 6;
+    while (useconds % 10 == 0)
+    {
+      useconds /= 10;
+      --width;
+    }
+
+    out.push_back('.');
+    append_padded(out, useconds, width);
+  }
+
+  void append_datetime(std::string &out, const ::mysqlx::DateTime &value)
+  {
+    append_padded(out, value.year(), 4);
+    out.push_back('-');
+    append_padded(out, value.month(), 2);
+    out.push_back('-');
+    append_padded(out, value.day(), 2);
+
+    if (value.has_time())
+    {
+      out.push_back(' ');
+      append_padded(out, value.hour(), 2);
+      out.push_back(':');
+      append_padded(out, value.minutes(), 2);
+      out.push_back(':');
+      append_padded(out, value.seconds(), 2);
+      append_useconds(out, value.useconds());
+    }
+  }
+
+  void append_time(std::string &out, const ::mysqlx::Time &value)
+  {
+    if (value.negate())
+      out.push_back('-');
+
+    append_padded(out, value.hour(), 2);
+    out.push_back(':');
+    append_padded(out, value.minutes(), 2);
+    out.push_back(':');
+    append_padded(out, value.seconds(), 2);
+    append_useconds(out, value.useconds());
+  }
+
+  /*
+  * Encodes rows straight from the protocol buffers of the result
+  *
+  * - csv: comma separated, values with separators, quotes or line breaks and
+  *   empty strings are double quoted, NULL is an empty field
+  * - tsv: tab separated, special characters are escaped with a backslash and
+  *   NULL is \N, as expected by LOAD DATA INFILE with the default options
+  * - ndjson: a JSON document per row with the column names as keys
+  */
+  class Row_encoder
+  {
+  public:
+    Row_encoder(Export_format format, const std::vector< ::mysqlx::ColumnMetadata> &columns)
+      : _format(format), _columns(columns)
+    {
+      if (_format == Ndjson)
+      {
+        for (size_t index = 0; index < _columns.size(); ++index)
+        {
+          std::string key(index ? "," : "{");
+          append_json_string(key, _columns[index].name.data(), _columns[index].name.size());
+          _keys.push_back(key.append(":"));
+        }
+      }
+    }
+
+    void append_row(const ::mysqlx::Row &row, std::string &out) const
+    {
+      const int field_count = static_cast<int>(_columns.size());
+
+      for (int field = 0; field < field_count; ++field)
+      {
+        if (_format == Ndjson)
+          out.append(_keys[field]);
+        else if (field)
+          out.push_back(_format == Csv ? ',' : '\t');
+
+        if (row.isNullField(field))
+        {
+          if (_format == Ndjson)
+            out.append("null");
+          else if (_format == Tsv)
+            out.append("\\N");
+        }
+        else
+          append_field(row, field, out);
+      }
+
+      if (_format == Ndjson)
+        out.push_back('}');
+
+      out.push_back('\n');
+    }
+
+  private:
+    void append_field(const ::mysqlx::Row &row, int field, std::string &out) const
+    {
+      const ::mysqlx::ColumnMetadata &column = _columns[field];
+
+      switch (column.type)
+      {
+        case ::mysqlx::SINT:
+          append_int(out, row.sInt64Field(field));
+          break;
+        case ::mysqlx::UINT:
+          append_uint(out, row.uInt64Field(field));
+          break;
+        case ::mysqlx::BIT:
+          append_uint(out, row.bitField(field));
+          break;
+        case ::mysqlx::DOUBLE:
+          append_double_exact(out, row.doubleField(field));
+          break;
+        case ::mysqlx::FLOAT:
+          append_float_exact(out, row.floatField(field));
+          break;
+        case ::mysqlx::DECIMAL:
+          out.append(row.decimalField(field));
+          break;
+        case ::mysqlx::DATETIME:
+          if (_format == Ndjson)
+            out.push_back('"');
+          append_datetime(out, row.dateTimeField(field));
+          if (_format == Ndjson)
+            out.push_back('"');
+          break;
+        case ::mysqlx::TIME:
+          if (_format == Ndjson)
+            out.push_back('"');
+          append_time(out, row.timeField(field));
+          if (_format == Ndjson)
+            out.push_back('"');
+          break;
+        case ::mysqlx::SET:
+        {
+          const std::string value(row.setFieldStr(field));
+          append_text(value.data(), value.size(), out);
+          break;
+        }
+        case ::mysqlx::ENUM:
+        {
+          const std::string value(row.enumField(field));
+          append_text(value.data(), value.size(), out);
+          break;
+        }
+        case ::mysqlx::BYTES:
+        {
+          size_t length;
+          const char *value = row.stringField(field, length);
+
+          // JSON columns are embedded as they are in the documents
+          if (_format == Ndjson && (column.content_type & 0x0003) == 2)
+            out.append(value, length);
+          else
+            append_text(value, length, out);
+          break;
+        }
+      }
+    }
+
+    void append_text(const char *text, size_t length, std::string &out) const
+    {
+      switch (_format)
+      {
+        case Csv:
+          append_csv_string(out, text, length);
+          break;
+        case Tsv:
+          append_tsv_string(out, text, length);
+          break;
+        case Ndjson:
+          append_json_string(out, text, length);
+          break;
+      }
+    }
+
+    static void append_csv_string(std::string &out, const char *text, size_t length)
+    {
+      const char *end = text + length;
+      bool quote = (length == 0);
+
+      for (const char *c = text; c < end && !quote; ++c)
+        quote = (*c == ',' || *c == '"' || *c == '\n' || *c == '\r');
+
+      if (!quote)
+      {
+        out.append(text, length);
+        return;
+      }
+
+      out.push_back('"');
+      for (const char *c = text; c < end; ++c)
+      {
+        if (*c == '"')
+          out.push_back('"');
+        out.push_back(*c);
+      }
+      out.push_back('"');
+    }
+
+    static void append_tsv_string(std::string &out, const char *text, size_t length)
+    {
+      const char *end = text + length;
+      const char *plain = text;
+
+      for (const char *c = text; c < end; ++c)
+      {
+        char escaped;
+
+        switch (*c)
+        {
+          case '\t': escaped = 't'; break;
+          case '\n': escaped = 'n'; break;
+          case '\r': escaped = 'r'; break;
+          case '\0': escaped = '0'; break;
+          case '\\': escaped = '\\'; break;
+          default: continue;
+        }
+
+        out.append(plain, c - plain);
+        out.push_back('\\');
+        out.push_back(escaped);
+        plain = c + 1;
+      }
+
+      out.append(plain, end - plain);
+    }
+
+    static void append_json_string(std::string &out, const char *text, size_t length)
+    {
+      static const char hex[] = "0123456789abcdef";
+      const char *end = text + length;
+      const char *plain = text;
+
+      out.push_back('"');
+      for (const char *c = text; c < end; ++c)
+      {
+        const unsigned char code = static_cast<unsigned char>(*c);
+
+        if (code >= 0x20 && code != '"' && code != '\\')
+          continue;
+
+        out.append(plain, c - plain);
+        out.push_back('\\');
+        switch (code)
+        {
+          case '"': out.push_back('"'); break;
+          case '\\': out.push_back('\\'); break;
+          case '\n': out.push_back('n'); break;
+          case '\r': out.push_back('r'); break;
+          case '\t': out.push_back('t'); break;
+          default:
+            out.append("u00");
+            out.push_back(hex[code >> 4]);
+            out.push_back(hex[code & 0x0F]);
+        }
+        plain = c + 1;
+      }
+
+      out.append(plain, end - plain);
+      out.push_back('"');
+    }
+
+    Export_format _format;
+    const std::vector< ::mysqlx::ColumnMetadata> &_columns;
+    std::vector<std::string> _keys;
+  };
+
+  /*
+  * Runs the chunk queries on a set of sessions, a thread per session
+  *
+  * Every chunk is written to its own file, or all of them to a single file
+  * in the order they were added. In the later case the calling thread does
+  * the writing: the chunk being written is streamed as it is read, and the
+  * ones after it are buffered in memory. Only a window of chunks is read
+  * ahead of the writer, so the memory used is bounded.
+  */
+  class Table_exporter
+  {
+  public:
+    Table_exporter(Export_format format, const std::string &file, bool chunk_files)
+      : _format(format), _file(file), _chunk_files(chunk_files), _window(0), _next_chunk(0), _written(0), _rows(0)
+    {
+    }
+
+    void add_chunk(const std::string &query)
+    {
+      _chunks.push_back(Chunk());
+      _chunks.back().query = query;
+    }
+
+    size_t chunk_count() const { return _chunks.size(); }
+
+    uint64_t run(const std::vector<boost::shared_ptr< ::mysqlx::Session> > &sessions)
+    {
+      std::ofstream out;
+      std::vector<std::thread> workers;
+
+      if (!_chunk_files)
+      {
+        out.open(_file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out)
+          throw std::runtime_error("Unable to open " + _file + " for writing");
+      }
+
+      _window = 2 * sessions.size();
+
+      for (size_t index = 0; index < sessions.size(); ++index)
+        workers.push_back(std::thread(&Table_exporter::export_chunks, this, sessions[index]));
+
+      if (!_chunk_files)
+        write_chunks(out);
+
+      for (size_t index = 0; index < workers.size(); ++index)
+        workers[index].join();
+
+      if (_error)
+        std::rethrow_exception(_error);
+
+      return _rows;
+    }
+
+  private:
+    struct Chunk
+    {
+      Chunk() : done(false) {}
+
+      std::string query;
+      std::deque<std::string> pieces;
+      bool done;
+    };
+
+    bool next_chunk(size_t &index)
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+
+      while (!_error && !_chunk_files && _next_chunk < _chunks.size() && _next_chunk >= _written + _window)
+        _cond.wait(lock);
+
+      if (_error || _next_chunk == _chunks.size())
+        return false;
+
+      index = _next_chunk++;
+      return true;
+    }
+
+    void add_piece(size_t index, std::string &piece, bool done)
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      Chunk &chunk = _chunks[index];
+
+      if (!piece.empty())
+      {
+        chunk.pieces.push_back(std::string());
+        chunk.pieces.back().swap(piece);
+      }
+
+      chunk.done = done;
+      _cond.notify_all();
+    }
+
+    void set_error(std::exception_ptr error)
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      if (!_error)
+        _error = error;
+
+      _cond.notify_all();
+    }
+
+    void export_chunks(boost::shared_ptr< ::mysqlx::Session> session)
+    {
+      uint64_t rows = 0;
+
+      try
+      {
+        size_t index;
+        std::string buffer;
+
+        while (next_chunk(index))
+        {
+          boost::shared_ptr< ::mysqlx::Result> result(session->executeSql(_chunks[index].query));
+          boost::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > columns(result->columnMetadata());
+          result->enable_read_ahead(READ_AHEAD_SIZE);
+          Row_encoder encoder(_format, *columns);
+          std::ofstream out;
+
+          if (_chunk_files)
+          {
+            std::string file(_file + ".");
+            append_uint(file, index);
+            out.open(file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!out)
+              throw std::runtime_error("Unable to open " + file + " for writing");
+          }
+
+          buffer.reserve(BUFFER_SIZE);
+
+          while (boost::shared_ptr< ::mysqlx::Row> row = result->next())
+          {
+            encoder.append_row(*row, buffer);
+            ++rows;
+
+            if (buffer.size() >= BUFFER_SIZE)
+            {
+              flush(index, buffer, out, false);
+              buffer.reserve(BUFFER_SIZE);
+            }
+          }
+
+          flush(index, buffer, out, true);
+        }
+      }
+      catch (...)
+      {
+        set_error(std::current_exception());
+      }
+
+      std::lock_guard<std::mutex> lock(_mutex);
+      _rows += rows;
+    }
+
+    void flush(size_t index, std::string &buffer, std::ofstream &out, bool done)
+    {
+      if (_chunk_files)
+      {
+        out.write(buffer.data(), buffer.size());
+        if (!out)
+          throw std::runtime_error("Error writing to " + _file);
+        buffer.clear();
+      }
+      else
+        add_piece(index, buffer, done);
+    }
+
+    void write_chunks(std::ofstream &out)
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+
+      while (!_error && _written < _chunks.size())
+      {
+        Chunk &chunk = _chunks[_written];
+
+        if (!chunk.pieces.empty())
+        {
+          std::string piece;
+          piece.swap(chunk.pieces.front());
+          chunk.pieces.pop_front();
+
+          lock.unlock();
+          out.write(piece.data(), piece.size());
+          lock.lock();
+
+          if (!out && !_error)
+            _error = std::make_exception_ptr(std::runtime_error("Error writing to " + _file));
+        }
+        else if (chunk.done)
+        {
+          ++_written;
+          _cond.notify_all();
+        }
+        else
+          _cond.wait(lock);
+      }
+
+      // Unblocks the workers waiting for the window to move
+      _cond.notify_all();
+    }
+
+    Export_format _format;
+    std::string _file;
+    bool _chunk_files;
+    size_t _window;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::vector<Chunk> _chunks;
+    size_t _next_chunk;
+    size_t _written;
+    uint64_t _rows;
+    std::exception_ptr _error;
+  };
+
+  // Splits schema.name, either name may be quoted with backticks
+  void split_object_name(const std::string &name, const std::string &type, std::string &schema, std::string &object)
+  {
+    std::vector<std::string> parts(1);
+    bool quoted = false;
+
+    for (size_t index = 0; index < name.size(); ++index)
+    {
+      if (name[index] == '`')
+      {
+        if (quoted && index + 1 < name.size() && name[index + 1] == '`')
+          parts.back().push_back(name[++index]);
+        else
+          quoted = !quoted;
+      }
+      else if (name[index] == '.' && !quoted)
+        parts.push_back(std::string());
+      else
+        parts.back().push_back(name[index]);
+    }
+
+    if (quoted || parts.size() != 2 || parts[0].empty() || parts[1].empty())
+      throw shcore::Exception::argument_error("Invalid " + type + " name '" + name + "', expected schema." + type);
+
+    schema = parts[0];
+    object = parts[1];
+  }
+
+  /*
+  * Session, schema and name of the Table or Collection at args[index]. It is
+  * either an object of an X session or a schema.name string, in which case
+  * the global session is used.
+  */
+  void get_target(const shcore::Argument_list &args, unsigned int index, const std::string &class_name,
+                  shcore::IShell_core &shell_core, boost::shared_ptr<mysh::mysqlx::BaseSession> &session,
+                  std::string &schema, std::string &name)
+  {
+    if (args[index].type == shcore::Object)
+    {
+      boost::shared_ptr<DatabaseObject> object = boost::dynamic_pointer_cast<DatabaseObject>(args.object_at(index));
+      if (!object || object->class_name() != class_name)
+      {
+        std::string error("Argument #");
+        append_uint(error, index + 1);
+        throw shcore::Exception::argument_error(error + " is expected to be either a string or a " + class_name + " object");
+      }
+
+      name = object->get_member("name").as_string();
+      schema = object->get_member("schema").as_object()->get_member("name").as_string();
+      session = boost::dynamic_pointer_cast<mysh::mysqlx::BaseSession>(object->get_member("session").as_object());
+    }
+    else
+    {
+      std::string type(class_name);
+      type[0] = static_cast<char>(tolower(type[0]));
+
+      split_object_name(args.string_at(index), type, schema, name);
+      session = boost::dynamic_pointer_cast<mysh::mysqlx::BaseSession>(shell_core.get_dev_session());
+    }
+  }
+
+  uint64_t get_key(const ::mysqlx::Row &row, int field, bool is_signed)
+  {
+    if (is_signed)
+      return static_cast<uint64_t>(row.sInt64Field(field)) ^ SIGN_BIT;
+
+    return row.uInt64Field(field);
+  }
+
+  std::string key_literal(uint64_t key, bool is_signed)
+  {
+    std::string literal;
+
+    if (is_signed)
+      return append_int(literal, static_cast<int64_t>(key ^ SIGN_BIT));
+
+    return append_uint(literal, key);
+  }
+
+  /*
+  * Splits the table in ranges of its primary key of about chunk_size rows,
+  * the size of the ranges comes from the row count estimate of the table
+  * and the span of the key values, with at most MAX_CHUNKS ranges. Tables
+  * without a single integer column as primary key are exported in a single
+  * chunk.
+  */
+  void plan_chunks(::mysqlx::Session &session, const std::string &schema, const std::string &table,
+                   uint64_t chunk_size, Table_exporter &exporter)
+  {
+    const std::string table_name = quote_identifier(schema, '`') + "." + quote_identifier(table, '`');
+    const std::string select = "SELECT * FROM " + table_name;
+
+    boost::shared_ptr< ::mysqlx::Result> result(session.executeSql(
+      sqlstring("SELECT TABLE_ROWS FROM information_schema.TABLES WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?", 0) << schema << table));
+    boost::shared_ptr< ::mysqlx::Row> row(result->next());
+
+    if (!row)
+      throw shcore::Exception::runtime_error("Table " + table_name + " does not exist");
+
+    const uint64_t estimated_rows = row->isNullField(0) ? 0 : row->uInt64Field(0);
+    result->flush();
+
+    std::vector<std::string> keys;
+    result = session.executeSql(sqlstring("SELECT COLUMN_NAME, DATA_TYPE FROM information_schema.COLUMNS "
+                                          "WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ? AND COLUMN_KEY = 'PRI'", 0) << schema << table);
+    while ((row = result->next()))
+    {
+      const std::string type = row->stringField(1);
+
+      if (type == "tinyint" || type == "smallint" || type == "mediumint" || type == "int" || type == "bigint")
+        keys.push_back(row->stringField(0));
+      else
+        keys.push_back("");
+    }
+
+    if (keys.size() != 1 || keys[0].empty())
+    {
+      exporter.add_chunk(select);
+      return;
+    }
+
+    const std::string key = quote_identifier(keys[0], '`');
+
+    result = session.executeSql("SELECT MIN(" + key + "), MAX(" + key + ") FROM " + table_name);
+    row = result->next();
+
+    // Empty table
+    if (row->isNullField(0))
+    {
+      result->flush();
+      exporter.add_chunk(select);
+      return;
+    }
+
+    const bool is_signed = (result->columnMetadata()->at(0).type == ::mysqlx::SINT);
+    const uint64_t first = get_key(*row, 0, is_signed);
+    const uint64_t last = get_key(*row, 1, is_signed);
+    result->flush();
+
+    uint64_t step = chunk_size;
+    if (estimated_rows)
+    {
+      const double keys_per_chunk = static_cast<double>(last - first) / estimated_rows * chunk_size;
+
+      if (keys_per_chunk < 1)
+        step = 1;
+      else if (keys_per_chunk >= 1.8e19)
+        step = std::numeric_limits<uint64_t>::max();
+      else
+        step = static_cast<uint64_t>(keys_per_chunk);
+    }
+
+    step = std::max(step, (last - first) / MAX_CHUNKS + 1);
+
+    for (uint64_t begin = first;; )
+    {
+      const uint64_t end = (last - begin < step) ? last : begin + step - 1;
+
+      exporter.add_chunk(select + " WHERE " + key + " BETWEEN " + key_literal(begin, is_signed) + " AND " +
+                         key_literal(end, is_signed) + " ORDER BY " + key);
+
+      if (end == last)
+        break;
+
+      begin = end + 1;
+    }
+  }
+
+  /*
+  * Starts a transaction with a consistent snapshot on the session. Snapshots
+  * taken while another session holds a read lock on the table see the same
+  * rows of it, as no write to the table can commit in between.
+  */
+  void start_snapshot(::mysqlx::Session &session)
+  {
+    session.executeSql("START TRANSACTION WITH CONSISTENT SNAPSHOT")->flush();
+  }
+
+  // Size of the reads from the input file
+  const size_t READ_SIZE = 8 * 1024 * 1024;
+
+  // Checks a document is an object with a string _id, if it has one
+  class Document_checker : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Document_checker>
+  {
+  public:
+    Document_checker() : _depth(0), _id_key(false), _has_id(false), _bad_id(false), _is_object(false) {}
+
+    bool Default() { return check_id(false); }
+    bool String(const char *, rapidjson::SizeType, bool) { return check_id(true); }
+
+    bool Key(const char *str, rapidjson::SizeType length, bool)
+    {
+      _id_key = (_depth == 1 && length == 3 && memcmp(str, "_id", 3) == 0);
+      return true;
+    }
+
+    bool StartObject()
+    {
+      if (_depth == 0)
+        _is_object = true;
+
+      ++_depth;
+      return check_id(false);
+    }
+
+    bool EndObject(rapidjson::SizeType)
+    {
+      --_depth;
+      return true;
+    }
+
+    bool StartArray()
+    {
+      ++_depth;
+      return check_id(false);
+    }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+      --_depth;
+      return true;
+    }
+
+    bool is_object() const { return _is_object; }
+    bool has_id() const { return _has_id; }
+    bool bad_id() const { return _bad_id; }
+
+  private:
+    bool check_id(bool is_string)
+    {
+      if (_id_key)
+      {
+        _id_key = false;
+        _bad_id = !is_string;
+        _has_id = is_string;
+      }
+
+      return !_bad_id;
+    }
+
+    int _depth;
+    bool _id_key;
+    bool _has_id;
+    bool _bad_id;
+    bool _is_object;
+  };
+
+  std::string new_document_id()
+  {
+    static const char hex[] = "0123456789abcdef";
+    uuid_type uuid;
+    std::string id;
+
+    generate_uuid(uuid);
+
+    for (size_t index = 0; index < sizeof(uuid); ++index)
+    {
+      id.push_back(hex[uuid[index] >> 4]);
+      id.push_back(hex[uuid[index] & 0x0F]);
+    }
+
+    return id;
+  }
+
+  // Collation of binary strings
+  const uint64_t BINARY_COLLATION = 63;
+
+  /*
+  * Type of the literals sent for the values of a column, as exported by
+  * util.exportTable: BIT values are written as numbers and binary strings
+  * as their raw bytes. Other values are converted from strings by the server.
+  */
+  Mysqlx::Datatypes::Scalar::Type literal_type(const ::mysqlx::ColumnMetadata &column)
+  {
+    if (column.type == ::mysqlx::BIT)
+      return Mysqlx::Datatypes::Scalar::V_UINT;
+
+    if (column.type == ::mysqlx::BYTES && column.collation == BINARY_COLLATION)
+      return Mysqlx::Datatypes::Scalar::V_OCTETS;
+
+    return Mysqlx::Datatypes::Scalar::V_STRING;
+  }
+
+  // Adds the field as a literal of the given type, false if its value is not valid for it
+  bool add_literal(Mysqlx::Crud::Insert_TypedRow *row, Mysqlx::Datatypes::Scalar::Type type, const Import_field &value)
+  {
+    Mysqlx::Expr::Expr *field = row->add_field();
+    Mysqlx::Datatypes::Scalar *literal = field->mutable_literal();
+
+    field->set_type(Mysqlx::Expr::Expr::LITERAL);
+
+    if (value.is_null)
+    {
+      literal->set_type(Mysqlx::Datatypes::Scalar::V_NULL);
+      return true;
+    }
+
+    literal->set_type(type);
+
+    switch (type)
+    {
+      case Mysqlx::Datatypes::Scalar::V_UINT:
+      {
+        uint64_t number = 0;
+
+        if (value.value.empty())
+          return false;
+
+        for (size_t index = 0; index < value.value.size(); ++index)
+        {
+          const unsigned digit = static_cast<unsigned char>(value.value[index]) - '0';
+
+          if (digit > 9 || number > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+            return false;
+
+          number = number * 10 + digit;
+        }
+
+        literal->set_v_unsigned_int(number);
+        break;
+      }
+      case Mysqlx::Datatypes::Scalar::V_OCTETS:
+        literal->mutable_v_octets()->set_value(value.value);
+        break;
+      default:
+        literal->mutable_v_string()->set_value(value.value);
+        break;
+    }
+
+    return true;
+  }
+
+  std::string record_error(uint64_t record, const std::string &error)
+  {
+    std::string message("Record #");
+    append_uint(message, record);
+    return message.append(": ").append(error);
+  }
+
+  // Records of the input given to a worker, numbered from 1
+  struct Batch
+  {
+    std::string data;
+    uint64_t first_record;
+  };
+
+  /*
+  * Loads the input file through a set of sessions, a thread per session
+  *
+  * The calling thread reads the file in large blocks and cuts it into
+  * batches of records, without parsing them. The workers parse the records
+  * of a batch into a Mysqlx::Crud::Insert message and send it through their
+  * own session. Only a few batches are queued, so the reading blocks while
+  * the workers are behind.
+  */
+  class Table_importer
+  {
+  public:
+    Table_importer(Import_format format, const std::string &schema, const std::string &name,
+                   const std::vector<std::string> &columns)
+      : _format(format), _schema(schema), _name(name), _columns(columns), _queue_size(0), _eof(false),
+        _running(0), _rows(0)
+    {
+    }
+
+    uint64_t run(const std::string &file, const std::vector<boost::shared_ptr< ::mysqlx::Session> > &sessions,
+                 uint64_t batch_size, uint64_t skip_rows, bool show_progress)
+    {
+      std::ifstream input(file.c_str(), std::ios::in | std::ios::binary);
+      if (!input)
+        throw std::runtime_error("Unable to open " + file);
+
+      std::vector<std::thread> workers;
+      Record_splitter splitter(_format);
+      std::string data;
+      std::vector<char> block(READ_SIZE);
+      size_t scanned = 0;
+      uint64_t record = 1;
+      uint64_t records = 0;
+
+      if (_format != Import_json)
+        load_column_types(*sessions[0]);
+
+      _queue_size = 2 * sessions.size();
+      _running = sessions.size();
+      _start = std::chrono::steady_clock::now();
+      _last_progress = _start;
+
+      for (size_t index = 0; index < sessions.size(); ++index)
+        workers.push_back(std::thread(&Table_importer::import_batches, this, sessions[index]));
+
+      while (!failed() && input.read(&block[0], block.size()).gcount() > 0)
+      {
+        data.append(&block[0], static_cast<size_t>(input.gcount()));
+
+        const char *begin = data.data();
+        const char *end = begin + data.size();
+        const char *position = begin + scanned;
+        size_t batch_start = 0;
+
+        while (const char *record_end = splitter.next(position, end))
+        {
+          position = record_end;
+
+          if (skip_rows)
+          {
+            --skip_rows;
+            ++record;
+            batch_start = position - begin;
+          }
+          else if (++records == batch_size)
+          {
+            push_batch(data.substr(batch_start, (position - begin) - batch_start), record, show_progress);
+            record += records;
+            records = 0;
+            batch_start = position - begin;
+          }
+        }
+
+        if (splitter.malformed())
+        {
+          set_error(std::make_exception_ptr(std::runtime_error(record_error(record + records, "Unexpected closing bracket"))));
+          break;
+        }
+
+        // The splitter keeps its state, the rest of the block is not scanned again
+        scanned = data.size() - batch_start;
+        data.erase(0, batch_start);
+      }
+
+      // Last batch, the last record may lack the line break
+      if (!failed() && data.find_first_not_of(" \t\r\n") != std::string::npos && !skip_rows)
+        push_batch(data, record, show_progress);
+
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _eof = true;
+        _cond.notify_all();
+
+        while (_running)
+        {
+          _cond.wait_for(lock, std::chrono::seconds(1));
+
+          lock.unlock();
+          report_progress(show_progress, false);
+          lock.lock();
+        }
+      }
+
+      for (size_t index = 0; index < workers.size(); ++index)
+        workers[index].join();
+
+      if (_error)
+        std::rethrow_exception(_error);
+
+      report_progress(show_progress, true);
+
+      return _rows;
+    }
+
+  private:
+    // Literal types of the columns loaded, from the metadata of the table
+    void load_column_types(::mysqlx::Session &session)
+    {
+      std::string columns;
+
+      for (size_t index = 0; index < _columns.size(); ++index)
+        columns.append(index ? ", " : "").append(quote_identifier(_columns[index], '`'));
+
+      boost::shared_ptr< ::mysqlx::Result> result(session.executeSql("SELECT " + (columns.empty() ? "*" : columns) + " FROM " +
+        quote_identifier(_schema, '`') + "." + quote_identifier(_name, '`') + " LIMIT 0"));
+      boost::shared_ptr<std::vector< ::mysqlx::ColumnMetadata> > metadata(result->columnMetadata());
+
+      _types.clear();
+      for (size_t index = 0; index < metadata->size(); ++index)
+        _types.push_back(literal_type(metadata->at(index)));
+
+      result->flush();
+    }
+
+    bool failed()
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _error ? true : false;
+    }
+
+    void set_error(std::exception_ptr error)
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      if (!_error)
+        _error = error;
+
+      _cond.notify_all();
+    }
+
+    void push_batch(std::string data, uint64_t first_record, bool show_progress)
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+
+      while (!_error && _batches.size() >= _queue_size)
+      {
+        _cond.wait_for(lock, std::chrono::seconds(1));
+
+        lock.unlock();
+        report_progress(show_progress, false);
+        lock.lock();
+      }
+
+      _batches.push_back(Batch());
+      _batches.back().data.swap(data);
+      _batches.back().first_record = first_record;
+      _cond.notify_all();
+    }
+
+    bool next_batch(Batch &batch)
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+
+      while (!_error && !_eof && _batches.empty())
+        _cond.wait(lock);
+
+      if (_error || _batches.empty())
+        return false;
+
+      batch.data.swap(_batches.front().data);
+      batch.first_record = _batches.front().first_record;
+      _batches.pop_front();
+      _cond.notify_all();
+
+      return true;
+    }
+
+    // Prints the progress once per second, and the totals at the end
+    void report_progress(bool show_progress, bool done)
+    {
+      if (!show_progress)
+        return;
+
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if (!done && now - _last_progress < std::chrono::seconds(1))
+        return;
+
+      uint64_t rows;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        rows = _rows;
+      }
+
+      const double seconds = std::chrono::duration<double>(now - _start).count();
+      std::string progress("\r");
+
+      append_uint(progress, rows);
+      progress.append(done ? " rows imported in " : " rows imported, ");
+      if (done)
+        append_double(progress, static_cast<int64_t>(seconds * 100) / 100.0).append(" sec (");
+      append_uint(progress, seconds > 0 ? static_cast<uint64_t>(rows / seconds) : rows);
+      progress.append(done ? " rows/s)\n" : " rows/s");
+
+      shcore::print(progress);
+      _last_progress = now;
+    }
+
+    void import_batches(boost::shared_ptr< ::mysqlx::Session> session)
+    {
+      try
+      {
+        Mysqlx::Crud::Insert insert;
+        Batch batch;
+
+        insert.mutable_collection()->set_schema(_schema);
+        insert.mutable_collection()->set_name(_name);
+        insert.set_data_model(_format == Import_json ? Mysqlx::Crud::DOCUMENT : Mysqlx::Crud::TABLE);
+
+        for (size_t index = 0; index < _columns.size(); ++index)
+          insert.add_projection()->set_name(_columns[index]);
+
+        while (next_batch(batch))
+        {
+          // Cleared rows are kept by protobuf and reused by the next batch
+          insert.clear_row();
+
+          if (_format == Import_json)
+            add_documents(batch, insert);
+          else
+            add_rows(batch, insert);
+
+          if (insert.row_size() == 0)
+            continue;
+
+          boost::shared_ptr< ::mysqlx::Result> result(session->connection()->execute_insert(insert));
+          result->wait();
+
+          std::lock_guard<std::mutex> lock(_mutex);
+          _rows += insert.row_size();
+        }
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_error)
+          _error = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(_mutex);
+      --_running;
+      _cond.notify_all();
+    }
+
+    void add_documents(const Batch &batch, Mysqlx::Crud::Insert &insert)
+    {
+      const char *begin = batch.data.data();
+      const char *end = begin + batch.data.size();
+      uint64_t record = batch.first_record;
+      std::string document;
+
+      for (const char *position = begin;; ++record)
+      {
+        while (position < end && isspace(static_cast<unsigned char>(*position)))
+          ++position;
+
+        if (position == end)
+          break;
+
+        rapidjson::Reader reader;
+        rapidjson::MemoryStream stream(position, end - position);
+        Document_checker checker;
+
+        rapidjson::ParseResult result = reader.Parse<rapidjson::kParseStopWhenDoneFlag>(stream, checker);
+
+        if (checker.bad_id())
+          throw std::runtime_error(record_error(record, "Invalid data type for _id field, should be a string"));
+
+        if (result.IsError())
+          throw std::runtime_error(record_error(record, std::string("Error parsing JSON: ") + rapidjson::GetParseError_En(result.Code())));
+
+        if (!checker.is_object())
+          throw std::runtime_error(record_error(record, "The document is expected to be a JSON object"));
+
+        const size_t length = stream.Tell();
+
+        // Documents without _id get a new one, as in Collection.add
+        if (checker.has_id())
+          document.assign(position, length);
+        else
+        {
+          document.assign("{\"_id\":\"").append(new_document_id()).append("\"");
+          const char *first = position + 1;
+
+          while (first < position + length && isspace(static_cast<unsigned char>(*first)))
+            ++first;
+
+          if (*first != '}')
+            document.push_back(',');
+
+          document.append(first, position + length - first);
+        }
+
+        Mysqlx::Expr::Expr *field = insert.add_row()->add_field();
+        field->set_type(Mysqlx::Expr::Expr::LITERAL);
+        field->mutable_literal()->set_type(Mysqlx::Datatypes::Scalar::V_OCTETS);
+        field->mutable_literal()->mutable_v_octets()->set_value(document);
+
+        position += length;
+      }
+    }
+
+    // Fields as written by util.exportTable, see read_record()
+    void add_rows(const Batch &batch, Mysqlx::Crud::Insert &insert)
+    {
+      const char *position = batch.data.data();
+      const char *end = position + batch.data.size();
+      uint64_t record = batch.first_record;
+      std::vector<Import_field> fields;
+      std::string error;
+
+      for (; position < end; ++record)
+      {
+        // Empty lines are skipped
+        if (*position == '\n' || (*position == '\r' && position + 1 < end && position[1] == '\n'))
+        {
+          position += (*position == '\r') ? 2 : 1;
+          continue;
+        }
+
+        size_t field_count;
+        position = read_record(_format, position, end, fields, field_count, error);
+
+        if (!position)
+          throw std::runtime_error(record_error(record, error));
+
+        Mysqlx::Crud::Insert_TypedRow *row = insert.add_row();
+
+        for (size_t index = 0; index < field_count; ++index)
+        {
+          const Mysqlx::Datatypes::Scalar::Type type = index < _types.size() ? _types[index] : Mysqlx::Datatypes::Scalar::V_STRING;
+
+          if (!add_literal(row, type, fields[index]))
+          {
+            std::string message("Invalid value for column #");
+            append_uint(message, index + 1);
+            throw std::runtime_error(record_error(record, message + ", expected an unsigned integer"));
+          }
+        }
+      }
+    }
+
+    Import_format _format;
+    std::string _schema;
+    std::string _name;
+    std::vector<std::string> _columns;
+    std::vector<Mysqlx::Datatypes::Scalar::Type> _types;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::deque<Batch> _batches;
+    size_t _queue_size;
+    bool _eof;
+    size_t _running;
+    uint64_t _rows;
+    std::exception_ptr _error;
+
+    std::chrono::steady_clock::time_point _start;
+    std::chrono::steady_clock::time_point _last_progress;
+  };
+
+  // Common part of importJson and importTable, the arguments are the file,
+  // the target and the options
+  uint64_t import_file(const shcore::Argument_list &args, const std::string &function,
+                       const std::string &class_name, shcore::IShell_core &shell_core)
+  {
+    const bool is_table = (class_name == "Table");
+    boost::shared_ptr<mysh::mysqlx::BaseSession> session;
+    std::string file;
+    std::string schema;
+    std::string name;
+    Import_format format = is_table ? Import_csv : Import_json;
+    std::vector<std::string> columns;
+    int64_t threads = 4;
+    int64_t batch_size = 1000;
+    int64_t skip_rows = 0;
+    bool show_progress = (*Shell_core_options::get())[SHCORE_INTERACTIVE].as_bool();
+
+    args.ensure_count(2, 3, function.c_str());
+
+    try
+    {
+      file = args.string_at(0);
+      get_target(args, 1, class_name, shell_core, session, schema, name);
+
+      if (args.size() == 3)
+      {
+        shcore::Value::Map_type_ref options = args.map_at(2);
+
+        for (shcore::Value::Map_type::const_iterator option = options->begin(); option != options->end(); ++option)
+        {
+          if (option->first == "threads")
+            threads = options->get_int("threads");
+          else if (option->first == "batchSize")
+            batch_size = options->get_int("batchSize");
+          else if (option->first == "showProgress")
+            show_progress = options->get_bool("showProgress");
+          else if (is_table && option->first == "format")
+          {
+            const std::string value = options->get_string("format");
+
+            if (value == "csv")
+              format = Import_csv;
+            else if (value == "tsv")
+              format = Import_tsv;
+            else
+              throw shcore::Exception::argument_error("Invalid format '" + value + "', allowed values are csv and tsv");
+          }
+          else if (is_table && option->first == "columns")
+          {
+            shcore::Value::Array_type_ref names = options->get_array("columns");
+
+            for (size_t index = 0; index < names->size(); ++index)
+              columns.push_back(names->at(index).as_string());
+          }
+          else if (is_table && option->first == "skipRows")
+            skip_rows = options->get_int("skipRows");
+          else
+            throw shcore::Exception::argument_error("Invalid option '" + option->first + "'");
+        }
+      }
+
+      if (threads < 1)
+        throw shcore::Exception::argument_error("The threads option must be a positive integer");
+
+      if (batch_size < 1)
+        throw shcore::Exception::argument_error("The batchSize option must be a positive integer");
+
+      if (skip_rows < 0)
+        throw shcore::Exception::argument_error("The skipRows option can not be negative");
+    }
+    CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION(function);
+
+    if (!session || !session->is_connected())
+      throw shcore::Exception::logic_error(function + ": an open X Protocol session is required");
+
+    uint64_t rows = 0;
+
+    try
+    {
+      std::vector<boost::shared_ptr< ::mysqlx::Session> > sessions;
+
+      while (sessions.size() < static_cast<size_t>(threads))
+        sessions.push_back(session->open_new_session());
+
+      Table_importer importer(format, schema, name, columns);
+      rows = importer.run(file, sessions, batch_size, skip_rows, show_progress);
+    }
+    CATCH_AND_TRANSLATE();
+
+    return rows;
+  }
+}
+
+Util::Util(shcore::IShell_core &owner) : _shell_core(owner)
+{
+  add_method("exportTable", boost::bind(&Util::export_table, this, _1), "table", shcore::String, "file", shcore::String, "options", shcore::Map, NULL);
+  add_method("importJson", boost::bind(&Util::import_json, this, _1), "file", shcore::String, "collection", shcore::String, "options", shcore::Map, NULL);
+  add_method("importTable", boost::bind(&Util::import_table, this, _1), "file", shcore::String, "table", shcore::String, "options", shcore::Map, NULL);
+}
+
+#ifdef DOXYGEN
+/**
+* Exports the rows of a table into a file.
+* \param table the Table object to export or a string in the form schema.table.
+* \param file the path of the file to be created.
+* \param options optional Map with the export options.
+* \return the number of rows exported.
+*
+* The table is split in ranges of its primary key, and the ranges are read in
+* parallel through their own X Protocol sessions, opened with the connection
+* data of the table session, or of the global session when the table is given
+* by name. Tables without a single integer column as primary key are read in
+* a single chunk.
+*
+* All the sessions read the table from the same consistent snapshot. The
+* snapshots are taken while one more session holds a read lock on the table,
+* so the LOCK TABLES privilege is needed, and writes to the table wait until
+* the sessions are opened.
+*
+* The options map accepts the following keys:
+*
+* - format: csv (default), tsv or ndjson.
+* - threads: number of sessions reading the table, 4 by default.
+* - chunkSize: approximate number of rows per chunk, 100000 by default. Tables
+*   are split in at most 10000 chunks.
+* - chunkFiles: if true every chunk is written to its own file, named file.0,
+*   file.1 and so on, instead of writing all the rows in order to file.
+*
+* In csv format, values with commas, quotes or line breaks are double quoted
+* and NULL is an empty field. The tsv format uses the escaping expected by
+* LOAD DATA INFILE with the default options, NULL is written as \\N. In ndjson
+* format every row is a JSON document with the column names as keys.
+*/
+Integer Util::exportTable(Table table, String file, Map options){}
+#endif
+shcore::Value Util::export_table(const shcore::Argument_list &args)
+{
+  boost::shared_ptr<mysqlx::BaseSession> session;
+  std::string schema;
+  std::string table;
+  std::string file;
+  Export_format format = Csv;
+  int64_t threads = 4;
+  int64_t chunk_size = 100000;
+  bool chunk_files = false;
+
+  args.ensure_count(2, 3, "Util.exportTable");
+
+  try
+  {
+    get_target(args, 0, "Table", _shell_core, session, schema, table);
+
+    file = args.string_at(1);
+
+    if (args.size() == 3)
+    {
+      shcore::Value::Map_type_ref options = args.map_at(2);
+
+      for (shcore::Value::Map_type::const_iterator option = options->begin(); option != options->end(); ++option)
+      {
+        if (option->first == "format")
+        {
+          const std::string value = options->get_string("format");
+
+          if (value == "csv")
+            format = Csv;
+          else if (value == "tsv")
+            format = Tsv;
+          else if (value == "ndjson")
+            format = Ndjson;
+          else
+            throw shcore::Exception::argument_error("Invalid format '" + value + "', allowed values are csv, tsv and ndjson");
+        }
+        else if (option->first == "threads")
+          threads = options->get_int("threads");
+        else if (option->first == "chunkSize")
+          chunk_size = options->get_int("chunkSize");
+        else if (option->first == "chunkFiles")
+          chunk_files = options->get_bool("chunkFiles");
+        else
+          throw shcore::Exception::argument_error("Invalid option '" + option->first + "'");
+      }
+    }
+
+    if (threads < 1)
+      throw shcore::Exception::argument_error("The threads option must be a positive integer");
+
+    if (chunk_size < 1)
+      throw shcore::Exception::argument_error("The chunkSize option must be a positive integer");
+  }
+  CATCH_AND_TRANSLATE_FUNCTION_EXCEPTION("Util.exportTable");
+
+  if (!session || !session->is_connected())
+    throw shcore::Exception::logic_error("Util.exportTable: an open X Protocol session is required");
+
+  uint64_t rows = 0;
+
+  try
+  {
+    // The first session plans the chunks and then reads them with the others.
+    // All of them read from snapshots taken under a read lock of the table,
+    // which is released before the rows are read.
+    boost::shared_ptr< ::mysqlx::Session> lock_session(session->open_new_session());
+    std::vector<boost::shared_ptr< ::mysqlx::Session> > sessions(1, session->open_new_session());
+    Table_exporter exporter(format, file, chunk_files);
+
+    lock_session->executeSql("LOCK TABLES " + quote_identifier(schema, '`') + "." + quote_identifier(table, '`') + " READ")->flush();
+    start_snapshot(*sessions[0]);
+
+    plan_chunks(*sessions[0], schema, table, chunk_size, exporter);
+
+    while (sessions.size() < std::min<size_t>(threads, exporter.chunk_count()))
+    {
+      sessions.push_back(session->open_new_session());
+      start_snapshot(*sessions.back());
+    }
+
+    lock_session->executeSql("UNLOCK TABLES")->flush();
+    lock_session->close();
+
+    rows = exporter.run(sessions);
+  }
+  CATCH_AND_TRANSLATE();
+
+  return shcore::Value(rows);
+}
+
+#ifdef DOXYGEN
+/**
+* Loads the documents of a JSON file into a collection.
+* \param file the path of the file with the documents.
+* \param collection the Collection object to load or a string in the form schema.collection.
+* \param options optional Map with the import options.
+* \return the number of documents added.
+*
+* The file holds JSON documents one after the other, usually one per line as
+* written by util.exportTable in ndjson format. Documents without an _id get
+* a new one, as in Collection.add().
+*
+* The file is read in large blocks and cut into batches of documents, which
+* are parsed and sent as a single insert each. The batches are loaded in
+* parallel through their own X Protocol sessions, opened with the connection
+* data of the collection session, or of the global session when the collection
+* is given by name. Rows loaded before an error are kept.
+*
+* The options map accepts the following keys:
+*
+* - threads: number of sessions loading the data, 4 by default.
+* - batchSize: number of documents per insert, 1000 by default.
+* - showProgress: prints the rows per second while loading, true by default in
+*   interactive mode.
+*/
+Integer Util::importJson(String file, Collection collection, Map options){}
+#endif
+shcore::Value Util::import_json(const shcore::Argument_list &args)
+{
+  return shcore::Value(import_file(args, "Util.importJson", "Collection", _shell_core));
+}
+
+#ifdef DOXYGEN
+/**
+* Loads the rows of a CSV or TSV file into a table.
+* \param file the path of the file with the rows.
+* \param table the Table object to load or a string in the form schema.table.
+* \param options optional Map with the import options.
+* \return the number of rows inserted.
+*
+* The file is expected in the format written by util.exportTable. Rows are
+* loaded in parallel batches as described for importJson().
+*
+* Besides threads, batchSize and showProgress, the options map accepts:
+*
+* - format: csv (default) or tsv.
+* - columns: list with the names of the columns in the file, by default all
+*   the columns of the table in their order.
+* - skipRows: number of rows skipped at the beginning of the file, i.e. for
+*   a header line.
+*/
+Integer Util::importTable(String file, Table table, Map options){}
+#endif
+shcore::Value Util::import_table(const shcore::Argument_list &args)
+{
+  return shcore::Value(import_file(args, "Util.importTable", "Table", _shell_core));
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Data transfer utilities
+// Exposed as "util" in the shell
+
+#ifndef _MOD_UTILS_H_
+#define _MOD_UTILS_H_
+
+#include "mod_common.h"
+#include "shellcore/types.h"
+#include "shellcore/types_cpp.h"
+#include "shellcore/ishell_core.h"
+
+namespace mysh
+{
+  /**
+  * Global object with utilities to move data in and out of the server.
+  *
+  * The operations open their own X Protocol sessions to the server of the
+  * session they are given, so the work is spread across several connections.
+  */
+  class SHCORE_PUBLIC Util : public shcore::Cpp_object_bridge
+  {
+  public:
+    Util(shcore::IShell_core &owner);
+
+    virtual std::string class_name() const { return "Util"; }
+    virtual bool operator == (const Object_bridge &other) const { return this == &other; }
+
+    shcore::Value export_table(const shcore::Argument_list &args);
+    shcore::Value import_json(const shcore::Argument_list &args);
+    shcore::Value import_table(const shcore::Argument_list &args);
+
+#ifdef DOXYGEN
+    Integer exportTable(Table table, String file, Map options);
+    Integer exportTable(String table, String file, Map options);
+    Integer importJson(String file, Collection collection, Map options);
+    Integer importJson(String file, String collection, Map options);
+    Integer importTable(String file, Table table, Map options);
+    Integer importTable(String file, String table, Map options);
+#endif
+
+  private:
+    shcore::IShell_core &_shell_core;
+  };
+};
+
+#endif
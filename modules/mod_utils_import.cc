@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "mod_utils_import.h"
+
+using namespace mysh;
+
+namespace
+{
+  // End of the value starting at position, a \r before the line break is
+  // not part of the value
+  const char *field_end(const char *position, const char *end, char separator)
+  {
+    const char *value_end = position;
+
+    while (value_end < end && *value_end != separator && *value_end != '\n')
+      ++value_end;
+
+    if (value_end > position && value_end[-1] == '\r' && (value_end == end || *value_end == '\n'))
+      --value_end;
+
+    return value_end;
+  }
+
+  // Reads a csv field, false if a quoted value is not closed
+  bool read_csv_field(const char *&position, const char *end, Import_field &field)
+  {
+    field.value.clear();
+    field.is_null = false;
+
+    if (position < end && *position == '"')
+    {
+      for (++position;; ++position)
+      {
+        if (position == end)
+          return false;
+
+        if (*position == '"')
+        {
+          if (position + 1 < end && position[1] == '"')
+            ++position;
+          else
+            break;
+        }
+
+        field.value.push_back(*position);
+      }
+      ++position;
+    }
+    else
+    {
+      const char *value_end = field_end(position, end, ',');
+
+      field.value.assign(position, value_end);
+      field.is_null = field.value.empty();
+      position = value_end;
+    }
+
+    return true;
+  }
+
+  // Reads a tsv field, escaped tabs and line breaks are part of the value
+  void read_tsv_field(const char *&position, const char *end, Import_field &field)
+  {
+    const char *start = position;
+    bool carriage_return = false;
+
+    field.value.clear();
+
+    for (; position < end && *position != '\t' && *position != '\n'; ++position)
+    {
+      carriage_return = false;
+
+      if (*position == '\\' && position + 1 < end)
+      {
+        switch (*++position)
+        {
+          case 't': field.value.push_back('\t'); break;
+          case 'n': field.value.push_back('\n'); break;
+          case 'r': field.value.push_back('\r'); break;
+          case '0': field.value.push_back('\0'); break;
+          case 'b': field.value.push_back('\b'); break;
+          case 'Z': field.value.push_back('\032'); break;
+          default: field.value.push_back(*position);
+        }
+      }
+      else
+      {
+        carriage_return = (*position == '\r');
+        field.value.push_back(*position);
+      }
+    }
+
+    // A \r before the line break is not part of the value
+    if (carriage_return && (position == end || *position == '\n'))
+    {
+      field.value.resize(field.value.size() - 1);
+      --position;
+    }
+
+    field.is_null = (position - start == 2 && start[0] == '\\' && start[1] == 'N');
+  }
+}
+
+Record_splitter::Record_splitter(Import_format format)
+  : _format(format), _quoted(false), _escaped(false), _depth(0), _malformed(false)
+{
+}
+
+const char *Record_splitter::next(const char *begin, const char *end)
+{
+  if (_malformed)
+    return NULL;
+
+  switch (_format)
+  {
+    case Import_tsv:
+      for (const char *c = begin; c < end; ++c)
+      {
+        if (_escaped)
+          _escaped = false;
+        else if (*c == '\\')
+          _escaped = true;
+        else if (*c == '\n')
+          return c + 1;
+      }
+      return NULL;
+    case Import_csv:
+      for (const char *c = begin; c < end; ++c)
+      {
+        if (*c == '"')
+          _quoted = !_quoted;
+        else if (*c == '\n' && !_quoted)
+          return c + 1;
+      }
+      return NULL;
+    case Import_json:
+      for (const char *c = begin; c < end; ++c)
+      {
+        if (_quoted)
+        {
+          if (_escaped)
+            _escaped = false;
+          else if (*c == '\\')
+            _escaped = true;
+          else if (*c == '"')
+            _quoted = false;
+        }
+        else if (*c == '"')
+          _quoted = true;
+        else if (*c == '{' || *c == '[')
+          ++_depth;
+        else if (*c == '}' || *c == ']')
+        {
+          if (_depth == 0)
+          {
+            _malformed = true;
+            return NULL;
+          }
+
+          if (--_depth == 0)
+            return c + 1;
+        }
+      }
+      return NULL;
+  }
+
+  return NULL;
+}
+
+const char *mysh::read_record(Import_format format, const char *position, const char *end,
+                              std::vector<Import_field> &fields, size_t &field_count, std::string &error)
+{
+  const char separator = (format == Import_csv) ? ',' : '\t';
+
+  field_count = 0;
+
+  for (;;)
+  {
+    if (field_count == fields.size())
+      fields.push_back(Import_field());
+
+    Import_field &field = fields[field_count++];
+
+    if (format == Import_csv)
+    {
+      if (!read_csv_field(position, end, field))
+      {
+        error = "Missing closing quote";
+        return NULL;
+      }
+    }
+    else
+      read_tsv_field(position, end, field);
+
+    // Line breaks may come as \r\n
+    if (position < end && *position == '\r' && (position + 1 == end || position[1] == '\n'))
+      ++position;
+
+    if (position < end && *position == separator)
+      ++position;
+    else
+      break;
+  }
+
+  if (position < end && *position != '\n')
+  {
+    error = "Unexpected character after a quoted value";
+    return NULL;
+  }
+
+  // The last record may lack the line break
+  return position < end ? position + 1 : end;
+}
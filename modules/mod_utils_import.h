@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+// Parsing of the files loaded by util.importJson and util.importTable
+
+#ifndef _MOD_UTILS_IMPORT_H_
+#define _MOD_UTILS_IMPORT_H_
+
+#include "shellcore/common.h"
+
+#include <string>
+#include <vector>
+
+namespace mysh
+{
+  enum Import_format
+  {
+    Import_json,
+    Import_csv,
+    Import_tsv
+  };
+
+  /*
+  * Finds where the records of the input end, without parsing them. The
+  * state is kept between calls so records can span several reads.
+  *
+  * - json: documents, one after the other, usually one per line
+  * - csv: lines, except the line breaks within double quotes
+  * - tsv: lines, except the line breaks escaped with a backslash
+  *
+  * A json closing bracket with no document open makes the input malformed,
+  * nothing more is split then.
+  */
+  class SHCORE_PUBLIC Record_splitter
+  {
+  public:
+    Record_splitter(Import_format format);
+
+    // Position after the end of the first record in [begin, end), NULL if
+    // the record continues after end
+    const char *next(const char *begin, const char *end);
+
+    bool malformed() const { return _malformed; }
+
+  private:
+    Import_format _format;
+    bool _quoted;
+    bool _escaped;
+    int _depth;
+    bool _malformed;
+  };
+
+  struct Import_field
+  {
+    std::string value;
+    bool is_null;
+  };
+
+  /*
+  * Reads the fields of the csv or tsv record at position, as written by
+  * util.exportTable: in csv an unquoted empty field is NULL and in tsv \N is
+  * NULL. In tsv a backslash escapes the next character, tabs and line breaks
+  * included, as in LOAD DATA INFILE. Line breaks may come as \r\n. Returns the position after the
+  * record, or NULL with error set when the record is malformed. The strings
+  * of fields are reused.
+  */
+  SHCORE_PUBLIC const char *read_record(Import_format format, const char *position, const char *end,
+                                        std::vector<Import_field> &fields, size_t &field_count, std::string &error);
+};
+
+#endif
@@ -32,12 +32,18 @@ using namespace mysh::mysql;
 #include "shellcore/object_factory.h"
 #include "shellcore/common.h"
 #include <stdlib.h>
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <chrono>
+#include <errmsg.h>
 
 #define MAX_COLUMN_LENGTH 1024
 #define MIN_COLUMN_LENGTH 4
 
-Result::Result(boost::shared_ptr<Connection> owner, my_ulonglong affected_rows_, unsigned int warning_count_, const char *info_)
-  : _connection(owner), _affected_rows(affected_rows_), _last_insert_id(0), _warning_count(warning_count_), _fetched_row_count(0), _execution_time(0), _has_resultset(false)
+Result::Result(boost::shared_ptr<Connection> owner, my_ulonglong affected_rows_, unsigned int warning_count_, const char *info_, const ::mysqlx::Result_timing &timing_)
+  : _connection(owner), _affected_rows(affected_rows_), _last_insert_id(0), _warning_count(warning_count_), _fetched_row_count(0), _execution_time(0), _has_resultset(false),
+  _timing(timing_), _end_of_rows(false)
 {
   if (info_)
     _info.assign(info_);
@@ -92,6 +98,10 @@ Row * Result::fetch_one()
     if (res)
     {
       MYSQL_ROW mysql_row = mysql_fetch_row(res.get());
+
+      if (!_fetched_row_count && !_end_of_rows)
+        _timing.mark(::mysqlx::Result_timing::Phase_first_row);
+
       if (mysql_row)
       {
         unsigned long *lengths;
@@ -101,6 +111,16 @@ Row * Result::fetch_one()
 
         // Each read row increases the count
         _fetched_row_count++;
+
+        Connection_metrics &metrics = _connection->metrics();
+        ++metrics.rows_fetched;
+        for (size_t index = 0; index < _metadata.size(); index++)
+          metrics.row_bytes_fetched += lengths[index];
+      }
+      else if (!_end_of_rows)
+      {
+        _timing.mark(::mysqlx::Result_timing::Phase_streaming);
+        _end_of_rows = true;
       }
     }
   }
@@ -126,6 +146,7 @@ void Result::reset(boost::shared_ptr<MYSQL_RES> res, unsigned long duration)
 
   _result = res;
   _execution_time = duration;
+  _end_of_rows = false;
 }
 
 Field::Field(const std::string& catalog_, const std::string& db_, const std::string& table_, const std::string& otable, const std::string& name_, const std::string& oname, int length_, int type_, int flags_, int decimals_, int charset_) :
@@ -220,8 +241,8 @@ std::string Row::get_value_as_string(int index)
 
 //----------------------------------------------
 
-Connection::Connection(const std::string &uri_, const char *password)
-  : _mysql(NULL)
+Connection::Connection(const std::string &uri_, const char *password, const bool compression)
+  : _mysql(NULL), _multi_statements(false), _compression(compression)
 {
   std::string protocol;
   std::string user;
@@ -246,6 +267,11 @@ Connection::Connection(const std::string &uri_, const char *password)
   _uri = shcore::strip_password(uri_);
 
   setup_ssl(ssl_ca, ssl_cert, ssl_key);
+  setup_local_infile();
+
+  if (compression)
+    mysql_options(_mysql, MYSQL_OPT_COMPRESS, NULL);
+
   unsigned int tcp = MYSQL_PROTOCOL_TCP;
   mysql_options(_mysql, MYSQL_OPT_PROTOCOL, &tcp);
   if (!mysql_real_connect(_mysql, host.c_str(), user.c_str(), pass.c_str(), db.empty() ? NULL : db.c_str(), port, sock.empty() ? NULL : sock.c_str(), flags))
@@ -255,8 +281,8 @@ Connection::Connection(const std::string &uri_, const char *password)
 }
 
 Connection::Connection(const std::string &host, int port, const std::string &socket, const std::string &user, const std::string &password, const std::string &schema,
-  const std::string &ssl_ca, const std::string &ssl_cert, const std::string &ssl_key)
-: _mysql(NULL)
+  const std::string &ssl_ca, const std::string &ssl_cert, const std::string &ssl_key, const bool compression)
+: _mysql(NULL), _multi_statements(false), _compression(compression)
 {
   long flags = CLIENT_MULTI_RESULTS;
 
@@ -277,6 +303,12 @@ Connection::Connection(const std::string &host, int port, const std::string &soc
     mysql_options(_mysql, MYSQL_OPT_SSL_MODE, &ssl_mode);
   }
 
+  setup_local_infile();
+
+  // Used only if the server supports it, is_compressed() tells
+  if (compression)
+    mysql_options(_mysql, MYSQL_OPT_COMPRESS, NULL);
+
   unsigned int tcp = MYSQL_PROTOCOL_TCP;
   mysql_options(_mysql, MYSQL_OPT_PROTOCOL, &tcp);
   if (!mysql_real_connect(_mysql, host.c_str(), user.c_str(), password.c_str(), schema.empty() ? NULL : schema.c_str(), port, socket.empty() ? NULL : socket.c_str(), flags))
@@ -299,6 +331,73 @@ bool Connection::setup_ssl(const std::string &ssl_ca, const std::string &ssl_cer
   return true;
 }
 
+void Connection::setup_local_infile()
+{
+  unsigned int local_infile = 1;
+  mysql_options(_mysql, MYSQL_OPT_LOCAL_INFILE, &local_infile);
+
+  mysql_set_local_infile_handler(_mysql, &Connection::local_infile_init, &Connection::local_infile_read,
+                                 &Connection::local_infile_end, &Connection::local_infile_error, this);
+}
+
+namespace
+{
+  // Lives from the request of the server until the end of the transfer
+  struct Local_infile_state
+  {
+    boost::shared_ptr<Local_infile_source> source;
+    std::string error;
+  };
+}
+
+int Connection::local_infile_init(void **data, const char *file_name, void *user_data)
+{
+  Connection *connection = static_cast<Connection *>(user_data);
+  Local_infile_state *state = new Local_infile_state();
+
+  *data = state;
+  state->source = connection->_local_infile_source;
+
+  // The server picks the file name, so nothing is sent unless the client set a source
+  if (!state->source)
+  {
+    state->error = "LOAD DATA LOCAL INFILE requires a data source, use ClassicSession.loadLocalInfile()";
+    return 1;
+  }
+
+  return state->source->open(file_name ? file_name : "", state->error) ? 0 : 1;
+}
+
+int Connection::local_infile_read(void *data, char *buffer, unsigned int length)
+{
+  Local_infile_state *state = static_cast<Local_infile_state *>(data);
+
+  return state->source->read(buffer, length, state->error);
+}
+
+void Connection::local_infile_end(void *data)
+{
+  Local_infile_state *state = static_cast<Local_infile_state *>(data);
+
+  if (state && state->source)
+    state->source->close();
+
+  delete state;
+}
+
+int Connection::local_infile_error(void *data, char *message, unsigned int length)
+{
+  Local_infile_state *state = static_cast<Local_infile_state *>(data);
+
+  if (state && length)
+  {
+    strncpy(message, state->error.c_str(), length - 1);
+    message[length - 1] = '\0';
+  }
+
+  return CR_UNKNOWN_ERROR;
+}
+
 void Connection::close()
 {
   // This should be logged, for now commenting to
@@ -311,7 +410,8 @@ void Connection::close()
 
 Result *Connection::run_sql(const std::string &query)
 {
-  if (_prev_result)
+  // Results left by multi statement queries are discarded as well
+  if (_prev_result || mysql_more_results(_mysql))
   {
     _prev_result.reset();
 
@@ -324,18 +424,72 @@ Result *Connection::run_sql(const std::string &query)
 
   _timer.start();
 
-  if (mysql_real_query(_mysql, query.c_str(), query.length()) != 0)
+  ::mysqlx::Result_timing timing;
+  timing.start();
+
+  // Same as mysql_real_query, split to time the send apart from the wait
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  int error = mysql_send_query(_mysql, query.c_str(), query.length());
+  timing.mark(::mysqlx::Result_timing::Phase_send);
+
+  if (error == 0)
+  {
+    error = mysql_read_query_result(_mysql);
+    timing.mark(::mysqlx::Result_timing::Phase_first_metadata);
+  }
+
+  ++_metrics.queries_sent;
+  _metrics.query_bytes_sent += query.length();
+  _metrics.query_latency.add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+  if (error != 0)
   {
     throw shcore::Exception::mysql_error_with_code_and_state(mysql_error(_mysql), mysql_errno(_mysql), mysql_sqlstate(_mysql));
   }
 
-  Result* result = new Result(shared_from_this(), mysql_affected_rows(_mysql), mysql_warning_count(_mysql), mysql_info(_mysql));
+  Result* result = new Result(shared_from_this(), mysql_affected_rows(_mysql), mysql_warning_count(_mysql), mysql_info(_mysql), timing);
+
+  next_data_set(result, true);
+
+  return result;
+}
+
+Result *Connection::next_result()
+{
+  _prev_result.reset();
+
+  _timer.start();
+
+  ::mysqlx::Result_timing timing;
+  timing.start();
+
+  int status = mysql_next_result(_mysql);
+  timing.mark(::mysqlx::Result_timing::Phase_first_metadata);
+
+  if (status < 0)
+    return NULL;
+
+  if (status > 0)
+    throw shcore::Exception::mysql_error_with_code_and_state(mysql_error(_mysql), mysql_errno(_mysql), mysql_sqlstate(_mysql));
+
+  Result* result = new Result(shared_from_this(), mysql_affected_rows(_mysql), mysql_warning_count(_mysql), mysql_info(_mysql), timing);
 
   next_data_set(result, true);
 
   return result;
 }
 
+void Connection::set_multi_statements(bool enabled)
+{
+  if (enabled == _multi_statements)
+    return;
+
+  if (mysql_set_server_option(_mysql, enabled ? MYSQL_OPTION_MULTI_STATEMENTS_ON : MYSQL_OPTION_MULTI_STATEMENTS_OFF))
+    throw shcore::Exception::mysql_error_with_code_and_state(mysql_error(_mysql), mysql_errno(_mysql), mysql_sqlstate(_mysql));
+
+  _multi_statements = enabled;
+}
+
 template <class T>
 static void free_result(T* result)
 {
@@ -387,4 +541,107 @@ bool Connection::next_data_set(Result *target, bool first_result)
 Connection::~Connection()
 {
   close();
-}
\ No newline at end of file
+}
+//----------------------------------------------
+
+bool Local_infile_file::open(const std::string &UNUSED(file_name), std::string &error)
+{
+  _file = fopen(_path.c_str(), "rb");
+
+  if (!_file)
+  {
+    error = "Unable to open " + _path + ": " + strerror(errno);
+    return false;
+  }
+
+  return true;
+}
+
+int Local_infile_file::read(char *buffer, unsigned int length, std::string &error)
+{
+  size_t count = fread(buffer, 1, length, _file);
+
+  if (count < length && ferror(_file))
+  {
+    error = "Error reading " + _path + ": " + strerror(errno);
+    return -1;
+  }
+
+  return static_cast<int>(count);
+}
+
+void Local_infile_file::close()
+{
+  if (_file)
+    fclose(_file);
+
+  _file = NULL;
+}
+
+bool Local_infile_buffer::open(const std::string &UNUSED(file_name), std::string &UNUSED(error))
+{
+  _offset = 0;
+
+  return true;
+}
+
+int Local_infile_buffer::read(char *buffer, unsigned int length, std::string &UNUSED(error))
+{
+  size_t count = std::min<size_t>(length, _data.size() - _offset);
+
+  memcpy(buffer, _data.data() + _offset, count);
+  _offset += count;
+
+  return static_cast<int>(count);
+}
+
+bool Local_infile_function::open(const std::string &UNUSED(file_name), std::string &UNUSED(error))
+{
+  _chunk.clear();
+  _offset = 0;
+  _done = false;
+
+  return true;
+}
+
+int Local_infile_function::read(char *buffer, unsigned int length, std::string &error)
+{
+  // Empty chunks are skipped, returning 0 would end the transfer
+  while (!_done && _offset == _chunk.size())
+  {
+    shcore::Value chunk;
+
+    try
+    {
+      chunk = _function->invoke(shcore::Argument_list());
+    }
+    catch (std::exception &e)
+    {
+      error = std::string("Error reading from the data function: ") + e.what();
+      return -1;
+    }
+
+    if (chunk.type == shcore::Null || chunk.type == shcore::Undefined)
+      _done = true;
+    else if (chunk.type == shcore::String)
+    {
+      _chunk = chunk.as_string();
+      _offset = 0;
+    }
+    else
+    {
+      error = "The data function must return strings, got " + shcore::type_name(chunk.type);
+      return -1;
+    }
+  }
+
+  if (_done)
+    return 0;
+
+  size_t count = std::min<size_t>(length, _chunk.size() - _offset);
+
+  memcpy(buffer, _chunk.data() + _offset, count);
+  _offset += count;
+
+  return static_cast<int>(count);
+}
@@ -26,7 +26,9 @@
 #include "shellcore/types.h"
 #include "shellcore/types_cpp.h"
 #include "utils/utils_time.h"
+#include "mysqlxtest/mysqlx_metrics.h"
 #include <boost/enable_shared_from_this.hpp>
+#include <cstdio>
 
 #if WIN32
 #  include <winsock2.h>
@@ -105,7 +107,7 @@ namespace mysh
     class SHCORE_PUBLIC Result
     {
     public:
-      Result(boost::shared_ptr<Connection> owner, my_ulonglong affected_rows, unsigned int warning_count, const char *info);
+      Result(boost::shared_ptr<Connection> owner, my_ulonglong affected_rows, unsigned int warning_count, const char *info, const ::mysqlx::Result_timing &timing);
       virtual ~Result();
 
       void reset(boost::shared_ptr<MYSQL_RES> res, unsigned long duration);
@@ -125,6 +127,7 @@ namespace mysh
       uint64_t fetched_row_count() { return _fetched_row_count; }
       int warning_count(){ return _warning_count; }
       unsigned long execution_time(){ return _execution_time; }
+      const ::mysqlx::Result_timing &timing() { return _timing; }
       uint64_t last_insert_id() { return _last_insert_id; }
       std::string info() { return _info; }
 
@@ -144,19 +147,118 @@ namespace mysh
       std::string _info;
       unsigned long _execution_time;
       bool _has_resultset;
+
+      // The send and first metadata phases are marked by run_sql
+      ::mysqlx::Result_timing _timing;
+      bool _end_of_rows;
+    };
+
+    // Client side counters of a classic session, packets are handled by
+    // libmysqlclient so only the queries and fetched rows are accounted
+    struct Connection_metrics
+    {
+      Connection_metrics() { reset(); }
+
+      void reset()
+      {
+        queries_sent = 0;
+        query_bytes_sent = 0;
+        rows_fetched = 0;
+        row_bytes_fetched = 0;
+        query_latency.reset();
+      }
+
+      uint64_t queries_sent;
+      uint64_t query_bytes_sent;
+      uint64_t rows_fetched;
+      uint64_t row_bytes_fetched;
+
+      // Time from the query being sent until the first result is available
+      ::mysqlx::Latency_histogram query_latency;
+    };
+
+    // Data sent for a LOAD DATA LOCAL INFILE statement. It is read in chunks
+    // as the server consumes it, so nothing is staged on a temporary file.
+    class SHCORE_PUBLIC Local_infile_source
+    {
+    public:
+      virtual ~Local_infile_source() {}
+
+      // Called when the server requests the file named on the statement
+      virtual bool open(const std::string &file_name, std::string &error) = 0;
+
+      // Copies up to length bytes, returns 0 at the end of the data and -1 on error
+      virtual int read(char *buffer, unsigned int length, std::string &error) = 0;
+
+      virtual void close() {}
+    };
+
+    // Streams a file chosen by the client, the name requested by the server is ignored
+    class SHCORE_PUBLIC Local_infile_file : public Local_infile_source
+    {
+    public:
+      Local_infile_file(const std::string &path) : _path(path), _file(NULL) {}
+      virtual ~Local_infile_file() { close(); }
+
+      virtual bool open(const std::string &file_name, std::string &error);
+      virtual int read(char *buffer, unsigned int length, std::string &error);
+      virtual void close();
+
+    private:
+      std::string _path;
+      FILE *_file;
+    };
+
+    // Sends an in memory buffer
+    class SHCORE_PUBLIC Local_infile_buffer : public Local_infile_source
+    {
+    public:
+      Local_infile_buffer(const std::string &data) : _data(data), _offset(0) {}
+
+      virtual bool open(const std::string &file_name, std::string &error);
+      virtual int read(char *buffer, unsigned int length, std::string &error);
+
+    private:
+      std::string _data;
+      size_t _offset;
+    };
+
+    // Sends the chunks returned by a shell function, called until it returns
+    // null, undefined or None. A JavaScript or Python generator is wrapped
+    // on a function returning its next value.
+    class SHCORE_PUBLIC Local_infile_function : public Local_infile_source
+    {
+    public:
+      Local_infile_function(shcore::Function_base_ref function) : _function(function), _offset(0), _done(false) {}
+
+      virtual bool open(const std::string &file_name, std::string &error);
+      virtual int read(char *buffer, unsigned int length, std::string &error);
+
+    private:
+      shcore::Function_base_ref _function;
+      std::string _chunk;
+      size_t _offset;
+      bool _done;
     };
 
     class SHCORE_PUBLIC Connection : public boost::enable_shared_from_this<Connection>
     {
     public:
-      Connection(const std::string &uri, const char *password = NULL);
-      Connection(const std::string &host, int port, const std::string &socket, const std::string &user, const std::string &password, const std::string &schema, const std::string &ssl_ca = "", const std::string &ssl_cert = "", const std::string &ssl_key = "");
-      Connection(const Connection& conn) : Connection(conn._uri, NULL) { }
+      Connection(const std::string &uri, const char *password = NULL, const bool compression = false);
+      Connection(const std::string &host, int port, const std::string &socket, const std::string &user, const std::string &password, const std::string &schema, const std::string &ssl_ca = "", const std::string &ssl_cert = "", const std::string &ssl_key = "", const bool compression = false);
+      Connection(const Connection& conn) : Connection(conn._uri, NULL, conn._compression) { }
       ~Connection();
 
       void close();
       Result *run_sql(const std::string &sql);
       bool next_data_set(Result *target, bool first_result = false);
+
+      // Result of the next statement on a multi statement query, NULL when
+      // there are no more. The previous result must have been consumed.
+      Result *next_result();
+
+      // Toggles CLIENT_MULTI_STATEMENTS, used while running statement batches
+      void set_multi_statements(bool enabled);
       std::string uri() { return _uri; }
 
       // Utility functions to retriev session status
@@ -166,14 +268,33 @@ namespace mysh
       const char* get_server_info() { _prev_result.reset(); return mysql_get_server_info(_mysql); }
       const char* get_stats() { _prev_result.reset(); return mysql_stat(_mysql); }
       const char* get_ssl_cipher() { _prev_result.reset(); return mysql_get_ssl_cipher(_mysql); }
+      // Whether the client and the server agreed on using the compressed protocol
+      bool is_compressed() { return _mysql->net.compress != 0; }
+
+      Connection_metrics &metrics() { return _metrics; }
+
+      // Source of the data for LOAD DATA LOCAL INFILE, the requests of the
+      // server are refused while no source is set
+      void set_local_infile_source(boost::shared_ptr<Local_infile_source> source) { _local_infile_source = source; }
 
     private:
       bool setup_ssl(const std::string &ssl_ca, const std::string &ssl_cert, const std::string &ssl_key);
+      void setup_local_infile();
+
+      static int local_infile_init(void **data, const char *file_name, void *user_data);
+      static int local_infile_read(void *data, char *buffer, unsigned int length);
+      static void local_infile_end(void *data);
+      static int local_infile_error(void *data, char *message, unsigned int length);
+
       std::string _uri;
       MYSQL *_mysql;
       MySQL_timer _timer;
+      Connection_metrics _metrics;
 
       boost::shared_ptr<MYSQL_RES> _prev_result;
+      boost::shared_ptr<Local_infile_source> _local_infile_source;
+      bool _multi_statements;
+      bool _compression;
     };
   };
 };
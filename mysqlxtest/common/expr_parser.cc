@@ -154,11 +154,11 @@ Mysqlx::Expr::Identifier* Expr_parser::identifier()
   Memory_new<Mysqlx::Expr::Identifier>::Unique_ptr id(new Mysqlx::Expr::Identifier());
   if (_tokenizer.next_token_type(Token::DOT))
   {
-    const std::string& schema_name = _tokenizer.consume_token(Token::IDENT);
+    const std::string schema_name = _tokenizer.consume_token(Token::IDENT);
     id->set_schema_name(schema_name.c_str(), schema_name.size());
     _tokenizer.consume_token(Token::DOT);
   }
-  const std::string& name = _tokenizer.consume_token(Token::IDENT);
+  const std::string name = _tokenizer.consume_token(Token::IDENT);
   id->set_name(name.c_str(), name.size());
   return id.release();
 }
@@ -188,17 +188,17 @@ void Expr_parser::docpath_member(Mysqlx::Expr::DocumentPathItem& item)
   item.set_type(Mysqlx::Expr::DocumentPathItem::MEMBER);
   if (_tokenizer.cur_token_type_is(Token::IDENT))
   {
-    const std::string& ident = _tokenizer.consume_token(Token::IDENT);
+    const std::string ident = _tokenizer.consume_token(Token::IDENT);
     item.set_value(ident.c_str(), ident.size());
   }
   else if (_tokenizer.cur_token_type_is(Token::LSTRING))
   {
-    const std::string& lstring = _tokenizer.consume_token(Token::LSTRING);
+    const std::string lstring = _tokenizer.consume_token(Token::LSTRING);
     item.set_value(lstring.c_str(), lstring.size());
   }
   else if (_tokenizer.cur_token_type_is(Token::MUL))
   {
-    const std::string& mul = _tokenizer.consume_token(Token::MUL);
+    const std::string mul = _tokenizer.consume_token(Token::MUL);
     item.set_value(mul.c_str(), mul.size());
     item.set_type(Mysqlx::Expr::DocumentPathItem::MEMBER_ASTERISK);
   }
@@ -223,7 +223,7 @@ void Expr_parser::docpath_array_loc(Mysqlx::Expr::DocumentPathItem& item)
   }
   else if (_tokenizer.cur_token_type_is(Token::LINTEGER))
   {
-    const std::string& value = _tokenizer.consume_token(Token::LINTEGER);
+    const std::string value = _tokenizer.consume_token(Token::LINTEGER);
     int v = boost::lexical_cast<int>(value.c_str(), value.size());
     if (v < 0)
       throw Parser_error((boost::format("Array index cannot be negative at position %d") % tok.get_pos()).str());
@@ -275,7 +275,7 @@ void Expr_parser::document_path(Mysqlx::Expr::ColumnIdentifier& colid)
 /*
  * id ::= IDENT | MUL
  */
-const std::string& Expr_parser::id()
+std::string Expr_parser::id()
 {
   if (_tokenizer.cur_token_type_is(Token::IDENT))
     return _tokenizer.consume_token(Token::IDENT);
@@ -290,7 +290,7 @@ Mysqlx::Expr::Expr* Expr_parser::column_field()
 {
   Memory_new<Mysqlx::Expr::Expr>::Unique_ptr e(new Mysqlx::Expr::Expr());
   std::vector<std::string> parts;
-  const std::string& part = id();
+  const std::string part = id();
 
   if (part == "*")
   {
@@ -351,7 +351,7 @@ Mysqlx::Expr::Expr* Expr_parser::document_field()
   {
     Mysqlx::Expr::DocumentPathItem* item = colid->mutable_document_path()->Add();
     item->set_type(Mysqlx::Expr::DocumentPathItem::MEMBER);
-    const std::string& value = _tokenizer.consume_token(Token::IDENT);
+    const std::string value = _tokenizer.consume_token(Token::IDENT);
     item->set_value(value.c_str(), value.size());
   }
   document_path(*colid);
@@ -385,7 +385,7 @@ Mysqlx::Expr::Expr* Expr_parser::atomic_expr()
   else if ((_tokenizer.cur_token_type_is(Token::LNUM) || _tokenizer.cur_token_type_is(Token::LINTEGER)) && ((type == Token::PLUS) || (type == Token::MINUS)))
   {
     const Token& token = _tokenizer.consume_any_token();
-    const std::string& val = token.get_text();
+    const std::string val = token.get_text();
     int sign = (type == Token::PLUS) ? 1 : -1;
     if (token.get_type() == Token::LNUM)
     {
@@ -413,7 +413,7 @@ Mysqlx::Expr::Expr* Expr_parser::atomic_expr()
   }
   else if ((type == Token::LNUM) || (type == Token::LINTEGER))
   {
-    const std::string& val = t.get_text();
+    const std::string val = t.get_text();
     if (t.get_type() == Token::LNUM)
     {
       return Expr_builder::build_literal_expr(Expr_builder::build_double_scalar(boost::lexical_cast<double>(val.c_str())));
@@ -547,7 +547,7 @@ Mysqlx::Expr::Expr* Expr_parser::array_()
 void Expr_parser::json_key_value(Mysqlx::Expr::Object* obj)
 {
   Mysqlx::Expr::Object_ObjectField* fld = obj->add_fld();
-  const std::string& key = _tokenizer.consume_token(Token::LSTRING);
+  const std::string key = _tokenizer.consume_token(Token::LSTRING);
   _tokenizer.consume_token(Token::COLON);
   fld->set_key(key.c_str());
   fld->set_allocated_value(my_expr());
@@ -844,7 +844,7 @@ Mysqlx::Expr::Expr* Expr_parser::parse_left_assoc_binary_op_expr(std::set<Token:
     Memory_new<Mysqlx::Expr::Expr>::Unique_ptr e(new Mysqlx::Expr::Expr());
     e->set_type(Mysqlx::Expr::Expr::OPERATOR);
     const Token &t = _tokenizer.consume_any_token();
-    const std::string& op_val = t.get_text();
+    const std::string op_val = t.get_text();
     Mysqlx::Expr::Operator* op = e->mutable_operator_();
     std::string& op_normalized = _tokenizer.map.operator_names.at(op_val);
     op->set_name(op_normalized.c_str(), op_normalized.size());
@@ -76,7 +76,7 @@ namespace mysqlx
     void docpath_member(Mysqlx::Expr::DocumentPathItem& item);
     void docpath_array_loc(Mysqlx::Expr::DocumentPathItem& item);
     void document_path(Mysqlx::Expr::ColumnIdentifier& colid);
-    const std::string& id();
+    std::string id();
     Mysqlx::Expr::Expr* column_field();
     Mysqlx::Expr::Expr* document_field();
     Mysqlx::Expr::Expr* atomic_expr();
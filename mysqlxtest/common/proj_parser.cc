@@ -33,7 +33,7 @@ Proj_parser::Proj_parser(const std::string& expr_str, bool document_mode, bool a
 /*
  * id ::= IDENT | MUL
  */
-const std::string& Proj_parser::id()
+std::string Proj_parser::id()
 {
   if (_tokenizer.cur_token_type_is(Token::IDENT))
     return _tokenizer.consume_token(Token::IDENT);
@@ -53,7 +53,7 @@ void Proj_parser::source_expression(Mysqlx::Crud::Projection &col)
     col.mutable_source()->set_type(Mysqlx::Expr::Expr::IDENT);
     if (_tokenizer.cur_token_type_is(Token::IDENT))
     {
-      const std::string& ident = _tokenizer.consume_token(Token::IDENT);
+      const std::string ident = _tokenizer.consume_token(Token::IDENT);
       colid->mutable_document_path()->Add()->set_value(ident.c_str(), ident.size());
     }
     document_path(*colid);
@@ -67,12 +67,12 @@ void Proj_parser::source_expression(Mysqlx::Crud::Projection &col)
     if (_tokenizer.cur_token_type_is(Token::AS))
     {
       _tokenizer.consume_token(Token::AS);
-      const std::string& alias = _tokenizer.consume_token(Token::IDENT);
+      const std::string alias = _tokenizer.consume_token(Token::IDENT);
       col.set_alias(alias.c_str());
     }
     else if (_tokenizer.cur_token_type_is(Token::IDENT))
     {
-      const std::string& alias = _tokenizer.consume_token(Token::IDENT);
+      const std::string alias = _tokenizer.consume_token(Token::IDENT);
       col.set_alias(alias.c_str());
     }
     else if (_document_mode)
@@ -50,7 +50,7 @@ namespace mysqlx
       }
     }
 
-    const std::string& id();
+    std::string id();
     void source_expression(Mysqlx::Crud::Projection &column);
   };
 };
@@ -22,13 +22,16 @@
 #include <stdexcept>
 #include <memory>
 #include <cstdlib>
+#include <cassert>
 #include <cctype>
 #include <cstring>
+#include <stdint.h>
 #include <cstdlib>
 
 #ifndef WIN32
 #  include <strings.h>
 #  define _stricmp strcasecmp
+#  define _strnicmp strncasecmp
 #endif
 
 // Avoid warnings from protobuf and rapidjson
@@ -67,54 +70,56 @@ struct Tokenizer::Maps Tokenizer::map;
 
 Tokenizer::Maps::Maps()
 {
-  reserved_words["and"] = Token::AND;
-  reserved_words["or"] = Token::OR;
-  reserved_words["xor"] = Token::XOR;
-  reserved_words["is"] = Token::IS;
-  reserved_words["not"] = Token::NOT;
-  reserved_words["like"] = Token::LIKE;
-  reserved_words["in"] = Token::IN_;
-  reserved_words["regexp"] = Token::REGEXP;
-  reserved_words["between"] = Token::BETWEEN;
-  reserved_words["interval"] = Token::INTERVAL;
-  reserved_words["escape"] = Token::ESCAPE;
-  reserved_words["div"] = Token::DIV;
-  reserved_words["hex"] = Token::HEX;
-  reserved_words["bin"] = Token::BIN;
-  reserved_words["true"] = Token::TRUE_;
-  reserved_words["false"] = Token::FALSE_;
-  reserved_words["null"] = Token::T_NULL;
-  reserved_words["second"] = Token::SECOND;
-  reserved_words["minute"] = Token::MINUTE;
-  reserved_words["hour"] = Token::HOUR;
-  reserved_words["day"] = Token::DAY;
-  reserved_words["week"] = Token::WEEK;
-  reserved_words["month"] = Token::MONTH;
-  reserved_words["quarter"] = Token::QUARTER;
-  reserved_words["year"] = Token::YEAR;
-  reserved_words["microsecond"] = Token::MICROSECOND;
-  reserved_words["as"] = Token::AS;
-  reserved_words["asc"] = Token::ASC;
-  reserved_words["desc"] = Token::DESC;
-  reserved_words["cast"] = Token::CAST;
-  reserved_words["character"] = Token::CHARACTER;
-  reserved_words["set"] = Token::SET;
-  reserved_words["charset"] = Token::CHARSET;
-  reserved_words["ascii"] = Token::ASCII;
-  reserved_words["unicode"] = Token::UNICODE;
-  reserved_words["byte"] = Token::BYTE;
-  reserved_words["binary"] = Token::BINARY;
-  reserved_words["char"] = Token::CHAR;
-  reserved_words["nchar"] = Token::NCHAR;
-  reserved_words["date"] = Token::DATE;
-  reserved_words["datetime"] = Token::DATETIME;
-  reserved_words["time"] = Token::TIME;
-  reserved_words["decimal"] = Token::DECIMAL;
-  reserved_words["signed"] = Token::SIGNED;
-  reserved_words["unsigned"] = Token::UNSIGNED;
-  reserved_words["integer"] = Token::INTEGER;
-  reserved_words["int"] = Token::INTEGER;
-  reserved_words["json"] = Token::JSON;
+  memset(reserved_words, 0, sizeof(reserved_words));
+
+  add_reserved_word("and", Token::AND);
+  add_reserved_word("or", Token::OR);
+  add_reserved_word("xor", Token::XOR);
+  add_reserved_word("is", Token::IS);
+  add_reserved_word("not", Token::NOT);
+  add_reserved_word("like", Token::LIKE);
+  add_reserved_word("in", Token::IN_);
+  add_reserved_word("regexp", Token::REGEXP);
+  add_reserved_word("between", Token::BETWEEN);
+  add_reserved_word("interval", Token::INTERVAL);
+  add_reserved_word("escape", Token::ESCAPE);
+  add_reserved_word("div", Token::DIV);
+  add_reserved_word("hex", Token::HEX);
+  add_reserved_word("bin", Token::BIN);
+  add_reserved_word("true", Token::TRUE_);
+  add_reserved_word("false", Token::FALSE_);
+  add_reserved_word("null", Token::T_NULL);
+  add_reserved_word("second", Token::SECOND);
+  add_reserved_word("minute", Token::MINUTE);
+  add_reserved_word("hour", Token::HOUR);
+  add_reserved_word("day", Token::DAY);
+  add_reserved_word("week", Token::WEEK);
+  add_reserved_word("month", Token::MONTH);
+  add_reserved_word("quarter", Token::QUARTER);
+  add_reserved_word("year", Token::YEAR);
+  add_reserved_word("microsecond", Token::MICROSECOND);
+  add_reserved_word("as", Token::AS);
+  add_reserved_word("asc", Token::ASC);
+  add_reserved_word("desc", Token::DESC);
+  add_reserved_word("cast", Token::CAST);
+  add_reserved_word("character", Token::CHARACTER);
+  add_reserved_word("set", Token::SET);
+  add_reserved_word("charset", Token::CHARSET);
+  add_reserved_word("ascii", Token::ASCII);
+  add_reserved_word("unicode", Token::UNICODE);
+  add_reserved_word("byte", Token::BYTE);
+  add_reserved_word("binary", Token::BINARY);
+  add_reserved_word("char", Token::CHAR);
+  add_reserved_word("nchar", Token::NCHAR);
+  add_reserved_word("date", Token::DATE);
+  add_reserved_word("datetime", Token::DATETIME);
+  add_reserved_word("time", Token::TIME);
+  add_reserved_word("decimal", Token::DECIMAL);
+  add_reserved_word("signed", Token::SIGNED);
+  add_reserved_word("unsigned", Token::UNSIGNED);
+  add_reserved_word("integer", Token::INTEGER);
+  add_reserved_word("int", Token::INTEGER);
+  add_reserved_word("json", Token::JSON);
 
   interval_units.insert(Token::MICROSECOND);
   interval_units.insert(Token::SECOND);
@@ -158,7 +163,47 @@ Tokenizer::Maps::Maps()
   unary_operator_names["not"] = "not";
 }
 
-Token::Token(Token::TokenType type, const std::string& text, int cur_pos) : _type(type), _text(text), _pos(cur_pos)
+void Tokenizer::Maps::add_reserved_word(const char *word, Token::TokenType type)
+{
+  const std::size_t length = strlen(word);
+  Reserved_word &entry = reserved_words[reserved_word_hash(word, length)];
+
+  // A collision means the hash seed has to be chosen again
+  assert(entry.word == NULL && length <= RESERVED_WORD_MAX_LENGTH);
+
+  entry.word = word;
+  entry.length = length;
+  entry.type = type;
+}
+
+/*
+ * FNV-1a of the lowercased word
+ */
+std::size_t Tokenizer::Maps::reserved_word_hash(const char *word, std::size_t length)
+{
+  uint32_t hash = 72305;
+
+  for (std::size_t i = 0; i < length; ++i)
+    hash = (hash ^ static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(word[i])))) * 16777619U;
+
+  return (hash >> 16) % RESERVED_WORDS_SIZE;
+}
+
+bool Tokenizer::Maps::find_reserved_word(const char *word, std::size_t length, Token::TokenType &type) const
+{
+  if (length > RESERVED_WORD_MAX_LENGTH)
+    return false;
+
+  const Reserved_word &entry = reserved_words[reserved_word_hash(word, length)];
+
+  if (entry.word == NULL || entry.length != length || _strnicmp(entry.word, word, length) != 0)
+    return false;
+
+  type = entry.type;
+  return true;
+}
+
+Token::Token(Token::TokenType type, const char *text, std::size_t length, int cur_pos) : _type(type), _text(text), _length(length), _pos(cur_pos)
 {
 }
 
@@ -169,6 +214,11 @@ Tokenizer::Tokenizer(const std::string& input) : _input(input)
   _pos = 0;
 }
 
+void Tokenizer::add_token(Token::TokenType type, std::size_t start, std::size_t length, int cur_pos)
+{
+  _tokens.push_back(Token(type, _input.data() + start, length, cur_pos));
+}
+
 bool Tokenizer::next_char_is(tokens_t::size_type i, int tok)
 {
   return (i + 1) < _input.size() && _input[i + 1] == tok;
@@ -198,11 +248,10 @@ bool Tokenizer::pos_token_type_is(tokens_t::size_type pos, Token::TokenType type
   return (pos < _tokens.size()) && (_tokens[pos].get_type() == type);
 }
 
-const std::string& Tokenizer::consume_token(Token::TokenType type)
+std::string Tokenizer::consume_token(Token::TokenType type)
 {
   assert_cur_token(type);
-  const std::string& v = _tokens[_pos++].get_text();
-  return v;
+  return _tokens[_pos++].get_text();
 }
 
 const Token& Tokenizer::peek_token()
@@ -223,6 +272,7 @@ void Tokenizer::get_tokens()
 {
   bool arrow_last = false;
   bool inside_arrow = false;
+  _tokens.reserve(_input.size() / 2 + 1);
   for (size_t i = 0; i < _input.size(); ++i)
   {
     char c = _input[i];
@@ -258,11 +308,11 @@ void Tokenizer::get_tokens()
           if (i == j)
             throw Parser_error((boost::format("Tokenizer: Missing exponential value for floating point at char %d") % i).str());
         }
-        _tokens.push_back(Token(Token::LNUM, std::string(_input, start, i - start), i));
+        add_token(Token::LNUM, start, i - start, i);
       }
       else
       {
-        _tokens.push_back(Token(Token::LINTEGER, std::string(_input, start, i - start), i));
+        add_token(Token::LINTEGER, start, i - start, i);
       }
       if (i < _input.size())
         --i;
@@ -272,106 +322,106 @@ void Tokenizer::get_tokens()
       // # non-identifier, e.g. operator or quoted literal
       if (c == '?')
       {
-        _tokens.push_back(Token(Token::PLACEHOLDER, std::string(1, c), i));
+        add_token(Token::PLACEHOLDER, i, 1, i);
       }
       else if (c == '+')
       {
-        _tokens.push_back(Token(Token::PLUS, std::string(1, c), i));
+        add_token(Token::PLUS, i, 1, i);
       }
       else if (c == '-')
       {
         if (!arrow_last && next_char_is(i, '>'))
         {
           ++i;
-          _tokens.push_back(Token(Token::ARROW, "->", i));
+          add_token(Token::ARROW, i - 1, 2, i);
           arrow_last = true;
           continue;
         }
         else
-          _tokens.push_back(Token(Token::MINUS, std::string(1, c), i));
+          add_token(Token::MINUS, i, 1, i);
       }
       else if (c == '*')
       {
         if (next_char_is(i, '*'))
         {
           ++i;
-          _tokens.push_back(Token(Token::DOUBLESTAR, std::string("**"), i));
+          add_token(Token::DOUBLESTAR, i - 1, 2, i);
         }
         else
         {
-          _tokens.push_back(Token(Token::MUL, std::string(1, c), i));
+          add_token(Token::MUL, i, 1, i);
         }
       }
       else if (c == '/')
       {
-        _tokens.push_back(Token(Token::DIV, std::string(1, c), i));
+        add_token(Token::DIV, i, 1, i);
       }
       else if (c == '$')
       {
-        _tokens.push_back(Token(Token::DOLLAR, std::string(1, c), i));
+        add_token(Token::DOLLAR, i, 1, i);
       }
       else if (c == '%')
       {
-        _tokens.push_back(Token(Token::MOD, std::string(1, c), i));
+        add_token(Token::MOD, i, 1, i);
       }
       else if (c == '=')
       {
-        _tokens.push_back(Token(Token::EQ, std::string(1, c), i));
+        add_token(Token::EQ, i, 1, i);
       }
       else if (c == '&')
       {
-        _tokens.push_back(Token(Token::BITAND, std::string(1, c), i));
+        add_token(Token::BITAND, i, 1, i);
       }
       else if (c == '|')
       {
-        _tokens.push_back(Token(Token::BITOR, std::string(1, c), i));
+        add_token(Token::BITOR, i, 1, i);
       }
       else if (c == '(')
       {
-        _tokens.push_back(Token(Token::LPAREN, std::string(1, c), i));
+        add_token(Token::LPAREN, i, 1, i);
       }
       else if (c == ')')
       {
-        _tokens.push_back(Token(Token::RPAREN, std::string(1, c), i));
+        add_token(Token::RPAREN, i, 1, i);
       }
       else if (c == '[')
       {
-        _tokens.push_back(Token(Token::LSQBRACKET, std::string(1, c), i));
+        add_token(Token::LSQBRACKET, i, 1, i);
       }
       else if (c == ']')
       {
-        _tokens.push_back(Token(Token::RSQBRACKET, std::string(1, c), i));
+        add_token(Token::RSQBRACKET, i, 1, i);
       }
       else if (c == '{')
       {
-        _tokens.push_back(Token(Token::LCURLY, std::string(1, c), i));
+        add_token(Token::LCURLY, i, 1, i);
       }
       else if (c == '}')
       {
-        _tokens.push_back(Token(Token::RCURLY, std::string(1, c), i));
+        add_token(Token::RCURLY, i, 1, i);
       }
       else if (c == '~')
       {
-        _tokens.push_back(Token(Token::NEG, std::string(1, c), i));
+        add_token(Token::NEG, i, 1, i);
       }
       else if (c == ',')
       {
-        _tokens.push_back(Token(Token::COMMA, std::string(1, c), i));
+        add_token(Token::COMMA, i, 1, i);
       }
       else if (c == ':')
       {
-        _tokens.push_back(Token(Token::COLON, std::string(1, c), i));
+        add_token(Token::COLON, i, 1, i);
       }
       else if (c == '!')
       {
         if (next_char_is(i, '='))
         {
           ++i;
-          _tokens.push_back(Token(Token::NE, std::string("!="), i));
+          add_token(Token::NE, i - 1, 2, i);
         }
         else
         {
-          _tokens.push_back(Token(Token::BANG, std::string(1, c), i));
+          add_token(Token::BANG, i, 1, i);
         }
       }
       else if (c == '<')
@@ -379,21 +429,21 @@ void Tokenizer::get_tokens()
         if (next_char_is(i, '<'))
         {
           ++i;
-          _tokens.push_back(Token(Token::LSHIFT, std::string("<<"), i));
+          add_token(Token::LSHIFT, i - 1, 2, i);
         }
         else if (next_char_is(i, '='))
         {
           ++i;
-          _tokens.push_back(Token(Token::LE, std::string("<="), i));
+          add_token(Token::LE, i - 1, 2, i);
         }
         else if (next_char_is(i, '>'))
         {
           ++i;
-          _tokens.push_back(Token(Token::NE, std::string("!="), i));
+          _tokens.push_back(Token(Token::NE, "!=", 2, i));
         }
         else
         {
-          _tokens.push_back(Token(Token::LT, std::string("<"), i));
+          add_token(Token::LT, i, 1, i);
         }
       }
       else if (c == '>')
@@ -401,16 +451,16 @@ void Tokenizer::get_tokens()
         if (next_char_is(i, '>'))
         {
           ++i;
-          _tokens.push_back(Token(Token::RSHIFT, std::string(">>"), i));
+          add_token(Token::RSHIFT, i - 1, 2, i);
         }
         else if (next_char_is(i, '='))
         {
           ++i;
-          _tokens.push_back(Token(Token::GE, std::string(">="), i));
+          add_token(Token::GE, i - 1, 2, i);
         }
         else
         {
-          _tokens.push_back(Token(Token::GT, std::string(1, c), i));
+          add_token(Token::GT, i, 1, i);
         }
       }
       else if (c == '.')
@@ -437,18 +487,18 @@ void Tokenizer::get_tokens()
             if (i == j)
               throw Parser_error((boost::format("Tokenizer: Missing exponential value for floating point at char %d") % i).str());
           }
-          _tokens.push_back(Token(Token::LNUM, std::string(_input, start, i - start), i));
+          add_token(Token::LNUM, start, i - start, i);
           if (i < _input.size())
             --i;
         }
         else
         {
-          _tokens.push_back(Token(Token::DOT, std::string(1, c), i));
+          add_token(Token::DOT, i, 1, i);
         }
       }
       else if (c == '\'' && arrow_last)
       {
-        _tokens.push_back(Token(Token::QUOTE, "'", i));
+        add_token(Token::QUOTE, i, 1, i);
         if (!inside_arrow)
           inside_arrow = true;
         else
@@ -460,8 +510,8 @@ void Tokenizer::get_tokens()
       else if (c == '"' || c == '\'' || c == '`')
       {
         char quote_char = c;
-        std::string val;
         size_t start = ++i;
+        size_t unescaped_start = std::string::npos;
 
         while (i < _input.size())
         {
@@ -477,24 +527,28 @@ void Tokenizer::get_tokens()
             // this quote char has to be doubled
             if ((i + 1) >= _input.size())
               break;
-            val.append(1, _input[++i]);
+            // The value is moved to the unescape buffer on the first escape
+            if (unescaped_start == std::string::npos)
+            {
+              _unescaped.reserve(_input.size());
+              unescaped_start = _unescaped.size();
+              _unescaped.append(_input, start, i - start);
+            }
+            _unescaped.push_back(_input[++i]);
           }
-          else
-            val.append(1, c);
+          else if (unescaped_start != std::string::npos)
+            _unescaped.push_back(c);
           ++i;
         }
         if ((i >= _input.size()) && (_input[i] != quote_char))
         {
           throw Parser_error((boost::format("Unterminated quoted string starting at position %d") % start).str());
         }
-        if (quote_char == '`')
-        {
-          _tokens.push_back(Token(Token::IDENT, val, i));
-        }
+        Token::TokenType type = quote_char == '`' ? Token::IDENT : Token::LSTRING;
+        if (unescaped_start == std::string::npos)
+          add_token(type, start, i - start, i);
         else
-        {
-          _tokens.push_back(Token(Token::LSTRING, val, i));
-        }
+          _tokens.push_back(Token(type, _unescaped.data() + unescaped_start, _unescaped.size() - unescaped_start, i));
       }
       else
       {
@@ -506,16 +560,11 @@ void Tokenizer::get_tokens()
       size_t start = i;
       while (i < _input.size() && (std::isalnum(_input[i]) || _input[i] == '_'))
         ++i;
-      std::string val(_input, start, i - start);
-      Maps::reserved_words_t::const_iterator it = map.reserved_words.find(val);
-      if (it != map.reserved_words.end())
-      {
-        _tokens.push_back(Token(it->second, val, i));
-      }
+      Token::TokenType type;
+      if (map.find_reserved_word(_input.data() + start, i - start, type))
+        add_token(type, start, i - start, i);
       else
-      {
-        _tokens.push_back(Token(Token::IDENT, val, i));
-      }
+        add_token(Token::IDENT, start, i - start, i);
       --i;
     }
   }
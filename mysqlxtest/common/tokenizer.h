@@ -20,6 +20,7 @@
 #ifndef _TOKENIZER_H_
 #define _TOKENIZER_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <map>
@@ -138,14 +139,19 @@ namespace mysqlx
       QUOTE = 83
     };
 
-    Token(Token::TokenType type, const std::string& text, int cur_pos);
+    // The text is not copied, it points into the tokenizer input (or its
+    // unescape buffer) and is valid while the tokenizer is alive
+    Token(Token::TokenType type, const char *text, std::size_t length, int cur_pos);
 
-    const std::string& get_text() const { return _text; }
+    std::string get_text() const { return std::string(_text, _length); }
+    const char *get_data() const { return _text; }
+    std::size_t get_length() const { return _length; }
     TokenType get_type() const { return _type; }
     int get_pos() const { return _pos; }
   private:
     TokenType _type;
-    std::string _text;
+    const char *_text;
+    std::size_t _length;
     int _pos;
   };
 
@@ -161,7 +167,7 @@ namespace mysqlx
     bool cur_token_type_is(Token::TokenType type);
     bool next_token_type(Token::TokenType type);
     bool pos_token_type_is(tokens_t::size_type pos, Token::TokenType type);
-    const std::string& consume_token(Token::TokenType type);
+    std::string consume_token(Token::TokenType type);
     const Token& peek_token();
     void unget_token();
     void inc_pos_token();
@@ -179,10 +185,19 @@ namespace mysqlx
     const std::string& get_input() { return _input; }
 
   protected:
+    void add_token(Token::TokenType type, std::size_t start, std::size_t length, int cur_pos);
+
     std::vector<Token> _tokens;
     std::string _input;
+    // Unescaped quoted strings, reserved to the input size on first use so
+    // it is never reallocated and the tokens can point into it
+    std::string _unescaped;
     tokens_t::size_type _pos;
 
+  private:
+    Tokenizer(const Tokenizer&);
+    Tokenizer& operator=(const Tokenizer&);
+
   public:
 
     struct Cmp_icase
@@ -192,13 +207,29 @@ namespace mysqlx
 
     struct Maps
     {
-      typedef std::map<std::string, Token::TokenType, Cmp_icase> reserved_words_t;
-      reserved_words_t reserved_words;
+      // Reserved words are kept in a perfect hash table, the seed of the
+      // hash was chosen so every word lands in a different slot
+      enum { RESERVED_WORDS_SIZE = 128, RESERVED_WORD_MAX_LENGTH = 11 };
+
+      struct Reserved_word
+      {
+        const char *word;
+        std::size_t length;
+        Token::TokenType type;
+      };
+
+      Reserved_word reserved_words[RESERVED_WORDS_SIZE];
       std::set<Token::TokenType> interval_units;
       std::map<std::string, std::string, Cmp_icase> operator_names;
       std::map<std::string, std::string, Cmp_icase> unary_operator_names;
 
       Maps();
+
+      bool find_reserved_word(const char *word, std::size_t length, Token::TokenType &type) const;
+      static std::size_t reserved_word_hash(const char *word, std::size_t length);
+
+    private:
+      void add_reserved_word(const char *word, Token::TokenType type);
     };
 
   public:
@@ -19,6 +19,12 @@
 //--------------------------------------------------------------------------------------------------
 #include "utils_mysql_parsing.h"
 #include <boost/algorithm/string/trim.hpp>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPLITTER_USE_SSE2
+#endif
 
 namespace shcore
 {
@@ -52,12 +58,201 @@ namespace shcore
 
       //--------------------------------------------------------------------------------------------------
 
+      // Characters handled by the splitter state machine, anything else only
+      // counts as statement content. The first character of the delimiter is
+      // checked separately as it may change while splitting.
+      static const bool special_chars[256] =
+      {
+        // "  #  '  *  -  /  D  `  d
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, true,  true,  false, false, false, true,  false, false, true,  false, false, true,  false, true,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, true,  false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        true,  false, false, false, true,  false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false,
+        false, false, false, false, false, false, false, false, false, false, false, false, false, false, false, false
+      };
+
+      /**
+       * Skips the characters not handled by the state machine, returns the first special one or end.
+       * has_content is set if any of the skipped characters is not a space.
+       */
+      static const unsigned char *skip_plain(const unsigned char *tail, const unsigned char *end,
+                                             unsigned char delimiter_char, bool &has_content)
+      {
+#ifdef SPLITTER_USE_SSE2
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i hash = _mm_set1_epi8('#');
+        const __m128i single_quote = _mm_set1_epi8('\'');
+        const __m128i star = _mm_set1_epi8('*');
+        const __m128i dash = _mm_set1_epi8('-');
+        const __m128i slash = _mm_set1_epi8('/');
+        const __m128i backtick = _mm_set1_epi8('`');
+        const __m128i lower_d = _mm_set1_epi8('d');
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        const __m128i delimiter = _mm_set1_epi8(static_cast<char>(delimiter_char));
+        const __m128i above_space = _mm_set1_epi8(' ' + 1);
+
+        while (end - tail >= 16)
+        {
+          const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+
+          __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, hash));
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, single_quote));
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, star));
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, dash));
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, slash));
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, backtick));
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_mm_or_si128(chunk, case_bit), lower_d));
+          matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, delimiter));
+
+          // Unsigned chunk > ' ' is the same as max(chunk, ' ' + 1) == chunk
+          const int content = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, above_space), chunk));
+          const int special = _mm_movemask_epi8(matches);
+
+          if (special)
+          {
+            int offset = 0;
+            while (!(special & (1 << offset)))
+              offset++;
+
+            if (content & ((1 << offset) - 1))
+              has_content = true;
+
+            return tail + offset;
+          }
+
+          if (content)
+            has_content = true;
+
+          tail += 16;
+        }
+#endif
+        while (tail < end && !special_chars[*tail] && *tail != delimiter_char)
+        {
+          if (*tail > ' ')
+            has_content = true;
+          tail++;
+        }
+
+        return tail;
+      }
+
+      /**
+       * Returns the position of the next line break or end if none.
+       */
+      static const unsigned char *find_line_break(const unsigned char *tail, const unsigned char *end,
+                                                  const unsigned char *line_break)
+      {
+        if (*line_break == '\0')
+          return end;
+
+        while (tail < end)
+        {
+          const unsigned char *next = static_cast<const unsigned char*>(memchr(tail, *line_break, end - tail));
+          if (!next)
+            return end;
+
+          if (is_line_break(next, line_break))
+            return next;
+
+          tail = next + 1;
+        }
+
+        return tail;
+      }
+
+      /**
+       * Skips a quoted string or identifier, returns the closing quote position, end if there's none or
+       * end + 1 when the last character escapes the (missing) closing quote.
+       */
+      static const unsigned char *skip_quoted(const unsigned char *tail, const unsigned char *end, unsigned char quote)
+      {
+        while (tail < end)
+        {
+#ifdef SPLITTER_USE_SSE2
+          const __m128i quote_mask = _mm_set1_epi8(static_cast<char>(quote));
+          const __m128i backslash = _mm_set1_epi8('\\');
+
+          while (end - tail >= 16)
+          {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote_mask), _mm_cmpeq_epi8(chunk, backslash))))
+              break;
+            tail += 16;
+          }
+#endif
+          while (tail < end && *tail != quote && *tail != '\\')
+            tail++;
+
+          if (tail == end || *tail == quote)
+            break;
+
+          // Skip any escaped character too.
+          tail += 2;
+        }
+
+        return tail;
+      }
+
+      //--------------------------------------------------------------------------------------------------
+
+      // Current parsing context, kept in sync with the top of the input context stack so the
+      // checks done on every character don't need to compare strings
+      enum Context
+      {
+        Context_none,
+        Context_statement,      // "-", a statement continues in the next call
+        Context_comment,        // "/*", a multiline comment continues in the next call
+        Context_quote           // A quoted string or identifier continues in the next call
+      };
+
+      static Context get_context(const std::stack<std::string> &input_context_stack)
+      {
+        if (input_context_stack.empty())
+          return Context_none;
+
+        const std::string &top = input_context_stack.top();
+        if (top == "-")
+          return Context_statement;
+        else if (top == "/*")
+          return Context_comment;
+
+        return Context_quote;
+      }
+
+      static Context push_context(std::stack<std::string> &input_context_stack, const std::string &context)
+      {
+        input_context_stack.push(context);
+        return get_context(input_context_stack);
+      }
+
+      static Context pop_context(std::stack<std::string> &input_context_stack)
+      {
+        input_context_stack.pop();
+        return get_context(input_context_stack);
+      }
+
+      //--------------------------------------------------------------------------------------------------
+
       /**
        * A statement splitter to take a list of sql statements and split them into individual statements,
        * return their position and length in the original string (instead the copied strings).
        *
        * A tweak was added to the function to return the number of complete statements found, where
        * complete means the ending delimiter was found.
+       *
+       * Characters which can't change the splitter state are skipped in blocks, only quotes, comment
+       * starts, the DELIMITER keyword and the delimiter itself go through the state machine.
        */
       size_t determineStatementRanges(const char *sql, size_t length, std::string &delimiter,
                                                  std::vector<std::pair<size_t, size_t> > &ranges,
@@ -73,18 +268,30 @@ namespace shcore
         const unsigned char *end = head + length;
         const unsigned char *new_line = (unsigned char*)line_break.c_str();
         bool have_content = false; // Set when anything else but comments were found for the current statement.
+        Context context = get_context(input_context_stack);
 
         ranges.clear();
 
         while (tail < end)
         {
+          if (!special_chars[*tail] && *tail != *delimiter_head)
+          {
+            // Multiline comments are ignored, everything else is not
+            bool has_content = false;
+            tail = skip_plain(tail, end, *delimiter_head, has_content);
+            if (has_content && context != Context_comment)
+              have_content = true;
+
+            if (tail == end)
+              break;
+          }
+
           switch (*tail)
           {
             case '*': // Comes from a multiline comment and comment is done
-              if (*(tail + 1) == '/' && (!input_context_stack.empty() && input_context_stack.top() == "/*"))
+              if (*(tail + 1) == '/' && context == Context_comment)
               {
-                if (!input_context_stack.empty())
-                  input_context_stack.pop();
+                context = pop_context(input_context_stack);
 
                 tail += 2;
                 head = tail; // Skip over the comment.
@@ -97,11 +304,11 @@ namespace shcore
                 bool is_hidden_command = (*tail == '!');
                 while (true)
                 {
-                  while (tail < end && *tail != '*')
-                    tail++;
+                  const unsigned char *star = static_cast<const unsigned char*>(tail < end ? memchr(tail, '*', end - tail) : NULL);
+                  tail = star ? star : end;
                   if (tail == end) // Unfinished comment.
                   {
-                    input_context_stack.push("/*");
+                    context = push_context(input_context_stack, "/*");
                     break;
                   }
                   else
@@ -126,9 +333,7 @@ namespace shcore
                         if (*(tail + 1) == '-' && (*end_char == ' ' || *end_char == '\t' || is_line_break(end_char, new_line) || length == 2))
                         {
                           // Skip everything until the end of the line.
-                          tail += 2;
-                          while (tail < end && !is_line_break(tail, new_line))
-                            tail++;
+                          tail = find_line_break(tail + 2, end, new_line);
                           if (!have_content)
                             head = tail;
                         }
@@ -136,8 +341,7 @@ namespace shcore
             }
 
             case '#': // MySQL single line comment.
-              while (tail < end && !is_line_break(tail, new_line))
-                tail++;
+              tail = find_line_break(tail, end, new_line);
               if (!have_content)
                 head = tail;
               break;
@@ -149,27 +353,21 @@ namespace shcore
                       have_content = true;
                       char quote = *tail++;
 
-                      if (input_context_stack.empty() || input_context_stack.top() == "-")
+                      if (context == Context_none || context == Context_statement)
                       {
                         // Quoted string/id. Skip this in a local loop if is opening quote.
-                        while (tail < end && *tail != quote)
-                        {
-                          // Skip any escaped character too.
-                          if (*tail == '\\')
-                            tail++;
-                          tail++;
-                        }
+                        tail = skip_quoted(tail, end, quote);
                         if (*tail == quote)
                           tail++; // Skip trailing quote char to if one was there.
                         else
                         {
                           std::string q;
                           q.assign(&quote, 1);
-                          input_context_stack.push(q); // Sets multiline opening quote to continue processing
+                          context = push_context(input_context_stack, q); // Sets multiline opening quote to continue processing
                         }
                       }
                       else // Closing quote, clears the multiline flag
-                        input_context_stack.pop();
+                        context = pop_context(input_context_stack);
 
                       break;
             }
@@ -225,12 +423,12 @@ namespace shcore
             {
               // Most common case. Trim the statement and check if it is not empty before adding the range.
               head = skip_leading_whitespace(head, tail);
-              if (head < tail || (!input_context_stack.empty() && input_context_stack.top() == "-"))
+              if (head < tail || context == Context_statement)
               {
                 full_statement_count++;
 
-                if (!input_context_stack.empty())
-                  input_context_stack.pop();
+                if (context != Context_none)
+                  context = pop_context(input_context_stack);
 
                 if (head < tail)
                   ranges.push_back(std::make_pair<size_t, size_t>(head - (unsigned char *)sql, tail - head));
@@ -250,12 +448,12 @@ namespace shcore
                 // Multi char delimiter is complete. Tail still points to the start of the delimiter.
                 // Run points to the first character after the delimiter.
                 head = skip_leading_whitespace(head, tail);
-                if (head < tail || (!input_context_stack.empty() && input_context_stack.top() == "-"))
+                if (head < tail || context == Context_statement)
                 {
                   full_statement_count++;
 
-                  if (!input_context_stack.empty())
-                    input_context_stack.pop();
+                  if (context != Context_none)
+                    context = pop_context(input_context_stack);
 
                   if (head < tail)
                     ranges.push_back(std::make_pair<size_t, size_t>(head - (unsigned char *)sql, tail - head));
@@ -269,20 +467,20 @@ namespace shcore
           }
 
           // Multiline comments are ignored, everything else is not
-          if (*tail > ' ' && (input_context_stack.empty() || input_context_stack.top() != "/*"))
+          if (*tail > ' ' && context != Context_comment)
             have_content = true;
           tail++;
         }
 
         // Add remaining text to the range list but ignores it when it is a multiline comment
         head = skip_leading_whitespace(head, tail);
-        if (head < tail && (input_context_stack.empty() || input_context_stack.top() != "/*"))
+        if (head < tail && context != Context_comment)
         {
           ranges.push_back(std::make_pair<size_t, size_t>(head - (unsigned char *)sql, tail - head));
 
           // If not a multiline string then sets the flag to multiline statement (not terminated)
-          if (input_context_stack.empty())
-            input_context_stack.push("-");
+          if (context == Context_none)
+            push_context(input_context_stack, "-");
         }
 
         return full_statement_count;
@@ -49,6 +49,11 @@ Connection_openssl_factory::Connection_openssl_factory(const std::string &ssl_ke
 
     mysqld::set_context(m_context->native_handle(), is_client, ssl_key, ssl_cert, ssl_ca,
                         ssl_ca_path, ssl_cipher, ssl_crl, ssl_crl_path);
+
+    // Sessions are resumed from m_session_cache, which is keyed by peer
+    // instead of by the internal cache which is keyed by session id
+    if (is_client)
+      SSL_CTX_set_session_cache_mode(m_context->native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
   }
   catch (const std::exception &e)
   {
@@ -66,7 +71,7 @@ Connection_openssl_factory::~Connection_openssl_factory()
 IConnection_unique_ptr Connection_openssl_factory::create_connection(boost::asio::io_service &io_service)
 {
   return IConnection_unique_ptr(new Connection_dynamic_tls(IConnection_unique_ptr(
-                                    new Connection_openssl(io_service, boost::ref(*m_context), m_is_client))));
+                                    new Connection_openssl(io_service, boost::ref(*m_context), m_is_client, &m_session_cache))));
 }
 
 
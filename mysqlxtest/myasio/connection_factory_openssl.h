@@ -25,6 +25,7 @@
 #include <boost/scoped_ptr.hpp>
 
 #include "myasio/connection_factory.h"
+#include "myasio/ssl_session_cache.h"
 
 
 // forward declaration of context is needed because of compatybility of
@@ -60,6 +61,7 @@ public:
 private:
   boost::asio::ssl::context *m_context;
   const bool m_is_client;
+  Ssl_session_cache m_session_cache;
 };
 
 
@@ -52,7 +52,7 @@ namespace ngs
 
   IConnection_unique_ptr Connection_yassl_factory::create_connection(boost::asio::io_service &io_service)
   {
-    Wrapper_ssl_ptr        wrapper_ssl(new Wrapper_yassl(ssl_ctxt));
+    Wrapper_ssl_ptr        wrapper_ssl(new Wrapper_yassl(ssl_ctxt, m_is_client ? &m_session_cache : NULL));
     IConnection_unique_ptr connection(Connection_raw_factory().create_connection(io_service));
 
     Vector_states_yassl  handlers;
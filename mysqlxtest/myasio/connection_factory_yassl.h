@@ -27,6 +27,7 @@
 #include "myasio/connection_factory.h"
 #include "myasio/wrapper_ssl.h"
 #include "myasio/connection_state_yassl.h"
+#include "myasio/ssl_session_cache.h"
 
 namespace yaSSL
 {
@@ -52,6 +53,7 @@ namespace ngs
 
     bool m_is_client;
     boost::shared_ptr<yaSSL::SSL_CTX> ssl_ctxt;
+    Ssl_session_cache m_session_cache;
   };
 
 } // namespace ngs
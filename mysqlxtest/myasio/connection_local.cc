@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "myasio/connection_local.h"
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+#include "myasio/connection_raw.h"
+
+namespace ngs
+{
+
+Connection_local::Connection_local(boost::asio::io_service &service)
+: m_asio_socket(service),
+  m_asio_strand(service)
+{
+}
+
+
+void Connection_local::async_connect(const std::string &socket_path, const On_asio_status_callback &on_connect_callback)
+{
+  const boost::asio::local::stream_protocol::endpoint endpoint(socket_path);
+
+  m_asio_socket.async_connect(endpoint, m_asio_strand.wrap(on_connect_callback));
+}
+
+
+Endpoint Connection_local::get_remote_endpoint() const
+{
+  return Endpoint();
+}
+
+
+int Connection_local::get_socket_id()
+{
+  return static_cast<int>(m_asio_socket.native());
+}
+
+
+IOptions_session_ptr Connection_local::options()
+{
+  static IOptions_session_ptr result(boost::make_shared<Options_default>());
+  return result;
+}
+
+
+void Connection_local::async_connect(const Endpoint &, const On_asio_status_callback &on_connect_callback, const On_asio_status_callback &)
+{
+  on_connect_callback(boost::system::errc::make_error_code(boost::system::errc::not_supported));
+}
+
+
+void Connection_local::async_accept(boost::asio::ip::tcp::acceptor &, const On_asio_status_callback &on_accept_callback,
+                                    const On_asio_status_callback &)
+{
+  on_accept_callback(boost::system::errc::make_error_code(boost::system::errc::not_supported));
+}
+
+
+void Connection_local::async_write(const Const_buffer_sequence &data, const On_asio_data_callback &on_write_callback)
+{
+  m_asio_socket.async_write_some(data, m_asio_strand.wrap(on_write_callback));
+}
+
+
+void Connection_local::async_read(const Mutable_buffer_sequence &data, const On_asio_data_callback &on_read_callback)
+{
+  m_asio_socket.async_read_some(data, m_asio_strand.wrap(on_read_callback));
+}
+
+
+void Connection_local::async_activate_tls(const On_asio_status_callback on_status)
+{
+  on_status(boost::system::errc::make_error_code(boost::system::errc::not_supported));
+}
+
+
+IConnection_ptr Connection_local::get_lowest_layer()
+{
+  // Used only by the TLS layers, which are never stacked on a local socket
+  return IConnection_ptr();
+}
+
+
+void Connection_local::post(const boost::function<void ()> &calee)
+{
+  m_asio_strand.post(m_asio_strand.wrap(calee));
+}
+
+
+bool Connection_local::thread_in_connection_strand()
+{
+  return m_asio_strand.running_in_this_thread();
+}
+
+
+void Connection_local::shutdown(boost::asio::socket_base::shutdown_type how_to_shutdown, boost::system::error_code &ec)
+{
+  m_asio_socket.shutdown(how_to_shutdown, ec);
+}
+
+
+void Connection_local::cancel()
+{
+  m_asio_socket.cancel();
+}
+
+
+void Connection_local::close()
+{
+  if (m_asio_socket.is_open())
+  {
+    boost::system::error_code ec;
+
+    m_asio_socket.close(ec);
+  }
+}
+
+} // namespace ngs
+
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
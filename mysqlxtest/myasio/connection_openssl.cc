@@ -32,11 +32,13 @@
 using namespace ngs;
 
 
-Connection_openssl::Connection_openssl(boost::asio::io_service &service, boost::asio::ssl::context &context, const bool is_client)
+Connection_openssl::Connection_openssl(boost::asio::io_service &service, boost::asio::ssl::context &context, const bool is_client,
+                                       Ssl_session_cache *session_cache)
 : m_handshake_type(is_client ? boost::asio::ssl::stream_base::client : boost::asio::ssl::stream_base::server),
   m_asio_socket(service, context),
   m_asio_strand(service),
-  m_state(State_handshake)
+  m_state(State_handshake),
+  m_session_cache(is_client ? session_cache : NULL)
 {
 }
 
@@ -127,6 +129,8 @@ void Connection_openssl::async_activate_tls(const On_asio_status_callback on_sta
     m_ready_callback = on_status;
   }
 
+  try_to_resume_session();
+
   m_asio_socket.async_handshake(m_handshake_type, m_asio_strand.wrap(boost::bind(&Connection_openssl::on_handshake, this, boost::asio::placeholders::error)));
 }
 
@@ -199,8 +203,51 @@ void Connection_openssl::on_handshake(const boost::system::error_code &error)
   m_state = error ? State_stop :
                     State_running;
 
+  store_session(error);
+
 
   callback.call_status_function(m_ready_callback, error);
 }
 
+void Connection_openssl::try_to_resume_session()
+{
+  if (NULL == m_session_cache)
+    return;
+
+  boost::system::error_code ec;
+  const Endpoint endpoint = m_asio_socket.lowest_layer().remote_endpoint(ec);
+
+  if (ec)
+    return;
+
+  m_session_peer = Ssl_session_cache::get_peer_key(endpoint);
+
+  Ssl_session_cache::Session_ptr session = m_session_cache->get(m_session_peer);
+
+  if (session)
+    SSL_set_session(m_asio_socket.native_handle(), static_cast<SSL_SESSION*>(session.get()));
+}
+
+void Connection_openssl::store_session(const boost::system::error_code &ec)
+{
+  if (NULL == m_session_cache || m_session_peer.empty())
+    return;
+
+  if (ec)
+  {
+    // Don't offer the same session again, next handshake is going to be a full one
+    m_session_cache->remove(m_session_peer);
+    return;
+  }
+
+  SSL *ssl = m_asio_socket.native_handle();
+
+  Ssl_session_cache::count_handshake(0 != SSL_session_reused(ssl));
+
+  SSL_SESSION *session = SSL_get1_session(ssl);
+
+  if (session)
+    m_session_cache->store(m_session_peer, Ssl_session_cache::Session_ptr(session, SSL_SESSION_free));
+}
+
 #endif // !defined(HAVE_YASSL)
@@ -25,6 +25,7 @@
 #include <boost/asio/ssl.hpp>
 
 #include "myasio/connection.h"
+#include "myasio/ssl_session_cache.h"
 
 
 namespace ngs
@@ -33,7 +34,8 @@ namespace ngs
 class Connection_openssl : public IConnection
 {
 public:
-  Connection_openssl(boost::asio::io_service &socket, boost::asio::ssl::context &context, const bool is_client = false);
+  Connection_openssl(boost::asio::io_service &socket, boost::asio::ssl::context &context, const bool is_client = false,
+                     Ssl_session_cache *session_cache = NULL);
   virtual ~Connection_openssl();
 
   virtual Endpoint    get_remote_endpoint() const;
@@ -65,6 +67,8 @@ private:
   void on_connect_try_handshake(const boost::system::error_code &ec);
   void on_accept_try_handshake(boost::asio::io_service &acceptor, const boost::system::error_code &ec);
   void on_handshake(const boost::system::error_code &ec);
+  void try_to_resume_session();
+  void store_session(const boost::system::error_code &ec);
 
   handshake_type m_handshake_type;
   stream         m_asio_socket;
@@ -74,6 +78,8 @@ private:
   On_asio_status_callback m_ready_callback;
 
   State m_state;
+  Ssl_session_cache *m_session_cache;
+  std::string        m_session_peer;
 };
 
 }  // namespace ngs
@@ -58,6 +58,7 @@ State_yassl::Result State_handshake_server_yassl::handle_pdu(boost::optional<Sta
 
   if (accept_result)
   {
+    m_ssl.ssl_store_session();
     next_state = State_running;
     m_callback->call_status_function(ready_callback, boost::system::error_code());
     return Result_done;
@@ -70,6 +71,8 @@ State_yassl::Result State_handshake_server_yassl::handle_pdu(boost::optional<Sta
     return Result_continue;
   }
 
+  m_ssl.ssl_remove_session();
+
   next_state = State_stop;
   m_callback->call_status_function(ready_callback, m_ssl.get_boost_error());
 
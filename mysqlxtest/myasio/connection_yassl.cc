@@ -23,6 +23,7 @@
 #include "myasio/options.h"
 #include "myasio/connection_raw.h"
 #include "myasio/connection_yassl.h"
+#include "myasio/ssl_session_cache.h"
 
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
@@ -221,6 +222,15 @@ namespace ngs
     if (!ec)
     {
       m_ssl->ssl_set_fd(m_connection->get_socket_id());
+
+      try
+      {
+        m_ssl->ssl_resume_session(Ssl_session_cache::get_peer_key(m_connection->get_remote_endpoint()));
+      }
+      catch (const boost::system::system_error &)
+      {
+        // Peer unknown, full handshake is going to be done
+      }
     }
 
     m_callback->call_status_function(m_accept_callback, ec);
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <sstream>
+
+#include "myasio/ssl_session_cache.h"
+
+
+namespace ngs
+{
+
+namespace
+{
+
+boost::mutex             statistics_mutex;
+Tls_handshake_statistics statistics;
+
+} // namespace
+
+
+Ssl_session_cache::Session_ptr Ssl_session_cache::get(const std::string &peer)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  Session_map::const_iterator i = m_sessions.find(peer);
+
+  if (m_sessions.end() == i)
+    return Session_ptr();
+
+  return i->second;
+}
+
+void Ssl_session_cache::store(const std::string &peer, const Session_ptr &session)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  if (session)
+    m_sessions[peer] = session;
+  else
+    m_sessions.erase(peer);
+}
+
+void Ssl_session_cache::remove(const std::string &peer)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  m_sessions.erase(peer);
+}
+
+std::string Ssl_session_cache::get_peer_key(const Endpoint &endpoint)
+{
+  std::stringstream key;
+
+  key << endpoint.address().to_string() << ":" << endpoint.port();
+
+  return key.str();
+}
+
+void Ssl_session_cache::count_handshake(const bool resumed)
+{
+  boost::mutex::scoped_lock lock(statistics_mutex);
+
+  if (resumed)
+    ++statistics.resumed_handshakes;
+  else
+    ++statistics.full_handshakes;
+}
+
+Tls_handshake_statistics Ssl_session_cache::get_statistics()
+{
+  boost::mutex::scoped_lock lock(statistics_mutex);
+
+  return statistics;
+}
+
+} // namespace ngs
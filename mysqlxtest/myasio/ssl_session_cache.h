@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _NGS_ASIO_SSL_SESSION_CACHE_H_
+#define _NGS_ASIO_SSL_SESSION_CACHE_H_
+
+#include <map>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "myasio/types.h"
+
+
+namespace ngs
+{
+
+struct Tls_handshake_statistics
+{
+  Tls_handshake_statistics()
+  : full_handshakes(0), resumed_handshakes(0)
+  {}
+
+  long full_handshakes;
+  long resumed_handshakes;
+};
+
+
+// Client side store of negotiated TLS sessions, one per peer.
+// Sessions are kept type erased, so the same store serves both
+// OpenSSL and yaSSL. The deleter given together with the session
+// (SSL_SESSION_free) releases the reference taken by SSL_get1_session.
+class Ssl_session_cache
+{
+public:
+  typedef boost::shared_ptr<void> Session_ptr;
+
+  Session_ptr get(const std::string &peer);
+  void store(const std::string &peer, const Session_ptr &session);
+  void remove(const std::string &peer);
+
+  static std::string get_peer_key(const Endpoint &endpoint);
+
+  static void count_handshake(const bool resumed);
+  static Tls_handshake_statistics get_statistics();
+
+private:
+  typedef std::map<std::string, Session_ptr> Session_map;
+
+  boost::mutex m_mutex;
+  Session_map  m_sessions;
+};
+
+
+} // namespace ngs
+
+#endif // _NGS_ASIO_SSL_SESSION_CACHE_H_
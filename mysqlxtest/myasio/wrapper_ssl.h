@@ -56,6 +56,12 @@ namespace ngs
     virtual void ssl_set_transport_recv(Socket_recv socket_recv) = 0;
     virtual void ssl_set_transport_send(Socket_send socket_send) = 0;
     virtual void ssl_set_transport_data(void *error) = 0;
+
+    // Client side session resumption, all are no-op when the wrapper
+    // wasn't created with a session cache
+    virtual void ssl_resume_session(const std::string &peer) = 0;
+    virtual void ssl_store_session() = 0;
+    virtual void ssl_remove_session() = 0;
   };
 
 } // namespace ngs
@@ -111,8 +111,9 @@ namespace ngs
   }
 
 
-  Wrapper_yassl::Wrapper_yassl(boost::shared_ptr<SSL_CTX> context)
-  : ssl_ctxt(context)
+  Wrapper_yassl::Wrapper_yassl(boost::shared_ptr<SSL_CTX> context, Ssl_session_cache *session_cache)
+  : ssl_ctxt(context),
+    m_session_cache(session_cache)
   {
   }
 
@@ -208,6 +209,41 @@ namespace ngs
     ssl->useSocket().set_transport_ptr(error);
   }
 
+  void Wrapper_yassl::ssl_resume_session(const std::string &peer)
+  {
+    if (NULL == m_session_cache)
+      return;
+
+    m_session_peer = peer;
+
+    Ssl_session_cache::Session_ptr session = m_session_cache->get(m_session_peer);
+
+    if (session)
+      SSL_set_session(ssl.get(), static_cast<SSL_SESSION*>(session.get()));
+  }
+
+  void Wrapper_yassl::ssl_store_session()
+  {
+    if (NULL == m_session_cache || m_session_peer.empty())
+      return;
+
+    Ssl_session_cache::count_handshake(0 != SSL_session_reused(ssl.get()));
+
+    SSL_SESSION *session = SSL_get1_session(ssl.get());
+
+    if (session)
+      m_session_cache->store(m_session_peer, Ssl_session_cache::Session_ptr(session, SSL_SESSION_free));
+  }
+
+  void Wrapper_yassl::ssl_remove_session()
+  {
+    if (NULL == m_session_cache || m_session_peer.empty())
+      return;
+
+    // Don't offer the same session again, next handshake is going to be a full one
+    m_session_cache->remove(m_session_peer);
+  }
+
   boost::system::error_code Wrapper_yassl::get_boost_error()
   {
     int error_code = ssl_get_error();
@@ -20,6 +20,7 @@
 #include <boost/system/error_code.hpp>
 
 #include "myasio/wrapper_ssl.h"
+#include "myasio/ssl_session_cache.h"
 #include "ngs/memory.h"
 
 namespace ngs
@@ -36,7 +37,7 @@ namespace ngs
   class Wrapper_yassl : public IWrapper_ssl
   {
   public:
-    Wrapper_yassl(boost::shared_ptr<yaSSL::SSL_CTX> context);
+    Wrapper_yassl(boost::shared_ptr<yaSSL::SSL_CTX> context, Ssl_session_cache *session_cache = NULL);
 
     virtual void ssl_initialize();
 
@@ -68,11 +69,19 @@ namespace ngs
 
     virtual void ssl_set_transport_data(void *error);
 
+    virtual void ssl_resume_session(const std::string &peer);
+
+    virtual void ssl_store_session();
+
+    virtual void ssl_remove_session();
+
     virtual boost::system::error_code get_boost_error();
 
   private:
     boost::shared_ptr<yaSSL::SSL_CTX>        ssl_ctxt;
     Custom_allocator<yaSSL::SSL>::Unique_ptr ssl;
+    Ssl_session_cache                       *m_session_cache;
+    std::string                              m_session_peer;
 
     int ssl_get_error();
   };
@@ -23,6 +23,7 @@
 #ifndef _MYSQLX_CONNECTOR_H_
 #define _MYSQLX_CONNECTOR_H_
 
+#include <cstdio>
 #include <stdexcept>
 #include <vector>
 #include <map>
@@ -30,6 +31,8 @@
 
 #include "ngs_common/xdatetime.h"
 #include "mysqlx_common.h"
+#include "mysqlx_metrics.h"
+#include "mysqlx_notice.h"
 
 #include <boost/enable_shared_from_this.hpp>
 
@@ -234,6 +237,14 @@ namespace mysqlx
                          const std::string &user, const std::string &pass,
                          const mysqlx::Ssl_config &ssl_config, const std::size_t timeout,
                          const std::string &auth_method = "", const bool get_caps = false);
+  // Same, connecting through the Unix domain socket when socket_path is given.
+  // With compression the compressed framing is requested from the server.
+  SessionRef openSession(const std::string &host, int port, const std::string &socket_path,
+                         const std::string &schema,
+                         const std::string &user, const std::string &pass,
+                         const mysqlx::Ssl_config &ssl_config, const std::size_t timeout,
+                         const std::string &auth_method = "", const bool get_caps = false,
+                         const bool compression = false);
 
   enum FieldType
   {
@@ -310,6 +321,9 @@ namespace mysqlx
     std::set<std::string> setField(int field) const;
     std::string enumField(int field) const;
     const char *stringField(int field, size_t &rlength) const;
+    // Null terminated field data that can be decoded in place, the row
+    // must not be read again afterwards
+    char *mutableStringField(int field, size_t &rlength);
     float floatField(int field) const;
     double doubleField(int field) const;
     DateTime dateTimeField(int field) const;
@@ -319,6 +333,7 @@ namespace mysqlx
 
   private:
     friend class Result;
+    friend class ResultData;
     Row(boost::shared_ptr<std::vector<ColumnMetadata> > columns, Mysqlx::Resultset::Row *data);
 
     void check_field(int field, FieldType type) const;
@@ -327,19 +342,54 @@ namespace mysqlx
     Mysqlx::Resultset::Row *m_data;
   };
 
+  // Rows of a buffered resultset, kept as their raw protobuf payload and
+  // parsed again when read. Payloads are kept in memory up to memory_limit
+  // bytes, the rest goes to a temporary file that is mapped back to read it.
   class MYSQLXTEST_PUBLIC ResultData
   {
   public:
-    ResultData(boost::shared_ptr<std::vector<ColumnMetadata> > columns);
+    ResultData(boost::shared_ptr<std::vector<ColumnMetadata> > columns, size_t memory_limit);
+    ~ResultData();
     boost::shared_ptr<std::vector<ColumnMetadata> > columnMetadata(){ return m_columns; }
     void add_row(boost::shared_ptr<Row> row);
+
+    // Space for the payload of a new row, valid until commit_row(), or
+    // until cancel_row() drops the row when its payload can't be read
+    char *reserve_row(size_t length);
+    void commit_row();
+    void cancel_row();
+
     void rewind();
     void tell(size_t &record);
     void seek(size_t record);
     boost::shared_ptr<Row> next();
   private:
+    ResultData(const ResultData &);
+
+    const char *row_payload(size_t record);
+
+    enum { BLOCK_SIZE = 1024 * 1024, IN_FILE = 0xFFFFFFFF };
+
+    struct Location
+    {
+      uint64_t offset;
+      uint32_t length;
+      uint32_t block;
+    };
+
     boost::shared_ptr<std::vector<ColumnMetadata> > m_columns;
-    std::vector<boost::shared_ptr<Row> > m_rows;
+    std::vector<Location> m_rows;
+    std::vector<std::vector<char> > m_blocks;
+    size_t m_memory;
+    const size_t m_memory_limit;
+
+    // Rows over the memory limit, the mapping is extended as the file grows
+    std::FILE *m_file;
+    uint64_t m_file_size;
+    std::vector<char> m_file_row;
+    char *m_map;
+    uint64_t m_map_size;
+
     size_t m_row_index;
   };
 
@@ -362,7 +412,16 @@ namespace mysqlx
     bool nextDataSet();
     void flush();
 
-    Result& buffer();
+    // Rows over memory_limit bytes are kept in a temporary file
+    Result& buffer(size_t memory_limit = DEFAULT_BUFFER_MEMORY);
+    bool is_buffered() const { return m_buffered; }
+
+    static const size_t DEFAULT_BUFFER_MEMORY = 64 * 1024 * 1024;
+
+    // The frames of each resultset are read by a helper thread, up to
+    // byte_limit bytes ahead, while the rows before them are consumed.
+    // They are still parsed by the thread calling next().
+    void enable_read_ahead(size_t byte_limit);
 
     // Return true if the operation was successfully executed
     bool rewind();
@@ -373,6 +432,9 @@ namespace mysqlx
 
     void mark_error();
 
+    // Phases are marked as the messages arrive
+    const Result_timing &timing() const { return m_timing; }
+
     struct Warning
     {
       std::string text;
@@ -389,10 +451,12 @@ namespace mysqlx
     void read_metadata();
     boost::shared_ptr<Row> read_row();
     void read_stmt_ok();
+    void start_read_ahead();
 
-    bool handle_notice(int32_t type, const std::string &data);
+    static bool handle_notice(void *context, const Notice_frame &frame);
 
-    int get_message_id();
+    int get_message_id(bool skip_rows = false);
+    void skip_rows();
     mysqlx::Message* pop_message();
 
     mysqlx::Message* current_message;
@@ -425,6 +489,9 @@ namespace mysqlx
     bool m_buffered;
     bool m_buffering;
     bool m_has_doc_ids;
+    size_t m_buffer_memory;
+    size_t m_read_ahead_limit;
+    Result_timing m_timing;
   };
 };
 
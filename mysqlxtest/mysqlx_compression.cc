@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#include <boost/make_shared.hpp>
+
+#include "mysqlx_compression.h"
+
+using namespace mysqlx;
+
+#ifdef HAVE_ZLIB
+Compression_deflate::Compression_deflate(const int level)
+: m_level(level)
+{
+}
+
+bool Compression_deflate::compress(const char *data, const std::size_t data_length, std::string &output)
+{
+  const std::size_t offset = output.size();
+  uLongf compressed_length = compressBound(static_cast<uLong>(data_length));
+
+  output.resize(offset + compressed_length);
+
+  if (Z_OK != compress2(reinterpret_cast<Bytef*>(&output[offset]), &compressed_length,
+                        reinterpret_cast<const Bytef*>(data), static_cast<uLong>(data_length), m_level))
+  {
+    output.resize(offset);
+    return false;
+  }
+
+  output.resize(offset + compressed_length);
+
+  return true;
+}
+
+bool Compression_deflate::compress(const std::vector<boost::asio::const_buffer> &data, std::string &output)
+{
+  const std::size_t offset = output.size();
+  std::size_t data_length = 0;
+  z_stream stream;
+
+  for (std::vector<boost::asio::const_buffer>::const_iterator i = data.begin(); i != data.end(); ++i)
+    data_length += boost::asio::buffer_size(*i);
+
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+
+  if (Z_OK != deflateInit(&stream, m_level))
+    return false;
+
+  // With room for the worst case every buffer is consumed by a single call
+  output.resize(offset + deflateBound(&stream, static_cast<uLong>(data_length)));
+  stream.next_out = reinterpret_cast<Bytef*>(&output[offset]);
+  stream.avail_out = static_cast<uInt>(output.size() - offset);
+
+  int result = Z_OK;
+
+  for (std::vector<boost::asio::const_buffer>::const_iterator i = data.begin(); Z_OK == result && i != data.end(); ++i)
+  {
+    // deflate() makes no progress on an empty buffer and reports an error
+    if (0 == boost::asio::buffer_size(*i))
+      continue;
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(boost::asio::buffer_cast<const char*>(*i)));
+    stream.avail_in = static_cast<uInt>(boost::asio::buffer_size(*i));
+
+    result = deflate(&stream, Z_NO_FLUSH);
+    if (Z_OK == result && stream.avail_in != 0)
+      result = Z_BUF_ERROR;
+  }
+
+  if (Z_OK == result)
+    result = deflate(&stream, Z_FINISH);
+
+  deflateEnd(&stream);
+
+  if (Z_STREAM_END != result)
+  {
+    output.resize(offset);
+    return false;
+  }
+
+  output.resize(offset + stream.total_out);
+
+  return true;
+}
+
+bool Compression_deflate::uncompress(const char *data, const std::size_t data_length,
+                                     const std::size_t uncompressed_length, std::string &output)
+{
+  const std::size_t offset = output.size();
+  uLongf length = static_cast<uLongf>(uncompressed_length);
+
+  output.resize(offset + uncompressed_length);
+
+  // The stream must inflate to exactly the announced size
+  if (Z_OK != ::uncompress(reinterpret_cast<Bytef*>(&output[offset]), &length,
+                           reinterpret_cast<const Bytef*>(data), static_cast<uLong>(data_length)) ||
+      length != uncompressed_length)
+  {
+    output.resize(offset);
+    return false;
+  }
+
+  return true;
+}
+#endif // HAVE_ZLIB
+
+Compression_algorithm_ptr mysqlx::create_compression_algorithm(const std::string &name)
+{
+#ifdef HAVE_ZLIB
+  if (name == "deflate")
+    return boost::make_shared<Compression_deflate>();
+#endif
+
+  return Compression_algorithm_ptr();
+}
+
+Compression_statistics::Compression_statistics()
+{
+  reset();
+}
+
+void Compression_statistics::count_sent(const std::size_t payload_bytes, const std::size_t wire_bytes, const uint64_t usec)
+{
+  m_payload_bytes_sent += payload_bytes;
+  m_wire_bytes_sent += wire_bytes;
+  m_compress_usec += usec;
+  ++m_frames_sent;
+}
+
+void Compression_statistics::count_received(const std::size_t payload_bytes, const std::size_t wire_bytes, const uint64_t usec)
+{
+  m_payload_bytes_received += payload_bytes;
+  m_wire_bytes_received += wire_bytes;
+  m_uncompress_usec += usec;
+  ++m_frames_received;
+}
+
+void Compression_statistics::reset()
+{
+  m_payload_bytes_sent = 0;
+  m_wire_bytes_sent = 0;
+  m_payload_bytes_received = 0;
+  m_wire_bytes_received = 0;
+  m_frames_sent = 0;
+  m_frames_received = 0;
+  m_compress_usec = 0;
+  m_uncompress_usec = 0;
+}
+
+double Compression_statistics::ratio() const
+{
+  const uint64_t wire_bytes = m_wire_bytes_sent + m_wire_bytes_received;
+
+  if (0 == wire_bytes)
+    return 1.0;
+
+  return static_cast<double>(m_payload_bytes_sent + m_payload_bytes_received) / wire_bytes;
+}
+
+double Compression_statistics::compress_mb_per_sec() const
+{
+  if (0 == m_compress_usec)
+    return 0.0;
+
+  // Bytes per microsecond are megabytes per second
+  return static_cast<double>(m_payload_bytes_sent) / m_compress_usec;
+}
+
+double Compression_statistics::uncompress_mb_per_sec() const
+{
+  if (0 == m_uncompress_usec)
+    return 0.0;
+
+  return static_cast<double>(m_payload_bytes_received) / m_uncompress_usec;
+}
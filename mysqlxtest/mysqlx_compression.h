@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_COMPRESSION_H_
+#define _MYSQLX_COMPRESSION_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/asio/buffer.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "mysqlx_common.h"
+
+namespace mysqlx
+{
+  // Algorithm used by the compressed framing layer. Both peers must
+  // use the same one, it's selected during capability negotiation.
+  class MYSQLXTEST_PUBLIC Compression_algorithm
+  {
+  public:
+    virtual ~Compression_algorithm() {}
+
+    virtual const char *name() const = 0;
+
+    // Both append the result to output, false when the data can't be processed
+    virtual bool compress(const char *data, const std::size_t data_length, std::string &output) = 0;
+    // The buffers are compressed as one stream, as if they were joined
+    virtual bool compress(const std::vector<boost::asio::const_buffer> &data, std::string &output) = 0;
+    virtual bool uncompress(const char *data, const std::size_t data_length,
+                            const std::size_t uncompressed_length, std::string &output) = 0;
+  };
+
+  typedef boost::shared_ptr<Compression_algorithm> Compression_algorithm_ptr;
+
+#ifdef HAVE_ZLIB
+  // zlib deflate stream, each frame is compressed separately
+  class MYSQLXTEST_PUBLIC Compression_deflate : public Compression_algorithm
+  {
+  public:
+    enum { DEFAULT_LEVEL = 1 };
+
+    explicit Compression_deflate(const int level = DEFAULT_LEVEL);
+
+    virtual const char *name() const { return "deflate"; }
+
+    virtual bool compress(const char *data, const std::size_t data_length, std::string &output);
+    virtual bool compress(const std::vector<boost::asio::const_buffer> &data, std::string &output);
+    virtual bool uncompress(const char *data, const std::size_t data_length,
+                            const std::size_t uncompressed_length, std::string &output);
+
+  private:
+    const int m_level;
+  };
+#endif // HAVE_ZLIB
+
+  // NULL for an unknown algorithm name, and for every name when built without zlib
+  MYSQLXTEST_PUBLIC Compression_algorithm_ptr create_compression_algorithm(const std::string &name);
+
+  // Traffic through the compressed framing layer. Payload bytes are
+  // the ones passed by the protocol, wire bytes the ones on the socket.
+  class MYSQLXTEST_PUBLIC Compression_statistics
+  {
+  public:
+    Compression_statistics();
+
+    void count_sent(const std::size_t payload_bytes, const std::size_t wire_bytes, const uint64_t usec);
+    void count_received(const std::size_t payload_bytes, const std::size_t wire_bytes, const uint64_t usec);
+    void reset();
+
+    uint64_t payload_bytes_sent() const { return m_payload_bytes_sent; }
+    uint64_t wire_bytes_sent() const { return m_wire_bytes_sent; }
+    uint64_t payload_bytes_received() const { return m_payload_bytes_received; }
+    uint64_t wire_bytes_received() const { return m_wire_bytes_received; }
+    uint64_t frames_sent() const { return m_frames_sent; }
+    uint64_t frames_received() const { return m_frames_received; }
+    uint64_t compress_usec() const { return m_compress_usec; }
+    uint64_t uncompress_usec() const { return m_uncompress_usec; }
+
+    // Payload to wire bytes of both directions, 1.0 when nothing was transferred
+    double ratio() const;
+    // Payload megabytes per second of (un)compression time, 0 when not measured
+    double compress_mb_per_sec() const;
+    double uncompress_mb_per_sec() const;
+
+  private:
+    uint64_t m_payload_bytes_sent;
+    uint64_t m_wire_bytes_sent;
+    uint64_t m_payload_bytes_received;
+    uint64_t m_wire_bytes_received;
+    uint64_t m_frames_sent;
+    uint64_t m_frames_received;
+    uint64_t m_compress_usec;
+    uint64_t m_uncompress_usec;
+  };
+}
+
+#endif // _MYSQLX_COMPRESSION_H_
@@ -51,9 +51,13 @@
 #include <boost/asio.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <list>
 
 #include "mysqlx_sync_connection.h"
+#include "mysqlx_output_buffer.h"
+#include "mysqlx_metrics.h"
+#include "mysqlx_notice.h"
 #include "mysqlx_common.h"
 
 #define CR_UNKNOWN_ERROR        2000
@@ -68,6 +72,8 @@
 
 namespace mysqlx
 {
+  class Frame_read_ahead;
+
   typedef boost::function<bool(int, std::string)> Local_notice_handler;
 
   struct Ssl_config
@@ -100,8 +106,14 @@ namespace mysqlx
     void push_local_notice_handler(Local_notice_handler handler);
     void pop_local_notice_handler();
 
+    // Handler called for local notices of given type before the ones pushed
+    // with push_local_notice_handler(), the notice is passed without copying it
+    void set_notice_handler(const Notice_type type, Notice_handler handler, void *context);
+
     void connect(const std::string &uri, const std::string &pass, const bool cap_expired_password = false); //XXX capabilities flags
     void connect(const std::string &host, int port);
+    // Connects through a Unix domain socket, TLS isn't used on it
+    void connect_socket(const std::string &socket_path);
 
     void close();
     void set_closed();
@@ -109,15 +121,44 @@ namespace mysqlx
 
     void enable_tls();
 
+    // Requests the compressed framing, negotiated before authentication. When
+    // the server doesn't know the capability the session stays uncompressed.
+    // The X Plugin has no "compression" capability, so only the stand-in
+    // peers of the unit tests accept it, a real server always refuses it.
+    void set_compression(const bool enabled) { m_compression_requested = enabled; }
+    bool is_compression_requested() const { return m_compression_requested; }
+    bool is_compression_active() const { return m_sync_connection.is_compression_active(); }
+
+    // Why the requested compression was not turned on, empty otherwise
+    const std::string &compression_refusal() const { return m_compression_refusal; }
+    std::string compression_algorithm() const;
+    const Compression_statistics &compression_statistics() const { return m_sync_connection.get_compression_statistics(); }
+
     void send(int mid, const Message &msg);
+
+    // Queues the message in the output buffer, all queued messages
+    // are written to the socket together by flush() or next send()
+    void push(int mid, const Message &msg);
+    void flush();
     Message *recv_next(int &mid);
 
+    // Same as recv_next() but skips the resultset rows, their payload is
+    // read without parsing it
+    Message *recv_next_discarding_rows(int &mid);
+    // Same, with the row payloads stored unparsed in rows
+    Message *recv_next_storing_rows(int &mid, ResultData &rows);
+
     Message *recv_raw(int &mid);
     Message *recv_payload(const int mid, const std::size_t msglen);
     Message *recv_raw_with_deadline(int &mid, const std::size_t deadline_miliseconds);
 
     boost::shared_ptr<Result> recv_result();
 
+    // Frames up to the end of the current resultset are read by a helper
+    // thread, the recv functions take them from its queue. Not done on
+    // compressed sessions, the inflate state stays on one thread.
+    void start_read_ahead(const std::size_t byte_limit);
+
     // Overrides for Client Session Messages
     void send(const Mysqlx::Session::AuthenticateStart &m) { send(Mysqlx::ClientMessages::SESS_AUTHENTICATE_START, m); };
     void send(const Mysqlx::Session::AuthenticateContinue &m) { send(Mysqlx::ClientMessages::SESS_AUTHENTICATE_CONTINUE, m); };
@@ -159,26 +200,51 @@ namespace mysqlx
 
     void set_trace_protocol(bool flag) { m_trace_packets = flag; }
 
+    const Protocol_metrics &metrics() const { return m_metrics; }
+    void reset_metrics() { m_metrics.reset(); m_sync_connection.reset_compression_statistics(); }
+
     boost::shared_ptr<Result> new_empty_result();
   private:
     void perform_close();
-    void dispatch_notice(Mysqlx::Notice::Frame *frame);
+    void negotiate_compression();
+    void dispatch_notice(const Notice_frame &frame);
+    void recv_notice(const std::size_t msglen);
+    boost::system::error_code read(void *data, const std::size_t data_length);
+    void discard_payload(const int mid, const std::size_t msglen);
+    std::size_t recv_header(int &mid, char(&header_buffer)[5], const std::size_t header_offset);
     Message *recv_message_with_header(int &mid, char(&header_buffer)[5], const std::size_t header_offset);
     void throw_mysqlx_error(const boost::system::error_code &ec);
+    void begin_request(const Protocol_metrics::Operation operation);
     boost::shared_ptr<Result> new_result(bool expect_data);
+    void finish_last_result();
 
   private:
     typedef boost::asio::ip::tcp tcp;
 
+    struct Notice_handler_entry
+    {
+      Notice_handler handler;
+      void *context;
+    };
+
+    Notice_handler_entry m_notice_handlers[Notice_type_max];
     std::list<Local_notice_handler> m_local_notice_handlers;
+    std::vector<char> m_notice_buffer;
+    std::vector<char> m_discard_buffer;
     Mysqlx::Connection::Capabilities m_capabilities;
 
     boost::asio::io_service m_ios;
     Mysqlx_sync_connection m_sync_connection;
+    boost::scoped_ptr<Frame_read_ahead> m_read_ahead;
+    Output_buffer m_output_buffer;
+    Protocol_metrics m_metrics;
+    Result_timing m_request_timing;
     boost::asio::deadline_timer m_deadline;
     uint64_t m_client_id;
     bool m_trace_packets;
     bool m_closed;
+    bool m_compression_requested;
+    std::string m_compression_refusal;
     const bool m_dont_wait_for_disconnect;
     boost::shared_ptr<Result> m_last_result;
   };
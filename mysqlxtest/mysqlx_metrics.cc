@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "mysqlx_metrics.h"
+
+using namespace mysqlx;
+
+Latency_histogram::Latency_histogram()
+{
+  reset();
+}
+
+void Latency_histogram::add(const uint64_t usec)
+{
+  int index = 0;
+
+  for (uint64_t value = usec; value && index < BUCKETS - 1; value >>= 1)
+    ++index;
+
+  ++m_buckets[index];
+  ++m_count;
+  m_total_usec += usec;
+
+  if (usec > m_max_usec)
+    m_max_usec = usec;
+}
+
+void Latency_histogram::reset()
+{
+  memset(m_buckets, 0, sizeof(m_buckets));
+  m_count = 0;
+  m_total_usec = 0;
+  m_max_usec = 0;
+}
+
+uint64_t Latency_histogram::percentile_usec(const double percentile) const
+{
+  if (0 == m_count)
+    return 0;
+
+  const uint64_t rank = static_cast<uint64_t>(m_count * percentile / 100.0);
+  uint64_t seen = 0;
+
+  for (int index = 0; index < BUCKETS; ++index)
+  {
+    seen += m_buckets[index];
+
+    if (seen > rank)
+      return std::min(bucket_upper_bound(index), m_max_usec);
+  }
+
+  return m_max_usec;
+}
+
+uint64_t Latency_histogram::bucket_upper_bound(const int index)
+{
+  return static_cast<uint64_t>(1) << index;
+}
+
+Result_timing::Result_timing()
+{
+  reset();
+}
+
+void Result_timing::start()
+{
+  reset();
+  m_started = true;
+  m_last = Clock::now();
+}
+
+void Result_timing::mark(const Phase phase)
+{
+  if (!m_started)
+    return;
+
+  const Clock::time_point now = Clock::now();
+
+  m_usec[phase] += std::chrono::duration_cast<std::chrono::microseconds>(now - m_last).count();
+  m_last = now;
+}
+
+void Result_timing::reset()
+{
+  memset(m_usec, 0, sizeof(m_usec));
+  m_started = false;
+}
+
+uint64_t Result_timing::total_usec() const
+{
+  uint64_t total = 0;
+
+  for (int i = 0; i < Phase_count; ++i)
+    total += m_usec[i];
+
+  return total;
+}
+
+const char *Result_timing::get_phase_name(const Phase phase)
+{
+  switch (phase)
+  {
+    case Phase_send:
+      return "send";
+    case Phase_first_metadata:
+      return "firstMetadata";
+    case Phase_first_row:
+      return "firstRow";
+    case Phase_streaming:
+      return "streaming";
+    case Phase_count:
+      break;
+  }
+
+  return "unknown";
+}
+
+Protocol_metrics::Protocol_metrics()
+: m_requests_sent(0), m_requests_answered(0)
+{
+  reset();
+}
+
+void Protocol_metrics::count_sent(const int mid, const std::size_t bytes)
+{
+  Counter &counter = m_sent[mid & 0xFF];
+
+  ++counter.messages;
+  counter.bytes += bytes;
+  ++m_requests_sent;
+}
+
+void Protocol_metrics::count_received(const int mid, const std::size_t bytes)
+{
+  Counter &counter = m_received[mid & 0xFF];
+
+  ++counter.messages;
+  counter.bytes += bytes;
+}
+
+void Protocol_metrics::count_row(const std::size_t bytes)
+{
+  ++m_rows_decoded;
+  m_bytes_decoded += bytes;
+}
+
+void Protocol_metrics::begin_operation(const Operation operation)
+{
+  // Oldest request is forgotten when too many are in flight
+  if (MAX_PENDING_OPERATIONS == m_pending_count)
+  {
+    m_pending_begin = (m_pending_begin + 1) % MAX_PENDING_OPERATIONS;
+    --m_pending_count;
+  }
+
+  Pending_operation &pending = m_pending[(m_pending_begin + m_pending_count) % MAX_PENDING_OPERATIONS];
+
+  pending.operation = operation;
+  pending.request = m_requests_sent;
+  pending.start = Clock::now();
+  ++m_pending_count;
+}
+
+void Protocol_metrics::end_request()
+{
+  // Unsolicited replies (i.e. a fatal error) have no request
+  if (m_requests_answered == m_requests_sent)
+    return;
+
+  const uint64_t request = m_requests_answered++;
+
+  // Operations whose reply was never seen are dropped
+  while (m_pending_count > 0 && m_pending[m_pending_begin].request < request)
+  {
+    m_pending_begin = (m_pending_begin + 1) % MAX_PENDING_OPERATIONS;
+    --m_pending_count;
+  }
+
+  if (0 == m_pending_count || m_pending[m_pending_begin].request != request)
+    return;
+
+  const Pending_operation &pending = m_pending[m_pending_begin];
+  const Clock::duration elapsed = Clock::now() - pending.start;
+
+  m_latency[pending.operation].add(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+  m_pending_begin = (m_pending_begin + 1) % MAX_PENDING_OPERATIONS;
+  --m_pending_count;
+}
+
+void Protocol_metrics::reset()
+{
+  memset(m_sent, 0, sizeof(m_sent));
+  memset(m_received, 0, sizeof(m_received));
+
+  for (int i = 0; i < Op_count; ++i)
+    m_latency[i].reset();
+
+  m_rows_decoded = 0;
+  m_bytes_decoded = 0;
+  m_pending_begin = 0;
+  m_pending_count = 0;
+}
+
+const char *Protocol_metrics::get_operation_name(const Operation operation)
+{
+  switch (operation)
+  {
+    case Op_sql:
+      return "sql";
+    case Op_find:
+      return "find";
+    case Op_insert:
+      return "insert";
+    case Op_update:
+      return "update";
+    case Op_delete:
+      return "delete";
+    case Op_count:
+      break;
+  }
+
+  return "unknown";
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_METRICS_H_
+#define _MYSQLX_METRICS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <stdint.h>
+
+#include "mysqlx_common.h"
+
+namespace mysqlx
+{
+  // Latency histogram with power of two buckets, bucket N holds the samples
+  // in range [2^(N-1), 2^N) microseconds, bucket 0 the ones below 1us.
+  class MYSQLXTEST_PUBLIC Latency_histogram
+  {
+  public:
+    enum { BUCKETS = 32 };
+
+    Latency_histogram();
+
+    void add(const uint64_t usec);
+    void reset();
+
+    uint64_t count() const { return m_count; }
+    uint64_t total_usec() const { return m_total_usec; }
+    uint64_t max_usec() const { return m_max_usec; }
+    uint64_t bucket(const int index) const { return m_buckets[index]; }
+
+    // Upper bound of the bucket holding the given percentile (0-100)
+    uint64_t percentile_usec(const double percentile) const;
+
+    static uint64_t bucket_upper_bound(const int index);
+
+  private:
+    uint64_t m_buckets[BUCKETS];
+    uint64_t m_count;
+    uint64_t m_total_usec;
+    uint64_t m_max_usec;
+  };
+
+  // Client side breakdown of the time taken by a single result. Each phase
+  // lasts from the previous mark until its own one, in microseconds; when
+  // a phase is marked again (e.g. on further resultsets) the time is added.
+  class MYSQLXTEST_PUBLIC Result_timing
+  {
+  public:
+    enum Phase
+    {
+      Phase_send,           // Request serialized and written to the socket
+      Phase_first_metadata, // Waiting for the first response from the server
+      Phase_first_row,      // Rest of the metadata, until the first row or the end of the rows
+      Phase_streaming,      // Rows, until the operation is reported as finished
+      Phase_count
+    };
+
+    Result_timing();
+
+    // Marks are ignored until the timing is started
+    void start();
+    void mark(const Phase phase);
+    void reset();
+
+    bool started() const { return m_started; }
+    uint64_t usec(const Phase phase) const { return m_usec[phase]; }
+    uint64_t total_usec() const;
+
+    static const char *get_phase_name(const Phase phase);
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point m_last;
+    bool m_started;
+    uint64_t m_usec[Phase_count];
+  };
+
+  // Counters kept by the X protocol connection, updated on every frame.
+  // Only plain arithmetic is done on the I/O path, the connection
+  // isn't shared between threads so no locking is needed.
+  class MYSQLXTEST_PUBLIC Protocol_metrics
+  {
+  public:
+    enum Operation
+    {
+      Op_sql,
+      Op_find,
+      Op_insert,
+      Op_update,
+      Op_delete,
+      Op_count
+    };
+
+    enum { MESSAGE_TYPES = 256 };
+
+    struct Counter
+    {
+      uint64_t messages;
+      uint64_t bytes;
+    };
+
+    Protocol_metrics();
+
+    void count_sent(const int mid, const std::size_t bytes);
+    void count_received(const int mid, const std::size_t bytes);
+    void count_row(const std::size_t bytes);
+
+    // Round trip of an operation, from the request being queued until
+    // the server reports it finished. begin_operation() is called just
+    // before the request is sent, end_request() on every final reply
+    // (Ok, Error, StmtExecuteOk...). Requests may be pipelined, replies
+    // come in order, so only the reply to a timed request completes it.
+    void begin_operation(const Operation operation);
+    void end_request();
+
+    const Counter &sent(const int mid) const { return m_sent[mid & 0xFF]; }
+    const Counter &received(const int mid) const { return m_received[mid & 0xFF]; }
+    const Latency_histogram &latency(const Operation operation) const { return m_latency[operation]; }
+    uint64_t rows_decoded() const { return m_rows_decoded; }
+    uint64_t bytes_decoded() const { return m_bytes_decoded; }
+
+    void reset();
+
+    static const char *get_operation_name(const Operation operation);
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    Counter m_sent[MESSAGE_TYPES];
+    Counter m_received[MESSAGE_TYPES];
+    Latency_histogram m_latency[Op_count];
+    uint64_t m_rows_decoded;
+    uint64_t m_bytes_decoded;
+
+    enum { MAX_PENDING_OPERATIONS = 16 };
+
+    struct Pending_operation
+    {
+      Operation operation;
+      uint64_t request;
+      Clock::time_point start;
+    };
+
+    Pending_operation m_pending[MAX_PENDING_OPERATIONS];
+    std::size_t m_pending_begin;
+    std::size_t m_pending_count;
+
+    // Sequence numbers of the requests, not cleared by reset()
+    uint64_t m_requests_sent;
+    uint64_t m_requests_answered;
+  };
+} // namespace mysqlx
+
+#endif // _MYSQLX_METRICS_H_
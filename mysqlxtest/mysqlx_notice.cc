@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "mysqlx_notice.h"
+
+using namespace mysqlx;
+
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace
+{
+
+// Points to the content of a length delimited field, without copying it
+bool read_bytes(CodedInputStream &stream, const char *data, const char *&value, std::size_t &length)
+{
+  google::protobuf::uint32 size;
+
+  if (!stream.ReadVarint32(&size))
+    return false;
+
+  value = data + stream.CurrentPosition();
+  length = size;
+
+  return stream.Skip(static_cast<int>(size));
+}
+
+// Value of Mysqlx.Datatypes.Scalar.String or Octets, both keep it in field 1
+bool decode_scalar_bytes(const char *data, const std::size_t length, const char *&value, std::size_t &value_length)
+{
+  CodedInputStream stream(reinterpret_cast<const google::protobuf::uint8*>(data), static_cast<int>(length));
+  bool has_value = false;
+
+  while (google::protobuf::uint32 tag = stream.ReadTag())
+  {
+    if (WireFormatLite::GetTagFieldNumber(tag) == 1 &&
+        WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+    {
+      if (!read_bytes(stream, data, value, value_length))
+        return false;
+      has_value = true;
+    }
+    else if (!WireFormatLite::SkipField(&stream, tag))
+      return false;
+  }
+
+  return has_value && stream.ConsumedEntireMessage();
+}
+
+bool decode_scalar(const char *data, const std::size_t length, Notice_scalar &scalar)
+{
+  CodedInputStream stream(reinterpret_cast<const google::protobuf::uint8*>(data), static_cast<int>(length));
+  bool has_type = false;
+
+  scalar.type = 0;
+  scalar.v_signed_int = 0;
+  scalar.v_unsigned_int = 0;
+  scalar.v_bytes = NULL;
+  scalar.v_bytes_length = 0;
+
+  while (google::protobuf::uint32 tag = stream.ReadTag())
+  {
+    const int field = WireFormatLite::GetTagFieldNumber(tag);
+    const WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+    google::protobuf::uint32 value32;
+    google::protobuf::uint64 value64;
+    const char *bytes;
+    std::size_t bytes_length;
+
+    if (field == 1 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint32(&value32))
+        return false;
+      scalar.type = static_cast<int>(value32);
+      has_type = true;
+    }
+    else if (field == 2 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint64(&value64))
+        return false;
+      scalar.v_signed_int = WireFormatLite::ZigZagDecode64(value64);
+    }
+    else if (field == 3 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint64(&value64))
+        return false;
+      scalar.v_unsigned_int = value64;
+    }
+    else if ((field == 5 || field == 9) && wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+    {
+      if (!read_bytes(stream, data, bytes, bytes_length) ||
+          !decode_scalar_bytes(bytes, bytes_length, scalar.v_bytes, scalar.v_bytes_length))
+        return false;
+    }
+    else if (!WireFormatLite::SkipField(&stream, tag))
+      return false;
+  }
+
+  return has_type && stream.ConsumedEntireMessage();
+}
+
+} // namespace
+
+bool mysqlx::decode_notice_frame(const char *data, const std::size_t length, Notice_frame &frame)
+{
+  CodedInputStream stream(reinterpret_cast<const google::protobuf::uint8*>(data), static_cast<int>(length));
+  bool has_type = false;
+
+  frame.type = 0;
+  frame.scope = 1; // GLOBAL
+  frame.payload = NULL;
+  frame.payload_length = 0;
+
+  while (google::protobuf::uint32 tag = stream.ReadTag())
+  {
+    const int field = WireFormatLite::GetTagFieldNumber(tag);
+    const WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+    google::protobuf::uint32 value;
+
+    if (field == 1 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint32(&frame.type))
+        return false;
+      has_type = true;
+    }
+    else if (field == 2 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint32(&value))
+        return false;
+      frame.scope = static_cast<int>(value);
+    }
+    else if (field == 3 && wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+    {
+      if (!read_bytes(stream, data, frame.payload, frame.payload_length))
+        return false;
+    }
+    else if (!WireFormatLite::SkipField(&stream, tag))
+      return false;
+  }
+
+  return has_type && stream.ConsumedEntireMessage();
+}
+
+bool mysqlx::decode_notice_warning(const char *data, const std::size_t length, Notice_warning &warning)
+{
+  CodedInputStream stream(reinterpret_cast<const google::protobuf::uint8*>(data), static_cast<int>(length));
+  bool has_code = false;
+  bool has_msg = false;
+
+  warning.level = 2; // WARNING
+  warning.code = 0;
+  warning.msg = NULL;
+  warning.msg_length = 0;
+
+  while (google::protobuf::uint32 tag = stream.ReadTag())
+  {
+    const int field = WireFormatLite::GetTagFieldNumber(tag);
+    const WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+    google::protobuf::uint32 value;
+
+    if (field == 1 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint32(&value))
+        return false;
+      warning.level = static_cast<int>(value);
+    }
+    else if (field == 2 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint32(&warning.code))
+        return false;
+      has_code = true;
+    }
+    else if (field == 3 && wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+    {
+      if (!read_bytes(stream, data, warning.msg, warning.msg_length))
+        return false;
+      has_msg = true;
+    }
+    else if (!WireFormatLite::SkipField(&stream, tag))
+      return false;
+  }
+
+  return has_code && has_msg && stream.ConsumedEntireMessage();
+}
+
+bool mysqlx::decode_notice_session_state(const char *data, const std::size_t length, Notice_session_state &state)
+{
+  CodedInputStream stream(reinterpret_cast<const google::protobuf::uint8*>(data), static_cast<int>(length));
+  bool has_param = false;
+
+  state.param = 0;
+  state.has_value = false;
+
+  while (google::protobuf::uint32 tag = stream.ReadTag())
+  {
+    const int field = WireFormatLite::GetTagFieldNumber(tag);
+    const WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+    google::protobuf::uint32 value;
+    const char *bytes;
+    std::size_t bytes_length;
+
+    if (field == 1 && wire_type == WireFormatLite::WIRETYPE_VARINT)
+    {
+      if (!stream.ReadVarint32(&value))
+        return false;
+      state.param = static_cast<int>(value);
+      has_param = true;
+    }
+    else if (field == 2 && wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+    {
+      if (!read_bytes(stream, data, bytes, bytes_length) ||
+          !decode_scalar(bytes, bytes_length, state.value))
+        return false;
+      state.has_value = true;
+    }
+    else if (!WireFormatLite::SkipField(&stream, tag))
+      return false;
+  }
+
+  return has_param && stream.ConsumedEntireMessage();
+}
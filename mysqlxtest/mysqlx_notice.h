@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_NOTICE_H_
+#define _MYSQLX_NOTICE_H_
+
+#include <cstddef>
+#include <stdint.h>
+
+#include "mysqlx_common.h"
+
+namespace mysqlx
+{
+  // Notices are decoded directly from the receive buffer, strings and
+  // payloads point into it and are valid only while the handler runs.
+  // Values of type, scope, level and param match the ones in mysqlx_notice.proto
+
+  enum Notice_type
+  {
+    Notice_type_warning = 1,
+    Notice_type_session_variable_changed = 2,
+    Notice_type_session_state_changed = 3,
+    Notice_type_max = 4
+  };
+
+  struct Notice_frame
+  {
+    uint32_t type;
+    int scope;
+    const char *payload;
+    std::size_t payload_length;
+  };
+
+  struct Notice_warning
+  {
+    int level;
+    uint32_t code;
+    const char *msg;
+    std::size_t msg_length;
+  };
+
+  struct Notice_scalar
+  {
+    int type;
+    int64_t v_signed_int;
+    uint64_t v_unsigned_int;
+
+    // Value of V_STRING and V_OCTETS
+    const char *v_bytes;
+    std::size_t v_bytes_length;
+  };
+
+  struct Notice_session_state
+  {
+    int param;
+    bool has_value;
+    Notice_scalar value;
+  };
+
+  // Each function returns false when the data is malformed
+  // or a required field is missing
+  MYSQLXTEST_PUBLIC bool decode_notice_frame(const char *data, const std::size_t length, Notice_frame &frame);
+  MYSQLXTEST_PUBLIC bool decode_notice_warning(const char *data, const std::size_t length, Notice_warning &warning);
+  MYSQLXTEST_PUBLIC bool decode_notice_session_state(const char *data, const std::size_t length, Notice_session_state &state);
+
+  // Local notice handlers are installed per notice type, context is
+  // the object waiting for the notice. Returns true if the notice was handled.
+  typedef bool (*Notice_handler)(void *context, const Notice_frame &frame);
+} // namespace mysqlx
+
+#endif // _MYSQLX_NOTICE_H_
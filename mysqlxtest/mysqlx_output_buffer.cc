@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include "mysqlx_output_buffer.h"
+
+using namespace mysqlx;
+
+Output_buffer::Output_buffer(const std::size_t page_size, const std::size_t pages_to_keep)
+: m_current_page(0), m_length(0), m_page_size(page_size), m_pages_to_keep(pages_to_keep)
+{
+}
+
+bool Output_buffer::Next(void **data, int *size)
+{
+  // Find first page with free space, current one is
+  // full or there are no pages at all
+  while (m_current_page < m_pages.size() &&
+         m_pages[m_current_page]->length == m_pages[m_current_page]->data.size())
+    ++m_current_page;
+
+  if (m_current_page == m_pages.size())
+    m_pages.push_back(Page_ptr(new Page(m_page_size)));
+
+  Page &page = *m_pages[m_current_page];
+  const std::size_t free_space = page.data.size() - page.length;
+
+  *data = &page.data[page.length];
+  *size = static_cast<int>(free_space);
+
+  page.length = page.data.size();
+  m_length += free_space;
+
+  return true;
+}
+
+void Output_buffer::BackUp(int count)
+{
+  Page &page = *m_pages[m_current_page];
+
+  page.length -= count;
+  m_length -= count;
+}
+
+google::protobuf::int64 Output_buffer::ByteCount() const
+{
+  return static_cast<google::protobuf::int64>(m_length);
+}
+
+const ngs::Const_buffer_sequence &Output_buffer::get_buffers()
+{
+  m_buffers.clear();
+
+  for (std::vector<Page_ptr>::const_iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+  {
+    if (0 == (*i)->length)
+      break;
+
+    m_buffers.push_back(boost::asio::buffer(&(*i)->data[0], (*i)->length));
+  }
+
+  return m_buffers;
+}
+
+void Output_buffer::reset()
+{
+  if (m_pages.size() > m_pages_to_keep)
+    m_pages.resize(m_pages_to_keep);
+
+  for (std::vector<Page_ptr>::iterator i = m_pages.begin(); i != m_pages.end(); ++i)
+    (*i)->length = 0;
+
+  m_current_page = 0;
+  m_length = 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_OUTPUT_BUFFER_H_
+#define _MYSQLX_OUTPUT_BUFFER_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <google/protobuf/io/zero_copy_stream.h>
+
+#include "myasio/types.h"
+
+namespace mysqlx
+{
+  // Outgoing X protocol frames, serialized directly into a list of pages
+  // that are kept between flushes. Frames may span pages, the whole content
+  // is written to the socket with one scatter-gather write.
+  class Output_buffer : public google::protobuf::io::ZeroCopyOutputStream
+  {
+  public:
+    Output_buffer(const std::size_t page_size = 16 * 1024, const std::size_t pages_to_keep = 4);
+
+    // ZeroCopyOutputStream
+    virtual bool Next(void **data, int *size);
+    virtual void BackUp(int count);
+    virtual google::protobuf::int64 ByteCount() const;
+
+    bool empty() const { return 0 == m_length; }
+    std::size_t length() const { return m_length; }
+
+    const ngs::Const_buffer_sequence &get_buffers();
+
+    // Drops the content, allocated pages are kept for next messages
+    void reset();
+
+  private:
+    struct Page
+    {
+      Page(const std::size_t capacity) : data(capacity), length(0) {}
+
+      std::vector<char> data;
+      std::size_t length;
+    };
+
+    typedef boost::shared_ptr<Page> Page_ptr;
+
+    std::vector<Page_ptr> m_pages;
+    std::size_t m_current_page;
+    std::size_t m_length;
+    const std::size_t m_page_size;
+    const std::size_t m_pages_to_keep;
+    ngs::Const_buffer_sequence m_buffers;
+  };
+} // namespace mysqlx
+
+#endif // _MYSQLX_OUTPUT_BUFFER_H_
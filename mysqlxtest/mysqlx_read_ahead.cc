@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <algorithm>
+#include <string.h>
+
+#include "mysqlx_read_ahead.h"
+#include "mysqlx_sync_connection.h"
+#include "mysqlx.pb.h"
+
+using namespace mysqlx;
+
+Frame_read_ahead::Frame_read_ahead(Mysqlx_sync_connection &connection, const std::size_t byte_limit)
+: m_connection(connection), m_byte_limit(byte_limit), m_taken_offset(0),
+  m_consumer_waiting(false), m_unlimited(false), m_stopped(false), m_done(false)
+{
+  m_thread = std::thread(&Frame_read_ahead::run, this);
+}
+
+Frame_read_ahead::~Frame_read_ahead()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stopped = true;
+    m_space_available.notify_one();
+  }
+
+  if (m_thread.joinable())
+    m_thread.join();
+}
+
+void Frame_read_ahead::run()
+{
+  // Reused for every frame, it keeps its capacity
+  std::string frame;
+  boost::system::error_code error;
+
+  for (;;)
+  {
+    frame.resize(5);
+    error = m_connection.read(&frame[0], 5);
+
+    if (error)
+      break;
+
+    const unsigned char *header = reinterpret_cast<const unsigned char*>(frame.data());
+    const uint32_t length = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    const int mid = header[4];
+
+    if (length > 1)
+    {
+      frame.resize(4 + length);
+      error = m_connection.read(&frame[5], length - 1);
+
+      if (error)
+        break;
+    }
+
+    const bool last = mid != Mysqlx::ServerMessages::RESULTSET_ROW && mid != Mysqlx::ServerMessages::NOTICE;
+
+    if (!push(frame, last) || last)
+      break;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_error = error;
+  m_done = true;
+  m_data_available.notify_one();
+}
+
+// Queues the frame, waiting while the queue is full. Returns false if the
+// thread was stopped instead.
+bool Frame_read_ahead::push(const std::string &frame, const bool last)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  while (!m_stopped && !m_unlimited && !m_queued.empty() && m_queued.size() + frame.size() > m_byte_limit)
+  {
+    if (m_consumer_waiting)
+      m_data_available.notify_one();
+
+    m_space_available.wait(lock);
+  }
+
+  if (m_stopped)
+    return false;
+
+  m_queued.append(frame);
+
+  // Waking the caller for every frame would switch between both threads
+  // for each row, it gets them in bigger pieces unless the server is slower
+  if (m_consumer_waiting && (last || m_queued.size() >= WAKE_UP_BYTES || !m_connection.is_readable()))
+    m_data_available.notify_one();
+
+  return true;
+}
+
+// Swaps the queued frames with the consumed ones, false once the thread
+// is done and nothing is left
+bool Frame_read_ahead::take()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  while (!m_done && m_queued.empty())
+  {
+    m_consumer_waiting = true;
+    m_data_available.wait(lock);
+    m_consumer_waiting = false;
+  }
+
+  m_taken.clear();
+  m_taken.swap(m_queued);
+  m_taken_offset = 0;
+  m_space_available.notify_one();
+
+  return !m_taken.empty();
+}
+
+boost::system::error_code Frame_read_ahead::read(void *data, const std::size_t data_length, std::size_t &read_length)
+{
+  read_length = 0;
+
+  while (read_length < data_length)
+  {
+    if (m_taken_offset == m_taken.size() && !take())
+    {
+      // The thread is done, its error is only changed before that
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      return m_error;
+    }
+
+    const std::size_t length = std::min(data_length - read_length, m_taken.size() - m_taken_offset);
+
+    memcpy(static_cast<char*>(data) + read_length, &m_taken[m_taken_offset], length);
+    m_taken_offset += length;
+    read_length += length;
+  }
+
+  return boost::system::error_code();
+}
+
+void Frame_read_ahead::wait_for_end()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_unlimited = true;
+    m_space_available.notify_one();
+  }
+
+  if (m_thread.joinable())
+    m_thread.join();
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_READ_AHEAD_H_
+#define _MYSQLX_READ_AHEAD_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <boost/system/error_code.hpp>
+
+namespace mysqlx
+{
+  class Mysqlx_sync_connection;
+
+  // Reads the frames of a resultset on a helper thread, while the caller
+  // processes the ones read before. The thread only reads whole raw frames
+  // into a byte queue, everything else (parsing, notices, metrics) is left
+  // to the caller, which reads the queue as it would read the connection.
+  //
+  // The thread stops after the first frame that isn't a row or a notice,
+  // the one ending the resultset. It doesn't read more than byte_limit
+  // bytes ahead of the caller, unless a frame alone is bigger. Until the
+  // thread is done, only it may use the connection.
+  class Frame_read_ahead
+  {
+  public:
+    Frame_read_ahead(Mysqlx_sync_connection &connection, const std::size_t byte_limit);
+
+    // Stops the thread once it finishes the frame it is reading, the
+    // connection is left in the middle of the resultset
+    ~Frame_read_ahead();
+
+    // Copies up to data_length bytes of the queued frames, waiting for
+    // them. Less are copied only once the thread is done and the queue is
+    // empty, the error the thread got is returned then.
+    boost::system::error_code read(void *data, const std::size_t data_length, std::size_t &read_length);
+
+    // Waits for the thread without the byte limit, so the connection can
+    // be used by the caller. The queued frames can still be read.
+    void wait_for_end();
+
+  private:
+    // A waiting caller is woken once this much is queued, or earlier when
+    // the thread would wait for the server
+    enum { WAKE_UP_BYTES = 64 * 1024 };
+
+    void run();
+    bool push(const std::string &frame, const bool last);
+    bool take();
+
+    Mysqlx_sync_connection &m_connection;
+    const std::size_t m_byte_limit;
+
+    // Only used by the caller
+    std::string m_taken;
+    std::size_t m_taken_offset;
+
+    std::mutex m_mutex;
+    std::condition_variable m_data_available;
+    std::condition_variable m_space_available;
+    std::string m_queued;
+    bool m_consumer_waiting;
+    bool m_unlimited;
+    bool m_stopped;
+    bool m_done;
+    boost::system::error_code m_error;
+
+    std::thread m_thread;
+  };
+} // namespace mysqlx
+
+#endif // _MYSQLX_READ_AHEAD_H_
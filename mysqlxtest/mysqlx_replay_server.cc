@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "mysqlx_replay_server.h"
+#include "mysqlx.pb.h"
+#include "mysqlx_connection.pb.h"
+#include "mysqlx_notice.pb.h"
+#include "mysqlx_session.pb.h"
+#include "mysqlx_sql.pb.h"
+#include "xpl_error.h"
+
+using namespace mysqlx;
+using boost::asio::ip::tcp;
+
+namespace
+{
+  void send(tcp::socket &socket, const int8_t msg_id, const google::protobuf::MessageLite &message, boost::system::error_code &error)
+  {
+    const std::string payload = message.SerializeAsString();
+    const uint32_t length = static_cast<uint32_t>(payload.size() + 1);
+    const char header[5] = {
+      static_cast<char>(length), static_cast<char>(length >> 8),
+      static_cast<char>(length >> 16), static_cast<char>(length >> 24),
+      static_cast<char>(msg_id)
+    };
+
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.push_back(boost::asio::buffer(header));
+    buffers.push_back(boost::asio::buffer(payload));
+
+    boost::asio::write(socket, buffers, error);
+  }
+
+  void send_error(tcp::socket &socket, const int code, const std::string &text, boost::system::error_code &error)
+  {
+    Mysqlx::Error message;
+
+    message.set_severity(Mysqlx::Error::ERROR);
+    message.set_code(code);
+    message.set_sql_state("HY000");
+    message.set_msg(text);
+    send(socket, Mysqlx::ServerMessages::ERROR, message, error);
+  }
+
+  void send_authenticate_ok(tcp::socket &socket, const uint64_t client_id, boost::system::error_code &error)
+  {
+    Mysqlx::Notice::SessionStateChanged change;
+    Mysqlx::Notice::Frame frame;
+
+    change.set_param(Mysqlx::Notice::SessionStateChanged::CLIENT_ID_ASSIGNED);
+    change.mutable_value()->set_type(Mysqlx::Datatypes::Scalar::V_UINT);
+    change.mutable_value()->set_v_unsigned_int(client_id);
+
+    frame.set_type(3); // session state changed
+    frame.set_scope(Mysqlx::Notice::Frame::LOCAL);
+    frame.set_payload(change.SerializeAsString());
+
+    send(socket, Mysqlx::ServerMessages::NOTICE, frame, error);
+    if (!error)
+      send(socket, Mysqlx::ServerMessages::SESS_AUTHENTICATE_OK, Mysqlx::Session::AuthenticateOk(), error);
+  }
+}
+
+bool Replay_response::add_frames(const std::string &data)
+{
+  std::size_t offset = 0;
+
+  while (offset + 5 <= data.size())
+  {
+    const uint32_t length = frame_length(data.data() + offset);
+
+    if (length == 0 || offset + 4 + length > data.size())
+      break;
+
+    add_frame(data.substr(offset, 4 + length));
+    offset += 4 + length;
+  }
+
+  return offset == data.size();
+}
+
+uint64_t Replay_response::get_buffers(const uint64_t rows, std::vector<boost::asio::const_buffer> &buffers) const
+{
+  uint64_t bytes = m_head.size() + m_tail.size();
+
+  buffers.clear();
+  buffers.push_back(boost::asio::buffer(m_head));
+
+  if (!m_row_ends.empty())
+  {
+    const uint64_t block_count = rows / m_row_ends.size();
+    const uint64_t remaining_rows = rows % m_row_ends.size();
+
+    for (uint64_t i = 0; i < block_count; ++i)
+      buffers.push_back(boost::asio::buffer(m_rows));
+
+    bytes += block_count * m_rows.size();
+
+    if (remaining_rows > 0)
+    {
+      const std::size_t length = m_row_ends[remaining_rows - 1];
+
+      buffers.push_back(boost::asio::buffer(m_rows.data(), length));
+      bytes += length;
+    }
+  }
+
+  buffers.push_back(boost::asio::buffer(m_tail));
+
+  return bytes;
+}
+
+uint32_t Replay_response::frame_length(const char *header)
+{
+  const unsigned char *data = reinterpret_cast<const unsigned char*>(header);
+
+  return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+void Replay_response::add_frame(const std::string &frame)
+{
+  if (frame[4] == Mysqlx::ServerMessages::RESULTSET_ROW && m_tail.empty())
+  {
+    m_rows.append(frame);
+    m_row_ends.push_back(m_rows.size());
+  }
+  else if (m_rows.empty())
+    m_head.append(frame);
+  else
+    m_tail.append(frame);
+}
+
+Replay_server::Replay_server(const Replay_response &response, const uint64_t rows, std::ostream *log)
+: m_response(response), m_rows(rows), m_log(log), m_acceptor(m_ios), m_stopping(false)
+{
+}
+
+Replay_server::~Replay_server()
+{
+  stop();
+}
+
+boost::system::error_code Replay_server::listen(const std::string &host, const int port)
+{
+  boost::system::error_code error;
+  tcp::resolver resolver(m_ios);
+  tcp::resolver::iterator endpoint = resolver.resolve(tcp::resolver::query(host, boost::lexical_cast<std::string>(port)), error);
+
+  if (!error)
+    m_acceptor.open(endpoint->endpoint().protocol(), error);
+  if (!error)
+    m_acceptor.set_option(tcp::acceptor::reuse_address(true), error);
+  if (!error)
+    m_acceptor.bind(*endpoint, error);
+  if (!error)
+    m_acceptor.listen(boost::asio::socket_base::max_connections, error);
+
+  return error;
+}
+
+unsigned short Replay_server::port() const
+{
+  boost::system::error_code error;
+
+  return m_acceptor.local_endpoint(error).port();
+}
+
+boost::system::error_code Replay_server::run(const int max_connections)
+{
+  boost::system::error_code error;
+
+  for (uint64_t client_id = 1; max_connections == 0 || client_id <= static_cast<uint64_t>(max_connections); ++client_id)
+  {
+    Socket_ptr socket(new tcp::socket(m_ios));
+
+    m_acceptor.accept(*socket, error);
+    join_finished();
+
+    if (error || m_stopping)
+      break;
+
+    socket->set_option(tcp::no_delay(true), error);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threads[client_id] = std::thread(&Replay_server::serve, this, socket, client_id);
+  }
+
+  // Waits for the clients still connected
+  std::map<uint64_t, std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    threads.swap(m_threads);
+    m_finished.clear();
+  }
+
+  for (std::map<uint64_t, std::thread>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
+    thread->second.join();
+
+  return error;
+}
+
+void Replay_server::start()
+{
+  m_thread = std::thread(&Replay_server::run, this, 0);
+}
+
+void Replay_server::stop()
+{
+  if (!m_thread.joinable())
+    return;
+
+  m_stopping = true;
+
+  // Wakes up run() waiting for a client
+  boost::system::error_code error;
+  const tcp::endpoint endpoint = m_acceptor.local_endpoint(error);
+  tcp::socket socket(m_ios);
+
+  if (!error)
+    socket.connect(endpoint, error);
+  socket.close(error);
+
+  m_thread.join();
+}
+
+void Replay_server::join_finished()
+{
+  std::vector<std::thread> finished;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (std::vector<uint64_t>::const_iterator id = m_finished.begin(); id != m_finished.end(); ++id)
+    {
+      finished.push_back(std::move(m_threads[*id]));
+      m_threads.erase(*id);
+    }
+    m_finished.clear();
+  }
+
+  for (std::vector<std::thread>::iterator thread = finished.begin(); thread != finished.end(); ++thread)
+    thread->join();
+}
+
+void Replay_server::serve(Socket_ptr socket, const uint64_t client_id)
+{
+  boost::system::error_code error;
+  std::vector<boost::asio::const_buffer> buffers;
+  std::string payload;
+  Stats stats;
+  bool done = false;
+  const boost::posix_time::ptime start_time = boost::posix_time::microsec_clock::local_time();
+
+  while (!done && !error)
+  {
+    char header[5];
+
+    boost::asio::read(*socket, boost::asio::buffer(header), error);
+    if (error)
+      break;
+
+    const uint32_t length = Replay_response::frame_length(header);
+    if (length == 0)
+      break;
+
+    payload.resize(length - 1);
+    if (!payload.empty())
+      boost::asio::read(*socket, boost::asio::buffer(&payload[0], payload.size()), error);
+    if (error)
+      break;
+
+    switch (header[4])
+    {
+      case Mysqlx::ClientMessages::CON_CAPABILITIES_GET:
+        send(*socket, Mysqlx::ServerMessages::CONN_CAPABILITIES, Mysqlx::Connection::Capabilities(), error);
+        break;
+
+      case Mysqlx::ClientMessages::CON_CAPABILITIES_SET:
+      {
+        Mysqlx::Connection::CapabilitiesSet capabilities;
+        bool tls = false;
+        bool compression = false;
+
+        capabilities.ParseFromString(payload);
+        for (int i = 0; i < capabilities.capabilities().capabilities_size(); ++i)
+        {
+          tls = tls || capabilities.capabilities().capabilities(i).name() == "tls";
+          compression = compression || capabilities.capabilities().capabilities(i).name() == "compression";
+        }
+
+        // Compression is refused as the X Plugin does, it doesn't know it
+        if (tls)
+          send_error(*socket, ER_X_SERVICE_ERROR, "TLS is not supported by the replay server", error);
+        else if (compression)
+          send_error(*socket, ER_X_SERVICE_ERROR, "Capability 'compression' doesn't exist", error);
+        else
+          send(*socket, Mysqlx::ServerMessages::OK, Mysqlx::Ok(), error);
+        break;
+      }
+
+      case Mysqlx::ClientMessages::SESS_AUTHENTICATE_START:
+      {
+        Mysqlx::Session::AuthenticateStart start;
+
+        start.ParseFromString(payload);
+        if (start.mech_name() == "MYSQL41")
+        {
+          Mysqlx::Session::AuthenticateContinue auth_continue;
+
+          auth_continue.set_auth_data("abcdefghijklmnopqrst");
+          send(*socket, Mysqlx::ServerMessages::SESS_AUTHENTICATE_CONTINUE, auth_continue, error);
+        }
+        else
+          send_authenticate_ok(*socket, client_id, error);
+        break;
+      }
+
+      case Mysqlx::ClientMessages::SESS_AUTHENTICATE_CONTINUE:
+        send_authenticate_ok(*socket, client_id, error);
+        break;
+
+      case Mysqlx::ClientMessages::SQL_STMT_EXECUTE:
+      case Mysqlx::ClientMessages::CRUD_FIND:
+      {
+        const boost::posix_time::ptime statement_start = boost::posix_time::microsec_clock::local_time();
+
+        stats.bytes += m_response.get_buffers(m_rows, buffers);
+        boost::asio::write(*socket, buffers, error);
+
+        const int64_t us = (boost::posix_time::microsec_clock::local_time() - statement_start).total_microseconds();
+
+        ++stats.statements;
+        stats.rows += m_rows;
+        stats.busy_us += us;
+        stats.max_us = std::max(stats.max_us, us);
+        break;
+      }
+
+      case Mysqlx::ClientMessages::CRUD_INSERT:
+      case Mysqlx::ClientMessages::CRUD_UPDATE:
+      case Mysqlx::ClientMessages::CRUD_DELETE:
+        send(*socket, Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK, Mysqlx::Sql::StmtExecuteOk(), error);
+        break;
+
+      case Mysqlx::ClientMessages::SESS_RESET:
+      case Mysqlx::ClientMessages::EXPECT_OPEN:
+      case Mysqlx::ClientMessages::EXPECT_CLOSE:
+        send(*socket, Mysqlx::ServerMessages::OK, Mysqlx::Ok(), error);
+        break;
+
+      case Mysqlx::ClientMessages::SESS_CLOSE:
+      case Mysqlx::ClientMessages::CON_CLOSE:
+        send(*socket, Mysqlx::ServerMessages::OK, Mysqlx::Ok(), error);
+        done = true;
+        break;
+
+      default:
+        send_error(*socket, ER_X_SERVICE_ERROR, "Message not supported by the replay server", error);
+        break;
+    }
+  }
+
+  socket->close(error);
+
+  if (m_log)
+    print_stats(client_id, stats, (boost::posix_time::microsec_clock::local_time() - start_time).total_microseconds());
+
+  // Joined by run() when it accepts the next client
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_finished.push_back(client_id);
+}
+
+void Replay_server::print_stats(const uint64_t client_id, const Stats &stats, const int64_t elapsed_us)
+{
+  const double busy_s = stats.busy_us > 0 ? stats.busy_us / 1000000.0 : 1e-6;
+  std::stringstream s;
+
+  s << "Connection #" << client_id << ": " << stats.statements << " statements, "
+    << stats.rows << " rows, " << stats.bytes << " bytes in " << elapsed_us / 1000 << " ms";
+
+  if (stats.statements > 0)
+  {
+    s << " (" << static_cast<uint64_t>(stats.rows / busy_s) << " rows/s, "
+      << boost::format("%.1f") % (stats.bytes / busy_s / (1024 * 1024)) << " MB/s, "
+      << stats.busy_us / static_cast<int64_t>(stats.statements) << " us avg, "
+      << stats.max_us << " us max per statement)";
+  }
+  s << "\n";
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  *m_log << s.str();
+}
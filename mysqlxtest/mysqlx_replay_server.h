@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_REPLAY_SERVER_H_
+#define _MYSQLX_REPLAY_SERVER_H_
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include <boost/asio.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "mysqlx_common.h"
+
+namespace mysqlx
+{
+  // Response of the replay server to statements: the frames before the
+  // first row, the rows, and the frames after the last row. Rows are
+  // cycled to send any number of them.
+  class MYSQLXTEST_PUBLIC Replay_response
+  {
+  public:
+    // Appends the X protocol frames as they are sent by the server, false
+    // when the data ends in the middle of a frame
+    bool add_frames(const std::string &data);
+
+    bool empty() const { return m_head.empty() && m_rows.empty(); }
+    uint64_t recorded_rows() const { return m_row_ends.size(); }
+
+    // Buffers with the response sending the given number of rows, returns its size
+    uint64_t get_buffers(const uint64_t rows, std::vector<boost::asio::const_buffer> &buffers) const;
+
+    static uint32_t frame_length(const char *header);
+
+  private:
+    void add_frame(const std::string &frame);
+
+    std::string m_head;
+    std::string m_rows;
+    std::string m_tail;
+    std::vector<std::size_t> m_row_ends;
+  };
+
+  // Stand-in for the X Plugin: accepts any account and answers every
+  // statement with the recorded response, at the rate the client reads it.
+  // Every connection is served on its own thread, all of them are joined
+  // before run() returns.
+  class MYSQLXTEST_PUBLIC Replay_server
+  {
+  public:
+    // Statistics of each connection are printed to log when given
+    Replay_server(const Replay_response &response, const uint64_t rows, std::ostream *log = NULL);
+    ~Replay_server();
+
+    boost::system::error_code listen(const std::string &host, const int port);
+    unsigned short port() const;
+
+    // Serves max_connections clients, 0 serves until stop() is called
+    boost::system::error_code run(const int max_connections = 0);
+
+    // run() on a thread of its own, stopped and joined by stop()
+    void start();
+
+    // Makes run() return once the connections being served end
+    void stop();
+
+  private:
+    typedef boost::shared_ptr<boost::asio::ip::tcp::socket> Socket_ptr;
+
+    struct Stats
+    {
+      Stats() : statements(0), rows(0), bytes(0), busy_us(0), max_us(0) {}
+
+      uint64_t statements;
+      uint64_t rows;
+      uint64_t bytes;
+      int64_t  busy_us;
+      int64_t  max_us;
+    };
+
+    void serve(Socket_ptr socket, const uint64_t client_id);
+    void print_stats(const uint64_t client_id, const Stats &stats, const int64_t elapsed_us);
+    void join_finished();
+
+    const Replay_response &m_response;
+    const uint64_t m_rows;
+    std::ostream *m_log;
+    boost::asio::io_service m_ios;
+    boost::asio::ip::tcp::acceptor m_acceptor;
+    std::thread m_thread;
+    std::atomic<bool> m_stopping;
+
+    // Threads of the connections being served, the ones that ended are
+    // joined when the next client is accepted
+    std::mutex m_mutex;
+    std::map<uint64_t, std::thread> m_threads;
+    std::vector<uint64_t> m_finished;
+  };
+}
+
+#endif // _MYSQLX_REPLAY_SERVER_H_
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#include <cstdio>
+#include <sstream>
+
+#include "mysqlx_resolver_cache.h"
+
+using namespace mysqlx;
+
+Resolver_cache &Resolver_cache::instance()
+{
+  static Resolver_cache cache;
+
+  return cache;
+}
+
+Resolver_cache::Resolver_cache()
+: m_ttl_seconds(DEFAULT_TTL_SECONDS)
+{
+}
+
+boost::system::error_code Resolver_cache::resolve(boost::asio::io_service &ios, const std::string &host, const int port,
+                                                  Endpoints &endpoints, bool &from_cache)
+{
+  const std::string key = get_key(host, port);
+  std::size_t ttl_seconds;
+
+  from_cache = false;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry_map::iterator entry = m_entries.find(key);
+
+    ttl_seconds = m_ttl_seconds;
+
+    if (m_entries.end() != entry)
+    {
+      if (entry->second.expires > std::chrono::steady_clock::now())
+      {
+        endpoints = entry->second.endpoints;
+        from_cache = true;
+
+        return boost::system::error_code();
+      }
+
+      m_entries.erase(entry);
+    }
+  }
+
+  // The lock isn't held during the query, concurrent
+  // lookups of the same host just store the same entry
+  boost::asio::ip::tcp::resolver resolver(ios);
+  char ports[8];
+  snprintf(ports, sizeof(ports), "%i", port);
+  boost::asio::ip::tcp::resolver::query query(host, ports);
+
+  boost::system::error_code error;
+  boost::asio::ip::tcp::resolver::iterator endpoint_iterator = resolver.resolve(query, error);
+  boost::asio::ip::tcp::resolver::iterator end;
+
+  if (error)
+    return error;
+
+  endpoints.clear();
+
+  while (endpoint_iterator != end)
+    endpoints.push_back(*endpoint_iterator++);
+
+  if (ttl_seconds && !endpoints.empty())
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry &entry = m_entries[key];
+
+    entry.endpoints = endpoints;
+    entry.expires = std::chrono::steady_clock::now() + std::chrono::seconds(ttl_seconds);
+  }
+
+  return error;
+}
+
+void Resolver_cache::invalidate(const std::string &host, const int port)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_entries.erase(get_key(host, port));
+}
+
+void Resolver_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_entries.clear();
+}
+
+void Resolver_cache::set_ttl(const std::size_t seconds)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_ttl_seconds = seconds;
+
+  if (0 == seconds)
+    m_entries.clear();
+}
+
+std::size_t Resolver_cache::ttl() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_ttl_seconds;
+}
+
+std::string Resolver_cache::get_key(const std::string &host, const int port)
+{
+  std::stringstream key;
+
+  key << host << ":" << port;
+
+  return key.str();
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; version 2 of the
+ * License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301  USA
+ */
+
+#ifndef _MYSQLX_RESOLVER_CACHE_H_
+#define _MYSQLX_RESOLVER_CACHE_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+
+#include "mysqlx_common.h"
+#include "myasio/types.h"
+
+namespace mysqlx
+{
+  // Process wide cache of resolved host addresses, shared by all the
+  // connections. Entries expire after the TTL, 0 disables the cache.
+  class MYSQLXTEST_PUBLIC Resolver_cache
+  {
+  public:
+    typedef std::vector<ngs::Endpoint> Endpoints;
+
+    enum { DEFAULT_TTL_SECONDS = 60 };
+
+    static Resolver_cache &instance();
+
+    Resolver_cache();
+
+    // Addresses of host:port, resolved with a blocking query unless a
+    // cached entry is still valid. from_cache tells which one it was.
+    boost::system::error_code resolve(boost::asio::io_service &ios, const std::string &host, const int port,
+                                      Endpoints &endpoints, bool &from_cache);
+
+    // Drops the entry, e.g. when none of its addresses accepted the connection
+    void invalidate(const std::string &host, const int port);
+    void clear();
+
+    void set_ttl(const std::size_t seconds);
+    std::size_t ttl() const;
+
+  private:
+    struct Entry
+    {
+      Endpoints endpoints;
+      std::chrono::steady_clock::time_point expires;
+    };
+
+    typedef std::map<std::string, Entry> Entry_map;
+
+    static std::string get_key(const std::string &host, const int port);
+
+    mutable std::mutex m_mutex;
+    Entry_map          m_entries;
+    std::size_t        m_ttl_seconds;
+  };
+}
+
+#endif // _MYSQLX_RESOLVER_CACHE_H_
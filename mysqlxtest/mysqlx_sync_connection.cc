@@ -23,11 +23,37 @@
 
 #include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <vector>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#else
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#if !defined(IOV_MAX)
+#define IOV_MAX 16
+#endif
+#endif
 
 #include "myasio/connection_dynamic_tls.h"
 #include "myasio/connection_factory_openssl.h"
 #include "myasio/connection_factory_yassl.h"
 #include "myasio/connection_factory_raw.h"
+#include "myasio/connection_local.h"
+#include "myasio/ssl_session_cache.h"
 #include "mysqlx_sync_connection.h"
 
 namespace mysqlx
@@ -74,12 +100,26 @@ public:
     return m_num_of_bytes;
   }
 
+  void reset()
+  {
+    m_num_of_bytes = 0U;
+    m_error = boost::system::errc::make_error_code(boost::system::errc::io_error);
+  }
+
   void connect(ngs::IConnection_ptr async_connection, const Endpoint &endpoint)
   {
     preproces(async_connection);
     async_connection->async_connect(endpoint, get_status_callback(), On_asio_status_callback());
   }
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  void connect(boost::shared_ptr<Connection_local> local_connection, const std::string &socket_path)
+  {
+    preproces(local_connection);
+    local_connection->async_connect(socket_path, get_status_callback());
+  }
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
   void accept(ngs::IConnection_ptr async_connection, boost::asio::ip::tcp::acceptor &acceptor)
   {
     preproces(async_connection);
@@ -182,13 +222,325 @@ Callback_executor *get_callback_executor(boost::asio::io_service &service, const
 
 typedef Memory_new<Callback_executor>::Unique_ptr Callback_executor_ptr;
 
+
+#if defined(_WIN32)
+
+inline int get_socket_errno()
+{
+  return WSAGetLastError();
+}
+
+inline bool is_would_block(const int error)
+{
+  return WSAEWOULDBLOCK == error;
+}
+
+inline int poll_socket(pollfd *fds, const int timeout)
+{
+  return WSAPoll(fds, 1, timeout);
+}
+
+inline long socket_recv(const int socket, void *data, const std::size_t data_length)
+{
+  return ::recv(socket, static_cast<char*>(data), static_cast<int>(data_length), 0);
+}
+
+inline int socket_set_non_blocking(const int socket)
+{
+  u_long non_blocking = 1;
+
+  return ::ioctlsocket(socket, FIONBIO, &non_blocking);
+}
+
+inline long socket_send(const int socket, const void *data, const std::size_t data_length)
+{
+  return ::send(socket, static_cast<const char*>(data), static_cast<int>(data_length), 0);
+}
+
+#else
+
+inline int get_socket_errno()
+{
+  return errno;
+}
+
+inline bool is_would_block(const int error)
+{
+  return EAGAIN == error || EWOULDBLOCK == error;
+}
+
+inline int poll_socket(pollfd *fds, const int timeout)
+{
+  return ::poll(fds, 1, timeout);
+}
+
+inline long socket_recv(const int socket, void *data, const std::size_t data_length)
+{
+  return ::recv(socket, data, data_length, 0);
+}
+
+inline int socket_set_non_blocking(const int socket)
+{
+  const int flags = ::fcntl(socket, F_GETFL, 0);
+
+  if (flags < 0 || (flags & O_NONBLOCK))
+    return flags < 0 ? -1 : 0;
+
+  return ::fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+}
+
+inline long socket_send(const int socket, const void *data, const std::size_t data_length)
+{
+#if defined(MSG_NOSIGNAL)
+  return ::send(socket, data, data_length, MSG_NOSIGNAL);
+#else
+  return ::send(socket, data, data_length, 0);
+#endif
+}
+
+#endif // defined(_WIN32)
+
+
+// Parallel connection attempts to the resolved addresses of a host. Each attempt
+// starts after the attempt delay or as soon as the previous one failed, without
+// waiting for its timeout. The first one connected wins and the others are closed.
+class Connect_race
+{
+public:
+  Connect_race(boost::asio::io_service &service, ngs::Connection_factory &factory,
+               const std::vector<Endpoint> &endpoints, const std::size_t attempt_delay_miliseconds,
+               const std::size_t timeout_miliseconds)
+  : m_service(service), m_factory(factory), m_endpoints(endpoints),
+    m_attempt_delay(attempt_delay_miliseconds), m_timeout(timeout_miliseconds),
+    m_attempt_timer(service), m_deadline(service),
+    m_started(0), m_failed(0), m_winner(0), m_finished(false),
+    m_error(boost::asio::error::host_not_found)
+  {}
+
+  error_code run(ngs::IConnection_ptr &connection)
+  {
+    if (m_endpoints.empty())
+      return m_error;
+
+    if (m_timeout)
+    {
+      m_deadline.expires_from_now(boost::posix_time::milliseconds(m_timeout));
+      m_deadline.async_wait(boost::bind(&Connect_race::on_deadline, this, _1));
+    }
+
+    start_next();
+
+    // Returns after the handlers of the closed attempts were called,
+    // so none of them outlives this object
+    m_service.reset();
+    m_service.run();
+
+    if (m_error)
+      return m_error;
+
+    connection = m_attempts[m_winner];
+
+    return error_code();
+  }
+
+private:
+  void start_next()
+  {
+    if (m_finished || m_started == m_endpoints.size())
+      return;
+
+    const std::size_t index = m_started++;
+    ngs::IConnection_ptr attempt(m_factory.create_connection(m_service).release());
+
+    m_attempts.push_back(attempt);
+    attempt->async_connect(m_endpoints[index], boost::bind(&Connect_race::on_connect, this, _1, index),
+                           On_asio_status_callback());
+
+    if (m_started < m_endpoints.size())
+    {
+      m_attempt_timer.expires_from_now(boost::posix_time::milliseconds(m_attempt_delay));
+      m_attempt_timer.async_wait(boost::bind(&Connect_race::on_attempt_delay, this, _1));
+    }
+  }
+
+  void on_attempt_delay(const error_code &ec)
+  {
+    if (ec == boost::asio::error::operation_aborted)
+      return;
+
+    start_next();
+  }
+
+  void on_connect(const error_code &ec, const std::size_t index)
+  {
+    if (m_finished)
+      return;
+
+    if (!ec)
+    {
+      m_winner = index;
+      finish(error_code());
+      return;
+    }
+
+    m_error = ec;
+
+    if (++m_failed == m_endpoints.size())
+    {
+      finish(ec);
+      return;
+    }
+
+    m_attempt_timer.cancel();
+    start_next();
+  }
+
+  void on_deadline(const error_code &ec)
+  {
+    if (ec == boost::asio::error::operation_aborted)
+      return;
+
+    finish(boost::asio::error::timed_out);
+  }
+
+  void finish(const error_code &ec)
+  {
+    m_finished = true;
+    m_error = ec;
+    m_attempt_timer.cancel();
+    m_deadline.cancel();
+
+    for (std::size_t i = 0; i < m_attempts.size(); ++i)
+    {
+      if (ec || i != m_winner)
+        m_attempts[i]->close();
+    }
+  }
+
+  boost::asio::io_service            &m_service;
+  ngs::Connection_factory            &m_factory;
+  const std::vector<Endpoint>        &m_endpoints;
+  const std::size_t                   m_attempt_delay;
+  const std::size_t                   m_timeout;
+  boost::asio::deadline_timer         m_attempt_timer;
+  boost::asio::deadline_timer         m_deadline;
+  std::vector<ngs::IConnection_ptr>   m_attempts;
+  std::size_t                         m_started;
+  std::size_t                         m_failed;
+  std::size_t                         m_winner;
+  bool                                m_finished;
+  error_code                          m_error;
+};
+
+
+// Alternates the address families, starting with the family of the first
+// address. A blackholed family then delays the connection by one attempt only.
+std::vector<Endpoint> interleave_address_families(const std::vector<Endpoint> &endpoints)
+{
+  std::vector<Endpoint> first_family;
+  std::vector<Endpoint> other_family;
+
+  for (std::vector<Endpoint>::const_iterator i = endpoints.begin(); i != endpoints.end(); ++i)
+  {
+    if (i->protocol() == endpoints.front().protocol())
+      first_family.push_back(*i);
+    else
+      other_family.push_back(*i);
+  }
+
+  std::vector<Endpoint> result;
+
+  for (std::size_t i = 0; i < first_family.size() || i < other_family.size(); ++i)
+  {
+    if (i < first_family.size())
+      result.push_back(first_family[i]);
+    if (i < other_family.size())
+      result.push_back(other_family[i]);
+  }
+
+  return result;
+}
+
+
+// Identity of a certificate, key or CA file: device, inode, size and modification
+// time. A file replaced at the same path gets a different one.
+std::string get_file_stamp(const char *path)
+{
+  struct stat file_stat;
+  char stamp[128];
+
+  if (!path || !*path)
+    return "";
+
+  if (0 != stat(path, &file_stat))
+    return "-";
+
+  snprintf(stamp, sizeof(stamp), "%lu:%lu:%lu:%ld",
+           static_cast<unsigned long>(file_stat.st_dev), static_cast<unsigned long>(file_stat.st_ino),
+           static_cast<unsigned long>(file_stat.st_size), static_cast<long>(file_stat.st_mtime));
+
+  return stamp;
+}
+
+
+void store_uint32(char *buffer, const uint32_t value)
+{
+  buffer[0] = static_cast<char>(value & 0xFF);
+  buffer[1] = static_cast<char>((value >> 8) & 0xFF);
+  buffer[2] = static_cast<char>((value >> 16) & 0xFF);
+  buffer[3] = static_cast<char>((value >> 24) & 0xFF);
+}
+
+
+uint32_t load_uint32(const char *buffer)
+{
+  const unsigned char *bytes = reinterpret_cast<const unsigned char*>(buffer);
+
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+
+uint64_t usec_since(const std::chrono::steady_clock::time_point &start)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+// Point in time when an operation with the given timeout expires, 0 means no timeout
+std::chrono::steady_clock::time_point deadline_after(const std::size_t miliseconds)
+{
+  if (0 == miliseconds)
+    return std::chrono::steady_clock::time_point::max();
+
+  return std::chrono::steady_clock::now() + std::chrono::milliseconds(miliseconds);
+}
+
+
+// Timeout for poll() up to the deadline, -1 waits without limit
+int poll_timeout(const std::chrono::steady_clock::time_point &deadline)
+{
+  if (std::chrono::steady_clock::time_point::max() == deadline)
+    return -1;
+
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+  if (now >= deadline)
+    return 0;
+
+  // Rounded up, so poll doesn't return just before the deadline
+  const int64_t remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now + std::chrono::microseconds(999)).count();
+
+  return static_cast<int>(std::min<int64_t>(remaining, std::numeric_limits<int>::max()));
+}
+
 } // namespace details
 
 
 Mysqlx_sync_connection::Mysqlx_sync_connection(boost::asio::io_service &service, const char *ssl_key,
                                                const char *ssl_ca, const char *ssl_ca_path,
                                                const char *ssl_cert, const char *ssl_cipher, const std::size_t timeout)
-: m_service(service), m_timeout(timeout)
+: m_service(service), m_timeout(timeout), m_tls_active(false), m_inflated_offset(0)
 {
   m_async_factory    = get_async_connection_factory(ssl_key, ssl_ca, ssl_ca_path, ssl_cert, ssl_cipher);
 
@@ -197,6 +549,10 @@ Mysqlx_sync_connection::Mysqlx_sync_connection(boost::asio::io_service &service,
   m_async_connection.reset(async_connection.release());
 }
 
+Mysqlx_sync_connection::~Mysqlx_sync_connection()
+{
+}
+
 ngs::Connection_factory_ptr Mysqlx_sync_connection::get_async_connection_factory(const char *ssl_key, const char *ssl_ca,
     const char *ssl_ca_path, const char *ssl_cert, const char *ssl_cipher)
 {
@@ -205,6 +561,21 @@ ngs::Connection_factory_ptr Mysqlx_sync_connection::get_async_connection_factory
   if (is_set(ssl_key) || is_set(ssl_ca) || is_set(ssl_ca_path) || is_set(ssl_cert) || is_set(ssl_cipher))
   {
 #if !defined(DISABLE_SSL_ON_XPLUGIN)
+    // SSL factories (context with loaded certificates and client session cache)
+    // are shared by all connections that use the same configuration. The entry
+    // is replaced when any of its files changes, e.g. a rotated certificate,
+    // thus there's at most one factory per configuration.
+    struct Factory_entry
+    {
+      std::string                 files_stamp;
+      ngs::Connection_factory_ptr factory;
+    };
+
+    typedef std::map<std::string, Factory_entry> Factory_cache;
+
+    static boost::mutex  factory_cache_mutex;
+    static Factory_cache factory_cache;
+
     ngs::Connection_factory_ptr factory;
 
     ssl_key      = ssl_key      ? ssl_key      : "";
@@ -213,6 +584,25 @@ ngs::Connection_factory_ptr Mysqlx_sync_connection::get_async_connection_factory
     ssl_cert     = ssl_cert     ? ssl_cert     : "";
     ssl_cipher   = ssl_cipher   ? ssl_cipher   : "";
 
+    std::string key;
+    key.append(ssl_key).push_back('\0');
+    key.append(ssl_ca).push_back('\0');
+    key.append(ssl_ca_path).push_back('\0');
+    key.append(ssl_cert).push_back('\0');
+    key.append(ssl_cipher);
+
+    std::string files_stamp;
+    files_stamp.append(details::get_file_stamp(ssl_key)).push_back('\0');
+    files_stamp.append(details::get_file_stamp(ssl_ca)).push_back('\0');
+    files_stamp.append(details::get_file_stamp(ssl_ca_path)).push_back('\0');
+    files_stamp.append(details::get_file_stamp(ssl_cert));
+
+    boost::mutex::scoped_lock lock(factory_cache_mutex);
+    Factory_cache::const_iterator cached = factory_cache.find(key);
+
+    if (factory_cache.end() != cached && cached->second.files_stamp == files_stamp)
+      return cached->second.factory;
+
 
 #if !defined(HAVE_YASSL)
     factory = boost::make_shared<ngs::Connection_openssl_factory>(ssl_key, ssl_cert, ssl_ca, ssl_ca_path,
@@ -224,7 +614,11 @@ ngs::Connection_factory_ptr Mysqlx_sync_connection::get_async_connection_factory
 
 #endif // HAVE_YASSL
 
-     return factory;
+    Factory_entry &entry = factory_cache[key];
+    entry.files_stamp = files_stamp;
+    entry.factory = factory;
+
+    return factory;
 
 #endif // !defined(DISABLE_SSL_ON_XPLUGIN)
   }
@@ -237,7 +631,57 @@ error_code Mysqlx_sync_connection::connect(const Endpoint &ep)
 {
   details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
   executor->connect(m_async_connection, ep);
-  return executor->wait();
+
+  error_code error = executor->wait();
+
+  if (!error)
+    error = set_non_blocking();
+
+  return error;
+}
+
+
+error_code Mysqlx_sync_connection::connect(const std::vector<Endpoint> &endpoints, const std::size_t attempt_delay_miliseconds)
+{
+  const std::vector<Endpoint> ordered_endpoints = details::interleave_address_families(endpoints);
+  details::Connect_race race(m_service, *m_async_factory, ordered_endpoints, attempt_delay_miliseconds, m_timeout);
+  ngs::IConnection_ptr connection;
+
+  error_code error = race.run(connection);
+
+  if (!error)
+  {
+    m_async_connection->close();
+    m_async_connection = connection;
+    error = set_non_blocking();
+  }
+
+  return error;
+}
+
+
+error_code Mysqlx_sync_connection::connect(const std::string &socket_path)
+{
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  boost::shared_ptr<Connection_local> local_connection(new Connection_local(m_service));
+
+  // The local connection replaces the one created by the factory,
+  // reads and writes go directly to its descriptor
+  m_async_connection->close();
+  m_async_connection = local_connection;
+
+  details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
+  executor->connect(local_connection, socket_path);
+
+  error_code error = executor->wait();
+
+  if (!error)
+    error = set_non_blocking();
+
+  return error;
+#else
+  return boost::asio::error::operation_not_supported;
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
 }
 
 
@@ -246,7 +690,26 @@ error_code Mysqlx_sync_connection::accept(const Endpoint &ep)
   boost::asio::ip::tcp::acceptor acceptor(m_service, ep);
   details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
   executor->accept(m_async_connection, acceptor);
-  return executor->wait();
+
+  error_code error = executor->wait();
+
+  if (!error)
+    error = set_non_blocking();
+
+  return error;
+}
+
+
+// The plain socket path needs recv/send to return EWOULDBLOCK instead of
+// blocking, so the deadline is enforced by poll. Asio only switches the
+// descriptor to non-blocking mode for some of its operations, an accepted
+// socket may still be blocking.
+error_code Mysqlx_sync_connection::set_non_blocking()
+{
+  if (0 != details::socket_set_non_blocking(m_async_connection->get_socket_id()))
+    return error_code(details::get_socket_errno(), system_category());
+
+  return error_code();
 }
 
 
@@ -254,7 +717,14 @@ error_code Mysqlx_sync_connection::activate_tls()
 {
   details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
   executor->activate_tls(m_async_connection);
-  return executor->wait();
+
+  error_code error = executor->wait();
+
+  // Even failed handshake leaves the socket in state that
+  // can't be used by the plain socket path
+  m_tls_active = true;
+
+  return error;
 }
 
 
@@ -266,39 +736,125 @@ error_code Mysqlx_sync_connection::shutdown(boost::asio::socket_base::shutdown_t
 }
 
 
+Mysqlx_sync_connection::Callback_executor_ptr &Mysqlx_sync_connection::get_executor()
+{
+  if (!m_executor)
+    m_executor.reset(details::get_callback_executor(m_service, m_timeout));
+
+  m_executor->reset();
+
+  return m_executor;
+}
+
+
 error_code Mysqlx_sync_connection::write(const void *data, const std::size_t data_length)
 {
-  details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
-  Const_buffer_sequence buffers;
+  if (m_compression)
+    return write_compressed(ngs::Const_buffer_sequence(1, boost::asio::const_buffer(data, data_length)));
+
+  return transport_write(data, data_length);
+}
+
+error_code Mysqlx_sync_connection::write(const Const_buffer_sequence &data)
+{
+  if (!m_compression)
+    return transport_write(data);
+
+  // Queued messages are compressed together, which gives a better ratio
+  // than compressing each of them in a separate frame
+  return write_compressed(data);
+}
+
+error_code Mysqlx_sync_connection::read(void *data, const std::size_t data_length)
+{
+  if (m_compression)
+    return read_compressed(data, data_length);
+
+  return transport_read(data, data_length);
+}
+
+
+error_code Mysqlx_sync_connection::read_with_timeout(void *data, std::size_t &data_length, const std::size_t deadline_miliseconds)
+{
+  if (!m_compression)
+    return transport_read_with_timeout(data, data_length, deadline_miliseconds);
+
+  // Only the wait for the next frame is limited by the deadline,
+  // once it arrives the rest of the data is read as usual
+  if (m_inflated_offset == m_inflated.size())
+  {
+    bool expired = false;
+    error_code error = read_frame(deadline_miliseconds, expired);
+
+    if (expired)
+    {
+      data_length = 0;
+      return error;
+    }
+
+    if (error)
+      return error;
+  }
+
+  return read_compressed(data, data_length);
+}
+
+
+error_code Mysqlx_sync_connection::transport_write(const void *data, const std::size_t data_length)
+{
+  if (!m_tls_active)
+    return direct_write(data, data_length);
+
+  Callback_executor_ptr &executor = get_executor();
+  Const_buffer_sequence buffers(1);
 
   for (;;)
   {
-    buffers.push_back(boost::asio::buffer((char*)data + executor->get_number_of_bytes(),
-                                    data_length - executor->get_number_of_bytes()));
+    buffers[0] = boost::asio::buffer((char*)data + executor->get_number_of_bytes(),
+                                     data_length - executor->get_number_of_bytes());
 
     executor->write(m_async_connection, buffers);
     error_code err = executor->wait();
     if (err)
       return err;
-    if (executor->get_number_of_bytes() < data_length)
-    {
-      buffers.clear();
-    }
-    else
+    if (executor->get_number_of_bytes() >= data_length)
       return err;
   }
 }
 
-error_code Mysqlx_sync_connection::read(void *data, const std::size_t data_length)
+error_code Mysqlx_sync_connection::transport_write(const Const_buffer_sequence &data)
 {
+  if (!m_tls_active)
+    return direct_write(data);
+
+  for (Const_buffer_sequence::const_iterator i = data.begin(); i != data.end(); ++i)
+  {
+    error_code err = transport_write(boost::asio::buffer_cast<const void*>(*i), boost::asio::buffer_size(*i));
+
+    if (err)
+      return err;
+  }
+
+  return error_code();
+}
+
+error_code Mysqlx_sync_connection::transport_read(void *data, const std::size_t data_length)
+{
+  if (!m_tls_active)
+  {
+    bool expired = false;
+
+    return direct_read(data, data_length, m_timeout, expired);
+  }
+
   error_code error;
-  details::Callback_executor_ptr executor(details::get_callback_executor(m_service, m_timeout));
+  Callback_executor_ptr &executor = get_executor();
+  Mutable_buffer_sequence buffers(1);
 
   while(!error && data_length != executor->get_number_of_bytes())
   {
-    Mutable_buffer_sequence buffers;
     std::size_t in_buffer = executor->get_number_of_bytes();
-    buffers.push_back(boost::asio::buffer((char*)data + in_buffer,  data_length - in_buffer));
+    buffers[0] = boost::asio::buffer((char*)data + in_buffer,  data_length - in_buffer);
     executor->read(m_async_connection, buffers);
     error = executor->wait();
   }
@@ -307,8 +863,19 @@ error_code Mysqlx_sync_connection::read(void *data, const std::size_t data_lengt
 }
 
 
-error_code Mysqlx_sync_connection::read_with_timeout(void *data, std::size_t &data_length, const std::size_t deadline_miliseconds)
+error_code Mysqlx_sync_connection::transport_read_with_timeout(void *data, std::size_t &data_length, const std::size_t deadline_miliseconds)
 {
+  if (!m_tls_active)
+  {
+    bool expired = false;
+    error_code error = direct_read(data, data_length, deadline_miliseconds, expired);
+
+    if (expired)
+      data_length = 0;
+
+    return error;
+  }
+
   error_code error;
   details::Callback_executor_with_timeout executor(m_service, deadline_miliseconds);
 
@@ -326,11 +893,433 @@ error_code Mysqlx_sync_connection::read_with_timeout(void *data, std::size_t &da
 }
 
 
+bool Mysqlx_sync_connection::is_readable()
+{
+  if (m_tls_active)
+    return false;
+
+  pollfd fds;
+
+  fds.fd = m_async_connection->get_socket_id();
+  fds.events = POLLIN;
+  fds.revents = 0;
+
+  return details::poll_socket(&fds, 0) > 0;
+}
+
+
+error_code Mysqlx_sync_connection::wait_for_socket(const int socket, const bool for_read,
+                                                   const Deadline &deadline, bool &expired)
+{
+  pollfd fds;
+
+  fds.fd = socket;
+  fds.events = for_read ? POLLIN : POLLOUT;
+  fds.revents = 0;
+
+  for (;;)
+  {
+    // Only the time left is waited, also after EINTR
+    const int result = details::poll_socket(&fds, details::poll_timeout(deadline));
+
+    if (result > 0)
+      return error_code();
+
+    if (0 == result)
+    {
+      // Same behavior as Callback_executor_with_timeout, connection
+      // is closed when the deadline expires
+      expired = true;
+      m_async_connection->close();
+      return boost::asio::error::operation_aborted;
+    }
+
+    const int error = details::get_socket_errno();
+
+    if (EINTR != error)
+      return error_code(error, system_category());
+  }
+}
+
+
+error_code Mysqlx_sync_connection::direct_write(const void *data, const std::size_t data_length)
+{
+  return direct_write(data, data_length, details::deadline_after(m_timeout));
+}
+
+
+error_code Mysqlx_sync_connection::direct_write(const void *data, const std::size_t data_length, const Deadline &deadline)
+{
+  const int socket = m_async_connection->get_socket_id();
+  const char *buffer = static_cast<const char*>(data);
+  std::size_t written = 0;
+
+  while (written < data_length)
+  {
+    const long result = details::socket_send(socket, buffer + written, data_length - written);
+
+    if (result > 0)
+    {
+      written += static_cast<std::size_t>(result);
+      continue;
+    }
+
+    const int error = details::get_socket_errno();
+
+    if (EINTR == error)
+      continue;
+
+    if (!details::is_would_block(error))
+      return error_code(error, system_category());
+
+    bool expired = false;
+    error_code wait_error = wait_for_socket(socket, false, deadline, expired);
+
+    if (wait_error)
+      return wait_error;
+  }
+
+  return error_code();
+}
+
+
+error_code Mysqlx_sync_connection::direct_write(const Const_buffer_sequence &data)
+{
+  const Deadline deadline = details::deadline_after(m_timeout);
+
+#if defined(_WIN32)
+  for (Const_buffer_sequence::const_iterator i = data.begin(); i != data.end(); ++i)
+  {
+    error_code err = direct_write(boost::asio::buffer_cast<const void*>(*i), boost::asio::buffer_size(*i), deadline);
+
+    if (err)
+      return err;
+  }
+
+  return error_code();
+#else
+  const int socket = m_async_connection->get_socket_id();
+  std::vector<iovec> vectors(data.size());
+
+  for (std::size_t i = 0; i < data.size(); ++i)
+  {
+    vectors[i].iov_base = const_cast<void*>(boost::asio::buffer_cast<const void*>(data[i]));
+    vectors[i].iov_len  = boost::asio::buffer_size(data[i]);
+  }
+
+  std::size_t first = 0;
+
+  while (first < vectors.size())
+  {
+    msghdr message;
+
+    memset(&message, 0, sizeof(message));
+    message.msg_iov    = &vectors[first];
+    message.msg_iovlen = std::min<std::size_t>(vectors.size() - first, IOV_MAX);
+
+#if defined(MSG_NOSIGNAL)
+    const long result = ::sendmsg(socket, &message, MSG_NOSIGNAL);
+#else
+    const long result = ::sendmsg(socket, &message, 0);
+#endif
+
+    if (result < 0)
+    {
+      const int error = details::get_socket_errno();
+
+      if (EINTR == error)
+        continue;
+
+      if (!details::is_would_block(error))
+        return error_code(error, system_category());
+
+      bool expired = false;
+      error_code wait_error = wait_for_socket(socket, false, deadline, expired);
+
+      if (wait_error)
+        return wait_error;
+
+      continue;
+    }
+
+    // Skip the buffers that were fully written and
+    // move the start of the partially written one
+    std::size_t written = static_cast<std::size_t>(result);
+
+    while (first < vectors.size() && written >= vectors[first].iov_len)
+      written -= vectors[first++].iov_len;
+
+    if (written)
+    {
+      vectors[first].iov_base = static_cast<char*>(vectors[first].iov_base) + written;
+      vectors[first].iov_len -= written;
+    }
+  }
+
+  return error_code();
+#endif // defined(_WIN32)
+}
+
+
+// The descriptor is made non-blocking by set_non_blocking() once connected, thus
+// recv returns EWOULDBLOCK instead of blocking and the deadline is enforced by poll.
+error_code Mysqlx_sync_connection::direct_read(void *data, const std::size_t data_length,
+                                               const std::size_t deadline_miliseconds, bool &expired)
+{
+  const Deadline deadline = details::deadline_after(deadline_miliseconds);
+  const int socket = m_async_connection->get_socket_id();
+  char *buffer = static_cast<char*>(data);
+  std::size_t received = 0;
+
+  while (received < data_length)
+  {
+    const long result = details::socket_recv(socket, buffer + received, data_length - received);
+
+    if (result > 0)
+    {
+      received += static_cast<std::size_t>(result);
+      continue;
+    }
+
+    if (0 == result)
+      return boost::asio::error::eof;
+
+    const int error = details::get_socket_errno();
+
+    if (EINTR == error)
+      continue;
+
+    if (!details::is_would_block(error))
+      return error_code(error, system_category());
+
+    error_code wait_error = wait_for_socket(socket, true, deadline, expired);
+
+    if (wait_error)
+      return wait_error;
+  }
+
+  return error_code();
+}
+
+
+void Mysqlx_sync_connection::enable_compression(const Compression_algorithm_ptr &algorithm)
+{
+  m_compression = algorithm;
+  m_compression_statistics.reset();
+  m_inflated.clear();
+  m_inflated_offset = 0;
+}
+
+
+error_code Mysqlx_sync_connection::write_compressed(const Const_buffer_sequence &data)
+{
+  std::size_t data_length = 0;
+
+  for (Const_buffer_sequence::const_iterator i = data.begin(); i != data.end(); ++i)
+    data_length += boost::asio::buffer_size(*i);
+
+  if (0 == data_length)
+    return error_code();
+
+  // Most writes fit in one frame, longer ones are cut into pieces of the
+  // same buffers
+  if (data_length <= COMPRESSED_FRAME_MAX_LENGTH)
+    return write_compressed_frame(data, data_length);
+
+  Const_buffer_sequence frame;
+  std::size_t frame_length = 0;
+
+  for (Const_buffer_sequence::const_iterator i = data.begin(); i != data.end(); ++i)
+  {
+    const char *piece = boost::asio::buffer_cast<const char*>(*i);
+    std::size_t piece_length = boost::asio::buffer_size(*i);
+
+    while (piece_length > 0)
+    {
+      const std::size_t length = std::min<std::size_t>(piece_length, COMPRESSED_FRAME_MAX_LENGTH - frame_length);
+
+      frame.push_back(boost::asio::const_buffer(piece, length));
+      frame_length += length;
+      piece += length;
+      piece_length -= length;
+
+      if (COMPRESSED_FRAME_MAX_LENGTH == frame_length)
+      {
+        error_code error = write_compressed_frame(frame, frame_length);
+
+        if (error)
+          return error;
+
+        frame.clear();
+        frame_length = 0;
+      }
+    }
+  }
+
+  if (frame_length > 0)
+    return write_compressed_frame(frame, frame_length);
+
+  return error_code();
+}
+
+
+error_code Mysqlx_sync_connection::write_compressed_frame(const Const_buffer_sequence &data, const std::size_t data_length)
+{
+  uint32_t uncompressed_length = 0;
+  uint64_t usec = 0;
+  std::size_t wire_length;
+  error_code error;
+
+  m_output_frame.resize(COMPRESSED_HEADER_SIZE);
+
+  if (data_length >= COMPRESSION_MIN_LENGTH)
+  {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if (m_compression->compress(data, m_output_frame) &&
+        m_output_frame.size() - COMPRESSED_HEADER_SIZE < data_length)
+      uncompressed_length = static_cast<uint32_t>(data_length);
+    else
+      m_output_frame.resize(COMPRESSED_HEADER_SIZE);
+
+    usec = details::usec_since(start);
+  }
+
+  if (uncompressed_length)
+  {
+    details::store_uint32(&m_output_frame[0], static_cast<uint32_t>(m_output_frame.size() - COMPRESSED_HEADER_SIZE));
+    details::store_uint32(&m_output_frame[4], uncompressed_length);
+
+    wire_length = m_output_frame.size();
+    error = transport_write(m_output_frame.data(), m_output_frame.size());
+  }
+  else
+  {
+    // Stored as is, the header goes in front of the buffers of the data
+    Const_buffer_sequence frame;
+
+    details::store_uint32(&m_output_frame[0], static_cast<uint32_t>(data_length));
+    details::store_uint32(&m_output_frame[4], 0);
+
+    frame.reserve(data.size() + 1);
+    frame.push_back(boost::asio::const_buffer(m_output_frame.data(), COMPRESSED_HEADER_SIZE));
+    frame.insert(frame.end(), data.begin(), data.end());
+
+    wire_length = COMPRESSED_HEADER_SIZE + data_length;
+    error = transport_write(frame);
+  }
+
+  if (!error)
+    m_compression_statistics.count_sent(data_length, wire_length, usec);
+
+  return error;
+}
+
+
+error_code Mysqlx_sync_connection::read_frame(const std::size_t deadline_miliseconds, bool &expired)
+{
+  char header[COMPRESSED_HEADER_SIZE];
+  error_code error;
+
+  expired = false;
+
+  if (deadline_miliseconds)
+  {
+    std::size_t header_length = sizeof(header);
+
+    error = transport_read_with_timeout(header, header_length, deadline_miliseconds);
+
+    if (0 == header_length)
+    {
+      expired = true;
+      return error;
+    }
+  }
+  else
+    error = transport_read(header, sizeof(header));
+
+  if (error)
+    return error;
+
+  const uint32_t payload_length = details::load_uint32(header);
+  const uint32_t uncompressed_length = details::load_uint32(header + 4);
+
+  if (payload_length > COMPRESSED_FRAME_MAX_LENGTH || uncompressed_length > COMPRESSED_FRAME_MAX_LENGTH)
+    return boost::system::errc::make_error_code(boost::system::errc::bad_message);
+
+  m_input_frame.resize(payload_length);
+
+  if (payload_length)
+  {
+    error = transport_read(&m_input_frame[0], payload_length);
+
+    if (error)
+      return error;
+  }
+
+  // Only called when all of the inflated data was consumed
+  m_inflated.clear();
+  m_inflated_offset = 0;
+
+  if (0 == uncompressed_length)
+  {
+    m_inflated.swap(m_input_frame);
+    m_compression_statistics.count_received(payload_length, payload_length + COMPRESSED_HEADER_SIZE, 0);
+
+    return error_code();
+  }
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  if (!m_compression->uncompress(m_input_frame.data(), payload_length, uncompressed_length, m_inflated))
+    return boost::system::errc::make_error_code(boost::system::errc::bad_message);
+
+  m_compression_statistics.count_received(uncompressed_length, payload_length + COMPRESSED_HEADER_SIZE,
+                                          details::usec_since(start));
+
+  return error_code();
+}
+
+
+error_code Mysqlx_sync_connection::read_compressed(void *data, const std::size_t data_length)
+{
+  char *buffer = static_cast<char*>(data);
+  std::size_t copied = 0;
+
+  while (copied < data_length)
+  {
+    if (m_inflated_offset == m_inflated.size())
+    {
+      bool expired = false;
+      error_code error = read_frame(0, expired);
+
+      if (error)
+        return error;
+
+      continue;
+    }
+
+    const std::size_t length = std::min(data_length - copied, m_inflated.size() - m_inflated_offset);
+
+    memcpy(buffer + copied, m_inflated.data() + m_inflated_offset, length);
+    m_inflated_offset += length;
+    copied += length;
+  }
+
+  return error_code();
+}
+
+
 void Mysqlx_sync_connection::close()
 {
   m_async_connection->close();
 }
 
+ngs::Tls_handshake_statistics Mysqlx_sync_connection::get_tls_handshake_statistics()
+{
+  return ngs::Ssl_session_cache::get_statistics();
+}
+
 bool Mysqlx_sync_connection::supports_ssl()
 {
   return m_async_connection->options()->supports_tls();;
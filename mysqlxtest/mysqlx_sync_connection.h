@@ -26,13 +26,21 @@
 
 
 #include <boost/system/error_code.hpp>
+#include <chrono>
 #include "myasio/connection.h"
 #include "myasio/connection_factory.h"
+#include "myasio/ssl_session_cache.h"
+#include "mysqlx_compression.h"
 
 
 namespace mysqlx
 {
 
+namespace details
+{
+  class Callback_executor;
+} // namespace details
+
 class Mysqlx_sync_connection
 {
 public:
@@ -40,30 +48,104 @@ public:
                          const char *ssl_ca = NULL, const char *ssl_ca_path = NULL, 
                          const char *ssl_cert = NULL, const char *ssl_cipher = NULL, 
                          const std::size_t timeout = 0l);
+  ~Mysqlx_sync_connection();
 
   boost::system::error_code connect(const ngs::Endpoint &);
+  // Connects to the first of the endpoints that accepts the connection, attempts
+  // run in parallel and start attempt_delay_miliseconds one after another
+  boost::system::error_code connect(const std::vector<ngs::Endpoint> &endpoints, const std::size_t attempt_delay_miliseconds);
+  // Connects through a Unix domain socket, the TLS configuration is ignored
+  boost::system::error_code connect(const std::string &socket_path);
   boost::system::error_code accept(const ngs::Endpoint &);
   boost::system::error_code activate_tls();
   boost::system::error_code shutdown(boost::asio::socket_base::shutdown_type how_to_shutdown);
 
   boost::system::error_code write(const void *data, const std::size_t data_length);
+  boost::system::error_code write(const ngs::Const_buffer_sequence &data);
   boost::system::error_code read(void *data, const std::size_t data_length);
   boost::system::error_code read_with_timeout(void *data, std::size_t &data_length, const std::size_t deadline_miliseconds);
 
+  // True when data from the peer is waiting on the socket, so the next read
+  // doesn't block. Data already held by TLS or the inflate buffer isn't seen.
+  bool is_readable();
+
   void close();
 
   bool supports_ssl();
 
+  // Wraps all further reads and writes in compressed frames. Both peers must
+  // enable it at the same point of the stream, e.g. once the capability is accepted.
+  void enable_compression(const Compression_algorithm_ptr &algorithm);
+  bool is_compression_active() const { return static_cast<bool>(m_compression); }
+  const Compression_algorithm_ptr &get_compression_algorithm() const { return m_compression; }
+  const Compression_statistics &get_compression_statistics() const { return m_compression_statistics; }
+  void reset_compression_statistics() { m_compression_statistics.reset(); }
+
+  // Process wide number of full and resumed TLS handshakes
+  static ngs::Tls_handshake_statistics get_tls_handshake_statistics();
+
 private:
 
+  typedef Memory_new<details::Callback_executor>::Unique_ptr Callback_executor_ptr;
+
+  // Compressed frame header: payload length and uncompressed length, 4 bytes each in
+  // little endian. Uncompressed length 0 marks a payload stored as is, used for the
+  // writes too short to gain anything and for the data that doesn't shrink.
+  enum
+  {
+    COMPRESSED_HEADER_SIZE = 8,
+    COMPRESSION_MIN_LENGTH = 64,
+    COMPRESSED_FRAME_MAX_LENGTH = 16 * 1024 * 1024
+  };
+
   static bool is_set(const char *string);
   ngs::Connection_factory_ptr get_async_connection_factory(const char *ssl_key,  const char *ssl_ca, const char *ssl_ca_path,
                                                            const char *ssl_cert, const char *ssl_cipher);
 
+  // Plain socket operations, used while TLS isn't active. They bypass the io_service
+  // and block in poll() until the socket is ready or the deadline expires. The
+  // deadline covers the whole operation, however many calls it takes.
+  typedef std::chrono::steady_clock::time_point Deadline;
+
+  boost::system::error_code set_non_blocking();
+  boost::system::error_code direct_write(const void *data, const std::size_t data_length);
+  boost::system::error_code direct_write(const void *data, const std::size_t data_length, const Deadline &deadline);
+  boost::system::error_code direct_write(const ngs::Const_buffer_sequence &data);
+  boost::system::error_code direct_read(void *data, const std::size_t data_length,
+                                        const std::size_t deadline_miliseconds, bool &expired);
+  boost::system::error_code wait_for_socket(const int socket, const bool for_read,
+                                            const Deadline &deadline, bool &expired);
+
+  // Socket (or TLS layer) operations, below the compressed framing
+  boost::system::error_code transport_write(const void *data, const std::size_t data_length);
+  boost::system::error_code transport_write(const ngs::Const_buffer_sequence &data);
+  boost::system::error_code transport_read(void *data, const std::size_t data_length);
+  boost::system::error_code transport_read_with_timeout(void *data, std::size_t &data_length, const std::size_t deadline_miliseconds);
+
+  // Frames of at most COMPRESSED_FRAME_MAX_LENGTH bytes, the buffers are
+  // compressed where they are
+  boost::system::error_code write_compressed(const ngs::Const_buffer_sequence &data);
+  boost::system::error_code write_compressed_frame(const ngs::Const_buffer_sequence &data, const std::size_t data_length);
+  boost::system::error_code read_compressed(void *data, const std::size_t data_length);
+  // Reads and unpacks the next frame into the inflated buffer, with deadline 0 it
+  // waits for the header as long as regular reads do
+  boost::system::error_code read_frame(const std::size_t deadline_miliseconds, bool &expired);
+
+  Callback_executor_ptr &get_executor();
+
   boost::asio::io_service    &m_service;
   ngs::Connection_factory_ptr m_async_factory;
   ngs::IConnection_ptr         m_async_connection;
   const std::size_t           m_timeout;
+  bool                        m_tls_active;
+  Callback_executor_ptr       m_executor;
+
+  Compression_algorithm_ptr   m_compression;
+  Compression_statistics      m_compression_statistics;
+  std::string                 m_output_frame;
+  std::string                 m_input_frame;
+  std::string                 m_inflated;
+  std::size_t                 m_inflated_offset;
 };
 
 
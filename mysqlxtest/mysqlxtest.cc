@@ -21,6 +21,8 @@
 #include "mysqlx.h"
 #include "mysqlx_crud.h"
 #include "mysqlx_connection.h"
+#include "mysqlx_replay_server.h"
+#include "xpl_error.h"
 
 #include <google/protobuf/dynamic_message.h>
 #include <google/protobuf/io/zero_copy_stream.h>
@@ -49,6 +51,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 const char CMD_ARG_SEPARATOR = '\t';
 
@@ -74,24 +79,26 @@ typedef std::map<int8_t, std::pair<mysqlx::Message* (*)(), std::string> > Messag
 static Message_by_id server_msgs_by_id;
 static Message_by_id client_msgs_by_id;
 
-bool OPT_quiet = false;
+// State changed by the scripts is kept per thread, the load mode runs
+// the script on several threads
+thread_local bool OPT_quiet = false;
 bool OPT_bindump = false;
-bool OPT_show_warnings = false;
-bool OPT_fatal_errors = false;
+thread_local bool OPT_show_warnings = false;
+thread_local bool OPT_fatal_errors = false;
 bool OPT_verbose = false;
 bool OPT_color = false;
 
 class Expected_error;
-static Expected_error *OPT_expect_error = 0;
+static thread_local Expected_error *OPT_expect_error = 0;
 
 struct Stack_frame {
   int line_number;
   std::string context;
 };
-static std::list<Stack_frame> script_stack;
+static thread_local std::list<Stack_frame> script_stack;
 
-static std::map<std::string, std::string> variables;
-static std::list<std::string> variables_to_unreplace;
+static thread_local std::map<std::string, std::string> variables;
+static thread_local std::list<std::string> variables_to_unreplace;
 
 void replace_all(std::string &input, const std::string &to_find, const std::string &change_to)
 {
@@ -291,7 +298,7 @@ public:
 
     if (OPT_verbose)
       std::cout << "Connecting...\n";
-    active_connection->connect(host, port);
+    connect(*active_connection);
   }
 
   void connect_default(const bool send_cap_password_expired = false, bool use_plain_auth = false)
@@ -329,7 +336,7 @@ public:
 
     connection.reset(new mysqlx::Connection(connection_ssl_config, timeout, dont_wait_for_disconnect));
 
-    connection->connect(host, port);
+    connect(*connection);
     if (user != "-")
     {
       if (user.empty())
@@ -453,6 +460,14 @@ public:
   }
 
 private:
+  void connect(mysqlx::Connection &connection)
+  {
+    if (sock.empty())
+      connection.connect(host, port);
+    else
+      connection.connect_socket(sock);
+  }
+
   std::map<std::string, boost::shared_ptr<mysqlx::Connection> > connections;
   boost::shared_ptr<mysqlx::Connection> active_connection;
   std::string active_connection_name;
@@ -582,7 +597,7 @@ static std::string message_to_text(const mysqlx::Message &message)
   return message.GetDescriptor()->full_name() + " {\n" + output + "}\n";
 }
 
-static std::string message_to_bindump(const mysqlx::Message &message)
+static std::string message_to_frame(const int8_t msg_id, const mysqlx::Message &message)
 {
   std::string res;
   std::string out;
@@ -597,10 +612,17 @@ static std::string message_to_bindump(const mysqlx::Message &message)
   std::swap(res[1], res[2]);
 #endif
 
-  res[4] = client_msgs_by_name[client_msgs_by_full_name[message.GetDescriptor()->full_name()]].second;
+  res[4] = msg_id;
   res.append(out);
 
-  return data_to_bindump(res);
+  return res;
+}
+
+static std::string message_to_bindump(const mysqlx::Message &message)
+{
+  const int8_t msg_id = client_msgs_by_name[client_msgs_by_full_name[message.GetDescriptor()->full_name()]].second;
+
+  return data_to_bindump(message_to_frame(msg_id, message));
 }
 
 /*
@@ -746,7 +768,7 @@ public:
   }
 
 public:
-  static std::list<boost::shared_ptr<Macro> > macros;
+  static thread_local std::list<boost::shared_ptr<Macro> > macros;
 
   static void add(boost::shared_ptr<Macro> macro)
   {
@@ -790,7 +812,7 @@ private:
   std::string m_body;
 };
 
-std::list<boost::shared_ptr<Macro> > Macro::macros;
+thread_local std::list<boost::shared_ptr<Macro> > Macro::macros;
 
 //---------------------------------------------------------------------------------------------------------
 
@@ -811,6 +833,7 @@ public:
     m_commands["recvtovar "]  = &Command::cmd_recvtovar;
     m_commands["recvuntil "] = &Command::cmd_recvuntil;
     m_commands["recvuntildisc"] = &Command::cmd_recv_all_until_disc;
+    m_commands["recvtofile "] = &Command::cmd_recvtofile;
     m_commands["enablessl"] = &Command::cmd_enablessl;
     m_commands["sleep "] = &Command::cmd_sleep;
     m_commands["login "] = &Command::cmd_login;
@@ -1116,6 +1139,41 @@ private:
     return Continue;
   }
 
+  Result cmd_recvtofile(Execution_context &context, const std::string &args)
+  {
+    std::ofstream file(args.c_str(), std::ios::out | std::ios::app | std::ios::binary);
+    if (!file.is_open())
+    {
+      std::cerr << error() << "Could not open file " << args << eoerr();
+      return Stop_with_failure;
+    }
+
+    int msgid;
+    int count = 0;
+    try
+    {
+      do
+      {
+        std::unique_ptr<mysqlx::Message> msg(context.connection()->recv_raw(msgid));
+        if (!msg.get())
+          break;
+
+        // One frame per line, in the same format as --bindump
+        file << data_to_bindump(message_to_frame(msgid, *msg)) << "\n";
+        ++count;
+      } while (msgid != Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK &&
+               msgid != Mysqlx::ServerMessages::ERROR);
+    }
+    catch (mysqlx::Error &e)
+    {
+      dumpx(e);
+      return Stop_with_failure;
+    }
+
+    std::cout << "Recorded " << count << " messages to " << args << "\n";
+    return Continue;
+  }
+
   Result cmd_enablessl(Execution_context &context, const std::string &args)
   {
     try
@@ -1596,7 +1654,7 @@ private:
   }
 
 
-  static boost::posix_time::ptime m_start_measure;
+  static thread_local boost::posix_time::ptime m_start_measure;
 
   Result cmd_measure(Execution_context &context, const std::string &args)
   {
@@ -1855,7 +1913,7 @@ private:
   Result cmd_import(Execution_context &context, const std::string &args);
 };
 
-boost::posix_time::ptime Command::m_start_measure = boost::posix_time::not_a_date_time;
+thread_local boost::posix_time::ptime Command::m_start_measure = boost::posix_time::not_a_date_time;
 
 static int process_client_message(mysqlx::Connection *connection, int8_t msg_id, const mysqlx::Message &msg)
 {
@@ -2401,6 +2459,27 @@ private:
   std::string m_variable_name;
 };
 
+typedef std::chrono::steady_clock Load_clock;
+
+// Latencies in microseconds of the commands and messages of the script,
+// by name. Collected only by the load mode.
+typedef std::map<std::string, std::vector<int64_t> > Command_latencies;
+static thread_local Command_latencies *command_latencies = NULL;
+
+static std::string get_command_name(const char *linebuf)
+{
+  if (linebuf[0] == '#' || linebuf[0] == 0)
+    return "";
+
+  return std::string(linebuf, strcspn(linebuf, " \t"));
+}
+
+static void add_command_latency(const std::string &name, const Load_clock::time_point &start)
+{
+  if (!name.empty())
+    (*command_latencies)[name].push_back(std::chrono::duration_cast<std::chrono::microseconds>(Load_clock::now() - start).count());
+}
+
 static int process_client_input(std::istream &input, std::vector<Block_processor_ptr> &eaters)
 {
   const std::size_t buffer_length = 64*1024 + 1024;
@@ -2416,6 +2495,8 @@ static int process_client_input(std::istream &input, std::vector<Block_processor
   }
 
   Block_processor_ptr hungry_block_reader;
+  Load_clock::time_point block_start;
+  std::string block_name;
 
   while (!input.eof())
   {
@@ -2428,6 +2509,12 @@ static int process_client_input(std::istream &input, std::vector<Block_processor
     {
       std::vector<Block_processor_ptr>::iterator i = eaters.begin();
 
+      if (command_latencies)
+      {
+        block_start = Load_clock::now();
+        block_name = get_command_name(linebuf);
+      }
+
       while (i != eaters.end() &&
              Block_result_not_hungry == result)
       {
@@ -2442,6 +2529,9 @@ static int process_client_input(std::istream &input, std::vector<Block_processor
         ++i;
       }
 
+      if (command_latencies && Block_result_feed_more != result)
+        add_command_latency(block_name, block_start);
+
       if (Block_result_everyone_not_hungry == result)
         break;
 
@@ -2454,8 +2544,13 @@ static int process_client_input(std::istream &input, std::vector<Block_processor
       return 1;
 
     if (Block_result_feed_more != result)
+    {
       hungry_block_reader.reset();
 
+      if (command_latencies)
+        add_command_latency(block_name, block_start);
+    }
+
     if (Block_result_everyone_not_hungry == result)
       break;
   }
@@ -2473,6 +2568,101 @@ static int process_client_input(std::istream &input, std::vector<Block_processor
   return 0;
 }
 
+//---------------------------------------------------------------------------------------------------------
+
+static std::string varint(uint64_t value)
+{
+  std::string result;
+
+  while (value >= 0x80)
+  {
+    result.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  result.push_back(static_cast<char>(value));
+
+  return result;
+}
+
+// Response of the replay server read from a file with a bindump per line
+static bool load_replay_response(const std::string &file_name, mysqlx::Replay_response &response)
+{
+  std::ifstream file(file_name.c_str());
+  if (!file.is_open())
+  {
+    std::cerr << "ERROR: Could not open file " << file_name << "\n";
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line))
+  {
+    boost::algorithm::trim(line);
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    if (!response.add_frames(bindump_to_data(line)))
+    {
+      std::cerr << "ERROR: Truncated message in " << file_name << "\n";
+      return false;
+    }
+  }
+
+  if (response.empty())
+  {
+    std::cerr << "ERROR: No messages found in " << file_name << "\n";
+    return false;
+  }
+
+  return true;
+}
+
+// Resultset with an integer, a string and a double column
+static void generate_replay_response(const int rows, mysqlx::Replay_response &response)
+{
+  static const char *names[] = { "id", "name", "value" };
+  static const Mysqlx::Resultset::ColumnMetaData::FieldType types[] = {
+    Mysqlx::Resultset::ColumnMetaData::SINT,
+    Mysqlx::Resultset::ColumnMetaData::BYTES,
+    Mysqlx::Resultset::ColumnMetaData::DOUBLE
+  };
+
+  for (int i = 0; i < 3; ++i)
+  {
+    Mysqlx::Resultset::ColumnMetaData column;
+
+    column.set_type(types[i]);
+    column.set_name(names[i]);
+    column.set_original_name(names[i]);
+    column.set_table("replay");
+    column.set_original_table("replay");
+    column.set_schema("test");
+    column.set_catalog("def");
+    response.add_frames(message_to_frame(Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA, column));
+  }
+
+  for (int i = 0; i < rows; ++i)
+  {
+    Mysqlx::Resultset::Row row;
+    const std::string id = boost::lexical_cast<std::string>(i + 1);
+    const double value = (i + 1) * 1.25;
+    uint64_t bits;
+    std::string fixed;
+
+    memcpy(&bits, &value, sizeof(bits));
+    for (int byte = 0; byte < 8; ++byte)
+      fixed.push_back(static_cast<char>(bits >> (8 * byte)));
+
+    row.add_field(varint(static_cast<uint64_t>(i + 1) << 1)); // zigzag encoded positive value
+    row.add_field(("name_" + id).append(1, '\0'));
+    row.add_field(fixed);
+    response.add_frames(message_to_frame(Mysqlx::ServerMessages::RESULTSET_ROW, row));
+  }
+
+  response.add_frames(message_to_frame(Mysqlx::ServerMessages::RESULTSET_FETCH_DONE, Mysqlx::Resultset::FetchDone()));
+  response.add_frames(message_to_frame(Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK, Mysqlx::Sql::StmtExecuteOk()));
+}
+
 #include "cmdline_options.h"
 
 class My_command_line_options : public Command_line_options
@@ -2480,7 +2670,9 @@ class My_command_line_options : public Command_line_options
 public:
   enum Run_mode{
     RunTest,
-    RunTestWithoutAuth
+    RunTestWithoutAuth,
+    RunReplayServer,
+    RunLoad
   } run_mode;
 
   std::string run_file;
@@ -2492,12 +2684,23 @@ public:
   int port;
   int timeout;
   std::string host;
+  std::string socket_path;
   std::string uri;
   std::string password;
   std::string schema;
   mysqlx::Ssl_config ssl;
   bool        daemon;
 
+  std::string replay_file;
+  int64_t     replay_rows;
+  int         replay_connections;
+
+  int         load_connections;
+  int         load_threads;
+  int         load_duration;
+  int         load_ramp_up;
+  int         load_think_time;
+
   void print_help()
   {
     std::cout << "mysqlxtest <options>\n";
@@ -2509,6 +2712,7 @@ public:
     std::cout << "-p, --password=<pass> Connection password\n";
     std::cout << "-h, --host=<host>     Connection host\n";
     std::cout << "-P, --port=<port>     Connection port\n";
+    std::cout << "-S, --socket=<path>   Connection socket, used instead of the port\n";
     std::cout << "-t, --timeout=<ms>    Connection timeout\n";
     std::cout << "--close-no-sync       Do not wait for connection to be closed by server(disconnect first)\n";
     std::cout << "--schema=<schema>     Default schema to connect to\n";
@@ -2524,6 +2728,18 @@ public:
     std::cout << "-B, --bindump         Dump binary representation of messages sent, in format suitable for\n";
     std::cout << "--verbose             Enable extra verbose messages\n";
     std::cout << "--daemon              Work as a daemon (unix only)\n";
+    std::cout << "--replay-server       Run as a stand-in server on --host and --port, answering every statement\n";
+    std::cout << "                      with a recorded response (run mode)\n";
+    std::cout << "--replay-file=<file>  Response of the replay server, recorded with -->recvtofile\n";
+    std::cout << "                      (a generated resultset is used if not given)\n";
+    std::cout << "--replay-rows=<n>     Number of rows sent by the replay server, recorded rows are repeated as needed\n";
+    std::cout << "--replay-connections=<n> Stop the replay server after serving n connections\n";
+    std::cout << "--load-connections=<n> Run the script repeatedly on n connections and report the throughput\n";
+    std::cout << "                      and latency percentiles of each command (run mode)\n";
+    std::cout << "--load-threads=<n>    Number of threads running the connections (default one per connection)\n";
+    std::cout << "--load-duration=<s>   Duration of the load in seconds, ramp-up included (default 10)\n";
+    std::cout << "--load-ramp-up=<s>    Seconds over which the connections are opened (default 0)\n";
+    std::cout << "--load-think-time=<ms> Pause of each connection between runs of the script (default 0)\n";
     std::cout << "--help                     Show command line help\n";
     std::cout << "--help-commands            Show help for input commands\n";
     std::cout << "\nOnly one option that changes run mode is allowed.\n";
@@ -2565,6 +2781,8 @@ public:
     std::cout << "  Read one message and print it, checking that its type is the specified one\n";
     std::cout << "-->recvuntil <msgtype>\n";
     std::cout << "  Read messages and print them, until a msg of the specified type (or Error) is received\n";
+    std::cout << "-->recvtofile <file>\n";
+    std::cout << "  Read messages until StmtExecuteOk (or Error) is received and append them to file, for --replay-file\n";
     std::cout << "-->repeat <N>\n";
     std::cout << "  Begin block of instructions that should be repeated N times\n";
     std::cout << "-->endrepeat\n";
@@ -2636,7 +2854,9 @@ public:
   My_command_line_options(int argc, char **argv)
   : Command_line_options(argc, argv), run_mode(RunTest), has_file(false),
     cap_expired_password(false), dont_wait_for_server_disconnect(false),
-    use_plain_auth(false), port(0), timeout(0l), daemon(false)
+    use_plain_auth(false), port(0), timeout(0l), daemon(false),
+    replay_rows(-1), replay_connections(0),
+    load_connections(0), load_threads(0), load_duration(10), load_ramp_up(0), load_think_time(0)
   {
     std::string user;
 
@@ -2658,6 +2878,37 @@ public:
           exit_code = 1;
         }
       }
+      else if (check_arg(argv, i, "--replay-server", NULL))
+      {
+        if (!set_mode(RunReplayServer))
+        {
+          std::cerr << "Only one option that changes run mode is allowed.\n";
+          exit_code = 1;
+        }
+      }
+      else if (check_arg_with_value(argv, i, "--replay-file", NULL, value))
+        replay_file = value;
+      else if (check_arg_with_value(argv, i, "--replay-rows", NULL, value))
+        replay_rows = boost::lexical_cast<int64_t>(value);
+      else if (check_arg_with_value(argv, i, "--replay-connections", NULL, value))
+        replay_connections = atoi(value);
+      else if (check_arg_with_value(argv, i, "--load-connections", NULL, value))
+      {
+        load_connections = atoi(value);
+        if (!set_mode(RunLoad))
+        {
+          std::cerr << "Only one option that changes run mode is allowed.\n";
+          exit_code = 1;
+        }
+      }
+      else if (check_arg_with_value(argv, i, "--load-threads", NULL, value))
+        load_threads = atoi(value);
+      else if (check_arg_with_value(argv, i, "--load-duration", NULL, value))
+        load_duration = atoi(value);
+      else if (check_arg_with_value(argv, i, "--load-ramp-up", NULL, value))
+        load_ramp_up = atoi(value);
+      else if (check_arg_with_value(argv, i, "--load-think-time", NULL, value))
+        load_think_time = atoi(value);
       else if (check_arg(argv, i, "--plain-auth", NULL))
       {
         use_plain_auth = true;
@@ -2682,6 +2933,8 @@ public:
         schema = value;
       else if (check_arg_with_value(argv, i, "--port", "-P", value))
         port = atoi(value);
+      else if (check_arg_with_value(argv, i, "--socket", "-S", value))
+        socket_path = value;
       else if (check_arg_with_value(argv, i, "--timeout", "-t", value))
         timeout = atoi(value);
       else if (check_arg_with_value(argv, i, "--fatal-errors", NULL, value))
@@ -2722,6 +2975,15 @@ public:
       }
     }
 
+    if (RunLoad == run_mode && load_connections <= 0)
+    {
+      std::cerr << "--load-connections must be greater than 0\n";
+      exit_code = 1;
+    }
+
+    if (load_threads <= 0)
+      load_threads = load_connections;
+
     if (port == 0)
       port = 33060;
     if (host.empty())
@@ -2737,6 +2999,9 @@ public:
         uri.append("@");
       }
       uri.append(host);
+      if (!socket_path.empty())
+        uri.append(":(").append(socket_path).append(")");
+      else
       {
         char buf[10];
         my_snprintf(buf, sizeof(buf), ":%i", port);
@@ -2846,6 +3111,290 @@ static int process_client_input_no_auth(const My_command_line_options &options,
   return r;
 }
 
+static int process_replay_server(const My_command_line_options &options, std::istream &input)
+{
+  mysqlx::Replay_response response;
+
+  if (options.replay_file.empty())
+    generate_replay_response(1000, response);
+  else if (!load_replay_response(options.replay_file, response))
+    return 1;
+
+  const uint64_t rows = options.replay_rows < 0 ? response.recorded_rows() : options.replay_rows;
+  mysqlx::Replay_server server(response, rows, OPT_quiet ? NULL : &std::cout);
+  boost::system::error_code error = server.listen(options.host, options.port);
+
+  if (error)
+  {
+    std::cerr << "ERROR: Unable to listen on " << options.host << ":" << options.port << ": " << error.message() << "\n";
+    return 1;
+  }
+
+  std::cout << "Replay server listening on " << options.host << ":" << options.port << "\n";
+
+  // Without a limit the server runs until it's killed
+  error = server.run(options.replay_connections);
+  if (error)
+  {
+    std::cerr << "ERROR: " << error.message() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+// Discards the output of the scripts run by the load mode
+class Null_streambuf : public std::streambuf
+{
+protected:
+  virtual int overflow(int c) { return traits_type::not_eof(c); }
+  virtual std::streamsize xsputn(const char *, std::streamsize count) { return count; }
+};
+
+class Load_generator
+{
+public:
+  Load_generator(const My_command_line_options &options, const std::string &script)
+  : m_options(options), m_script(script), m_errors(0), m_failed_connections(0),
+    m_quiet(OPT_quiet), m_show_warnings(OPT_show_warnings), m_fatal_errors(OPT_fatal_errors)
+  {
+  }
+
+  int run(std::ostream &report)
+  {
+    const int threads_count = std::max(1, std::min(m_options.load_threads, m_options.load_connections));
+    std::vector<std::thread> threads;
+
+    // The variables given on the command line, copied to every connection
+    m_variables = variables;
+    m_start = Load_clock::now();
+    m_end = m_start + std::chrono::seconds(m_options.load_duration);
+
+    for (int i = 0; i < threads_count; ++i)
+      threads.push_back(std::thread(&Load_generator::run_thread, this, i, threads_count));
+
+    for (std::vector<std::thread>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
+      thread->join();
+
+    print_report(report, std::chrono::duration_cast<std::chrono::microseconds>(Load_clock::now() - m_start).count());
+
+    return m_errors == 0 && m_failed_connections == 0 ? 0 : 1;
+  }
+
+private:
+  struct Load_connection
+  {
+    int index;
+    Load_clock::time_point next_run;
+    boost::shared_ptr<Connection_manager> cm;
+    std::map<std::string, std::string> variables;
+    bool failed;
+  };
+
+  void run_thread(const int thread_index, const int threads_count)
+  {
+    std::vector<Load_connection> connections;
+    Command_latencies latencies;
+    Expected_error expected_error;
+    uint64_t errors = 0;
+    uint64_t failed_connections = 0;
+
+    OPT_quiet = m_quiet;
+    OPT_show_warnings = m_show_warnings;
+    OPT_fatal_errors = m_fatal_errors;
+    OPT_expect_error = &expected_error;
+    command_latencies = &latencies;
+
+    // Connections are spread over the ramp-up period in creation order
+    for (int i = thread_index; i < m_options.load_connections; i += threads_count)
+    {
+      Load_connection connection;
+
+      connection.index = i;
+      connection.next_run = m_start + std::chrono::milliseconds(static_cast<int64_t>(m_options.load_ramp_up) * 1000 * i / m_options.load_connections);
+      connection.variables = m_variables;
+      connection.failed = false;
+      connections.push_back(connection);
+    }
+
+    Load_clock::time_point now = Load_clock::now();
+
+    while (now < m_end)
+    {
+      Load_clock::time_point next_run = m_end;
+
+      for (std::vector<Load_connection>::iterator connection = connections.begin(); connection != connections.end(); ++connection)
+      {
+        if (connection->failed)
+          continue;
+
+        if (connection->next_run <= now)
+        {
+          if (!run_script(*connection))
+            ++errors;
+
+          now = Load_clock::now();
+          connection->next_run = now + std::chrono::milliseconds(m_options.load_think_time);
+
+          if (connection->failed)
+          {
+            ++failed_connections;
+            continue;
+          }
+        }
+
+        next_run = std::min(next_run, connection->next_run);
+      }
+
+      if (next_run > now)
+        std::this_thread::sleep_until(next_run);
+
+      now = Load_clock::now();
+    }
+
+    for (std::vector<Load_connection>::iterator connection = connections.begin(); connection != connections.end(); ++connection)
+    {
+      try
+      {
+        if (connection->cm && !connection->failed)
+          connection->cm->close_active(true);
+      }
+      catch (mysqlx::Error &)
+      {
+      }
+    }
+
+    command_latencies = NULL;
+    OPT_expect_error = NULL;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (Command_latencies::const_iterator command = latencies.begin(); command != latencies.end(); ++command)
+    {
+      std::vector<int64_t> &all = m_latencies[command->first];
+      all.insert(all.end(), command->second.begin(), command->second.end());
+    }
+
+    m_errors += errors;
+    m_failed_connections += failed_connections;
+  }
+
+  // Runs the script once on the connection, which is opened on first use
+  bool run_script(Load_connection &connection)
+  {
+    const Load_clock::time_point start = Load_clock::now();
+    int r = 1;
+
+    variables.swap(connection.variables);
+    Macro::macros.clear();
+    script_stack.clear();
+
+    Stack_frame frame = { 0, "connection #" + boost::lexical_cast<std::string>(connection.index + 1) };
+    script_stack.push_front(frame);
+
+    try
+    {
+      if (!connection.cm)
+      {
+        connection.cm.reset(new Connection_manager(m_options.uri, m_options.ssl, m_options.timeout, m_options.dont_wait_for_server_disconnect));
+        connection.cm->connect_default(m_options.cap_expired_password, m_options.use_plain_auth);
+        add_command_latency("connect", start);
+      }
+
+      std::stringstream input(m_script);
+      std::vector<Block_processor_ptr> eaters(create_block_processors(connection.cm.get()));
+
+      r = process_client_input(input, eaters);
+      if (r == 0)
+        add_command_latency("script", start);
+    }
+    catch (mysqlx::Error &error)
+    {
+      dumpx(error);
+      connection.failed = true;
+    }
+    catch (std::exception &error)
+    {
+      dumpx(error);
+    }
+
+    variables.swap(connection.variables);
+
+    return r == 0;
+  }
+
+  static int64_t percentile(const std::vector<int64_t> &sorted, const int percent)
+  {
+    return sorted[std::min(sorted.size() - 1, sorted.size() * percent / 100)];
+  }
+
+  void print_report(std::ostream &report, const int64_t elapsed_us)
+  {
+    const double elapsed_s = std::max<int64_t>(elapsed_us, 1) / 1000000.0;
+
+    report << m_options.load_connections << " connections, " << m_options.load_threads << " threads, "
+           << boost::format("%.1f s") % elapsed_s << " (" << m_options.load_ramp_up << " s ramp-up, "
+           << m_options.load_think_time << " ms think time)\n";
+    report << boost::format("%-32s %10s %10s %10s %10s %10s %10s %10s\n")
+              % "Command" % "Count" % "Ops/s" % "Avg us" % "p50 us" % "p90 us" % "p99 us" % "Max us";
+
+    for (Command_latencies::iterator command = m_latencies.begin(); command != m_latencies.end(); ++command)
+    {
+      std::vector<int64_t> &samples = command->second;
+      int64_t total = 0;
+
+      std::sort(samples.begin(), samples.end());
+      for (std::vector<int64_t>::const_iterator sample = samples.begin(); sample != samples.end(); ++sample)
+        total += *sample;
+
+      report << boost::format("%-32s %10u %10.1f %10d %10d %10d %10d %10d\n")
+                % command->first % samples.size() % (samples.size() / elapsed_s)
+                % (total / static_cast<int64_t>(samples.size()))
+                % percentile(samples, 50) % percentile(samples, 90) % percentile(samples, 99) % samples.back();
+    }
+
+    report << "Failed script runs: " << m_errors << ", failed connections: " << m_failed_connections << "\n";
+  }
+
+  const My_command_line_options &m_options;
+  const std::string m_script;
+  std::map<std::string, std::string> m_variables;
+  Load_clock::time_point m_start;
+  Load_clock::time_point m_end;
+
+  std::mutex m_mutex;
+  Command_latencies m_latencies;
+  uint64_t m_errors;
+  uint64_t m_failed_connections;
+
+  // Options set before the threads are started
+  const bool m_quiet;
+  const bool m_show_warnings;
+  const bool m_fatal_errors;
+};
+
+static int process_client_input_load(const My_command_line_options &options, std::istream &input)
+{
+  std::stringstream script;
+  script << input.rdbuf();
+
+  Load_generator generator(options, script.str());
+  Null_streambuf null_output;
+  std::ostream report(std::cout.rdbuf());
+
+  // Only the report is printed, the scripts would interleave their output
+  std::cout.rdbuf(&null_output);
+  const int r = generator.run(report);
+  std::cout.rdbuf(report.rdbuf());
+
+  if (r == 0)
+    std::cerr << "ok\n";
+  else
+    std::cerr << "not ok\n";
+
+  return r;
+}
+
 bool Macro::call(Execution_context &context, const std::string &cmd)
 {
   std::string name;
@@ -2940,6 +3489,12 @@ static Program_mode get_mode_function(const My_command_line_options &opt)
     case My_command_line_options::RunTestWithoutAuth:
       return process_client_input_no_auth;
 
+    case My_command_line_options::RunReplayServer:
+      return process_replay_server;
+
+    case My_command_line_options::RunLoad:
+      return process_client_input_load;
+
     case My_command_line_options::RunTest:
     default:
       return process_client_input_on_session;
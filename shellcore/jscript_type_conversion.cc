@@ -238,7 +238,7 @@ v8::Handle<v8::Value> JScript_type_bridger::shcore_value_to_v8_value(const Value
       r = v8::Boolean::New(owner->isolate(), value.value.b);
       break;
     case String:
-      r = v8::String::NewFromUtf8(owner->isolate(), value.value.s->c_str());
+      r = v8::String::NewFromUtf8(owner->isolate(), value.value.s.c_str());
       break;
     case Integer:
       r = v8::Integer::New(owner->isolate(), value.value.i);
@@ -250,19 +250,19 @@ v8::Handle<v8::Value> JScript_type_bridger::shcore_value_to_v8_value(const Value
       r = v8::Number::New(owner->isolate(), value.value.d);
       break;
     case Object:
-      r = native_object_to_js(*value.value.o);
+      r = native_object_to_js(value.value.o);
       break;
     case Array:
       // maybe convert fully
-      r = array_wrapper->wrap(*value.value.array);
+      r = array_wrapper->wrap(value.value.array);
       break;
     case Map:
       // maybe convert fully
-      r = map_wrapper->wrap(*value.value.map);
+      r = map_wrapper->wrap(value.value.map);
       break;
     case MapRef:
     {
-      boost::shared_ptr<Value::Map_type> map(value.value.mapref->lock());
+      boost::shared_ptr<Value::Map_type> map(value.value.mapref.lock());
       if (map)
       {
         throw std::invalid_argument("Cannot convert internal value to JS: wrapmapref not implemented\n");
@@ -270,7 +270,7 @@ v8::Handle<v8::Value> JScript_type_bridger::shcore_value_to_v8_value(const Value
     }
     break;
     case shcore::Function:
-      r = function_wrapper->wrap(*value.value.func);
+      r = function_wrapper->wrap(value.value.func);
       break;
   }
   return r;
@@ -52,7 +52,7 @@ void Object_registry::add_to_reg_list(const std::string &list_name, const boost:
   else if (liter->second.type != Array)
     throw std::invalid_argument("Registry "+list_name+" is not a list");
 
-  (*liter->second.value.array)->push_back(Value(object));
+  liter->second.value.array->push_back(Value(object));
 }
 
 
@@ -65,7 +65,7 @@ void Object_registry::add_to_reg_list(const std::string &list_name, const Value
   else if (liter->second.type != Array)
     throw std::invalid_argument("Registry "+list_name+" is not a list");
 
-  (*liter->second.value.array)->push_back(value);
+  liter->second.value.array->push_back(value);
 }
 
 
@@ -76,9 +76,9 @@ void Object_registry::remove_from_reg_list(const std::string &list_name, const b
     throw std::invalid_argument("Registry "+list_name+" is not a list");
 
   Value &list(liter->second);
-  Value::Array_type::iterator iter = std::find((*list.value.array)->begin(), (*list.value.array)->end(), Value(object));
-  if (iter != (*list.value.array)->end())
-    (*list.value.array)->erase(iter);
+  Value::Array_type::iterator iter = std::find(list.value.array->begin(), list.value.array->end(), Value(object));
+  if (iter != list.value.array->end())
+    list.value.array->erase(iter);
 }
 
 
@@ -88,7 +88,7 @@ void Object_registry::remove_from_reg_list(const std::string &list_name, Value::
   if (liter != _registry->end() || liter->second.type != Array)
     throw std::invalid_argument("Registry "+list_name+" is not a list");
 
-  (*liter->second.value.array)->erase(iterator);
+  liter->second.value.array->erase(iterator);
 }
 
 
@@ -98,5 +98,5 @@ boost::shared_ptr<Value::Array_type> &Object_registry::get_reg_list(const std::s
   if (liter != _registry->end() || liter->second.type != Array)
     throw std::invalid_argument("Registry "+list_name+" is not a list");
 
-  return *liter->second.value.array;
+  return liter->second.value.array;
 }
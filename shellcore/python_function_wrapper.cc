@@ -73,7 +73,7 @@ static PyObject *method_call(PyShFuncObject *self, PyObject *args, PyObject *UNU
     try
     {
       Value v = ctx->pyobj_to_shcore_value(argval);
-      r.push_back(v);
+      r.push_back(std::move(v));
     }
     catch (std::exception &exc)
     {
@@ -373,7 +373,7 @@ static PyObject *call_object_method(boost::shared_ptr<shcore::Object_bridge> obj
     try
     {
       Value v = ctx->pyobj_to_shcore_value(argval);
-      r.push_back(v);
+      r.push_back(std::move(v));
     }
     catch (std::exception &exc)
     {
@@ -23,6 +23,8 @@
 #include "shellcore/shell_python.h"
 #include "shellcore/object_registry.h"
 #include "modules/base_session.h"
+#include "modules/mod_mysql_session.h"
+#include "modules/mod_utils.h"
 #include "interactive_global_schema.h"
 #include "interactive_global_session.h"
 #include <boost/algorithm/string.hpp>
@@ -63,6 +65,8 @@ Shell_core::Shell_core(Interpreter_delegate *shdelegate)
     set_global("session", shcore::Value::wrap<Global_session>(new Global_session(*this)));
   }
 
+  set_global("util", shcore::Value::wrap<mysh::Util>(new mysh::Util(*this)));
+
   shcore::print = boost::bind(&shcore::Shell_core::print, this, _1);
 }
 
@@ -149,12 +153,27 @@ int Shell_core::process_stream(std::istream& stream, const std::string& source,
   // In SQL Mode the stdin and file are processed line by line
   if (_mode == Shell_core::Mode_SQL)
   {
+    // When statement batching is enabled lines are grouped up to the batch size,
+    // so the statements on them can be sent on a single query. Only classic
+    // sessions batch statements, the rest keep getting the input line by line.
+    size_t batch_size = 0;
+    if (boost::dynamic_pointer_cast<mysh::mysql::ClassicSession>(get_dev_session()))
+      batch_size = static_cast<size_t>((*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE].as_int());
+
     while (!stream.eof())
     {
       std::string line;
 
       std::getline(stream, line);
 
+      while (line.size() < batch_size && !stream.eof())
+      {
+        std::string next_line;
+
+        std::getline(stream, next_line);
+        line.append("\n").append(next_line);
+      }
+
       handle_input(line, state, result_processor);
 
       if (_global_return_code && !(*Shell_core_options::get())[SHCORE_BATCH_CONTINUE_ON_ERROR].as_bool())
@@ -325,6 +344,10 @@ bool Shell_core::handle_shell_command(const std::string &line)
 *  - ssl_ca, the path to the X509 certificate authority in PEM format.
 *  - ssl_cert, the path to the X509 certificate in PEM format.
 *  - ssl_key, the path to the X509 key in PEM format.
+*  - compression, true to compress the client/server traffic when the server supports it.
+*    Classic sessions use the compressed protocol of the server. The X Plugin has no
+*    compression capability, so X sessions stay uncompressed against a real server:
+*    their status shows COMPRESSION_REFUSED with the reason.
 *
 * If a Password is added to the args list, it will override any password coming on the Connection Data Dictionary.
 *
@@ -79,9 +79,12 @@ void Shell_core_options::set_member(const std::string &prop, Value value)
     else if (prop == SHCORE_INTERACTIVE || prop == SHCORE_BATCH_CONTINUE_ON_ERROR)
       throw shcore::Exception::value_error((boost::format("The option %s is read only.") % prop).str());
 
-    else if (prop == SHCORE_SHOW_WARNINGS && value.type != shcore::Bool)
+    else if ((prop == SHCORE_SHOW_WARNINGS || prop == SHCORE_SHOW_TIMING) && value.type != shcore::Bool)
         throw shcore::Exception::value_error((boost::format("The option %s requires a boolean value.") % prop).str());
 
+    else if (prop == SHCORE_SQL_BATCH_SIZE && (value.type != shcore::Integer || value.as_int() < 0))
+        throw shcore::Exception::value_error((boost::format("The option %s requires a non negative integer value.") % prop).str());
+
     (*_options)[prop] = value;
   }
   else
@@ -94,9 +97,11 @@ _options(new shcore::Value::Map_type)
   (*_options)[SHCORE_OUTPUT_FORMAT] = Value("table");
   (*_options)[SHCORE_INTERACTIVE] = Value::True();
   (*_options)[SHCORE_SHOW_WARNINGS] = Value::True();
+  (*_options)[SHCORE_SHOW_TIMING] = Value::False();
   (*_options)[SHCORE_BATCH_CONTINUE_ON_ERROR] = Value::False();
   (*_options)[SHCORE_MULTIPLE_INSTANCES] = Value::False();
   (*_options)[SHCORE_USE_WIZARDS] = Value::True();
+  (*_options)[SHCORE_SQL_BATCH_SIZE] = Value(0);
 }
 
 Shell_core_options::~Shell_core_options()
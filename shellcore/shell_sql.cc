@@ -20,11 +20,14 @@
 #include "shellcore/shell_sql.h"
 #include "../modules/base_session.h"
 #include "../modules/mod_mysql_session.h"
+#include "../modules/mod_mysql_resultset.h"
 #include "../modules/mod_mysqlx_session.h"
 #include "../utils/utils_mysql_parsing.h"
+#include "shellcore/shell_core_options.h"
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
+#include <cctype>
 #include <fstream>
 
 using namespace shcore;
@@ -108,39 +111,60 @@ void Shell_sql::handle_input(std::string &code, Interactive_input_state &state,
 
       code = _sql_cache;
 
-      // Executes every found statement
-      for (index = 0; index < statements.size(); index++)
-      {
-        shcore::Argument_list query;
-        query.push_back(Value(statements[index]));
+      // Classic sessions can send several statements on a single query
+      boost::shared_ptr<mysh::mysql::ClassicSession> classic = boost::dynamic_pointer_cast<mysh::mysql::ClassicSession>(session);
+      int64_t batch_size = (*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE].as_int();
 
-        try
-        {
-          // ClassicSession has runSql and returns a ClassicResult object
-          if (session->has_member("runSql"))
-            ret_val = session->call("runSql", query);
-
-          // NodeSession uses SqlExecute object in which we need to call
-          // .execute() to get the Resultset object
-          else if (session->has_member("sql"))
-            ret_val = session->call("sql", query).as_object()->call("execute", shcore::Argument_list());
-          else
-            throw shcore::Exception::logic_error("The current session type (" + session->class_name() + ") can't be used for SQL execution.");
+      bool stopped = false;
 
-          // If reached this point, processes the returned result object
-          if (!_killed)
-            result_processor(ret_val);
-          _killed = false;
-        }
-        catch (shcore::Exception &exc)
+      if (classic && batch_size > 0 && statements.size() > 1 && _delimiter == ";")
+        stopped = execute_batched(*classic, statements, static_cast<size_t>(batch_size), result_processor, ret_val);
+      else
+      {
+        // Executes every found statement
+        for (index = 0; index < statements.size() && !stopped; index++)
         {
-          print_exception(exc);
+          shcore::Argument_list query;
+          query.push_back(Value(statements[index]));
+
+          try
+          {
+            // ClassicSession has runSql and returns a ClassicResult object
+            if (session->has_member("runSql"))
+              ret_val = session->call("runSql", query);
+
+            // NodeSession uses SqlExecute object in which we need to call
+            // .execute() to get the Resultset object
+            else if (session->has_member("sql"))
+              ret_val = session->call("sql", query).as_object()->call("execute", shcore::Argument_list());
+            else
+              throw shcore::Exception::logic_error("The current session type (" + session->class_name() + ") can't be used for SQL execution.");
+
+            // If reached this point, processes the returned result object
+            if (!_killed)
+              result_processor(ret_val);
+            _killed = false;
+          }
+          catch (shcore::Exception &exc)
+          {
+            stopped = statement_failed(exc, result_processor);
+          }
+
+          if (_last_handled.empty())
+            _last_handled = statements[index];
+          else
+            _last_handled.append("\n").append(statements[index]);
         }
+      }
 
-        if (_last_handled.empty())
-          _last_handled = statements[index];
-        else
-          _last_handled.append("\n").append(statements[index]);
+      // The rest of the input is dropped, including a statement still being read
+      if (stopped)
+      {
+        _sql_cache.clear();
+        code.clear();
+
+        while (!_parsing_context_stack.empty())
+          _parsing_context_stack.pop();
       }
     }
     else if (range_count)
@@ -271,4 +295,165 @@ void Shell_sql::abort()
     }
     _killed = true;
   }
-}
\ No newline at end of file
+}
+
+/*
+* Prints the error of a failed statement. While processing a file or stdin the
+* failure is also reported as a processing error, returns true when the rest
+* of the input must be skipped.
+*/
+bool Shell_sql::statement_failed(const shcore::Exception &exc, boost::function<void(shcore::Value)> result_processor)
+{
+  print_exception(exc);
+
+  if (_owner->get_input_source().empty())
+    return false;
+
+  // An undefined result is taken as a processing error
+  result_processor(Value());
+
+  return !(*Shell_core_options::get())[SHCORE_BATCH_CONTINUE_ON_ERROR].as_bool();
+}
+
+/*
+* True when the statement is a CALL, once the leading comments are skipped.
+* The content of executable comments is looked into as well.
+*/
+static bool is_call_statement(const std::string &statement)
+{
+  size_t offset = 0;
+
+  while (offset < statement.size())
+  {
+    if (isspace(static_cast<unsigned char>(statement[offset])))
+      ++offset;
+    else if (statement[offset] == '#' || statement.compare(offset, 3, "-- ") == 0 || statement.compare(offset, 3, "--\t") == 0)
+    {
+      offset = statement.find('\n', offset);
+      if (offset == std::string::npos)
+        return false;
+    }
+    else if (statement.compare(offset, 3, "/*!") == 0 || statement.compare(offset, 3, "/*+") == 0)
+    {
+      // Skips the marker and the optional server version
+      offset += 3;
+      while (offset < statement.size() && isdigit(static_cast<unsigned char>(statement[offset])))
+        ++offset;
+    }
+    else if (statement.compare(offset, 2, "/*") == 0)
+    {
+      offset = statement.find("*/", offset + 2);
+      if (offset == std::string::npos)
+        return false;
+      offset += 2;
+    }
+    else
+      break;
+  }
+
+  return boost::istarts_with(statement.c_str() + offset, "call") &&
+         (offset + 4 == statement.size() || !(isalnum(static_cast<unsigned char>(statement[offset + 4])) || statement[offset + 4] == '_'));
+}
+
+/*
+* Sends the statements grouped on queries of up to batch_size bytes, results
+* are processed one statement at a time as they are read. The server stops a
+* query on the first failing statement, so the error is reported for it and
+* the batching resumes on the next one, unless the input must be stopped.
+* Returns true when the rest of the input must be skipped.
+*/
+bool Shell_sql::execute_batched(mysh::mysql::ClassicSession &session, const std::vector<std::string> &statements, size_t batch_size,
+                                boost::function<void(shcore::Value)> result_processor, Value &ret_val)
+{
+  mysh::mysql::Connection *connection = session.connection();
+
+  if (!connection)
+    return statement_failed(shcore::Exception::logic_error("Not connected."), result_processor);
+
+  try
+  {
+    connection->set_multi_statements(true);
+  }
+  catch (shcore::Exception &exc)
+  {
+    return statement_failed(exc, result_processor);
+  }
+
+  bool stopped = false;
+  size_t index = 0;
+  while (index < statements.size() && !stopped)
+  {
+    // A CALL may return several results, it is sent on a query of its own
+    // so every result can be matched to its statement
+    std::string query = statements[index];
+    size_t last = index;
+
+    if (!is_call_statement(statements[index]))
+    {
+      while (last + 1 < statements.size() && query.size() + statements[last + 1].size() + 2 <= batch_size &&
+             !is_call_statement(statements[last + 1]))
+        query.append(";\n").append(statements[++last]);
+    }
+
+    size_t current = index;
+
+    try
+    {
+      ret_val = Value::wrap(new mysh::mysql::ClassicResult(boost::shared_ptr<mysh::mysql::Result>(connection->run_sql(query))));
+
+      while (true)
+      {
+        if (!_killed)
+          result_processor(ret_val);
+        _killed = false;
+
+        if (current == last)
+          break;
+
+        ++current;
+        mysh::mysql::Result *result = connection->next_result();
+
+        // The server answered fewer statements than were sent, the ones left
+        // may not have been executed so an error is reported for each
+        if (!result)
+        {
+          stopped = statement_failed(shcore::Exception::runtime_error("No result was received for: " + statements[current]), result_processor);
+
+          while (!stopped && current < last)
+          {
+            ++current;
+            stopped = statement_failed(shcore::Exception::runtime_error("No result was received for: " + statements[current]), result_processor);
+          }
+
+          break;
+        }
+
+        ret_val = Value::wrap(new mysh::mysql::ClassicResult(boost::shared_ptr<mysh::mysql::Result>(result)));
+      }
+    }
+    catch (shcore::Exception &exc)
+    {
+      stopped = statement_failed(exc, result_processor);
+    }
+
+    for (; index <= current; index++)
+    {
+      if (_last_handled.empty())
+        _last_handled = statements[index];
+      else
+        _last_handled.append("\n").append(statements[index]);
+    }
+  }
+
+  // The option is left on only while batching, runSql keeps rejecting several statements
+  try
+  {
+    connection->set_multi_statements(false);
+  }
+  catch (shcore::Exception &exc)
+  {
+    stopped = statement_failed(exc, result_processor) || stopped;
+  }
+
+  return stopped;
+}
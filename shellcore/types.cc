@@ -18,6 +18,7 @@
  */
 
 #include "shellcore/types.h"
+#include "utils/utils_format.h"
 #include <stdexcept>
 #include <cstdarg>
 #include <boost/format.hpp>
@@ -29,7 +30,12 @@
 #include <cstring>
 #include <sstream>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/error/en.h>
 #include <limits>
+#include <new>
+#include <utility>
 
 using namespace shcore;
 
@@ -137,14 +143,14 @@ Exception Exception::parser_error(const std::string &message)
 const char *Exception::what() const BOOST_NOEXCEPT_OR_NOTHROW
 {
   if ((*_error)["message"].type == String)
-  return (*_error)["message"].value.s->c_str();
+  return (*_error)["message"].value.s.c_str();
   return "?";
 }
 
 const char *Exception::type() const BOOST_NOEXCEPT_OR_NOTHROW
 {
   if ((*_error)["type"].type == String)
-  return (*_error)["type"].value.s->c_str();
+  return (*_error)["type"].value.s.c_str();
   return "Exception";
 }
 
@@ -351,15 +357,27 @@ void Value::Map_type::merge_contents(boost::shared_ptr<Map_type> source, bool ov
 }
 
 Value::Value(const Value &copy)
-  : type(shcore::Null)
+  : type(Undefined)
 {
-  operator=(copy);
+  copy_from(copy);
+}
+
+Value::Value(Value &&other)
+  : type(Undefined)
+{
+  move_from(other);
 }
 
 Value::Value(const std::string &s)
   : type(String)
 {
-  value.s = new std::string(s);
+  new (&value.s) std::string(s);
+}
+
+Value::Value(std::string &&s)
+  : type(String)
+{
+  new (&value.s) std::string(std::move(s));
 }
 
 Value::Value(const char *s)
@@ -367,7 +385,7 @@ Value::Value(const char *s)
   if (s)
   {
     type = String;
-    value.s = new std::string(s);
+    new (&value.s) std::string(s);
   }
   else
   {
@@ -380,7 +398,7 @@ Value::Value(const char *s, size_t n)
   if (s)
   {
     type = String;
-    value.s = new std::string(s, n);
+    new (&value.s) std::string(s, n);
   }
   else
   {
@@ -421,37 +439,42 @@ Value::Value(bool b)
 Value::Value(boost::shared_ptr<Function_base> f)
   : type(Function)
 {
-  value.func = new boost::shared_ptr<Function_base>(f);
+  new (&value.func) boost::shared_ptr<Function_base>(f);
 }
 
 Value::Value(boost::shared_ptr<Object_bridge> n)
   : type(Object)
 {
-  value.o = new boost::shared_ptr<Object_bridge>(n);
+  new (&value.o) boost::shared_ptr<Object_bridge>(n);
 }
 
 Value::Value(Map_type_ref n)
   : type(Map)
 {
-  value.map = new boost::shared_ptr<Map_type>(n);
+  new (&value.map) boost::shared_ptr<Map_type>(n);
 }
 
 Value::Value(boost::weak_ptr<Map_type> n)
   : type(MapRef)
 {
-  value.mapref = new boost::weak_ptr<Map_type>(n);
+  new (&value.mapref) boost::weak_ptr<Map_type>(n);
 }
 
 Value::Value(Array_type_ref n)
   : type(Array)
 {
-  value.array = new boost::shared_ptr<Array_type>(n);
+  new (&value.array) boost::shared_ptr<Array_type>(n);
 }
 
 Value &Value::operator= (const Value &other)
 {
+  if (this == &other)
+    return *this;
+
   if (type == other.type)
   {
+    // Same kind of content, assigned in place so the
+    // string keeps its buffer
     switch (type)
     {
     case Undefined:
@@ -471,96 +494,167 @@ Value &Value::operator= (const Value &other)
       value.d = other.value.d;
       break;
     case String:
-      *value.s = *other.value.s;
+      value.s = other.value.s;
       break;
     case Object:
-      *value.o = *other.value.o;
+      value.o = other.value.o;
       break;
     case Array:
-      *value.array = *other.value.array;
+      value.array = other.value.array;
       break;
     case Map:
-      *value.map = *other.value.map;
+      value.map = other.value.map;
       break;
     case MapRef:
-      *value.mapref = *other.value.mapref;
+      value.mapref = other.value.mapref;
       break;
     case Function:
-      *value.func = *other.value.func;
+      value.func = other.value.func;
       break;
     }
   }
   else
   {
-    switch (type)
-    {
-    case Undefined:
-    case shcore::Null:
-    case Bool:
-    case Integer:
-    case UInteger:
-    case Float:
-      break;
-    case String:
-      delete value.s;
-      break;
-    case Object:
-      delete value.o;
-      break;
-    case Array:
-      delete value.array;
-      break;
-    case Map:
-      delete value.map;
-      break;
-    case MapRef:
-      delete value.mapref;
-      break;
-    case Function:
-      delete value.func;
-      break;
-    }
-    type = other.type;
-    switch (type)
-    {
-    case Undefined:
-    case shcore::Null:
-      break;
-    case Bool:
-      value.b = other.value.b;
-      break;
-    case Integer:
-      value.i = other.value.i;
-      break;
-    case UInteger:
-      value.ui = other.value.ui;
-      break;
-    case Float:
-      value.d = other.value.d;
-      break;
-    case String:
-      value.s = new std::string(*other.value.s);
-      break;
-    case Object:
-      value.o = new boost::shared_ptr<Object_bridge>(*other.value.o);
-      break;
-    case Array:
-      value.array = new boost::shared_ptr<Array_type>(*other.value.array);
-      break;
-    case Map:
-      value.map = new boost::shared_ptr<Map_type>(*other.value.map);
-      break;
-    case MapRef:
-      value.mapref = new boost::weak_ptr<Map_type>(*other.value.mapref);
-      break;
-    case Function:
-      value.func = new boost::shared_ptr<Function_base>(*other.value.func);
-      break;
-    }
+    // other may be owned by this value (i.e. an element of its array)
+    Value copy(other);
+
+    release();
+    move_from(copy);
   }
   return *this;
 }
 
+Value &Value::operator= (Value &&other)
+{
+  if (this != &other)
+  {
+    // other may be owned by this value, it's detached before releasing
+    Value tmp(std::move(other));
+
+    release();
+    move_from(tmp);
+  }
+  return *this;
+}
+
+void Value::copy_from(const Value &other)
+{
+  switch (other.type)
+  {
+  case Undefined:
+  case shcore::Null:
+    break;
+  case Bool:
+    value.b = other.value.b;
+    break;
+  case Integer:
+    value.i = other.value.i;
+    break;
+  case UInteger:
+    value.ui = other.value.ui;
+    break;
+  case Float:
+    value.d = other.value.d;
+    break;
+  case String:
+    new (&value.s) std::string(other.value.s);
+    break;
+  case Object:
+    new (&value.o) boost::shared_ptr<Object_bridge>(other.value.o);
+    break;
+  case Array:
+    new (&value.array) boost::shared_ptr<Array_type>(other.value.array);
+    break;
+  case Map:
+    new (&value.map) boost::shared_ptr<Map_type>(other.value.map);
+    break;
+  case MapRef:
+    new (&value.mapref) boost::weak_ptr<Map_type>(other.value.mapref);
+    break;
+  case Function:
+    new (&value.func) boost::shared_ptr<Function_base>(other.value.func);
+    break;
+  }
+  type = other.type;
+}
+
+void Value::move_from(Value &other)
+{
+  switch (other.type)
+  {
+  case Undefined:
+  case shcore::Null:
+    break;
+  case Bool:
+    value.b = other.value.b;
+    break;
+  case Integer:
+    value.i = other.value.i;
+    break;
+  case UInteger:
+    value.ui = other.value.ui;
+    break;
+  case Float:
+    value.d = other.value.d;
+    break;
+  case String:
+    new (&value.s) std::string(std::move(other.value.s));
+    break;
+  case Object:
+    new (&value.o) boost::shared_ptr<Object_bridge>(std::move(other.value.o));
+    break;
+  case Array:
+    new (&value.array) boost::shared_ptr<Array_type>(std::move(other.value.array));
+    break;
+  case Map:
+    new (&value.map) boost::shared_ptr<Map_type>(std::move(other.value.map));
+    break;
+  case MapRef:
+    new (&value.mapref) boost::weak_ptr<Map_type>(std::move(other.value.mapref));
+    break;
+  case Function:
+    new (&value.func) boost::shared_ptr<Function_base>(std::move(other.value.func));
+    break;
+  }
+  type = other.type;
+
+  // The moved from value is left undefined
+  other.release();
+}
+
+void Value::release()
+{
+  switch (type)
+  {
+  case Undefined:
+  case shcore::Null:
+  case Bool:
+  case Integer:
+  case UInteger:
+  case Float:
+    break;
+  case String:
+    value.s.~basic_string();
+    break;
+  case Object:
+    value.o.~shared_ptr();
+    break;
+  case Array:
+    value.array.~shared_ptr();
+    break;
+  case Map:
+    value.map.~shared_ptr();
+    break;
+  case MapRef:
+    value.mapref.~weak_ptr();
+    break;
+  case Function:
+    value.func.~shared_ptr();
+    break;
+  }
+  type = Undefined;
+}
+
 Value Value::parse_map(char **pc)
 {
   Map_type_ref map(new Map_type());
@@ -832,6 +926,127 @@ Value Value::parse_number(char **pcc)
   return ret_val;
 }
 
+namespace
+{
+  // Builds a Value straight from the rapidjson parser events, containers
+  // being filled are kept on a stack
+  class Json_value_builder : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Json_value_builder>
+  {
+  public:
+    bool Null() { return add(Value::Null()); }
+    bool Bool(bool b) { return add(Value(b)); }
+    bool Int(int i) { return add(Value(i)); }
+    bool Uint(unsigned u) { return add(Value(static_cast<int64_t>(u))); }
+    bool Int64(int64_t i) { return add(Value(i)); }
+    bool Uint64(uint64_t u)
+    {
+      if (u > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+        return add(Value(u));
+      return add(Value(static_cast<int64_t>(u)));
+    }
+    bool Double(double d) { return add(Value(d)); }
+    bool String(const char *str, rapidjson::SizeType length, bool) { return add(Value(str, length)); }
+
+    bool Key(const char *str, rapidjson::SizeType length, bool)
+    {
+      _key.assign(str, length);
+      return true;
+    }
+
+    bool StartObject()
+    {
+      Value::Map_type_ref map(new Value::Map_type());
+      Container container = { map.get(), NULL };
+
+      add(Value(map));
+      _stack.push_back(container);
+      return true;
+    }
+
+    bool EndObject(rapidjson::SizeType)
+    {
+      _stack.pop_back();
+      return true;
+    }
+
+    bool StartArray()
+    {
+      Value::Array_type_ref array(new Value::Array_type());
+      Container container = { NULL, array.get() };
+
+      add(Value(array));
+      _stack.push_back(container);
+      return true;
+    }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+      _stack.pop_back();
+      return true;
+    }
+
+    Value &result() { return _result; }
+
+  private:
+    bool add(Value &&value)
+    {
+      if (_stack.empty())
+        _result = std::move(value);
+      else if (_stack.back().map)
+        (*_stack.back().map)[_key] = std::move(value);
+      else
+        _stack.back().array->push_back(std::move(value));
+
+      return true;
+    }
+
+    // Containers are owned by the values already added to their parent
+    struct Container
+    {
+      Value::Map_type *map;
+      Value::Array_type *array;
+    };
+
+    std::vector<Container> _stack;
+    std::string _key;
+    Value _result;
+  };
+
+  void throw_json_error(const rapidjson::ParseResult &result)
+  {
+    std::string msg = "Error parsing JSON: ";
+    msg.append(rapidjson::GetParseError_En(result.Code()));
+    msg.append(" at offset " + boost::lexical_cast<std::string>(result.Offset()));
+    throw Exception::parser_error(msg);
+  }
+}
+
+Value Value::parse_json(const char *data, size_t length)
+{
+  rapidjson::Reader reader;
+  rapidjson::MemoryStream stream(data, length);
+  Json_value_builder builder;
+
+  rapidjson::ParseResult result = reader.Parse(stream, builder);
+  if (result.IsError())
+    throw_json_error(result);
+
+  return std::move(builder.result());
+}
+
+Value Value::parse_json_in_situ(char *data)
+{
+  rapidjson::Reader reader;
+  rapidjson::InsituStringStream stream(data);
+  Json_value_builder builder;
+
+  rapidjson::ParseResult result = reader.Parse<rapidjson::kParseInsituFlag>(stream, builder);
+  if (result.IsError())
+    throw_json_error(result);
+
+  return std::move(builder.result());
+}
+
 bool my_strnicmp(const char *c1, const char *c2, size_t n)
 {
   return boost::iequals(boost::make_iterator_range(c1, c1 + n), boost::make_iterator_range(c2, c2 + n));
@@ -923,17 +1138,17 @@ bool Value::operator == (const Value &other) const
     case Float:
       return value.d == other.value.d;
     case String:
-      return *value.s == *other.value.s;
+      return value.s == other.value.s;
     case Object:
-      return **value.o == **other.value.o;
+      return *value.o == *other.value.o;
     case Array:
-      return **value.array == **other.value.array;
+      return *value.array == *other.value.array;
     case Map:
-      return **value.map == **other.value.map;
+      return *value.map == *other.value.map;
     case MapRef:
-      return *value.mapref->lock() == *other.value.mapref->lock();
+      return *value.mapref.lock() == *other.value.mapref.lock();
     case Function:
-      return **value.func == **other.value.func;
+      return *value.func == *other.value.func;
     }
   }
   else
@@ -1049,42 +1264,30 @@ std::string &Value::append_descr(std::string &s_out, int indent, int quote_strin
       s_out += "false";
     break;
   case Integer:
-  {
-    boost::format fmt("%ld");
-    fmt % value.i;
-    s_out += fmt.str();
-  }
+    append_int(s_out, value.i);
     break;
   case UInteger:
-  {
-    boost::format fmt("%ld");
-    fmt % value.ui;
-    s_out += fmt.str();
-  }
+    append_uint(s_out, value.ui);
     break;
   case Float:
-  {
-    boost::format fmt("%g");
-    fmt % value.d;
-    s_out += fmt.str();
-  }
+    append_double(s_out, value.d);
     break;
   case String:
     if (quote_strings)
-      s_out += (char)quote_strings + *value.s + (char)quote_strings;
+      s_out += (char)quote_strings + value.s + (char)quote_strings;
     else
-      s_out += *value.s;
+      s_out += value.s;
     break;
   case Object:
-    if (!value.o || !*value.o)
+    if (!value.o)
       throw Exception::value_error("Invalid object value encountered");
     as_object()->append_descr(s_out, indent, quote_strings);
     break;
   case Array:
   {
-    if (!value.array || !*value.array)
+    if (!value.array)
       throw Exception::value_error("Invalid array value encountered");
-    Array_type *vec = value.array->get();
+    Array_type *vec = value.array.get();
     Array_type::iterator myend = vec->end(), mybegin = vec->begin();
     s_out += "[";
     for (Array_type::iterator iter = mybegin; iter != myend; ++iter)
@@ -1104,9 +1307,9 @@ std::string &Value::append_descr(std::string &s_out, int indent, int quote_strin
     break;
   case Map:
   {
-    if (!value.map || !*value.map)
+    if (!value.map)
       throw Exception::value_error("Invalid map value encountered");
-    Map_type *map = value.map->get();
+    Map_type *map = value.map.get();
     Map_type::iterator myend = map->end(), mybegin = map->begin();
     s_out += "{" + nl;
     for (Map_type::iterator iter = mybegin; iter != myend; ++iter)
@@ -1154,29 +1357,17 @@ std::string &Value::append_repr(std::string &s_out) const
       s_out += "false";
     break;
   case Integer:
-  {
-    boost::format fmt("%ld");
-    fmt % value.i;
-    s_out += fmt.str();
-  }
+    append_int(s_out, value.i);
     break;
   case UInteger:
-  {
-    boost::format fmt("%ld");
-    fmt % value.ui;
-    s_out += fmt.str();
-  }
+    append_uint(s_out, value.ui);
     break;
   case Float:
-  {
-    boost::format fmt("%g");
-    fmt % value.d;
-    s_out += fmt.str();
-  }
+    append_double(s_out, value.d);
     break;
   case String:
   {
-    std::string &s = *value.s;
+    const std::string &s = value.s;
     s_out += "\"";
     for (size_t i = 0; i < s.length(); i++)
     {
@@ -1223,11 +1414,11 @@ std::string &Value::append_repr(std::string &s_out) const
   }
     break;
   case Object:
-    s_out = (*value.o)->append_repr(s_out);
+    s_out = value.o->append_repr(s_out);
     break;
   case Array:
   {
-    Array_type *vec = value.array->get();
+    Array_type *vec = value.array.get();
     Array_type::iterator myend = vec->end(), mybegin = vec->begin();
     s_out += "[";
     for (Array_type::iterator iter = mybegin; iter != myend; ++iter)
@@ -1241,7 +1432,7 @@ std::string &Value::append_repr(std::string &s_out) const
     break;
   case Map:
   {
-    Map_type *map = value.map->get();
+    Map_type *map = value.map.get();
     Map_type::iterator myend = map->end(), mybegin = map->begin();
     s_out += "{";
     for (Map_type::iterator iter = mybegin; iter != myend; ++iter)
@@ -1268,34 +1459,7 @@ std::string &Value::append_repr(std::string &s_out) const
 
 Value::~Value()
 {
-  switch (type)
-  {
-  case Undefined:
-  case shcore::Null:
-  case Bool:
-  case Integer:
-  case UInteger:
-  case Float:
-    break;
-  case String:
-    delete value.s;
-    break;
-  case Object:
-    delete value.o;
-    break;
-  case Array:
-    delete value.array;
-    break;
-  case Map:
-    delete value.map;
-    break;
-  case MapRef:
-    delete value.mapref;
-    break;
-  case Function:
-    delete value.func;
-    break;
-  }
+  release();
 }
 
 void Value::check_type(Value_type t) const
@@ -1355,7 +1519,7 @@ const std::string &Argument_list::string_at(unsigned int i) const
     throw Exception::argument_error("Insufficient number of arguments");
   if (at(i).type != String)
     throw Exception::type_error((boost::format("Argument #%1% is expected to be a string") % (i + 1)).str());
-  return *at(i).value.s;
+  return at(i).value.s;
 }
 
 bool Argument_list::bool_at(unsigned int i) const
@@ -1417,7 +1581,7 @@ boost::shared_ptr<Object_bridge> Argument_list::object_at(unsigned int i) const
     throw Exception::argument_error("Insufficient number of arguments");
   if (at(i).type != Object)
     throw Exception::type_error((boost::format("Argument #%1% is expected to be an object") % (i + 1)).str());
-  return *at(i).value.o;
+  return at(i).value.o;
 }
 
 boost::shared_ptr<Value::Map_type> Argument_list::map_at(unsigned int i) const
@@ -1426,7 +1590,7 @@ boost::shared_ptr<Value::Map_type> Argument_list::map_at(unsigned int i) const
     throw Exception::argument_error("Insufficient number of arguments");
   if (at(i).type != Map)
     throw Exception::type_error((boost::format("Argument #%1% is expected to be a map") % (i + 1)).str());
-  return *at(i).value.map;
+  return at(i).value.map;
 }
 
 boost::shared_ptr<Value::Array_type> Argument_list::array_at(unsigned int i) const
@@ -1435,7 +1599,7 @@ boost::shared_ptr<Value::Array_type> Argument_list::array_at(unsigned int i) con
     throw Exception::argument_error("Insufficient number of arguments");
   if (at(i).type != Array)
     throw Exception::type_error((boost::format("Argument #%1% is expected to be an array") % (i + 1)).str());
-  return *at(i).value.array;
+  return at(i).value.array;
 }
 
 void Argument_list::ensure_count(unsigned int c, const char *context) const
@@ -133,6 +133,15 @@ _options(options)
   SET_SHELL_COMMAND("\\status|\\s", "Print information about the current global connection.", "", Interactive_shell::cmd_status);
   SET_SHELL_COMMAND("\\use|\\u", "Set the current schema for the global session.", cmd_help_use, Interactive_shell::cmd_use);
 
+  const std::string cmd_help_metrics =
+    "SYNTAX:\n"
+    "   \\metrics [reset]\n\n"
+    "Prints the protocol counters of the global session: messages and bytes by type, "
+    "rows and bytes decoded and the round trip latency histograms of each operation.\n"
+    "When reset is given the counters are cleared after being printed.\n";
+
+  SET_SHELL_COMMAND("\\metrics", "Print protocol metrics of the current global connection.", cmd_help_metrics, Interactive_shell::cmd_metrics);
+
   const std::string cmd_help_store_connection =
     "SYNTAX:\n"
     "   \\savecon [-f] <SESSION_CONFIG_NAME> <URI>\n\n"
@@ -248,6 +257,8 @@ bool Interactive_shell::connect(bool primary_session)
                                      _options.ssl != 0,
                                      _options.ssl_ca, _options.ssl_cert, _options.ssl_key,
                                      _options.auth_method);
+      if (_options.compress)
+        (*connection_data)["compression"] = Value::True();
       if (_options.auth_method == "PLAIN")
         _delegate.print(_delegate.user_data, "mysqlx: [Warning] PLAIN authentication method is NOT secure!\n");
 
@@ -942,6 +953,33 @@ bool Interactive_shell::cmd_status(const std::vector<std::string>& UNUSED(args))
   return true;
 }
 
+bool Interactive_shell::cmd_metrics(const std::vector<std::string>& args)
+{
+  if (_shell->get_dev_session() && _shell->get_dev_session()->is_connected())
+  {
+    if (args.size() > 2 || (args.size() == 2 && args[1] != "reset"))
+    {
+      print_error("\\metrics only accepts 'reset' as argument\n");
+      return true;
+    }
+
+    shcore::Value metrics = _shell->get_dev_session()->get_metrics();
+    std::string format = (*Shell_core_options::get())[SHCORE_OUTPUT_FORMAT].as_string();
+
+    if (format.find("json") == 0)
+      println(metrics.json(format == "json"));
+    else
+      println(metrics.descr(true));
+
+    if (args.size() == 2)
+      _shell->get_dev_session()->reset_metrics();
+  }
+  else
+    _delegate.print_error(_delegate.user_data, "Not Connected.\n");
+
+  return true;
+}
+
 bool Interactive_shell::cmd_use(const std::vector<std::string>& args)
 {
   std::string error;
@@ -1418,6 +1456,7 @@ void Interactive_shell::print_cmd_line_helper()
   println("  --ssl-ca=name            CA file in PEM format (check OpenSSL docs)");
   println("  --passwords-from-stdin   Read passwords from stdin instead of the tty");
   println("  --auth-method=method     Authentication method to use");
+  println("  -C, --compress           Use compression in the client/server protocol if supported");
   println("  --show-warnings          Automatically display SQL warnings on SQL mode if available");
   println("  --dba enableXProtocol    Enable the X Protocol in the server connected to. Must be used with --classic");
 
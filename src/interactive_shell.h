@@ -58,6 +58,7 @@ public:
   bool cmd_delete_connection(const std::vector<std::string>& args);
   bool cmd_list_connections(const std::vector<std::string>& args);
   bool cmd_status(const std::vector<std::string>& args);
+  bool cmd_metrics(const std::vector<std::string>& args);
   bool cmd_use(const std::vector<std::string>& args);
 
   void print_banner();
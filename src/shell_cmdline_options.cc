@@ -56,6 +56,7 @@ Shell_command_line_options::Shell_command_line_options(int argc, char **argv)
   password = NULL;
   prompt_password = false;
   trace_protocol = false;
+  compress = false;
   wizards = true;
 
   sock = "";
@@ -222,6 +223,8 @@ Shell_command_line_options::Shell_command_line_options(int argc, char **argv)
       output_format = "table";
     else if (check_arg(argv, i, "--trace-proto", NULL))
       trace_protocol = true;
+    else if (check_arg(argv, i, "--compress", "-C"))
+      compress = true;
     else if (check_arg(argv, i, "--help", "--help"))
     {
       print_cmd_line_helper = true;
@@ -297,5 +300,6 @@ bool Shell_command_line_options::has_connection_data()
          ssl == 1 ||
          !ssl_ca.empty() ||
          !ssl_cert.empty() ||
-         !ssl_key.empty();
+         !ssl_key.empty() ||
+         compress;
 }
\ No newline at end of file
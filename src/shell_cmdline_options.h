@@ -40,6 +40,7 @@ public:
   std::string schema;
   std::string sock;
   std::string auth_method;
+  bool compress;
 
   std::string protocol;
 
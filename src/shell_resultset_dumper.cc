@@ -20,9 +20,9 @@
 #include "shell_resultset_dumper.h"
 #include "shellcore/shell_core_options.h"
 #include <boost/format.hpp>
-#include <boost/lexical_cast.hpp>
 #include "modules/mod_mysql_resultset.h"
 #include "modules/mod_mysqlx_resultset.h"
+#include "utils/utils_time.h"
 
 using namespace shcore;
 
@@ -30,11 +30,12 @@ using namespace shcore;
 #define MIN_COLUMN_LENGTH 4
 
 ResultsetDumper::ResultsetDumper(boost::shared_ptr<mysh::ShellBaseResult> target, bool buffer_data) :
-_resultset(target), _buffer_data(buffer_data)
+_resultset(target), _buffer_data(buffer_data), _formatting_time(0)
 {
   _format = Shell_core_options::get()->get_string(SHCORE_OUTPUT_FORMAT);
   _interactive = Shell_core_options::get()->get_bool(SHCORE_INTERACTIVE);
   _show_warnings = Shell_core_options::get()->get_bool(SHCORE_SHOW_WARNINGS);
+  _show_timing = Shell_core_options::get()->get_bool(SHCORE_SHOW_TIMING);
 }
 
 void ResultsetDumper::dump()
@@ -192,7 +193,11 @@ void ResultsetDumper::dump_normal(boost::shared_ptr<mysh::mysqlx::DocResult> res
 
   if (array_docs->size())
   {
+    MySQL_timer timer;
+    timer.start();
     shcore::print(documents.json(_format != "json/raw") + "\n");
+    timer.end();
+    _formatting_time = timer.duration_usec();
 
     int row_count = int(array_docs->size());
     output = (boost::format("%lld %s in set") % row_count % (row_count == 1 ? "document" : "documents")).str();
@@ -246,17 +251,19 @@ void ResultsetDumper::dump_tabbed(shcore::Value::Array_type_ref records)
     shcore::print(index < (field_count - 1) ? "\t" : "\n");
   }
 
-  // Now prints the records
+  // Now prints the records, each line is formatted into the same buffer
+  std::string line;
   for (size_t row_index = 0; row_index < records->size(); row_index++)
   {
     boost::shared_ptr<mysh::Row> row = (*records)[row_index].as_object<mysh::Row>();
 
+    line.clear();
     for (size_t field_index = 0; field_index < field_count; field_index++)
     {
-      std::string raw_value = row->get_member(field_index).descr();
-      shcore::print(raw_value);
-      shcore::print(field_index < (field_count - 1) ? "\t" : "\n");
+      row->get_member(field_index).append_descr(line);
+      line.append(field_index < (field_count - 1) ? "\t" : "\n");
     }
+    shcore::print(line);
   }
 }
 
@@ -283,29 +290,26 @@ void ResultsetDumper::dump_table(shcore::Value::Array_type_ref records)
 
   // Now updates the length with the real column data lengths
   size_t row_index;
+  std::string value;
   for (row_index = 0; row_index < records->size(); row_index++)
   {
     boost::shared_ptr<mysh::Row> row = (*records)[row_index].as_object<mysh::Row>();
     for (size_t field_index = 0; field_index < field_count; field_index++)
-      max_lengths[field_index] = std::max<uint64_t>(max_lengths[field_index], row->get_member(field_index).descr().length());
+    {
+      value.clear();
+      row->get_member(field_index).append_descr(value);
+      max_lengths[field_index] = std::max<uint64_t>(max_lengths[field_index], value.length());
+    }
   }
 
   //-----------
 
   size_t index = 0;
-  std::vector<std::string> formats(field_count, "%-");
 
   // Calculates the max column widths and constructs the separator line.
   std::string separator("+");
   for (index = 0; index < field_count; index++)
   {
-    // Creates the format string to print each field
-    formats[index].append(boost::lexical_cast<std::string>(max_lengths[index]));
-    if (index == field_count - 1)
-      formats[index].append("s |");
-    else
-      formats[index].append("s | ");
-
     std::string field_separator(max_lengths[index] + 2, '-');
     field_separator.append("+");
     separator.append(field_separator);
@@ -314,35 +318,38 @@ void ResultsetDumper::dump_table(shcore::Value::Array_type_ref records)
 
   // Prints the initial separator line and the column headers
   // TODO: Consider the charset information on the length calculations
-  shcore::print(separator + "| ");
+  std::string line(separator + "| ");
   for (index = 0; index < field_count; index++)
   {
-    std::string data = (boost::format(formats[index]) % column_names[index]).str();
-    shcore::print(data);
-
-    // Once the header is printed, updates the numeric fields formats
-    // so they are right aligned
-    if (numerics[index])
-    formats[index] = formats[index].replace(1, 1, "");
+    line.append(column_names[index]);
+    line.append(max_lengths[index] - column_names[index].length(), ' ');
+    line.append(index == field_count - 1 ? " |" : " | ");
   }
 
-  shcore::print("\n" + separator);
+  shcore::print(line + "\n" + separator);
 
-  // Now prints the records
+  // Now prints the records, numeric fields are right aligned
   for (row_index = 0; row_index < records->size(); row_index++)
   {
-    shcore::print("| ");
-
     boost::shared_ptr<mysh::Row> row = (*records)[row_index].as_object<mysh::Row>();
 
+    line.assign("| ");
     for (size_t field_index = 0; field_index < field_count; field_index++)
     {
-      std::string raw_value = row->get_member(field_index).descr();
-      std::string data = (boost::format(formats[field_index]) % (raw_value)).str();
+      value.clear();
+      row->get_member(field_index).append_descr(value);
+
+      const size_t padding = max_lengths[field_index] - value.length();
+      if (numerics[field_index])
+        line.append(padding, ' ').append(value);
+      else
+        line.append(value).append(padding, ' ');
 
-      shcore::print(data);
+      line.append(field_index == field_count - 1 ? " |" : " | ");
     }
-    shcore::print("\n");
+    line.append("\n");
+
+    shcore::print(line);
   }
 
   shcore::print(separator);
@@ -378,11 +385,35 @@ int ResultsetDumper::get_warning_and_execution_time_stats(std::string& output_st
     output_stats.append(" ");
     output_stats.append((boost::format("(%s)") % _resultset->get_member("executionTime").as_string()).str());
     output_stats.append("\n");
+
+    if (_show_timing)
+      append_timing(output_stats);
   }
 
   return warning_count;
 }
 
+void ResultsetDumper::append_timing(std::string& output_stats)
+{
+  static const char *phases[][2] = {
+    { "send", "send" },
+    { "firstMetadata", "first metadata" },
+    { "firstRow", "first row" },
+    { "streaming", "streaming" }
+  };
+
+  shcore::Value::Map_type_ref timing = _resultset->get_member("timing").as_map();
+
+  output_stats.append("Timing:");
+  for (size_t index = 0; index < sizeof(phases) / sizeof(phases[0]); index++)
+    output_stats.append((boost::format(" %s %.3f ms,") % phases[index][1] % (timing->get_uint(phases[index][0]) / 1000.0)).str());
+
+  output_stats.append((boost::format(" formatting %.3f ms\n") % (_formatting_time / 1000.0)).str());
+
+  // Next data set is measured from scratch
+  _formatting_time = 0;
+}
+
 void ResultsetDumper::dump_records(std::string& output_stats)
 {
   shcore::Value records = _resultset->call("fetchAll", shcore::Argument_list());
@@ -391,11 +422,17 @@ void ResultsetDumper::dump_records(std::string& output_stats)
   if (array_records->size())
   {
     // print rows from result, with stats etc
+    MySQL_timer timer;
+    timer.start();
+
     if (_interactive || _format == "table")
       dump_table(array_records);
     else
       dump_tabbed(array_records);
 
+    timer.end();
+    _formatting_time = timer.duration_usec();
+
     int row_count = int(array_records->size());
     output_stats = (boost::format("%lld %s in set") % row_count % (row_count == 1 ? "row" : "rows")).str();
   }
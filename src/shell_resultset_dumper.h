@@ -50,9 +50,13 @@ protected:
   boost::shared_ptr<mysh::ShellBaseResult>_resultset;
   std::string _format;
   bool _show_warnings;
+  bool _show_timing;
   bool _interactive;
   bool _buffer_data;
 
+  // Time spent formatting the records, in microseconds
+  uint64_t _formatting_time;
+
   void dump_json();
   void dump_normal();
   void dump_normal(boost::shared_ptr<mysh::mysql::ClassicResult> result);
@@ -63,6 +67,7 @@ protected:
 
   std::string get_affected_stats(const std::string& member, const std::string &legend);
   int get_warning_and_execution_time_stats(std::string& output_stats);
+  void append_timing(std::string& output_stats);
   void dump_records(std::string& output_stats);
   void dump_tabbed(shcore::Value::Array_type_ref records);
   void dump_table(shcore::Value::Array_type_ref records);
@@ -0,0 +1,99 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <chrono>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+
+namespace benchmarks
+{
+  typedef std::chrono::steady_clock Clock;
+
+  // Passed to every benchmark, the body has to run the measured
+  // operation iterations() times.
+  class State
+  {
+  public:
+    explicit State(const uint64_t iterations);
+
+    uint64_t iterations() const { return m_iterations; }
+
+    // Work done by a single iteration, used to report the rates
+    void set_bytes_per_iteration(const uint64_t bytes) { m_bytes = bytes; }
+    void set_items_per_iteration(const uint64_t items) { m_items = items; }
+
+    // Leaves the setup done so far out of the measured time
+    void reset_timer() { m_start = Clock::now(); }
+
+    Clock::time_point start() const { return m_start; }
+    uint64_t bytes() const { return m_bytes; }
+    uint64_t items() const { return m_items; }
+
+  private:
+    uint64_t m_iterations;
+    uint64_t m_bytes;
+    uint64_t m_items;
+    Clock::time_point m_start;
+  };
+
+  typedef void(*Function)(State &state);
+
+  class Registrar
+  {
+  public:
+    Registrar(const char *group, const char *name, Function function);
+  };
+
+  // Pseudo random numbers with a fixed seed, every build has
+  // to measure exactly the same data
+  class Random
+  {
+  public:
+    explicit Random(const uint32_t seed = 1) : m_state(seed) {}
+
+    uint32_t next()
+    {
+      m_state = m_state * 1103515245U + 12345U;
+      return m_state >> 8;
+    }
+
+    uint32_t next(const uint32_t max) { return next() % max; }
+
+  private:
+    uint32_t m_state;
+  };
+
+  // Keeps the compiler from optimizing away results that are not used
+  void consume(const uint64_t value);
+
+  // Server response recorded with --capture, empty when the
+  // benchmarks have to generate their own
+  const std::string &capture_file();
+}
+
+#define BENCHMARK(group, name) \
+  static void benchmark_##group##_##name(benchmarks::State &state); \
+  static benchmarks::Registrar registrar_##group##_##name(#group, #name, benchmark_##group##_##name); \
+  static void benchmark_##group##_##name(benchmarks::State &state)
+
+#endif
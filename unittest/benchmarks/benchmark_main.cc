@@ -0,0 +1,400 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include "benchmark.h"
+
+using namespace benchmarks;
+
+namespace
+{
+  struct Benchmark
+  {
+    std::string name;
+    Function function;
+  };
+
+  struct Result
+  {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    double ns_per_op_min;
+    double ns_per_op_max;
+    double bytes_per_second;
+    double items_per_second;
+  };
+
+  struct Options
+  {
+    Options() : list(false), repetitions(5), min_time_ms(200) {}
+
+    std::string filter;
+    bool list;
+    int repetitions;
+    int min_time_ms;
+    std::string json_file;
+    std::string compare_file;
+    std::string capture_file;
+  };
+
+  std::vector<Benchmark> &registry()
+  {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+  }
+
+  Options options;
+  volatile uint64_t sink = 0;
+
+  bool get_option(const char *arg, const char *name, std::string &value)
+  {
+    const size_t length = strlen(name);
+
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=')
+      return false;
+
+    value = arg + length + 1;
+    return true;
+  }
+
+  void print_usage(const char *program)
+  {
+    std::cout << "Usage: " << program << " [options]\n"
+      "  --list                 Lists the benchmarks and exits\n"
+      "  --filter=<text>        Runs only the benchmarks with <text> in their name\n"
+      "  --repetitions=<n>      Measured runs per benchmark, the median is reported (default 5)\n"
+      "  --min-time=<ms>        Minimum duration of each run (default 200)\n"
+      "  --json=<file>          Writes the results as JSON, - for the standard output\n"
+      "  --compare=<file>       Compares the results with the ones of a previous --json run\n"
+      "  --capture=<file>       X protocol resultset recorded from a server, replayed\n"
+      "                         instead of the generated one\n";
+  }
+
+  bool parse_options(int argc, char **argv)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string value;
+
+      if (strcmp(argv[i], "--list") == 0)
+        options.list = true;
+      else if (get_option(argv[i], "--filter", value))
+        options.filter = value;
+      else if (get_option(argv[i], "--repetitions", value))
+        options.repetitions = std::max(1, atoi(value.c_str()));
+      else if (get_option(argv[i], "--min-time", value))
+        options.min_time_ms = std::max(1, atoi(value.c_str()));
+      else if (get_option(argv[i], "--json", value))
+        options.json_file = value;
+      else if (get_option(argv[i], "--compare", value))
+        options.compare_file = value;
+      else if (get_option(argv[i], "--capture", value))
+        options.capture_file = value;
+      else
+      {
+        print_usage(argv[0]);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  double run(const Benchmark &benchmark, State &state)
+  {
+    state.reset_timer();
+    benchmark.function(state);
+
+    return std::chrono::duration<double, std::nano>(Clock::now() - state.start()).count();
+  }
+
+  Result measure(const Benchmark &benchmark)
+  {
+    const double min_time_ns = options.min_time_ms * 1e6;
+    uint64_t iterations = 1;
+
+    // Grows the iteration count until a run lasts at least min_time
+    for (;;)
+    {
+      State state(iterations);
+      const double elapsed = run(benchmark, state);
+
+      if (elapsed >= min_time_ns || iterations >= 1000000000)
+        break;
+
+      double factor = elapsed > 0 ? min_time_ns * 1.4 / elapsed : 100;
+      factor = std::min(std::max(factor, 2.0), 100.0);
+      iterations = static_cast<uint64_t>(iterations * factor);
+    }
+
+    std::vector<double> samples;
+    uint64_t bytes = 0;
+    uint64_t items = 0;
+
+    for (int i = 0; i < options.repetitions; ++i)
+    {
+      State state(iterations);
+      samples.push_back(run(benchmark, state) / iterations);
+      bytes = state.bytes();
+      items = state.items();
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.ns_per_op = samples[samples.size() / 2];
+    result.ns_per_op_min = samples.front();
+    result.ns_per_op_max = samples.back();
+    result.bytes_per_second = bytes * 1e9 / result.ns_per_op;
+    result.items_per_second = items * 1e9 / result.ns_per_op;
+
+    return result;
+  }
+
+  std::string to_json(const std::vector<Result> &results)
+  {
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    char date[32];
+    time_t now = time(NULL);
+
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    writer.StartObject();
+    writer.String("context");
+    writer.StartObject();
+    writer.String("date");
+    writer.String(date);
+#ifdef NDEBUG
+    writer.String("build_type");
+    writer.String("release");
+#else
+    writer.String("build_type");
+    writer.String("debug");
+#endif
+    writer.String("repetitions");
+    writer.Int(options.repetitions);
+    writer.String("min_time_ms");
+    writer.Int(options.min_time_ms);
+    writer.String("capture");
+    writer.String(options.capture_file.c_str());
+    writer.EndObject();
+
+    writer.String("benchmarks");
+    writer.StartArray();
+    for (std::vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it)
+    {
+      writer.StartObject();
+      writer.String("name");
+      writer.String(it->name.c_str());
+      writer.String("iterations");
+      writer.Uint64(it->iterations);
+      writer.String("ns_per_op");
+      writer.Double(it->ns_per_op);
+      writer.String("ns_per_op_min");
+      writer.Double(it->ns_per_op_min);
+      writer.String("ns_per_op_max");
+      writer.Double(it->ns_per_op_max);
+      writer.String("bytes_per_second");
+      writer.Double(it->bytes_per_second);
+      writer.String("items_per_second");
+      writer.Double(it->items_per_second);
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    return std::string(buffer.GetString(), buffer.GetSize()) + "\n";
+  }
+
+  // ns_per_op of every benchmark in a file written with --json
+  std::map<std::string, double> load_baseline(const std::string &path)
+  {
+    std::ifstream file(path.c_str());
+    if (!file)
+      throw std::runtime_error("Unable to open " + path);
+
+    std::stringstream data;
+    data << file.rdbuf();
+
+    rapidjson::Document document;
+    const std::string text = data.str();
+    document.Parse(text.c_str());
+
+    if (document.HasParseError() || !document.IsObject() ||
+        !document.HasMember("benchmarks") || !document["benchmarks"].IsArray())
+      throw std::runtime_error(path + " does not contain benchmark results");
+
+    std::map<std::string, double> baseline;
+    const rapidjson::Value &benchmarks = document["benchmarks"];
+
+    for (rapidjson::SizeType i = 0; i < benchmarks.Size(); ++i)
+    {
+      const rapidjson::Value &item = benchmarks[i];
+
+      if (item.IsObject() && item.HasMember("name") && item["name"].IsString() &&
+          item.HasMember("ns_per_op") && item["ns_per_op"].IsNumber())
+        baseline[item["name"].GetString()] = item["ns_per_op"].GetDouble();
+    }
+
+    return baseline;
+  }
+
+  void print_header(const bool compare)
+  {
+    printf("%-36s %12s %14s %10s %14s", "Benchmark", "Iterations", "ns/op", "MB/s", "items/s");
+    if (compare)
+      printf(" %14s %8s", "baseline ns/op", "change");
+    printf("\n");
+  }
+
+  void print_result(const Result &result, const std::map<std::string, double> *baseline)
+  {
+    printf("%-36s %12llu %14.1f %10.1f %14.0f", result.name.c_str(),
+           static_cast<unsigned long long>(result.iterations), result.ns_per_op,
+           result.bytes_per_second / (1024 * 1024), result.items_per_second);
+
+    if (baseline)
+    {
+      std::map<std::string, double>::const_iterator it = baseline->find(result.name);
+
+      // Positive change means the benchmark got slower
+      if (it != baseline->end() && it->second > 0)
+        printf(" %14.1f %+7.1f%%", it->second, (result.ns_per_op - it->second) * 100 / it->second);
+      else
+        printf(" %14s %8s", "-", "-");
+    }
+
+    printf("\n");
+    fflush(stdout);
+  }
+}
+
+State::State(const uint64_t iterations)
+: m_iterations(iterations), m_bytes(0), m_items(0), m_start(Clock::now())
+{
+}
+
+Registrar::Registrar(const char *group, const char *name, Function function)
+{
+  Benchmark benchmark;
+  benchmark.name = std::string(group) + "." + name;
+  benchmark.function = function;
+
+  registry().push_back(benchmark);
+}
+
+void benchmarks::consume(const uint64_t value)
+{
+  sink = sink + value;
+}
+
+const std::string &benchmarks::capture_file()
+{
+  return options.capture_file;
+}
+
+int main(int argc, char **argv)
+{
+  if (!parse_options(argc, argv))
+    return 1;
+
+  std::vector<Benchmark> benchmarks(registry());
+  std::vector<Benchmark> selected;
+
+  for (std::vector<Benchmark>::const_iterator it = benchmarks.begin(); it != benchmarks.end(); ++it)
+  {
+    if (it->name.find(options.filter) != std::string::npos)
+      selected.push_back(*it);
+  }
+
+  struct By_name
+  {
+    bool operator()(const Benchmark &a, const Benchmark &b) const { return a.name < b.name; }
+  };
+  std::sort(selected.begin(), selected.end(), By_name());
+
+  if (options.list)
+  {
+    for (std::vector<Benchmark>::const_iterator it = selected.begin(); it != selected.end(); ++it)
+      std::cout << it->name << "\n";
+    return 0;
+  }
+
+  try
+  {
+    std::map<std::string, double> baseline;
+    const bool compare = !options.compare_file.empty();
+
+    if (compare)
+      baseline = load_baseline(options.compare_file);
+
+    // Results go to the standard output as JSON only, when asked to
+    const bool print_table = options.json_file != "-";
+    std::vector<Result> results;
+
+    if (print_table)
+      print_header(compare);
+
+    for (std::vector<Benchmark>::const_iterator it = selected.begin(); it != selected.end(); ++it)
+    {
+      results.push_back(measure(*it));
+
+      if (print_table)
+        print_result(results.back(), compare ? &baseline : NULL);
+    }
+
+    if (options.json_file == "-")
+      std::cout << to_json(results);
+    else if (!options.json_file.empty())
+    {
+      std::ofstream file(options.json_file.c_str());
+      file << to_json(results);
+
+      if (!file)
+        throw std::runtime_error("Unable to write " + options.json_file);
+    }
+  }
+  catch (std::exception &e)
+  {
+    std::cerr << "ERROR: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
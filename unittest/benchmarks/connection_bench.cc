@@ -0,0 +1,280 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "mysqlx_compression.h"
+#include "mysqlx_sync_connection.h"
+
+#include "benchmark.h"
+
+using namespace benchmarks;
+using boost::asio::ip::tcp;
+
+namespace
+{
+  // Stand-in server, sends back every X protocol frame it receives. When
+  // compressed it talks the compressed framing, deflating every response.
+  template <typename Protocol>
+  class Echo_server
+  {
+  public:
+    explicit Echo_server(const typename Protocol::endpoint &endpoint, const bool compressed = false)
+    : m_acceptor(m_ios, endpoint), m_compressed(compressed)
+    {
+      m_thread = std::thread(&Echo_server::serve, this);
+    }
+
+    ~Echo_server()
+    {
+      // Wakes up the server in case no client ever connected
+      boost::system::error_code error;
+      typename Protocol::socket socket(m_ios);
+      socket.connect(m_acceptor.local_endpoint(), error);
+      socket.close(error);
+
+      m_thread.join();
+    }
+
+    typename Protocol::endpoint endpoint() const { return m_acceptor.local_endpoint(); }
+
+  private:
+    void serve()
+    {
+      boost::system::error_code error;
+      typename Protocol::socket socket(m_ios);
+
+      m_acceptor.accept(socket, error);
+
+      if (error)
+        return;
+
+#ifdef HAVE_ZLIB
+      if (m_compressed)
+        echo_compressed_frames(socket);
+      else
+#endif
+        echo_frames(socket);
+    }
+
+    void echo_frames(typename Protocol::socket &socket)
+    {
+      boost::system::error_code error;
+      std::vector<char> frame;
+
+      while (!error)
+      {
+        unsigned char header[5];
+        boost::asio::read(socket, boost::asio::buffer(header), error);
+        if (error)
+          break;
+
+        const uint32_t length = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+        frame.resize(length + 4);
+        std::copy(header, header + 5, frame.begin());
+
+        if (length > 1)
+          boost::asio::read(socket, boost::asio::buffer(&frame[5], length - 1), error);
+
+        if (!error)
+          boost::asio::write(socket, boost::asio::buffer(frame), error);
+      }
+    }
+
+#ifdef HAVE_ZLIB
+    void echo_compressed_frames(typename Protocol::socket &socket)
+    {
+      boost::system::error_code error;
+      mysqlx::Compression_deflate deflate;
+      std::string payload;
+      std::string data;
+      std::string response;
+
+      while (!error)
+      {
+        unsigned char header[8];
+        boost::asio::read(socket, boost::asio::buffer(header), error);
+        if (error)
+          break;
+
+        const uint32_t length = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+        const uint32_t uncompressed_length = header[4] | (header[5] << 8) | (header[6] << 16) | (static_cast<uint32_t>(header[7]) << 24);
+        payload.resize(length);
+
+        if (length)
+          boost::asio::read(socket, boost::asio::buffer(&payload[0], length), error);
+        if (error)
+          break;
+
+        data.clear();
+        if (0 == uncompressed_length)
+          data = payload;
+        else if (!deflate.uncompress(payload.data(), length, uncompressed_length, data))
+          break;
+
+        response.assign(8, '\0');
+        if (!deflate.compress(data.data(), data.size(), response))
+          break;
+
+        const uint32_t response_length = static_cast<uint32_t>(response.size() - 8);
+        const uint32_t data_length = static_cast<uint32_t>(data.size());
+        for (int i = 0; i < 4; ++i)
+        {
+          response[i] = static_cast<char>(response_length >> (8 * i));
+          response[4 + i] = static_cast<char>(data_length >> (8 * i));
+        }
+
+        boost::asio::write(socket, boost::asio::buffer(response), error);
+      }
+    }
+#endif // HAVE_ZLIB
+
+    boost::asio::io_service m_ios;
+    typename Protocol::acceptor m_acceptor;
+    const bool m_compressed;
+    std::thread m_thread;
+  };
+
+  std::string frame(const std::size_t payload_size)
+  {
+    const uint32_t length = static_cast<uint32_t>(payload_size + 1);
+    std::string result(payload_size + 5, 'x');
+
+    result[0] = static_cast<char>(length);
+    result[1] = static_cast<char>(length >> 8);
+    result[2] = static_cast<char>(length >> 16);
+    result[3] = static_cast<char>(length >> 24);
+    result[4] = 1;
+
+    return result;
+  }
+
+  // Small frames sent one at a time, each waits for its echo
+  void round_trips(mysqlx::Mysqlx_sync_connection &connection, State &state)
+  {
+    const std::string request = frame(16);
+    std::string response(request.size(), '\0');
+
+    state.set_bytes_per_iteration(request.size());
+    state.reset_timer();
+
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+      if (connection.write(request.data(), request.size()) ||
+          connection.read(&response[0], 5) ||
+          connection.read(&response[5], response.size() - 5))
+        throw std::runtime_error("Echo server round trip failed");
+    }
+
+    consume(response.size());
+  }
+}
+
+BENCHMARK(Connection, loopback_round_trip)
+{
+  Echo_server<tcp> server(tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+  boost::asio::io_service ios;
+  mysqlx::Mysqlx_sync_connection connection(ios);
+
+  if (connection.connect(server.endpoint()))
+    throw std::runtime_error("Unable to connect to the echo server");
+
+  round_trips(connection, state);
+  connection.close();
+}
+
+#ifdef HAVE_ZLIB
+// Row like data through the compressed framing, as sent by bulk exports
+BENCHMARK(Connection, compressed_round_trip)
+{
+  Echo_server<tcp> server(tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0), true);
+  boost::asio::io_service ios;
+  mysqlx::Mysqlx_sync_connection connection(ios);
+  std::string request(5, '\0');
+  char row[128];
+
+  for (int i = 0; request.size() < 64 * 1024; ++i)
+  {
+    const int length = snprintf(row, sizeof(row), "{\"_id\": \"%08i\", \"name\": \"customer %i\", \"balance\": %i.%02i}",
+                                i, i, i * 37 % 10000, i % 100);
+    request.append(row, length);
+  }
+
+  const uint32_t length = static_cast<uint32_t>(request.size() - 4);
+  for (int i = 0; i < 4; ++i)
+    request[i] = static_cast<char>(length >> (8 * i));
+  request[4] = 1;
+
+  if (connection.connect(server.endpoint()))
+    throw std::runtime_error("Unable to connect to the echo server");
+  connection.enable_compression(mysqlx::create_compression_algorithm("deflate"));
+
+  std::string response(request.size(), '\0');
+
+  // Payload going both ways
+  state.set_bytes_per_iteration(2 * request.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    if (connection.write(request.data(), request.size()) ||
+        connection.read(&response[0], response.size()))
+      throw std::runtime_error("Compressed echo server round trip failed");
+  }
+
+  consume(connection.get_compression_statistics().wire_bytes_received());
+  connection.close();
+}
+#endif // HAVE_ZLIB
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+using boost::asio::local::stream_protocol;
+
+// Same round trip over a Unix domain socket
+BENCHMARK(Connection, local_socket_round_trip)
+{
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/run_benchmarks.%i.sock", static_cast<int>(getpid()));
+  ::unlink(path);
+
+  {
+    Echo_server<stream_protocol> server((stream_protocol::endpoint(path)));
+    boost::asio::io_service ios;
+    mysqlx::Mysqlx_sync_connection connection(ios);
+
+    if (connection.connect(std::string(path)))
+      throw std::runtime_error("Unable to connect to the echo server");
+
+    round_trips(connection, state);
+    connection.close();
+  }
+
+  ::unlink(path);
+}
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
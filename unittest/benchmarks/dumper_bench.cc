@@ -0,0 +1,97 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include "shellcore/common.h"
+#include "shellcore/shell_core_options.h"
+#include "modules/mod_mysqlx_resultset.h"
+#include "mysqlx.h"
+#include "mysqlx_connection.h"
+#include "../src/shell_resultset_dumper.h"
+
+#include "benchmark.h"
+#include "replay_server.h"
+
+using namespace benchmarks;
+
+namespace
+{
+  uint64_t printed = 0;
+
+  void count_output(std::string text)
+  {
+    printed += text.size();
+  }
+
+  // Resultset from the replay server, buffered so it can be dumped again
+  boost::shared_ptr<mysh::mysqlx::RowResult> buffered_result()
+  {
+    static boost::shared_ptr<mysh::mysqlx::RowResult> result;
+
+    if (!result)
+    {
+      result.reset(new mysh::mysqlx::RowResult(replay_connection()->execute_sql("select * from bench.orders")));
+      result->buffer();
+    }
+
+    return result;
+  }
+
+  void dump(const char *format, const bool interactive, State &state)
+  {
+    boost::shared_ptr<mysh::mysqlx::RowResult> result = buffered_result();
+    shcore::Value::Map_type_ref options = shcore::Shell_core_options::get();
+
+    (*options)[SHCORE_OUTPUT_FORMAT] = shcore::Value(format);
+    (*options)[SHCORE_INTERACTIVE] = shcore::Value(interactive);
+    (*options)[SHCORE_SHOW_WARNINGS] = shcore::Value::False();
+
+    shcore::print = count_output;
+    printed = 0;
+    state.reset_timer();
+
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+      ResultsetDumper dumper(result, true);
+      dumper.dump();
+    }
+
+    shcore::print = shcore::default_print;
+
+    state.set_bytes_per_iteration(printed / state.iterations());
+    state.set_items_per_iteration(resultset_frames().rows.size());
+    consume(printed);
+  }
+}
+
+// Interactive output, rows in a table with borders
+BENCHMARK(Dumper, table)
+{
+  dump("table", true, state);
+}
+
+// Batch output, tab separated values
+BENCHMARK(Dumper, tabbed)
+{
+  dump("table", false, state);
+}
+
+BENCHMARK(Dumper, json)
+{
+  dump("json", false, state);
+}
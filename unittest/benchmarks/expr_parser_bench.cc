@@ -0,0 +1,85 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../mysqlxtest/common/expr_parser.h"
+#include "../mysqlxtest/common/tokenizer.h"
+#include "mysqlx_expr.pb.h"
+
+#include "benchmark.h"
+
+using namespace benchmarks;
+
+namespace
+{
+  void parse(const std::string &text, const bool document_mode, State &state)
+  {
+    std::vector<std::string> placeholders;
+
+    state.set_bytes_per_iteration(text.size());
+    state.reset_timer();
+
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+      placeholders.clear();
+
+      mysqlx::Expr_parser parser(text, document_mode, false, &placeholders);
+      std::unique_ptr<Mysqlx::Expr::Expr> expr(parser.expr());
+
+      consume(expr->type());
+    }
+  }
+}
+
+// Search condition of a find() on a table
+BENCHMARK(Expr_parser, condition)
+{
+  parse("name like :name and (age between 18 and 65 or status in ('active', 'pending')) "
+        "and created > '2016-01-01' and cast(price as decimal) * quantity >= 100.5 and not deleted",
+        false, state);
+}
+
+// Document given to add(), every JSON literal goes through the parser
+BENCHMARK(Expr_parser, document)
+{
+  parse("{\"_id\": \"8a2e3f0c1b\", \"name\": \"customer 1\", \"age\": 37, \"balance\": 1234.5, "
+        "\"active\": true, \"address\": {\"city\": \"Lisbon\", \"zip\": \"1000-001\", \"street\": \"Rua Augusta\"}, "
+        "\"tags\": [\"a\", \"b\", \"c\", 1, 2, 3], \"notes\": null}",
+        true, state);
+}
+
+// Tokenizing alone, every parser starts with it
+BENCHMARK(Expr_parser, tokenizer)
+{
+  const std::string expression("name = 'some name' and (age between 18 and 65 or $.address.city in ('x', \"y\")) "
+                               "and cast(price as decimal) >= 12.5e2 and not `tag``s` like :param");
+
+  state.set_bytes_per_iteration(expression.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    mysqlx::Tokenizer tokenizer(expression);
+    tokenizer.get_tokens();
+    consume(tokenizer.end() - tokenizer.begin());
+  }
+}
@@ -0,0 +1,205 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include "mysqlx.h"
+#include "mysqlx_connection.h"
+#include "mysqlx_row.h"
+#include "ngs_common/xdecimal.h"
+#include "mysqlx_resultset.pb.h"
+#include "modules/mod_mysqlx_resultset.h"
+
+#include "benchmark.h"
+#include "replay_server.h"
+
+using namespace benchmarks;
+
+namespace
+{
+  uint64_t decode_field(const int type, const std::string &field)
+  {
+    size_t length;
+
+    switch (type)
+    {
+      case Mysqlx::Resultset::ColumnMetaData::SINT:
+        return static_cast<uint64_t>(mysqlx::Row_decoder::s64_from_buffer(field));
+      case Mysqlx::Resultset::ColumnMetaData::UINT:
+      case Mysqlx::Resultset::ColumnMetaData::BIT:
+        return mysqlx::Row_decoder::u64_from_buffer(field);
+      case Mysqlx::Resultset::ColumnMetaData::DOUBLE:
+        return static_cast<uint64_t>(mysqlx::Row_decoder::double_from_buffer(field));
+      case Mysqlx::Resultset::ColumnMetaData::FLOAT:
+        return static_cast<uint64_t>(mysqlx::Row_decoder::float_from_buffer(field));
+      case Mysqlx::Resultset::ColumnMetaData::DATETIME:
+        return mysqlx::Row_decoder::datetime_from_buffer(field).year();
+      case Mysqlx::Resultset::ColumnMetaData::TIME:
+        return mysqlx::Row_decoder::time_from_buffer(field).hour();
+      case Mysqlx::Resultset::ColumnMetaData::DECIMAL:
+        return mysqlx::Row_decoder::decimal_from_buffer(field).str().size();
+      case Mysqlx::Resultset::ColumnMetaData::SET:
+        return mysqlx::Row_decoder::set_from_buffer_as_str(field).size();
+      default:
+        mysqlx::Row_decoder::string_from_buffer(field, length);
+        return length;
+    }
+  }
+}
+
+// Decoding of the captured rows, from the frame payload to C++ types
+BENCHMARK(Protocol, row_decoder)
+{
+  const Resultset_frames &frames = resultset_frames();
+  Mysqlx::Resultset::Row row;
+  uint64_t bytes = 0;
+
+  for (std::vector<std::string>::const_iterator payload = frames.rows.begin(); payload != frames.rows.end(); ++payload)
+    bytes += payload->size();
+
+  state.set_bytes_per_iteration(bytes);
+  state.set_items_per_iteration(frames.rows.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    for (std::vector<std::string>::const_iterator payload = frames.rows.begin(); payload != frames.rows.end(); ++payload)
+    {
+      row.ParseFromString(*payload);
+
+      for (int field = 0; field < row.field_size() && field < static_cast<int>(frames.column_types.size()); ++field)
+      {
+        // Empty fields are NULL
+        if (!row.field(field).empty())
+          consume(decode_field(frames.column_types[field], row.field(field)));
+      }
+    }
+  }
+}
+
+// Resultset read from the replay server through mysqlx::Result
+BENCHMARK(Protocol, result_next)
+{
+  boost::shared_ptr<mysqlx::Connection> connection = replay_connection();
+
+  state.set_bytes_per_iteration(resultset_capture().size());
+  state.set_items_per_iteration(resultset_frames().rows.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    boost::shared_ptr<mysqlx::Result> result(connection->execute_sql("select * from bench.orders"));
+    uint64_t rows = 0;
+
+    while (result->next())
+      ++rows;
+
+    consume(rows);
+  }
+}
+
+// Same resultset with its frames read by a helper thread, the rows are
+// parsed by the consumer
+BENCHMARK(Protocol, result_read_ahead)
+{
+  boost::shared_ptr<mysqlx::Connection> connection = replay_connection();
+
+  state.set_bytes_per_iteration(resultset_capture().size());
+  state.set_items_per_iteration(resultset_frames().rows.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    boost::shared_ptr<mysqlx::Result> result(connection->execute_sql("select * from bench.orders"));
+    uint64_t rows = 0;
+
+    result->enable_read_ahead(4 * 1024 * 1024);
+
+    while (result->next())
+      ++rows;
+
+    consume(rows);
+  }
+}
+
+// Same resultset skipped by Result::flush, the rows are not parsed
+BENCHMARK(Protocol, result_flush)
+{
+  boost::shared_ptr<mysqlx::Connection> connection = replay_connection();
+
+  state.set_bytes_per_iteration(resultset_capture().size());
+  state.set_items_per_iteration(resultset_frames().rows.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    boost::shared_ptr<mysqlx::Result> result(connection->execute_sql("select * from bench.orders"));
+
+    result->flush();
+    consume(result->has_data());
+  }
+}
+
+// Same resultset buffered and read twice, the second pass from the buffer
+BENCHMARK(Protocol, result_buffer)
+{
+  boost::shared_ptr<mysqlx::Connection> connection = replay_connection();
+
+  state.set_bytes_per_iteration(2 * resultset_capture().size());
+  state.set_items_per_iteration(2 * resultset_frames().rows.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    boost::shared_ptr<mysqlx::Result> result(connection->execute_sql("select * from bench.orders"));
+    uint64_t rows = 0;
+
+    result->buffer();
+
+    while (result->next())
+      ++rows;
+
+    result->rewind();
+
+    while (result->next())
+      ++rows;
+
+    consume(rows);
+  }
+}
+
+// Same resultset converted to shell values by RowResult::fetch_one
+BENCHMARK(Protocol, row_result_fetch_one)
+{
+  boost::shared_ptr<mysqlx::Connection> connection = replay_connection();
+  const shcore::Argument_list no_args;
+
+  state.set_bytes_per_iteration(resultset_capture().size());
+  state.set_items_per_iteration(resultset_frames().rows.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    mysh::mysqlx::RowResult result(connection->execute_sql("select * from bench.orders"));
+    uint64_t rows = 0;
+
+    while (result.fetch_one(no_args))
+      ++rows;
+
+    consume(rows);
+  }
+}
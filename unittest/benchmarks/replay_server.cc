@@ -0,0 +1,256 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "mysqlx.h"
+#include "mysqlx_connection.h"
+#include "mysqlx_replay_server.h"
+#include "mysqlx.pb.h"
+#include "mysqlx_resultset.pb.h"
+#include "mysqlx_sql.pb.h"
+
+#include "benchmark.h"
+#include "replay_server.h"
+
+using namespace benchmarks;
+
+namespace
+{
+  void append_frame(std::string &capture, const int mid, const google::protobuf::MessageLite &message)
+  {
+    const std::string payload = message.SerializeAsString();
+    const uint32_t length = static_cast<uint32_t>(payload.size() + 1);
+    const char header[5] = {
+      static_cast<char>(length), static_cast<char>(length >> 8),
+      static_cast<char>(length >> 16), static_cast<char>(length >> 24),
+      static_cast<char>(mid)
+    };
+
+    capture.append(header, sizeof(header));
+    capture.append(payload);
+  }
+
+  std::string varint(uint64_t value)
+  {
+    std::string result;
+
+    while (value >= 0x80)
+    {
+      result.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    result.push_back(static_cast<char>(value));
+
+    return result;
+  }
+
+  std::string sint(const int64_t value)
+  {
+    return varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+
+  std::string fixed_double(const double value)
+  {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    std::string result;
+    for (int i = 0; i < 8; ++i)
+      result.push_back(static_cast<char>(bits >> (8 * i)));
+
+    return result;
+  }
+
+  // Strings are sent with a trailing \0
+  std::string bytes(const std::string &value)
+  {
+    return value + '\0';
+  }
+
+  std::string random_text(Random &random, const size_t min_length, const size_t max_length)
+  {
+    static const char letters[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::string text(min_length + random.next(static_cast<uint32_t>(max_length - min_length + 1)), ' ');
+
+    for (size_t i = 0; i < text.size(); ++i)
+      text[i] = letters[random.next(sizeof(letters) - 1)];
+
+    return text;
+  }
+
+  void add_column(std::string &capture, const char *name, const Mysqlx::Resultset::ColumnMetaData::FieldType type, const uint32_t length)
+  {
+    Mysqlx::Resultset::ColumnMetaData column;
+
+    column.set_type(type);
+    column.set_name(name);
+    column.set_original_name(name);
+    column.set_table("orders");
+    column.set_original_table("orders");
+    column.set_schema("bench");
+    column.set_catalog("def");
+    column.set_length(length);
+
+    append_frame(capture, Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA, column);
+  }
+
+  // resultset_capture() as answered by the replay server, all its rows each time
+  const mysqlx::Replay_response &capture_response()
+  {
+    static mysqlx::Replay_response response;
+
+    if (response.empty() && !response.add_frames(resultset_capture()))
+      throw std::runtime_error("Truncated X protocol frame in the capture");
+
+    return response;
+  }
+
+  struct Replay_fixture
+  {
+    Replay_fixture()
+    : server(capture_response(), capture_response().recorded_rows()), connection(new mysqlx::Connection(mysqlx::Ssl_config(), 0))
+    {
+      if (server.listen("127.0.0.1", 0))
+        throw std::runtime_error("Unable to start the replay server");
+      server.start();
+
+      connection->connect("127.0.0.1", server.port());
+    }
+
+    // The connection is closed before the server is stopped
+    mysqlx::Replay_server server;
+    boost::shared_ptr<mysqlx::Connection> connection;
+  };
+}
+
+std::string benchmarks::build_resultset_capture(const size_t rows)
+{
+  std::string capture;
+  Random random(static_cast<uint32_t>(rows));
+
+  add_column(capture, "id", Mysqlx::Resultset::ColumnMetaData::SINT, 11);
+  add_column(capture, "customer", Mysqlx::Resultset::ColumnMetaData::BYTES, 64);
+  add_column(capture, "price", Mysqlx::Resultset::ColumnMetaData::DOUBLE, 22);
+  add_column(capture, "quantity", Mysqlx::Resultset::ColumnMetaData::UINT, 10);
+  add_column(capture, "created", Mysqlx::Resultset::ColumnMetaData::DATETIME, 19);
+  add_column(capture, "discount", Mysqlx::Resultset::ColumnMetaData::SINT, 11);
+  add_column(capture, "notes", Mysqlx::Resultset::ColumnMetaData::BYTES, 255);
+
+  for (size_t i = 0; i < rows; ++i)
+  {
+    Mysqlx::Resultset::Row row;
+
+    row.add_field(sint(static_cast<int64_t>(i) + 1));
+    row.add_field(bytes(random_text(random, 8, 24)));
+    row.add_field(fixed_double(random.next(100000) / 100.0));
+    row.add_field(varint(random.next(50)));
+    row.add_field(varint(2016) + varint(1 + random.next(12)) + varint(1 + random.next(28)) +
+                  varint(random.next(24)) + varint(random.next(60)) + varint(random.next(60)));
+
+    // NULL is sent as an empty field
+    if (i % 10 == 0)
+      row.add_field("");
+    else
+      row.add_field(sint(-static_cast<int64_t>(random.next(20))));
+
+    row.add_field(bytes(random_text(random, 20, 120)));
+
+    append_frame(capture, Mysqlx::ServerMessages::RESULTSET_ROW, row);
+  }
+
+  append_frame(capture, Mysqlx::ServerMessages::RESULTSET_FETCH_DONE, Mysqlx::Resultset::FetchDone());
+  append_frame(capture, Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK, Mysqlx::Sql::StmtExecuteOk());
+
+  return capture;
+}
+
+const std::string &benchmarks::resultset_capture()
+{
+  static std::string capture;
+
+  if (capture.empty())
+  {
+    if (capture_file().empty())
+      capture = build_resultset_capture(CAPTURE_ROWS);
+    else
+    {
+      std::ifstream file(capture_file().c_str(), std::ios::in | std::ios::binary);
+      if (!file)
+        throw std::runtime_error("Unable to open " + capture_file());
+
+      std::stringstream data;
+      data << file.rdbuf();
+      capture = data.str();
+    }
+  }
+
+  return capture;
+}
+
+void benchmarks::split_capture(const std::string &capture, Resultset_frames &frames)
+{
+  size_t offset = 0;
+
+  frames.column_types.clear();
+  frames.rows.clear();
+
+  while (offset + 5 <= capture.size())
+  {
+    const unsigned char *header = reinterpret_cast<const unsigned char*>(capture.data() + offset);
+    const uint32_t length = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    const int mid = header[4];
+
+    if (length == 0 || offset + 4 + length > capture.size())
+      throw std::runtime_error("Truncated X protocol frame in the capture");
+
+    const char *payload = capture.data() + offset + 5;
+
+    if (mid == Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA)
+    {
+      Mysqlx::Resultset::ColumnMetaData column;
+      column.ParseFromArray(payload, length - 1);
+      frames.column_types.push_back(column.type());
+    }
+    else if (mid == Mysqlx::ServerMessages::RESULTSET_ROW)
+      frames.rows.push_back(std::string(payload, length - 1));
+
+    offset += 4 + length;
+  }
+}
+
+const Resultset_frames &benchmarks::resultset_frames()
+{
+  static Resultset_frames frames;
+
+  if (frames.column_types.empty())
+    split_capture(resultset_capture(), frames);
+
+  return frames;
+}
+
+boost::shared_ptr<mysqlx::Connection> benchmarks::replay_connection()
+{
+  static Replay_fixture fixture;
+
+  return fixture.connection;
+}
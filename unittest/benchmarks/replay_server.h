@@ -0,0 +1,61 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#ifndef _REPLAY_SERVER_H_
+#define _REPLAY_SERVER_H_
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+namespace mysqlx
+{
+  class Connection;
+}
+
+namespace benchmarks
+{
+  enum { CAPTURE_ROWS = 1000 };
+
+  // X protocol frames of a SELECT response as sent by the server:
+  // column metadata, the rows, FetchDone and StmtExecuteOk
+  std::string build_resultset_capture(const size_t rows);
+
+  // Recorded capture given with --capture, or a generated one
+  const std::string &resultset_capture();
+
+  // Column types and row payloads of a capture
+  struct Resultset_frames
+  {
+    std::vector<int> column_types;
+    std::vector<std::string> rows;
+  };
+
+  void split_capture(const std::string &capture, Resultset_frames &frames);
+
+  // Frames of resultset_capture()
+  const Resultset_frames &resultset_frames();
+
+  // Connection to a replay server of resultset_capture(), shared by the
+  // benchmarks. Every query returns the captured resultset.
+  boost::shared_ptr<mysqlx::Connection> replay_connection();
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <cstdio>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "../utils/utils_mysql_parsing.h"
+
+#include "benchmark.h"
+
+using namespace benchmarks;
+
+namespace
+{
+  enum { SCRIPT_SIZE = 1024 * 1024 };
+
+  // Data dump, long statements made mostly of quoted strings
+  const std::string &dump_script()
+  {
+    static std::string script;
+
+    if (script.empty())
+    {
+      script.reserve(SCRIPT_SIZE + 1024);
+      script.append("-- MySQL dump\n/*!40101 SET NAMES utf8 */;\n"
+                    "CREATE TABLE `customers` (\n  `id` int NOT NULL,\n  `name` varchar(64) DEFAULT NULL,\n  PRIMARY KEY (`id`)\n);\n");
+
+      for (int row = 0; script.size() < SCRIPT_SIZE; ++row)
+      {
+        script.append("INSERT INTO `customers` VALUES ");
+        for (int i = 0; i < 20; ++i)
+        {
+          char value[128];
+          snprintf(value, sizeof(value), "%s(%d,'Customer name %d, \\'quoted\\'','2016-01-01 10:00:00',%d.5)",
+                   i ? "," : "", row * 20 + i, row * 20 + i, i);
+          script.append(value);
+        }
+        script.append(";\n");
+      }
+    }
+
+    return script;
+  }
+
+  // Schema script, short statements, comments and delimiter changes
+  const std::string &schema_script()
+  {
+    static std::string script;
+
+    if (script.empty())
+    {
+      script.reserve(SCRIPT_SIZE + 1024);
+
+      for (int i = 0; script.size() < SCRIPT_SIZE; ++i)
+      {
+        char statements[1024];
+        snprintf(statements, sizeof(statements),
+                 "-- Table %d\n"
+                 "CREATE TABLE t%d (id INT PRIMARY KEY, name VARCHAR(32) /* display name */, value DOUBLE);\n"
+                 "# Access\n"
+                 "GRANT SELECT ON t%d TO 'reader'@'%%';\n"
+                 "DELIMITER $$\n"
+                 "CREATE PROCEDURE p%d()\nBEGIN\n  SELECT COUNT(*) FROM t%d WHERE name <> \"x;y\";\n  SELECT 1;\nEND$$\n"
+                 "DELIMITER ;\n"
+                 "SELECT `weird;name` FROM t%d;\n",
+                 i, i, i, i, i, i);
+        script.append(statements);
+      }
+    }
+
+    return script;
+  }
+
+  void split(const std::string &script, State &state)
+  {
+    std::vector<std::pair<size_t, size_t> > ranges;
+    std::stack<std::string> context;
+
+    state.set_bytes_per_iteration(script.size());
+    state.reset_timer();
+
+    for (uint64_t i = 0; i < state.iterations(); ++i)
+    {
+      std::string delimiter = ";";
+
+      ranges.clear();
+      consume(shcore::mysql::splitter::determineStatementRanges(script.data(), script.size(), delimiter,
+                                                                ranges, "\n", context));
+    }
+
+    state.set_items_per_iteration(ranges.size());
+  }
+}
+
+BENCHMARK(Splitter, dump)
+{
+  split(dump_script(), state);
+}
+
+BENCHMARK(Splitter, schema)
+{
+  split(schema_script(), state);
+}
@@ -0,0 +1,274 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "shellcore/types.h"
+
+#include "benchmark.h"
+
+using namespace benchmarks;
+
+namespace
+{
+  // Collection of documents as the ones returned by a find()
+  const std::string &documents_json()
+  {
+    static std::string json;
+
+    if (json.empty())
+    {
+      Random random(42);
+      std::stringstream stream;
+
+      stream << "[";
+      for (int i = 0; i < 200; ++i)
+      {
+        if (i)
+          stream << ", ";
+
+        stream << "{\"_id\": \"" << std::hex << random.next() << std::dec << "\", "
+               << "\"name\": \"customer " << i << "\", "
+               << "\"age\": " << random.next(90) << ", "
+               << "\"balance\": " << random.next(1000000) / 100.0 << ", "
+               << "\"active\": " << (random.next(2) ? "true" : "false") << ", "
+               << "\"address\": {\"city\": \"city " << random.next(100) << "\", \"zip\": \"" << random.next(99999) << "\"}, "
+               << "\"tags\": [\"a\", \"b\", " << random.next(10) << "]}";
+      }
+      stream << "]";
+
+      json = stream.str();
+    }
+
+    return json;
+  }
+
+  const shcore::Value &documents()
+  {
+    static shcore::Value value;
+
+    if (!value)
+      value = shcore::Value::parse(documents_json());
+
+    return value;
+  }
+}
+
+// Parser of the shell literals, also used for JSON coming from scripts
+BENCHMARK(Value, parse)
+{
+  const std::string &json = documents_json();
+
+  state.set_bytes_per_iteration(json.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+    consume(shcore::Value::parse(json).as_array()->size());
+}
+
+// JSON parser used for the documents of a DocResult
+BENCHMARK(Value, parse_json)
+{
+  const std::string &json = documents_json();
+
+  state.set_bytes_per_iteration(json.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+    consume(shcore::Value::parse_json(json.data(), json.size()).as_array()->size());
+}
+
+// Same, decoding in place a copy of the row buffer received from the server
+BENCHMARK(Value, parse_json_in_situ)
+{
+  const std::string &json = documents_json();
+  std::vector<char> buffer;
+
+  state.set_bytes_per_iteration(json.size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    buffer.assign(json.c_str(), json.c_str() + json.size() + 1);
+    consume(shcore::Value::parse_json_in_situ(&buffer[0]).as_array()->size());
+  }
+}
+
+BENCHMARK(Value, descr)
+{
+  const shcore::Value &value = documents();
+  std::string output;
+
+  state.set_bytes_per_iteration(documents_json().size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    output.clear();
+    value.append_descr(output);
+    consume(output.size());
+  }
+}
+
+BENCHMARK(Value, repr)
+{
+  const shcore::Value &value = documents();
+
+  state.set_bytes_per_iteration(documents_json().size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+    consume(value.repr().size());
+}
+
+BENCHMARK(Value, json)
+{
+  const shcore::Value &value = documents();
+
+  state.set_bytes_per_iteration(documents_json().size());
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+    consume(value.json(false).size());
+}
+
+namespace
+{
+  enum { CHURN_ROWS = 1000 };
+
+  shcore::Value make_row(const int id)
+  {
+    shcore::Value row(shcore::Value::new_map());
+    shcore::Value::Map_type_ref fields = row.as_map();
+
+    shcore::Value value_id(id);
+    shcore::Value name("name");
+    shcore::Value price(id * 1.5);
+    (*fields)["id"] = std::move(value_id);
+    (*fields)["name"] = std::move(name);
+    (*fields)["price"] = std::move(price);
+
+    return row;
+  }
+
+  const shcore::Value::Array_type &churn_rows()
+  {
+    static shcore::Value::Array_type rows;
+
+    if (rows.empty())
+    {
+      for (int i = 0; i < CHURN_ROWS; ++i)
+        rows.push_back(make_row(i));
+    }
+
+    return rows;
+  }
+}
+
+// Rows of values built the way result fetching does
+BENCHMARK(Value, build_rows)
+{
+  state.set_items_per_iteration(CHURN_ROWS);
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    shcore::Value::Array_type rows;
+
+    for (int id = 0; id < CHURN_ROWS; ++id)
+      rows.push_back(make_row(id));
+
+    consume(rows.size());
+  }
+}
+
+// Arguments of a call into a bridged function
+BENCHMARK(Value, argument_list)
+{
+  const shcore::Value::Array_type &rows = churn_rows();
+
+  state.set_items_per_iteration(CHURN_ROWS);
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    for (int id = 0; id < CHURN_ROWS; ++id)
+    {
+      shcore::Argument_list args;
+      args.push_back(shcore::Value("a short string"));
+      args.push_back(shcore::Value(id));
+      args.push_back(rows[id]);
+      consume(args.string_at(0).size());
+    }
+  }
+}
+
+BENCHMARK(Value, copy_rows)
+{
+  const shcore::Value::Array_type &rows = churn_rows();
+
+  state.set_items_per_iteration(CHURN_ROWS);
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    shcore::Value::Array_type copies(rows.begin(), rows.end());
+    consume(copies.size());
+  }
+}
+
+// Rows go back and forth between two arrays, no copy is made
+BENCHMARK(Value, move_rows)
+{
+  shcore::Value::Array_type source(churn_rows().begin(), churn_rows().end());
+  shcore::Value::Array_type target;
+
+  target.reserve(source.size());
+  state.set_items_per_iteration(CHURN_ROWS);
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    for (shcore::Value::Array_type::iterator row = source.begin(); row != source.end(); ++row)
+      target.push_back(std::move(*row));
+
+    source.clear();
+    source.swap(target);
+    consume(source.size());
+  }
+}
+
+// Numeric cells of a result being printed
+BENCHMARK(Value, descr_numbers)
+{
+  std::string line;
+
+  state.set_items_per_iteration(2);
+  state.reset_timer();
+
+  for (uint64_t i = 0; i < state.iterations(); ++i)
+  {
+    line.clear();
+    shcore::Value(static_cast<int64_t>(i) * 7919).append_descr(line);
+    shcore::Value(i * 0.25).append_descr(line);
+    consume(line.size());
+  }
+}
@@ -366,6 +366,7 @@ namespace shcore {
       MY_EXPECT_STDOUT_CONTAINS("\\nowarnings (\\w)       Don't show warnings after every statement.");
       MY_EXPECT_STDOUT_CONTAINS("\\status     (\\s)       Print information about the current global connection.");
       MY_EXPECT_STDOUT_CONTAINS("\\use        (\\u)       Set the current schema for the global session.");
+      MY_EXPECT_STDOUT_CONTAINS("\\metrics               Print protocol metrics of the current global connection.");
       MY_EXPECT_STDOUT_CONTAINS("\\saveconn   (\\savec)   Store a session configuration.");
       MY_EXPECT_STDOUT_CONTAINS("\\rmconn     (\\rmc)     Remove the stored session configuration.");
       MY_EXPECT_STDOUT_CONTAINS("\\lsconn     (\\lsc)     List stored session configurations.");
@@ -0,0 +1,230 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "mod_utils_import.h"
+
+namespace mysh
+{
+  namespace tests {
+    // Records of data as found by the splitter, fed in reads of read_size bytes
+    static std::vector<std::string> split(Import_format format, const std::string &data, size_t read_size)
+    {
+      Record_splitter splitter(format);
+      std::vector<std::string> records;
+      std::string pending;
+      size_t scanned = 0;
+
+      for (size_t offset = 0; offset < data.size(); offset += read_size)
+      {
+        pending.append(data.substr(offset, read_size));
+
+        const char *begin = pending.data();
+        const char *end = begin + pending.size();
+        const char *position = begin + scanned;
+
+        while (const char *record_end = splitter.next(position, end))
+        {
+          records.push_back(std::string(begin, record_end));
+          begin = record_end;
+          position = record_end;
+        }
+
+        pending.erase(0, begin - pending.data());
+        scanned = pending.size();
+      }
+
+      // Rest of the data, the last record may lack the line break
+      if (!pending.empty())
+        records.push_back(pending);
+
+      return records;
+    }
+
+    // Fields of the records of data, "NULL" for NULL values
+    static std::vector<std::vector<std::string> > read(Import_format format, const std::string &data)
+    {
+      std::vector<std::vector<std::string> > records;
+      std::vector<Import_field> fields;
+      std::string error;
+      const char *position = data.data();
+      const char *end = position + data.size();
+
+      while (position < end)
+      {
+        size_t field_count;
+
+        position = read_record(format, position, end, fields, field_count, error);
+        if (!position)
+        {
+          ADD_FAILURE() << error;
+          break;
+        }
+
+        records.push_back(std::vector<std::string>());
+        for (size_t index = 0; index < field_count; ++index)
+          records.back().push_back(fields[index].is_null ? "NULL" : fields[index].value);
+      }
+
+      return records;
+    }
+
+    TEST(Mod_utils_import, split_csv_quoted_line_breaks)
+    {
+      const std::string data = "1,\"first\nline\"\n2,\"say \"\"hi\"\"\n\"\n3,plain\n";
+
+      for (size_t read_size = 1; read_size <= data.size(); ++read_size)
+      {
+        std::vector<std::string> records = split(Import_csv, data, read_size);
+
+        ASSERT_EQ(3U, records.size()) << "read size " << read_size;
+        EXPECT_EQ("1,\"first\nline\"\n", records[0]);
+        EXPECT_EQ("2,\"say \"\"hi\"\"\n\"\n", records[1]);
+        EXPECT_EQ("3,plain\n", records[2]);
+      }
+    }
+
+    TEST(Mod_utils_import, split_tsv_escaped_line_breaks)
+    {
+      std::vector<std::string> records = split(Import_tsv, "1\tone\\ntwo\n2\tthree\\\nfour\\\\\n3\n", 4);
+
+      ASSERT_EQ(3U, records.size());
+      EXPECT_EQ("1\tone\\ntwo\n", records[0]);
+      EXPECT_EQ("2\tthree\\\nfour\\\\\n", records[1]);
+      EXPECT_EQ("3\n", records[2]);
+    }
+
+    TEST(Mod_utils_import, split_json_documents)
+    {
+      const std::string data = "{\"a\": \"}\\\"{\", \"b\": [1, {\"c\": 2}]}\n  {\"_id\": \"x\"}{}";
+      std::vector<std::string> records = split(Import_json, data, 3);
+
+      ASSERT_EQ(3U, records.size());
+      EXPECT_EQ("{\"a\": \"}\\\"{\", \"b\": [1, {\"c\": 2}]}", records[0]);
+      EXPECT_EQ("\n  {\"_id\": \"x\"}", records[1]);
+      EXPECT_EQ("{}", records[2]);
+    }
+
+    TEST(Mod_utils_import, split_json_stray_closing_bracket)
+    {
+      const std::string data = "{\"a\": 1}\n]\n{\"b\": 2}\n{\"c\": 3}";
+      Record_splitter splitter(Import_json);
+      const char *position = data.data();
+      const char *end = position + data.size();
+
+      position = splitter.next(position, end);
+      ASSERT_TRUE(position != NULL);
+      EXPECT_FALSE(splitter.malformed());
+
+      // Nothing is split after the stray bracket, not even in later reads
+      EXPECT_TRUE(NULL == splitter.next(position, end));
+      EXPECT_TRUE(splitter.malformed());
+      EXPECT_TRUE(NULL == splitter.next(position + 2, end));
+    }
+
+    TEST(Mod_utils_import, split_trailing_record_without_line_break)
+    {
+      std::vector<std::string> records = split(Import_csv, "1,a\n2,\"b\nc\"", 5);
+
+      ASSERT_EQ(2U, records.size());
+      EXPECT_EQ("1,a\n", records[0]);
+      EXPECT_EQ("2,\"b\nc\"", records[1]);
+    }
+
+    TEST(Mod_utils_import, read_csv_quoting)
+    {
+      std::vector<std::vector<std::string> > records = read(Import_csv, "1,\"a, \"\"b\"\"\",,\"\"\n2,\"x\ny\",z,\n");
+
+      ASSERT_EQ(2U, records.size());
+      ASSERT_EQ(4U, records[0].size());
+      EXPECT_EQ("1", records[0][0]);
+      EXPECT_EQ("a, \"b\"", records[0][1]);
+      EXPECT_EQ("NULL", records[0][2]);
+      EXPECT_EQ("", records[0][3]);
+
+      ASSERT_EQ(4U, records[1].size());
+      EXPECT_EQ("x\ny", records[1][1]);
+      EXPECT_EQ("z", records[1][2]);
+      EXPECT_EQ("NULL", records[1][3]);
+    }
+
+    TEST(Mod_utils_import, read_tsv_escaped_separators)
+    {
+      std::vector<std::vector<std::string> > records = read(Import_tsv, "a\\tb\t\\N\tc\\\\\\n\t\\0\\Z\t\\\\N\tx\\\ty\\\nz\n");
+
+      ASSERT_EQ(1U, records.size());
+      ASSERT_EQ(6U, records[0].size());
+      EXPECT_EQ("a\tb", records[0][0]);
+      EXPECT_EQ("NULL", records[0][1]);
+      EXPECT_EQ("c\\\n", records[0][2]);
+      EXPECT_EQ(std::string("\0\032", 2), records[0][3]);
+      EXPECT_EQ("\\N", records[0][4]);
+
+      // Tabs and line breaks escaped as in LOAD DATA INFILE
+      EXPECT_EQ("x\ty\nz", records[0][5]);
+    }
+
+    TEST(Mod_utils_import, read_crlf)
+    {
+      std::vector<std::vector<std::string> > csv = read(Import_csv, "1,\"a\r\nb\"\r\n2,\r\n");
+
+      ASSERT_EQ(2U, csv.size());
+      ASSERT_EQ(2U, csv[0].size());
+      EXPECT_EQ("a\r\nb", csv[0][1]);
+      ASSERT_EQ(2U, csv[1].size());
+      EXPECT_EQ("2", csv[1][0]);
+      EXPECT_EQ("NULL", csv[1][1]);
+
+      std::vector<std::vector<std::string> > tsv = read(Import_tsv, "1\tx\r\n2\t\\N\r\n");
+
+      ASSERT_EQ(2U, tsv.size());
+      EXPECT_EQ("x", tsv[0][1]);
+      EXPECT_EQ("NULL", tsv[1][1]);
+    }
+
+    TEST(Mod_utils_import, read_trailing_record_without_line_break)
+    {
+      std::vector<std::vector<std::string> > csv = read(Import_csv, "1,a\n2,\"b\"");
+
+      ASSERT_EQ(2U, csv.size());
+      ASSERT_EQ(2U, csv[1].size());
+      EXPECT_EQ("b", csv[1][1]);
+
+      std::vector<std::vector<std::string> > tsv = read(Import_tsv, "1\ta\r\n2\t\\N");
+
+      ASSERT_EQ(2U, tsv.size());
+      ASSERT_EQ(2U, tsv[1].size());
+      EXPECT_EQ("NULL", tsv[1][1]);
+    }
+
+    TEST(Mod_utils_import, read_errors)
+    {
+      std::vector<Import_field> fields;
+      size_t field_count;
+      std::string error;
+      const std::string unclosed = "1,\"abc\n";
+      const std::string trailing = "1,\"abc\"d\n";
+
+      EXPECT_TRUE(NULL == read_record(Import_csv, unclosed.data(), unclosed.data() + unclosed.size(), fields, field_count, error));
+      EXPECT_EQ("Missing closing quote", error);
+
+      EXPECT_TRUE(NULL == read_record(Import_csv, trailing.data(), trailing.data() + trailing.size(), fields, field_count, error));
+      EXPECT_EQ("Unexpected character after a quoted value", error);
+    }
+  }
+}
@@ -0,0 +1,111 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "gtest/gtest.h"
+#include "mysqlx_compression.h"
+
+namespace mysqlx
+{
+  namespace tests {
+#ifdef HAVE_ZLIB
+    TEST(Mysqlx_compression, deflate_round_trip)
+    {
+      Compression_algorithm_ptr deflate = create_compression_algorithm("deflate");
+      ASSERT_TRUE(static_cast<bool>(deflate));
+      EXPECT_STREQ("deflate", deflate->name());
+
+      std::string data;
+      for (int i = 0; i < 1000; ++i)
+        data.append("row data ");
+
+      // Output is appended to whatever is already there
+      std::string compressed("header");
+      ASSERT_TRUE(deflate->compress(data.data(), data.size(), compressed));
+      EXPECT_EQ("header", compressed.substr(0, 6));
+      EXPECT_LT(compressed.size(), data.size());
+
+      std::string uncompressed("x");
+      ASSERT_TRUE(deflate->uncompress(compressed.data() + 6, compressed.size() - 6, data.size(), uncompressed));
+      EXPECT_EQ("x" + data, uncompressed);
+    }
+
+    TEST(Mysqlx_compression, deflate_buffers)
+    {
+      Compression_deflate deflate;
+      std::string data;
+      for (int i = 0; i < 1000; ++i)
+        data.append("row data ");
+
+      // Compressed as one stream, empty buffers included
+      std::vector<boost::asio::const_buffer> buffers;
+      buffers.push_back(boost::asio::buffer(data.data(), 10));
+      buffers.push_back(boost::asio::buffer(data.data() + 10, 0));
+      buffers.push_back(boost::asio::buffer(data.data() + 10, data.size() - 10));
+
+      std::string compressed("header");
+      ASSERT_TRUE(deflate.compress(buffers, compressed));
+      EXPECT_EQ("header", compressed.substr(0, 6));
+      EXPECT_LT(compressed.size(), data.size());
+
+      std::string uncompressed;
+      ASSERT_TRUE(deflate.uncompress(compressed.data() + 6, compressed.size() - 6, data.size(), uncompressed));
+      EXPECT_EQ(data, uncompressed);
+    }
+
+    TEST(Mysqlx_compression, deflate_wrong_length)
+    {
+      Compression_deflate deflate;
+      const std::string data(500, 'a');
+      std::string compressed;
+      std::string uncompressed;
+
+      ASSERT_TRUE(deflate.compress(data.data(), data.size(), compressed));
+
+      EXPECT_FALSE(deflate.uncompress(compressed.data(), compressed.size(), data.size() - 1, uncompressed));
+      EXPECT_TRUE(uncompressed.empty());
+      EXPECT_FALSE(deflate.uncompress(compressed.data(), compressed.size(), data.size() + 1, uncompressed));
+      EXPECT_TRUE(uncompressed.empty());
+      EXPECT_FALSE(deflate.uncompress(compressed.data(), compressed.size() / 2, data.size(), uncompressed));
+      EXPECT_TRUE(uncompressed.empty());
+    }
+#endif // HAVE_ZLIB
+
+    TEST(Mysqlx_compression, unknown_algorithm)
+    {
+      EXPECT_FALSE(static_cast<bool>(create_compression_algorithm("lz4")));
+    }
+
+    TEST(Mysqlx_compression, statistics)
+    {
+      Compression_statistics statistics;
+
+      EXPECT_EQ(1.0, statistics.ratio());
+      EXPECT_EQ(0.0, statistics.compress_mb_per_sec());
+
+      statistics.count_sent(1000, 250, 10);
+      statistics.count_received(3000, 750, 0);
+
+      EXPECT_EQ(4.0, statistics.ratio());
+      EXPECT_EQ(100.0, statistics.compress_mb_per_sec());
+      EXPECT_EQ(0.0, statistics.uncompress_mb_per_sec());
+      EXPECT_EQ(1U, statistics.frames_sent());
+      EXPECT_EQ(1U, statistics.frames_received());
+
+      statistics.reset();
+      EXPECT_EQ(0U, statistics.wire_bytes_sent());
+      EXPECT_EQ(1.0, statistics.ratio());
+    }
+  }
+}
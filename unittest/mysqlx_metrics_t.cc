@@ -0,0 +1,162 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "mysqlx_metrics.h"
+
+namespace mysqlx
+{
+  namespace tests {
+    TEST(Mysqlx_metrics, latency_histogram_buckets)
+    {
+      Latency_histogram histogram;
+
+      histogram.add(0);
+      histogram.add(1);
+      histogram.add(3);
+      histogram.add(4);
+      histogram.add(1000);
+
+      EXPECT_EQ(5U, histogram.count());
+      EXPECT_EQ(1008U, histogram.total_usec());
+      EXPECT_EQ(1000U, histogram.max_usec());
+
+      EXPECT_EQ(1U, histogram.bucket(0));
+      EXPECT_EQ(1U, histogram.bucket(1));
+      EXPECT_EQ(1U, histogram.bucket(2));
+      EXPECT_EQ(1U, histogram.bucket(3));
+      EXPECT_EQ(1U, histogram.bucket(10));
+
+      EXPECT_EQ(4U, histogram.percentile_usec(50));
+      EXPECT_EQ(1000U, histogram.percentile_usec(99));
+
+      histogram.reset();
+      EXPECT_EQ(0U, histogram.count());
+      EXPECT_EQ(0U, histogram.percentile_usec(50));
+    }
+
+    TEST(Mysqlx_metrics, protocol_counters)
+    {
+      Protocol_metrics metrics;
+
+      metrics.count_sent(12, 30);
+      metrics.count_sent(12, 20);
+      metrics.count_received(13, 100);
+      metrics.count_row(95);
+
+      EXPECT_EQ(2U, metrics.sent(12).messages);
+      EXPECT_EQ(50U, metrics.sent(12).bytes);
+      EXPECT_EQ(1U, metrics.received(13).messages);
+      EXPECT_EQ(100U, metrics.received(13).bytes);
+      EXPECT_EQ(0U, metrics.received(12).messages);
+      EXPECT_EQ(1U, metrics.rows_decoded());
+      EXPECT_EQ(95U, metrics.bytes_decoded());
+
+      metrics.reset();
+      EXPECT_EQ(0U, metrics.sent(12).messages);
+      EXPECT_EQ(0U, metrics.rows_decoded());
+    }
+
+    TEST(Mysqlx_metrics, pipelined_operations)
+    {
+      Protocol_metrics metrics;
+
+      // Reply without a request is ignored
+      metrics.end_request();
+
+      metrics.begin_operation(Protocol_metrics::Op_find);
+      metrics.count_sent(17, 10);
+      metrics.begin_operation(Protocol_metrics::Op_insert);
+      metrics.count_sent(18, 10);
+      metrics.end_request();
+
+      EXPECT_EQ(1U, metrics.latency(Protocol_metrics::Op_find).count());
+      EXPECT_EQ(0U, metrics.latency(Protocol_metrics::Op_insert).count());
+
+      metrics.end_request();
+      metrics.end_request();
+
+      EXPECT_EQ(1U, metrics.latency(Protocol_metrics::Op_insert).count());
+      EXPECT_EQ(0U, metrics.latency(Protocol_metrics::Op_sql).count());
+    }
+
+    TEST(Mysqlx_metrics, untimed_requests)
+    {
+      Protocol_metrics metrics;
+
+      // Expectation block opened before the statement
+      metrics.count_sent(24, 10);
+      metrics.begin_operation(Protocol_metrics::Op_sql);
+      metrics.count_sent(12, 20);
+
+      // The error replying to the expectation doesn't end the statement
+      metrics.end_request();
+      EXPECT_EQ(0U, metrics.latency(Protocol_metrics::Op_sql).count());
+
+      metrics.end_request();
+      EXPECT_EQ(1U, metrics.latency(Protocol_metrics::Op_sql).count());
+
+      // A reply for an untimed request sent afterwards isn't counted either
+      metrics.count_sent(7, 5);
+      metrics.end_request();
+      EXPECT_EQ(1U, metrics.latency(Protocol_metrics::Op_sql).count());
+
+      // Sequence survives a reset while a request is in flight
+      metrics.begin_operation(Protocol_metrics::Op_delete);
+      metrics.count_sent(20, 10);
+      metrics.reset();
+      metrics.begin_operation(Protocol_metrics::Op_update);
+      metrics.count_sent(19, 10);
+      metrics.end_request();
+      EXPECT_EQ(0U, metrics.latency(Protocol_metrics::Op_update).count());
+      metrics.end_request();
+      EXPECT_EQ(1U, metrics.latency(Protocol_metrics::Op_update).count());
+    }
+
+    TEST(Mysqlx_metrics, result_timing)
+    {
+      Result_timing timing;
+
+      // Marks before the start are ignored
+      timing.mark(Result_timing::Phase_send);
+      EXPECT_FALSE(timing.started());
+      EXPECT_EQ(0U, timing.total_usec());
+
+      timing.start();
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      timing.mark(Result_timing::Phase_send);
+      timing.mark(Result_timing::Phase_first_metadata);
+
+      EXPECT_TRUE(timing.started());
+      EXPECT_LE(2000U, timing.usec(Result_timing::Phase_send));
+      EXPECT_EQ(0U, timing.usec(Result_timing::Phase_streaming));
+
+      // Marking a phase again adds to it
+      const uint64_t send = timing.usec(Result_timing::Phase_send);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      timing.mark(Result_timing::Phase_send);
+      EXPECT_LE(send + 1000, timing.usec(Result_timing::Phase_send));
+      EXPECT_EQ(timing.usec(Result_timing::Phase_send) + timing.usec(Result_timing::Phase_first_metadata), timing.total_usec());
+
+      EXPECT_STREQ("firstMetadata", Result_timing::get_phase_name(Result_timing::Phase_first_metadata));
+
+      timing.reset();
+      EXPECT_FALSE(timing.started());
+      EXPECT_EQ(0U, timing.total_usec());
+    }
+  }
+}
@@ -0,0 +1,119 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "mysqlx_notice.h"
+#include "mysqlx_notice.pb.h"
+
+namespace mysqlx
+{
+  namespace tests {
+    TEST(Mysqlx_notice, decode_frame)
+    {
+      Mysqlx::Notice::Frame frame;
+      frame.set_type(Notice_type_warning);
+      frame.set_scope(Mysqlx::Notice::Frame::LOCAL);
+      frame.set_payload("payload");
+
+      const std::string data = frame.SerializeAsString();
+      Notice_frame decoded;
+
+      ASSERT_TRUE(decode_notice_frame(data.data(), data.size(), decoded));
+      EXPECT_EQ(1U, decoded.type);
+      EXPECT_EQ(Mysqlx::Notice::Frame::LOCAL, decoded.scope);
+      EXPECT_EQ("payload", std::string(decoded.payload, decoded.payload_length));
+
+      // Payload points into the given buffer
+      EXPECT_TRUE(decoded.payload >= data.data() && decoded.payload < data.data() + data.size());
+    }
+
+    TEST(Mysqlx_notice, decode_frame_defaults)
+    {
+      Mysqlx::Notice::Frame frame;
+      frame.set_type(Notice_type_session_state_changed);
+
+      const std::string data = frame.SerializeAsString();
+      Notice_frame decoded;
+
+      ASSERT_TRUE(decode_notice_frame(data.data(), data.size(), decoded));
+      EXPECT_EQ(Mysqlx::Notice::Frame::GLOBAL, decoded.scope);
+      EXPECT_EQ(0U, decoded.payload_length);
+    }
+
+    TEST(Mysqlx_notice, decode_malformed)
+    {
+      Notice_frame frame;
+      Notice_warning warning;
+
+      // Missing required type
+      EXPECT_FALSE(decode_notice_frame("", 0, frame));
+
+      // Length of payload past the end of data
+      const char truncated[] = { 0x08, 0x01, 0x1a, 0x10, 'a' };
+      EXPECT_FALSE(decode_notice_frame(truncated, sizeof(truncated), frame));
+
+      Mysqlx::Notice::Warning message;
+      message.set_code(1);
+      message.set_msg("text");
+      const std::string data = message.SerializePartialAsString();
+      EXPECT_FALSE(decode_notice_warning(data.data(), data.size() - 1, warning));
+    }
+
+    TEST(Mysqlx_notice, decode_warning)
+    {
+      Mysqlx::Notice::Warning message;
+      message.set_level(Mysqlx::Notice::Warning::NOTE);
+      message.set_code(1287);
+      message.set_msg("deprecated");
+
+      const std::string data = message.SerializeAsString();
+      Notice_warning warning;
+
+      ASSERT_TRUE(decode_notice_warning(data.data(), data.size(), warning));
+      EXPECT_EQ(Mysqlx::Notice::Warning::NOTE, warning.level);
+      EXPECT_EQ(1287U, warning.code);
+      EXPECT_EQ("deprecated", std::string(warning.msg, warning.msg_length));
+    }
+
+    TEST(Mysqlx_notice, decode_session_state)
+    {
+      Mysqlx::Notice::SessionStateChanged message;
+      message.set_param(Mysqlx::Notice::SessionStateChanged::ROWS_AFFECTED);
+      message.mutable_value()->set_type(Mysqlx::Datatypes::Scalar::V_UINT);
+      message.mutable_value()->set_v_unsigned_int(42);
+
+      std::string data = message.SerializeAsString();
+      Notice_session_state state;
+
+      ASSERT_TRUE(decode_notice_session_state(data.data(), data.size(), state));
+      EXPECT_EQ(Mysqlx::Notice::SessionStateChanged::ROWS_AFFECTED, state.param);
+      EXPECT_TRUE(state.has_value);
+      EXPECT_EQ(Mysqlx::Datatypes::Scalar::V_UINT, state.value.type);
+      EXPECT_EQ(42U, state.value.v_unsigned_int);
+
+      message.set_param(Mysqlx::Notice::SessionStateChanged::PRODUCED_MESSAGE);
+      message.mutable_value()->Clear();
+      message.mutable_value()->set_type(Mysqlx::Datatypes::Scalar::V_STRING);
+      message.mutable_value()->mutable_v_string()->set_value("Rows matched: 1");
+      data = message.SerializeAsString();
+
+      ASSERT_TRUE(decode_notice_session_state(data.data(), data.size(), state));
+      EXPECT_EQ(Mysqlx::Datatypes::Scalar::V_STRING, state.value.type);
+      EXPECT_EQ("Rows matched: 1", std::string(state.value.v_bytes, state.value.v_bytes_length));
+    }
+  }
+}
@@ -0,0 +1,163 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <google/protobuf/io/coded_stream.h>
+
+#include "gtest/gtest.h"
+#include "mysqlx_output_buffer.h"
+
+namespace mysqlx
+{
+  namespace tests {
+    // Copies the data the way protobuf does, returning the unused part of the last block
+    static void write(Output_buffer &buffer, const std::string &data)
+    {
+      std::size_t written = 0;
+
+      while (written < data.size())
+      {
+        void *block;
+        int size;
+
+        ASSERT_TRUE(buffer.Next(&block, &size));
+        ASSERT_GT(size, 0);
+
+        const std::size_t length = std::min(static_cast<std::size_t>(size), data.size() - written);
+        memcpy(block, data.data() + written, length);
+        written += length;
+
+        if (length < static_cast<std::size_t>(size))
+          buffer.BackUp(static_cast<int>(size - length));
+      }
+    }
+
+    static std::string content(Output_buffer &buffer)
+    {
+      const ngs::Const_buffer_sequence &buffers = buffer.get_buffers();
+      std::string result;
+
+      for (ngs::Const_buffer_sequence::const_iterator i = buffers.begin(); i != buffers.end(); ++i)
+        result.append(boost::asio::buffer_cast<const char*>(*i), boost::asio::buffer_size(*i));
+
+      return result;
+    }
+
+    static std::string pattern(const std::size_t length, const char first)
+    {
+      std::string result(length, '\0');
+
+      for (std::size_t i = 0; i < length; ++i)
+        result[i] = static_cast<char>(first + i % 26);
+
+      return result;
+    }
+
+    TEST(Mysqlx_output_buffer, growth_across_pages)
+    {
+      Output_buffer buffer(16, 4);
+      const std::string data = pattern(40, 'a');
+
+      EXPECT_TRUE(buffer.empty());
+
+      write(buffer, data);
+
+      EXPECT_EQ(40U, buffer.length());
+      EXPECT_EQ(40, buffer.ByteCount());
+
+      const ngs::Const_buffer_sequence &buffers = buffer.get_buffers();
+      ASSERT_EQ(3U, buffers.size());
+      EXPECT_EQ(16U, boost::asio::buffer_size(buffers[0]));
+      EXPECT_EQ(16U, boost::asio::buffer_size(buffers[1]));
+      EXPECT_EQ(8U, boost::asio::buffer_size(buffers[2]));
+
+      EXPECT_EQ(data, content(buffer));
+    }
+
+    TEST(Mysqlx_output_buffer, partial_writes)
+    {
+      Output_buffer buffer(16, 4);
+      const std::string first = pattern(5, 'a');
+      const std::string second = pattern(7, 'k');
+      const std::string third = pattern(10, 'A');
+
+      // Unused space given back with BackUp() is filled by the next write
+      write(buffer, first);
+      write(buffer, second);
+      ASSERT_EQ(1U, buffer.get_buffers().size());
+      EXPECT_EQ(12U, buffer.length());
+
+      // Rest of the page is used before a new one is started
+      write(buffer, third);
+      ASSERT_EQ(2U, buffer.get_buffers().size());
+      EXPECT_EQ(16U, boost::asio::buffer_size(buffer.get_buffers()[0]));
+      EXPECT_EQ(first + second + third, content(buffer));
+    }
+
+    TEST(Mysqlx_output_buffer, coded_stream)
+    {
+      Output_buffer buffer(16, 4);
+      const std::string data = pattern(100, 'a');
+
+      {
+        google::protobuf::io::CodedOutputStream stream(&buffer);
+
+        stream.WriteLittleEndian32(static_cast<uint32_t>(data.size()));
+        stream.WriteString(data);
+      }
+
+      const std::string result = content(buffer);
+      ASSERT_EQ(104U, result.size());
+      EXPECT_EQ(100, result[0]);
+      EXPECT_EQ(data, result.substr(4));
+    }
+
+    TEST(Mysqlx_output_buffer, reuse_after_reset)
+    {
+      Output_buffer buffer(16, 2);
+      void *first_page;
+      int size;
+
+      write(buffer, pattern(80, 'a'));
+      EXPECT_EQ(5U, buffer.get_buffers().size());
+
+      buffer.reset();
+
+      EXPECT_TRUE(buffer.empty());
+      EXPECT_EQ(0, buffer.ByteCount());
+      EXPECT_TRUE(buffer.get_buffers().empty());
+
+      // Kept pages are reused from the start
+      ASSERT_TRUE(buffer.Next(&first_page, &size));
+      EXPECT_EQ(16, size);
+      buffer.BackUp(size);
+
+      const std::string data = pattern(40, 'A');
+      write(buffer, data);
+
+      const ngs::Const_buffer_sequence &buffers = buffer.get_buffers();
+      ASSERT_EQ(3U, buffers.size());
+      EXPECT_EQ(first_page, boost::asio::buffer_cast<const void*>(buffers[0]));
+      EXPECT_EQ(data, content(buffer));
+
+      // Nothing of the previous content is left behind
+      buffer.reset();
+      write(buffer, "xyz");
+      EXPECT_EQ("xyz", content(buffer));
+    }
+  }
+}
@@ -0,0 +1,90 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include "gtest/gtest.h"
+#include "mysqlx_resolver_cache.h"
+
+namespace mysqlx
+{
+  namespace tests {
+    TEST(Mysqlx_resolver_cache, resolve_from_cache)
+    {
+      boost::asio::io_service ios;
+      Resolver_cache cache;
+      Resolver_cache::Endpoints first;
+      Resolver_cache::Endpoints second;
+      bool from_cache = true;
+
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 33060, first, from_cache));
+      EXPECT_FALSE(from_cache);
+      ASSERT_EQ(1U, first.size());
+      EXPECT_EQ(33060, first[0].port());
+
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 33060, second, from_cache));
+      EXPECT_TRUE(from_cache);
+      EXPECT_EQ(first, second);
+
+      // Entries are kept per port
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 3306, second, from_cache));
+      EXPECT_FALSE(from_cache);
+      EXPECT_EQ(3306, second[0].port());
+    }
+
+    TEST(Mysqlx_resolver_cache, invalidate)
+    {
+      boost::asio::io_service ios;
+      Resolver_cache cache;
+      Resolver_cache::Endpoints endpoints;
+      bool from_cache = true;
+
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 33060, endpoints, from_cache));
+      cache.invalidate("127.0.0.1", 33060);
+
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 33060, endpoints, from_cache));
+      EXPECT_FALSE(from_cache);
+
+      cache.clear();
+
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 33060, endpoints, from_cache));
+      EXPECT_FALSE(from_cache);
+    }
+
+    TEST(Mysqlx_resolver_cache, disabled)
+    {
+      boost::asio::io_service ios;
+      Resolver_cache cache;
+      Resolver_cache::Endpoints endpoints;
+      bool from_cache = true;
+
+      EXPECT_EQ(static_cast<std::size_t>(Resolver_cache::DEFAULT_TTL_SECONDS), cache.ttl());
+      cache.set_ttl(0);
+
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 33060, endpoints, from_cache));
+      ASSERT_FALSE(cache.resolve(ios, "127.0.0.1", 33060, endpoints, from_cache));
+      EXPECT_FALSE(from_cache);
+    }
+
+    TEST(Mysqlx_resolver_cache, unknown_host)
+    {
+      boost::asio::io_service ios;
+      Resolver_cache cache;
+      Resolver_cache::Endpoints endpoints;
+      bool from_cache = true;
+
+      EXPECT_TRUE(cache.resolve(ios, "host.invalid", 33060, endpoints, from_cache));
+      EXPECT_FALSE(from_cache);
+    }
+  }
+}
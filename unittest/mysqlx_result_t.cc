@@ -0,0 +1,522 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <boost/asio.hpp>
+#include <boost/make_shared.hpp>
+
+#include "gtest/gtest.h"
+#include "mysqlx.h"
+#include "mysqlx_connection.h"
+#include "mysqlx_replay_server.h"
+#include "mysqlx.pb.h"
+#include "mysqlx_notice.pb.h"
+#include "mysqlx_resultset.pb.h"
+#include "mysqlx_sql.pb.h"
+
+namespace mysqlx
+{
+  namespace tests {
+    // Every statement is answered with ROWS rows of an id column, counting
+    // them from 1, and a data column of the size given to SetUp_server()
+    class Mysqlx_result : public ::testing::Test
+    {
+    protected:
+      enum { ROWS = 10 };
+
+      void SetUp_server(const std::size_t data_size)
+      {
+        static const char *names[] = { "id", "data" };
+        static const Mysqlx::Resultset::ColumnMetaData::FieldType types[] = {
+          Mysqlx::Resultset::ColumnMetaData::SINT,
+          Mysqlx::Resultset::ColumnMetaData::BYTES
+        };
+
+        for (int i = 0; i < 2; ++i)
+        {
+          Mysqlx::Resultset::ColumnMetaData column;
+
+          column.set_type(types[i]);
+          column.set_name(names[i]);
+          add_frame(Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA, column);
+        }
+
+        for (int i = 1; i <= ROWS; ++i)
+          add_frame(Mysqlx::ServerMessages::RESULTSET_ROW, make_row(i, data_size));
+
+        add_frame(Mysqlx::ServerMessages::RESULTSET_FETCH_DONE, Mysqlx::Resultset::FetchDone());
+        add_frame(Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK, Mysqlx::Sql::StmtExecuteOk());
+
+        m_server.reset(new Replay_server(m_response, m_response.recorded_rows()));
+        ASSERT_FALSE(m_server->listen("127.0.0.1", 0));
+        m_server->start();
+
+        m_connection = boost::make_shared<Connection>(Ssl_config(), 0);
+        m_connection->connect("127.0.0.1", m_server->port());
+      }
+
+      virtual void TearDown()
+      {
+        m_connection.reset();
+        m_server.reset();
+      }
+
+      static std::string frame(const int mid, const google::protobuf::MessageLite &message)
+      {
+        const std::string payload = message.SerializeAsString();
+        const uint32_t length = static_cast<uint32_t>(payload.size() + 1);
+        const char header[5] = {
+          static_cast<char>(length), static_cast<char>(length >> 8),
+          static_cast<char>(length >> 16), static_cast<char>(length >> 24),
+          static_cast<char>(mid)
+        };
+
+        return std::string(header, sizeof(header)) + payload;
+      }
+
+      void add_frame(const int mid, const google::protobuf::MessageLite &message)
+      {
+        ASSERT_TRUE(m_response.add_frames(frame(mid, message)));
+      }
+
+      static Mysqlx::Resultset::Row make_row(const int id, const std::size_t data_size)
+      {
+        Mysqlx::Resultset::Row row;
+
+        row.add_field(std::string(1, static_cast<char>(id << 1))); // zigzag encoded positive value
+        row.add_field(std::string(data_size, static_cast<char>('a' + id)).append(1, '\0'));
+
+        return row;
+      }
+
+      static boost::shared_ptr<std::vector<ColumnMetadata> > make_columns()
+      {
+        boost::shared_ptr<std::vector<ColumnMetadata> > columns(new std::vector<ColumnMetadata>(2));
+
+        (*columns)[0].type = SINT;
+        (*columns)[1].type = BYTES;
+
+        return columns;
+      }
+
+      // Column metadata frames for rows made by make_row()
+      static std::string resultset_head()
+      {
+        std::string data;
+        Mysqlx::Resultset::ColumnMetaData column;
+
+        for (int i = 0; i < 2; ++i)
+        {
+          column.set_type(i ? Mysqlx::Resultset::ColumnMetaData::BYTES : Mysqlx::Resultset::ColumnMetaData::SINT);
+          data += frame(Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA, column);
+        }
+
+        return data;
+      }
+
+      // Stores the rows as Connection::recv_next_storing_rows() does
+      static void store_rows(ResultData &rows, const int first_id, const int last_id, const std::size_t data_size)
+      {
+        for (int id = first_id; id <= last_id; ++id)
+        {
+          const std::string payload = make_row(id, data_size).SerializeAsString();
+
+          std::copy(payload.begin(), payload.end(), rows.reserve_row(payload.size()));
+          rows.commit_row();
+        }
+      }
+
+      // Reads the rest of the rows, checking the ids go from first_id to last_id
+      template <typename Rows>
+      void expect_rows(Rows &rows, const int first_id, const std::size_t data_size, const int last_id = ROWS)
+      {
+        int id = first_id;
+
+        while (boost::shared_ptr<Row> row = rows.next())
+        {
+          EXPECT_EQ(id, row->sInt64Field(0));
+          EXPECT_EQ(std::string(data_size, static_cast<char>('a' + id)), row->stringField(1));
+          ++id;
+        }
+
+        EXPECT_EQ(last_id + 1, id);
+      }
+
+      Replay_response m_response;
+      boost::shared_ptr<Replay_server> m_server;
+      boost::shared_ptr<Connection> m_connection;
+    };
+
+    TEST_F(Mysqlx_result, recv_next_discarding_rows)
+    {
+      // Rows bigger than the discard buffer are read in pieces
+      const std::size_t data_size = 100 * 1024;
+      Mysqlx::Sql::StmtExecute statement;
+      int mid;
+
+      SetUp_server(data_size);
+      statement.set_stmt("select * from t");
+      m_connection->send(statement);
+
+      for (int i = 0; i < 2; ++i)
+      {
+        delete m_connection->recv_next_discarding_rows(mid);
+        EXPECT_EQ(Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA, mid);
+      }
+
+      delete m_connection->recv_next_discarding_rows(mid);
+      EXPECT_EQ(Mysqlx::ServerMessages::RESULTSET_FETCH_DONE, mid);
+
+      delete m_connection->recv_next_discarding_rows(mid);
+      EXPECT_EQ(Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK, mid);
+
+      // Discarded rows are counted with their whole payload
+      const Protocol_metrics &metrics = m_connection->metrics();
+      EXPECT_EQ(static_cast<uint64_t>(ROWS), metrics.rows_decoded());
+      EXPECT_EQ(static_cast<uint64_t>(ROWS), metrics.received(Mysqlx::ServerMessages::RESULTSET_ROW).messages);
+      EXPECT_LT(static_cast<uint64_t>(ROWS * data_size), metrics.bytes_decoded());
+
+      // Nothing of the discarded rows is left on the connection
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+      expect_rows(*result, 1, data_size);
+    }
+
+    TEST_F(Mysqlx_result, flush_in_the_middle_of_the_rows)
+    {
+      SetUp_server(16);
+
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+
+      ASSERT_TRUE(result->next().get() != NULL);
+      ASSERT_TRUE(result->next().get() != NULL);
+
+      // skip_rows() goes on from the third row
+      result->flush();
+      EXPECT_FALSE(result->next().get() != NULL);
+
+      boost::shared_ptr<Result> next_result(m_connection->execute_sql("select * from t"));
+      expect_rows(*next_result, 1, 16);
+    }
+
+    TEST_F(Mysqlx_result, unread_result_flushed_by_next_command)
+    {
+      SetUp_server(16);
+
+      // Only the connection holds the first result, its rows are discarded
+      m_connection->execute_sql("select * from t");
+      m_connection->reset_metrics();
+
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+
+      EXPECT_EQ(static_cast<uint64_t>(ROWS), m_connection->metrics().rows_decoded());
+      expect_rows(*result, 1, 16);
+    }
+
+    TEST_F(Mysqlx_result, held_result_buffered_by_next_command)
+    {
+      SetUp_server(16);
+
+      boost::shared_ptr<Result> first(m_connection->execute_sql("select * from t"));
+      boost::shared_ptr<Row> row(first->next());
+
+      ASSERT_TRUE(row.get() != NULL);
+      EXPECT_EQ(1, row->sInt64Field(0));
+
+      // The rows left of the first result are kept for its holder
+      boost::shared_ptr<Result> second(m_connection->execute_sql("select * from t"));
+      expect_rows(*second, 1, 16);
+
+      expect_rows(*first, 2, 16);
+    }
+
+    TEST_F(Mysqlx_result, read_ahead_one_frame_at_a_time)
+    {
+      SetUp_server(16);
+
+      // Each frame is over the limit, they are queued one by one
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+      result->enable_read_ahead(1);
+      expect_rows(*result, 1, 16);
+
+      // Rows are counted by the consumer, which parses them
+      EXPECT_EQ(static_cast<uint64_t>(ROWS), m_connection->metrics().rows_decoded());
+
+      // The connection is read directly again after the resultset
+      boost::shared_ptr<Result> next_result(m_connection->execute_sql("select * from t"));
+      expect_rows(*next_result, 1, 16);
+    }
+
+    TEST_F(Mysqlx_result, read_ahead_result_buffered_by_next_command)
+    {
+      SetUp_server(16);
+
+      boost::shared_ptr<Result> first(m_connection->execute_sql("select * from t"));
+      first->enable_read_ahead(1);
+
+      boost::shared_ptr<Row> row(first->next());
+      ASSERT_TRUE(row.get() != NULL);
+      EXPECT_EQ(1, row->sInt64Field(0));
+
+      // The statement is written once the thread has read the rest of the
+      // resultset, the queued rows are buffered for the holder
+      boost::shared_ptr<Result> second(m_connection->execute_sql("select * from t"));
+      expect_rows(*second, 1, 16);
+
+      expect_rows(*first, 2, 16);
+    }
+
+    TEST_F(Mysqlx_result, compression_refused_by_the_server)
+    {
+      SetUp_server(16);
+
+      // The session goes on uncompressed, telling why
+      m_connection->set_compression(true);
+      m_connection->authenticate_mysql41("root", "", "");
+
+      EXPECT_TRUE(m_connection->is_compression_requested());
+      EXPECT_FALSE(m_connection->is_compression_active());
+      EXPECT_NE(std::string::npos, m_connection->compression_refusal().find("compression"));
+
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+      expect_rows(*result, 1, 16);
+    }
+
+    // Memory limit of the spill tests: one block, holding 3 rows of
+    // SPILL_DATA_SIZE bytes, the rest go to the temporary file
+    static const std::size_t SPILL_MEMORY = 1024 * 1024;
+    static const std::size_t SPILL_DATA_SIZE = 300 * 1024;
+
+    TEST_F(Mysqlx_result, result_data_spilled_to_file)
+    {
+      ResultData rows(make_columns(), SPILL_MEMORY);
+      std::size_t record;
+
+      store_rows(rows, 1, 5, SPILL_DATA_SIZE);
+      expect_rows(rows, 1, SPILL_DATA_SIZE, 5);
+
+      // Rows stored after some were read from the file are read too
+      store_rows(rows, 6, ROWS, SPILL_DATA_SIZE);
+      expect_rows(rows, 6, SPILL_DATA_SIZE);
+
+      rows.rewind();
+      rows.tell(record);
+      EXPECT_EQ(0U, record);
+      expect_rows(rows, 1, SPILL_DATA_SIZE);
+    }
+
+    TEST_F(Mysqlx_result, result_data_seek_across_the_spill)
+    {
+      ResultData rows(make_columns(), SPILL_MEMORY);
+      std::size_t record;
+
+      store_rows(rows, 1, ROWS, SPILL_DATA_SIZE);
+
+      // Last row in memory, first one in the file, and back to memory
+      rows.seek(2);
+      expect_rows(rows, 3, SPILL_DATA_SIZE);
+
+      rows.seek(3);
+      rows.tell(record);
+      EXPECT_EQ(3U, record);
+      expect_rows(rows, 4, SPILL_DATA_SIZE);
+
+      rows.seek(1);
+      expect_rows(rows, 2, SPILL_DATA_SIZE);
+
+      // Seeking past the end leaves no rows to read
+      rows.seek(ROWS + 5);
+      rows.tell(record);
+      EXPECT_EQ(static_cast<std::size_t>(ROWS), record);
+      EXPECT_FALSE(rows.next().get() != NULL);
+    }
+
+    TEST_F(Mysqlx_result, result_data_cancelled_rows)
+    {
+      ResultData rows(make_columns(), SPILL_MEMORY);
+
+      // A cancelled row leaves no trace, in memory nor in the file
+      store_rows(rows, 1, 2, SPILL_DATA_SIZE);
+      rows.reserve_row(SPILL_DATA_SIZE);
+      rows.cancel_row();
+      store_rows(rows, 3, 5, SPILL_DATA_SIZE);
+      rows.reserve_row(SPILL_DATA_SIZE);
+      rows.cancel_row();
+      store_rows(rows, 6, ROWS, SPILL_DATA_SIZE);
+
+      expect_rows(rows, 1, SPILL_DATA_SIZE);
+    }
+
+    TEST_F(Mysqlx_result, buffer_spilled_to_file)
+    {
+      SetUp_server(SPILL_DATA_SIZE);
+
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+      std::size_t dataset;
+      std::size_t record;
+
+      result->buffer(SPILL_MEMORY);
+      ASSERT_TRUE(result->is_buffered());
+      ASSERT_TRUE(result->tell(dataset, record));
+      expect_rows(*result, 1, SPILL_DATA_SIZE);
+
+      ASSERT_TRUE(result->rewind());
+      expect_rows(*result, 1, SPILL_DATA_SIZE);
+
+      ASSERT_TRUE(result->seek(dataset, 3));
+      expect_rows(*result, 4, SPILL_DATA_SIZE);
+
+      ASSERT_TRUE(result->seek(dataset, 2));
+      expect_rows(*result, 3, SPILL_DATA_SIZE);
+    }
+
+    // Stand-in server, answers the first frame with data and closes the
+    // connection
+    static void send_and_close(boost::asio::io_service &ios, boost::asio::ip::tcp::acceptor &acceptor, const std::string &data)
+    {
+      boost::system::error_code error;
+      boost::asio::ip::tcp::socket socket(ios);
+      char header[5];
+
+      acceptor.accept(socket, error);
+      if (!error)
+        boost::asio::read(socket, boost::asio::buffer(header), error);
+      if (error)
+        return;
+
+      std::string payload(Replay_response::frame_length(header) - 1, '\0');
+
+      if (!payload.empty())
+        boost::asio::read(socket, boost::asio::buffer(&payload[0], payload.size()), error);
+      if (!error)
+        boost::asio::write(socket, boost::asio::buffer(data), error);
+    }
+
+    TEST_F(Mysqlx_result, failed_read_while_storing_rows)
+    {
+      std::string data;
+      Mysqlx::Resultset::ColumnMetaData column;
+      Mysqlx::Sql::StmtExecute statement;
+      int mid;
+
+      for (int i = 0; i < 2; ++i)
+      {
+        column.set_type(i ? Mysqlx::Resultset::ColumnMetaData::BYTES : Mysqlx::Resultset::ColumnMetaData::SINT);
+        data += frame(Mysqlx::ServerMessages::RESULTSET_COLUMN_META_DATA, column);
+      }
+
+      // The connection is closed in the middle of the fourth row, the
+      // first one going to the file
+      for (int i = 1; i <= 4; ++i)
+        data += frame(Mysqlx::ServerMessages::RESULTSET_ROW, make_row(i, SPILL_DATA_SIZE));
+      data.resize(data.size() - SPILL_DATA_SIZE / 2);
+
+      boost::asio::io_service ios;
+      boost::asio::ip::tcp::acceptor acceptor(ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+      std::thread server(send_and_close, std::ref(ios), std::ref(acceptor), std::cref(data));
+
+      m_connection = boost::make_shared<Connection>(Ssl_config(), 0);
+      m_connection->connect("127.0.0.1", acceptor.local_endpoint().port());
+      statement.set_stmt("select * from t");
+      m_connection->send(statement);
+
+      for (int i = 0; i < 2; ++i)
+        delete m_connection->recv_next_discarding_rows(mid);
+
+      ResultData rows(make_columns(), SPILL_MEMORY);
+
+      EXPECT_THROW(m_connection->recv_next_storing_rows(mid, rows), Error);
+      server.join();
+
+      // Only the rows read completely are kept, and more can be stored
+      store_rows(rows, 4, 5, SPILL_DATA_SIZE);
+      expect_rows(rows, 1, SPILL_DATA_SIZE, 5);
+    }
+
+    TEST_F(Mysqlx_result, read_ahead_notices_between_rows)
+    {
+      std::string data = resultset_head();
+
+      // Every row is followed by a warning, handled by the consumer as it
+      // reaches it
+      for (int i = 1; i <= 4; ++i)
+      {
+        Mysqlx::Notice::Warning warning;
+        Mysqlx::Notice::Frame notice;
+
+        warning.set_level(Mysqlx::Notice::Warning::WARNING);
+        warning.set_code(1000 + i);
+        warning.set_msg("warning");
+        notice.set_type(1);
+        notice.set_scope(Mysqlx::Notice::Frame::LOCAL);
+        notice.set_payload(warning.SerializeAsString());
+
+        data += frame(Mysqlx::ServerMessages::RESULTSET_ROW, make_row(i, 16));
+        data += frame(Mysqlx::ServerMessages::NOTICE, notice);
+      }
+
+      data += frame(Mysqlx::ServerMessages::RESULTSET_FETCH_DONE, Mysqlx::Resultset::FetchDone());
+      data += frame(Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK, Mysqlx::Sql::StmtExecuteOk());
+
+      boost::asio::io_service ios;
+      boost::asio::ip::tcp::acceptor acceptor(ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+      std::thread server(send_and_close, std::ref(ios), std::ref(acceptor), std::cref(data));
+
+      m_connection = boost::make_shared<Connection>(Ssl_config(), 0);
+      m_connection->connect("127.0.0.1", acceptor.local_endpoint().port());
+
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+      result->enable_read_ahead(1024 * 1024);
+      expect_rows(*result, 1, 16, 4);
+      server.join();
+
+      ASSERT_EQ(4U, result->getWarnings().size());
+      for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(1001 + i, result->getWarnings()[i].code);
+    }
+
+    TEST_F(Mysqlx_result, read_ahead_failed_read)
+    {
+      std::string data = resultset_head();
+
+      // The connection is closed in the middle of the fourth row
+      for (int i = 1; i <= 4; ++i)
+        data += frame(Mysqlx::ServerMessages::RESULTSET_ROW, make_row(i, 16));
+      data.resize(data.size() - 8);
+
+      boost::asio::io_service ios;
+      boost::asio::ip::tcp::acceptor acceptor(ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+      std::thread server(send_and_close, std::ref(ios), std::ref(acceptor), std::cref(data));
+
+      m_connection = boost::make_shared<Connection>(Ssl_config(), 0);
+      m_connection->connect("127.0.0.1", acceptor.local_endpoint().port());
+
+      boost::shared_ptr<Result> result(m_connection->execute_sql("select * from t"));
+      result->enable_read_ahead(1024 * 1024);
+
+      // Rows read completely are consumed, the error of the thread comes after them
+      for (int i = 1; i <= 3; ++i)
+      {
+        boost::shared_ptr<Row> row(result->next());
+        ASSERT_TRUE(row.get() != NULL);
+        EXPECT_EQ(i, row->sInt64Field(0));
+      }
+
+      EXPECT_THROW(result->next(), Error);
+      server.join();
+    }
+  }
+}
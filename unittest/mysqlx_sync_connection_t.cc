@@ -0,0 +1,505 @@
+/* Copyright (c) 2016 Oracle and/or its affiliates. All rights reserved.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; version 2 of the License.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "gtest/gtest.h"
+#include "mysqlx_compression.h"
+#include "mysqlx_sync_connection.h"
+
+namespace mysqlx
+{
+  namespace tests {
+    using boost::asio::ip::tcp;
+
+    // Stand-in server, sends back every X protocol frame it receives
+    template <typename Acceptor_type>
+    static void echo_frames(Acceptor_type &acceptor)
+    {
+      boost::system::error_code error;
+      typename Acceptor_type::protocol_type::socket socket(acceptor.get_io_service());
+
+      acceptor.accept(socket, error);
+
+      std::vector<char> payload;
+
+      while (!error)
+      {
+        char header[5];
+        boost::asio::read(socket, boost::asio::buffer(header), error);
+        if (error)
+          break;
+
+        uint32_t length = *(uint32_t*)header - 1;
+        payload.resize(length + 5);
+        std::copy(header, header + 5, payload.begin());
+
+        if (length)
+          boost::asio::read(socket, boost::asio::buffer(&payload[5], length), error);
+
+        if (!error)
+          boost::asio::write(socket, boost::asio::buffer(payload), error);
+      }
+    }
+
+    static std::string frame(const std::size_t payload_size)
+    {
+      std::string result(5, '\0');
+      *(uint32_t*)&result[0] = static_cast<uint32_t>(payload_size + 1);
+      result[4] = 1;
+      result.append(payload_size, 'x');
+
+      return result;
+    }
+
+    class Mysqlx_sync_connection_test : public ::testing::Test
+    {
+    protected:
+      virtual void SetUp()
+      {
+        m_acceptor.reset(new tcp::acceptor(m_server_ios, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)));
+        m_server = std::thread(echo_frames<tcp::acceptor>, std::ref(*m_acceptor));
+      }
+
+      virtual void TearDown()
+      {
+        m_server.join();
+        m_acceptor.reset();
+      }
+
+      boost::asio::io_service m_server_ios;
+      boost::shared_ptr<tcp::acceptor> m_acceptor;
+      std::thread m_server;
+    };
+
+    TEST_F(Mysqlx_sync_connection_test, read_write_plain)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+
+      ASSERT_FALSE(connection.connect(m_acceptor->local_endpoint()));
+
+      const std::string request = frame(100);
+      std::string response(request.size(), '\0');
+
+      EXPECT_FALSE(connection.write(request.data(), request.size()));
+      EXPECT_FALSE(connection.read(&response[0], 5));
+      EXPECT_FALSE(connection.read(&response[5], response.size() - 5));
+      EXPECT_EQ(request, response);
+
+      connection.close();
+    }
+
+    TEST_F(Mysqlx_sync_connection_test, read_with_timeout_expires)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+
+      ASSERT_FALSE(connection.connect(m_acceptor->local_endpoint()));
+
+      char header[5];
+      std::size_t length = sizeof(header);
+
+      // Server doesn't send anything unless asked
+      connection.read_with_timeout(header, length, 50);
+      EXPECT_EQ(0U, length);
+    }
+
+    // Port on loopback that refuses connections
+    static tcp::endpoint closed_endpoint()
+    {
+      boost::asio::io_service ios;
+      tcp::acceptor acceptor(ios, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+      return acceptor.local_endpoint();
+    }
+
+    TEST_F(Mysqlx_sync_connection_test, connect_race_refused_address)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+      std::vector<ngs::Endpoint> endpoints;
+
+      endpoints.push_back(closed_endpoint());
+      endpoints.push_back(m_acceptor->local_endpoint());
+
+      // Failed attempt starts the next one without waiting for the delay
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      ASSERT_FALSE(connection.connect(endpoints, 5000));
+      EXPECT_GT(2000, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+      const std::string request = frame(10);
+      std::string response(request.size(), '\0');
+
+      EXPECT_FALSE(connection.write(request.data(), request.size()));
+      EXPECT_FALSE(connection.read(&response[0], response.size()));
+      EXPECT_EQ(request, response);
+
+      connection.close();
+    }
+
+    TEST_F(Mysqlx_sync_connection_test, connect_race_unreachable_address)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+      std::vector<ngs::Endpoint> endpoints;
+
+      // TEST-NET-1, never answers or is reported unreachable
+      endpoints.push_back(tcp::endpoint(boost::asio::ip::address_v4::from_string("192.0.2.1"), m_acceptor->local_endpoint().port()));
+      endpoints.push_back(m_acceptor->local_endpoint());
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      ASSERT_FALSE(connection.connect(endpoints, 50));
+      EXPECT_GT(2000, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+      connection.close();
+    }
+
+    TEST_F(Mysqlx_sync_connection_test, connect_race_all_refused)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+      std::vector<ngs::Endpoint> endpoints;
+
+      endpoints.push_back(closed_endpoint());
+      endpoints.push_back(closed_endpoint());
+
+      EXPECT_EQ(boost::asio::error::connection_refused, connection.connect(endpoints, 50));
+      EXPECT_TRUE(connection.connect(std::vector<ngs::Endpoint>(), 50));
+
+      // Unblocks the server waiting for a client
+      ASSERT_FALSE(connection.connect(m_acceptor->local_endpoint()));
+      connection.close();
+    }
+
+    // Client that sends one byte at a time, each before a 100ms timeout would expire
+    static void trickle_bytes(const tcp::endpoint &endpoint, const std::size_t count)
+    {
+      boost::asio::io_service ios;
+      tcp::socket socket(ios);
+      boost::system::error_code error;
+
+      for (int attempt = 0; attempt < 200; ++attempt)
+      {
+        socket.connect(endpoint, error);
+        if (!error)
+          break;
+        socket.close();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+
+      for (std::size_t i = 0; i < count && !error; ++i)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        boost::asio::write(socket, boost::asio::buffer("x", 1), error);
+      }
+    }
+
+    TEST_F(Mysqlx_sync_connection_test, read_with_timeout_not_extended_by_partial_data)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+      const tcp::endpoint endpoint = closed_endpoint();
+      std::thread client(trickle_bytes, endpoint, 10);
+
+      // Accepted socket is read through the plain socket path as well
+      ASSERT_FALSE(connection.accept(endpoint));
+
+      char data[10];
+      std::size_t length = sizeof(data);
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      connection.read_with_timeout(data, length, 100);
+      EXPECT_EQ(0U, length);
+      EXPECT_GT(250, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+      connection.close();
+      client.join();
+
+      // Unblocks the server waiting for a client
+      ASSERT_FALSE(connection.connect(m_acceptor->local_endpoint()));
+      connection.close();
+    }
+
+#ifdef HAVE_ZLIB
+    // Stand-in peer for the compressed framing, sends back the payload of every
+    // frame it receives. It packs the frames on its own, thus the client is
+    // checked against the wire format and not only against itself. gtest
+    // assertions only work on the main thread, so a failure is handed back
+    // through failure and the connection is dropped.
+    static void echo_compressed_frames(tcp::acceptor &acceptor, std::string &failure)
+    {
+      boost::system::error_code error;
+      tcp::socket socket(acceptor.get_io_service());
+      Compression_deflate deflate;
+
+      acceptor.accept(socket, error);
+
+      std::string payload;
+      std::string data;
+      std::string response;
+
+      while (!error)
+      {
+        char header[8];
+        boost::asio::read(socket, boost::asio::buffer(header), error);
+        if (error)
+          break;
+
+        const uint32_t length = *(uint32_t*)header;
+        const uint32_t uncompressed_length = *(uint32_t*)(header + 4);
+        payload.resize(length);
+
+        if (length)
+          boost::asio::read(socket, boost::asio::buffer(&payload[0], length), error);
+        if (error)
+          break;
+
+        data.clear();
+        if (0 == uncompressed_length)
+          data = payload;
+        else if (!deflate.uncompress(payload.data(), length, uncompressed_length, data))
+        {
+          failure = "Frame sent by the client can't be uncompressed";
+          break;
+        }
+
+        // Always deflated, even when it doesn't shrink
+        response.assign(8, '\0');
+        if (!deflate.compress(data.data(), data.size(), response))
+        {
+          failure = "Response can't be compressed";
+          break;
+        }
+
+        *(uint32_t*)&response[0] = static_cast<uint32_t>(response.size() - 8);
+        *(uint32_t*)&response[4] = static_cast<uint32_t>(data.size());
+
+        boost::asio::write(socket, boost::asio::buffer(response), error);
+      }
+    }
+
+    class Mysqlx_sync_connection_compressed_test : public ::testing::Test
+    {
+    protected:
+      Mysqlx_sync_connection_compressed_test()
+      : m_connection(m_ios)
+      {
+      }
+
+      virtual void SetUp()
+      {
+        m_acceptor.reset(new tcp::acceptor(m_server_ios, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)));
+        m_server = std::thread(echo_compressed_frames, std::ref(*m_acceptor), std::ref(m_server_failure));
+
+        ASSERT_FALSE(m_connection.connect(m_acceptor->local_endpoint()));
+        m_connection.enable_compression(create_compression_algorithm("deflate"));
+      }
+
+      virtual void TearDown()
+      {
+        m_connection.close();
+
+        // Wakes up the server in case SetUp failed before the client connected
+        {
+          boost::system::error_code error;
+          tcp::socket socket(m_server_ios);
+          socket.connect(m_acceptor->local_endpoint(), error);
+        }
+
+        m_server.join();
+        m_acceptor.reset();
+
+        EXPECT_EQ("", m_server_failure);
+      }
+
+      void round_trip(const std::string &request)
+      {
+        std::string response(request.size(), '\0');
+
+        ASSERT_FALSE(m_connection.write(request.data(), request.size()));
+        ASSERT_FALSE(m_connection.read(&response[0], 5));
+        ASSERT_FALSE(m_connection.read(&response[5], response.size() - 5));
+        ASSERT_EQ(request, response);
+      }
+
+      boost::asio::io_service m_server_ios;
+      boost::shared_ptr<tcp::acceptor> m_acceptor;
+      std::thread m_server;
+      std::string m_server_failure;
+
+      boost::asio::io_service m_ios;
+      Mysqlx_sync_connection m_connection;
+    };
+
+    TEST_F(Mysqlx_sync_connection_compressed_test, read_write_compressed)
+    {
+      EXPECT_TRUE(m_connection.is_compression_active());
+
+      // Too short to be compressed, sent as is
+      round_trip(frame(10));
+
+      const Compression_statistics &statistics = m_connection.get_compression_statistics();
+      EXPECT_EQ(1U, statistics.frames_sent());
+      EXPECT_EQ(15U + 8U, statistics.wire_bytes_sent());
+
+      round_trip(frame(4000));
+
+      EXPECT_EQ(2U, statistics.frames_sent());
+      EXPECT_EQ(2U, statistics.frames_received());
+      EXPECT_EQ(15U + 4005U, statistics.payload_bytes_sent());
+      EXPECT_LT(statistics.wire_bytes_sent(), statistics.payload_bytes_sent());
+      EXPECT_LT(statistics.wire_bytes_received(), statistics.payload_bytes_received());
+      EXPECT_GT(statistics.ratio(), 1.0);
+    }
+
+    TEST_F(Mysqlx_sync_connection_compressed_test, write_buffer_sequence)
+    {
+      const std::string first = frame(100);
+      const std::string second = frame(200);
+      ngs::Const_buffer_sequence buffers;
+
+      buffers.push_back(boost::asio::buffer(first));
+      buffers.push_back(boost::asio::buffer(second));
+
+      // Queued messages go in a single frame
+      ASSERT_FALSE(m_connection.write(buffers));
+      EXPECT_EQ(1U, m_connection.get_compression_statistics().frames_sent());
+
+      std::string response(first.size() + second.size(), '\0');
+      ASSERT_FALSE(m_connection.read(&response[0], response.size()));
+      EXPECT_EQ(first + second, response);
+    }
+
+    TEST_F(Mysqlx_sync_connection_compressed_test, read_with_timeout_expires)
+    {
+      char header[5];
+      std::size_t length = sizeof(header);
+
+      m_connection.read_with_timeout(header, length, 50);
+      EXPECT_EQ(0U, length);
+    }
+
+    TEST_F(Mysqlx_sync_connection_compressed_test, read_with_timeout)
+    {
+      // The frame arrives before the deadline, the rest of it is read as usual
+      const std::string request = frame(1000);
+      std::string response(request.size(), '\0');
+      std::size_t length = 5;
+
+      ASSERT_FALSE(m_connection.write(request.data(), request.size()));
+      ASSERT_FALSE(m_connection.read_with_timeout(&response[0], length, 1000));
+      ASSERT_EQ(5U, length);
+      ASSERT_FALSE(m_connection.read(&response[5], response.size() - 5));
+      EXPECT_EQ(request, response);
+    }
+
+    // Row like data, as sent by bulk exports
+    TEST_F(Mysqlx_sync_connection_compressed_test, row_data_ratio)
+    {
+      std::string request(5, '\0');
+      char row[128];
+
+      for (int i = 0; request.size() < 64 * 1024; ++i)
+      {
+        const int length = snprintf(row, sizeof(row), "{\"_id\": \"%08i\", \"name\": \"customer %i\", \"balance\": %i.%02i}",
+                                    i, i, i * 37 % 10000, i % 100);
+        request.append(row, length);
+      }
+
+      *(uint32_t*)&request[0] = static_cast<uint32_t>(request.size() - 4);
+      request[4] = 1;
+
+      round_trip(request);
+      round_trip(request);
+
+      EXPECT_GT(m_connection.get_compression_statistics().ratio(), 2.0);
+    }
+#endif // HAVE_ZLIB
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    using boost::asio::local::stream_protocol;
+
+    class Mysqlx_sync_connection_local_test : public ::testing::Test
+    {
+    protected:
+      virtual void SetUp()
+      {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/mysqlx_sync_connection_t.%i.sock", static_cast<int>(getpid()));
+        m_socket_path = path;
+        ::unlink(path);
+
+        m_acceptor.reset(new stream_protocol::acceptor(m_server_ios, stream_protocol::endpoint(m_socket_path)));
+        m_server = std::thread(echo_frames<stream_protocol::acceptor>, std::ref(*m_acceptor));
+      }
+
+      virtual void TearDown()
+      {
+        m_server.join();
+        m_acceptor.reset();
+        ::unlink(m_socket_path.c_str());
+      }
+
+      boost::asio::io_service m_server_ios;
+      boost::shared_ptr<stream_protocol::acceptor> m_acceptor;
+      std::thread m_server;
+      std::string m_socket_path;
+    };
+
+    TEST_F(Mysqlx_sync_connection_local_test, read_write_plain)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+
+      ASSERT_FALSE(connection.connect(m_socket_path));
+      EXPECT_FALSE(connection.supports_ssl());
+
+      const std::string request = frame(100);
+      std::string response(request.size(), '\0');
+
+      EXPECT_FALSE(connection.write(request.data(), request.size()));
+      EXPECT_FALSE(connection.read(&response[0], 5));
+      EXPECT_FALSE(connection.read(&response[5], response.size() - 5));
+      EXPECT_EQ(request, response);
+
+      connection.close();
+    }
+
+    TEST_F(Mysqlx_sync_connection_local_test, connect_missing_socket)
+    {
+      boost::asio::io_service ios;
+      Mysqlx_sync_connection connection(ios);
+
+      EXPECT_TRUE(connection.connect(m_socket_path + ".missing"));
+
+      // Unblocks the server waiting for a client
+      ASSERT_FALSE(connection.connect(m_socket_path));
+      connection.close();
+    }
+
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  }
+}
@@ -14,9 +14,11 @@ var result = mySession.runSql('create table js_shell_test.buffer_table (name var
 var members = dir(result);
 print ("SqlResult Members:" + members);
 validateMember(members, 'executionTime');
+validateMember(members, 'timing');
 validateMember(members, 'warningCount');
 validateMember(members, 'warnings');
 validateMember(members, 'getExecutionTime');
+validateMember(members, 'getTiming');
 validateMember(members, 'getWarningCount');
 validateMember(members, 'getWarnings');
 validateMember(members, 'columnCount');
@@ -16,6 +16,7 @@ validateMember(sessionMembers, 'getSchemas');
 validateMember(sessionMembers, 'getUri');
 validateMember(sessionMembers, 'setCurrentSchema');
 validateMember(sessionMembers, 'runSql');
+validateMember(sessionMembers, 'loadLocalInfile');
 validateMember(sessionMembers, 'defaultSchema');
 validateMember(sessionMembers, 'uri');
 validateMember(sessionMembers, 'currentSchema');
@@ -88,6 +89,25 @@ classicSession.commit();
 var result = classicSession.runSql('select * from sample');
 print('Inserted Documents:', result.fetchAll().length);
 
+//@ ClassicSession: loadLocalInfile from data and generator
+var load = "load data local infile 'ignored' into table sample";
+var result = classicSession.loadLocalInfile(load, { data: 'john\nmary\n' });
+print('Affected Rows:', result.affectedRowCount);
+
+var names = ['paul\n', '', 'ringo\ngeorge\n'];
+var index = 0;
+var result = classicSession.loadLocalInfile(load, { generator: function() { return index < names.length ? names[index++] : null; } });
+print('Affected Rows:', result.affectedRowCount);
+
+//@# ClassicSession: loadLocalInfile errors
+var result = classicSession.loadLocalInfile(load);
+var result = classicSession.loadLocalInfile(load, {});
+var result = classicSession.loadLocalInfile(load, { other: 'john' });
+var result = classicSession.loadLocalInfile(load, { generator: 5 });
+var result = classicSession.loadLocalInfile(load, { generator: function() { return 5; } });
+var result = classicSession.loadLocalInfile(load, { file: 'unexisting_file.txt' });
+var result = classicSession.runSql(load);
+
 classicSession.dropSchema('node_session_schema');
 classicSession.dropSchema('quoted schema');
 
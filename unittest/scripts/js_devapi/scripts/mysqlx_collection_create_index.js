@@ -80,5 +80,54 @@ var result = collection.createIndex('_name', mysqlx.IndexType.Unique).field('nam
 var result = collection.add({ name: 'John', last_name: 'Carter', age: 17 }).execute();
 var result = collection.add({ name: 'John', last_name: 'Doe', age: 18 }).execute();
 
+// -----------------------------------
+// Multiple index creation
+// -----------------------------------
+//@# Error conditions on createIndexes
+var result = collection.createIndexes();
+var result = collection.createIndexes(5);
+var result = collection.createIndexes([]);
+var result = collection.createIndexes([{ fields: [{ field: 'age', type: 'INTEGER' }] }]);
+var result = collection.createIndexes([{ name: '_age' }]);
+var result = collection.createIndexes([{ name: '_age', fields: [{ field: 'age', type: 'INTEGER', other: true }] }]);
+var result = collection.createIndexes([{ name: '_age', fields: [{ field: 'age', type: 'INTEGER; DROP' }] }]);
+var result = collection.createIndexes([{ name: '_age', fields: [{ field: 'age', type: 'TEXT' }] }]);
+var result = collection.createIndexes([{ name: '_age', fields: [{ field: 'age', type: 'INTEGER' }] }, { name: '_age', fields: [{ field: 'age', type: 'INTEGER' }] }]);
+var result = collection.createIndexes([{ name: '_age', fields: [{ field: 'age', type: 'INTEGER' }] }], { other: true });
+
+//@ Multiple indexes: creation in a single statement
+var result = collection.remove().execute();
+var result = collection.createIndexes([{ name: '_age', fields: [{ field: 'age', type: 'INTEGER' }] },
+                                       { name: '_full_name', unique: true, fields: [{ field: 'last_name', type: 'TEXT(50)', required: true }, { field: 'first_name', type: 'TEXT(50)' }] },
+                                       { name: '_last_name', fields: [{ field: 'last_name', type: 'TEXT(20)', required: true }] }],
+                                      { showProgress: false });
+var result = collection.add({ first_name: 'John', last_name: 'Carter', age: 17 }).execute();
+var result = collection.add({ first_name: 'Jane', last_name: 'Carter', age: 18 }).execute();
+var records = collection.find('age > 17').execute().fetchAll();
+print('Records:', records.length);
+
+//@ ERROR: multiple indexes, insertion of document missing required field
+var result = collection.add({ first_name: 'Rock', age: 19 }).execute();
+
+//@ ERROR: multiple indexes, none is created if one fails
+var result = collection.createIndexes([{ name: '_first_name', fields: [{ field: 'first_name', type: 'TEXT(50)' }] },
+                                       { name: '_age', fields: [{ field: 'age', type: 'INTEGER' }] }],
+                                      { showProgress: false });
+
+//@ Multiple indexes: dropping one keeps the others
+var result = collection.dropIndex('_age').execute();
+var result = collection.createIndexes([{ name: '_first_name', fields: [{ field: 'first_name', type: 'TEXT(50)' }] },
+                                       { name: '_age', fields: [{ field: 'age', type: 'INTEGER' }] }],
+                                      { showProgress: false });
+var result = collection.add({ first_name: 'John', last_name: 'Doe', age: 20 }).execute();
+print('Affected Rows:', result.affectedItemCount);
+
+//@ Multiple indexes: generated columns shared with createIndex
+var result = collection.createIndex('_zip').field('zip', 'INTEGER', false).execute();
+var result = collection.createIndexes([{ name: '_zip_age', fields: [{ field: 'zip', type: 'INTEGER' }, { field: 'age', type: 'INTEGER' }] }],
+                                      { showProgress: false });
+var result = mySession.sql("select count(*) from information_schema.columns where table_schema = 'js_shell_test' and table_name = 'collection1' and column_name like '$ix\\_i\\_%'").execute();
+print('Integer columns:', result.fetchOne()[0]);
+
 //@ Cleanup
 mySession.close();
\ No newline at end of file
@@ -14,9 +14,11 @@ var result = mySession.sql('create table js_shell_test.buffer_table (name varcha
 var sqlMembers = dir(result);
 print ("SqlResult Members:" + sqlMembers);
 validateMember(sqlMembers, 'executionTime');
+validateMember(sqlMembers, 'timing');
 validateMember(sqlMembers, 'warningCount');
 validateMember(sqlMembers, 'warnings');
 validateMember(sqlMembers, 'getExecutionTime');
+validateMember(sqlMembers, 'getTiming');
 validateMember(sqlMembers, 'getWarningCount');
 validateMember(sqlMembers, 'getWarnings');
 validateMember(sqlMembers, 'columnCount');
@@ -50,9 +52,11 @@ var collection = schema.createCollection('buffer_collection');
 var resultMembers = dir(result);
 print ("Result Members:" + resultMembers);
 validateMember(resultMembers, 'executionTime');
+validateMember(resultMembers, 'timing');
 validateMember(resultMembers, 'warningCount');
 validateMember(resultMembers, 'warnings');
 validateMember(resultMembers, 'getExecutionTime');
+validateMember(resultMembers, 'getTiming');
 validateMember(resultMembers, 'getWarningCount');
 validateMember(resultMembers, 'getWarnings');
 validateMember(resultMembers, 'affectedItemCount');
@@ -69,9 +73,11 @@ var result = table.select().execute();
 var rowResultMembers = dir(result);
 print ("RowResult Members:" + rowResultMembers);
 validateMember(rowResultMembers, 'executionTime');
+validateMember(rowResultMembers, 'timing');
 validateMember(rowResultMembers, 'warningCount');
 validateMember(rowResultMembers, 'warnings');
 validateMember(rowResultMembers, 'getExecutionTime');
+validateMember(rowResultMembers, 'getTiming');
 validateMember(rowResultMembers, 'getWarningCount');
 validateMember(rowResultMembers, 'getWarnings');
 validateMember(rowResultMembers, 'columnCount');
@@ -88,9 +94,11 @@ var result = collection.find().execute();
 var docResultMembers = dir(result);
 print ("DocRowResult Members:" + docResultMembers);
 validateMember(docResultMembers, 'executionTime');
+validateMember(docResultMembers, 'timing');
 validateMember(docResultMembers, 'warningCount');
 validateMember(docResultMembers, 'warnings');
 validateMember(docResultMembers, 'getExecutionTime');
+validateMember(docResultMembers, 'getTiming');
 validateMember(docResultMembers, 'getWarningCount');
 validateMember(docResultMembers, 'getWarnings');
 validateMember(docResultMembers, 'fetchOne');
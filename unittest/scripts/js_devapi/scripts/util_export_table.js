@@ -0,0 +1,60 @@
+// Assumptions: ensure_schema_does_not_exist available
+// Assumes __uripwd is defined as <user>:<pwd>@<host>:<plugin_port>
+var mysqlx = require('mysqlx').mysqlx;
+
+var mySession = mysqlx.getNodeSession(__uripwd);
+
+ensure_schema_does_not_exist(mySession, 'js_shell_test');
+
+var schema = mySession.createSchema('js_shell_test');
+mySession.setCurrentSchema('js_shell_test');
+
+// Creates a test table with initial data
+var result = mySession.sql('create table table1 (id integer primary key, name varchar(50), price decimal(5,2), created datetime);').execute();
+var result = mySession.sql('create table table2 (name varchar(50));').execute();
+var table = schema.getTable('table1');
+
+var result = table.insert({ id: 1, name: 'jack', price: 1.5, created: '2016-01-02 03:04:05' }).execute();
+var result = table.insert({ id: 2, name: 'adam, "the first"', price: 20, created: '2016-02-03 04:05:06' }).execute();
+var result = table.insert({ id: 5, name: 'brian\tbrown', created: '2016-03-04 05:06:07' }).execute();
+var result = table.insert({ id: 9, name: '', price: 3.25 }).execute();
+var result = mySession.sql("insert into table2 values ('alma'), ('carol');").execute();
+
+//@ Util: exportTable csv
+var rows = util.exportTable(table, 'js_shell_test_export.csv', { threads: 2, chunkSize: 1 });
+print('Rows:', rows, '\n');
+print(os.load_text_file('js_shell_test_export.csv'));
+
+//@ Util: exportTable tsv
+var rows = util.exportTable(table, 'js_shell_test_export.tsv', { format: 'tsv' });
+print('Rows:', rows, '\n');
+print(os.load_text_file('js_shell_test_export.tsv'));
+
+//@ Util: exportTable ndjson
+var rows = util.exportTable(table, 'js_shell_test_export.json', { format: 'ndjson', threads: 3 });
+print('Rows:', rows, '\n');
+print(os.load_text_file('js_shell_test_export.json'));
+
+//@ Util: exportTable chunk files
+var rows = util.exportTable(table, 'js_shell_test_export.chunk', { threads: 2, chunkSize: 2, chunkFiles: true });
+print('Rows:', rows, '\n');
+print('First:', os.load_text_file('js_shell_test_export.chunk.0'));
+
+//@ Util: exportTable without primary key
+var rows = util.exportTable(schema.getTable('table2'), 'js_shell_test_export.csv', { threads: 4 });
+print('Rows:', rows, '\n');
+print(os.load_text_file('js_shell_test_export.csv'));
+
+//@# Util: exportTable errors
+util.exportTable();
+util.exportTable(table);
+util.exportTable(5, 'js_shell_test_export.csv');
+util.exportTable('table1', 'js_shell_test_export.csv');
+util.exportTable(table, 'js_shell_test_export.csv', { format: 'xml' });
+util.exportTable(table, 'js_shell_test_export.csv', { threads: 0 });
+util.exportTable(table, 'js_shell_test_export.csv', { chunkSize: 0 });
+util.exportTable(table, 'js_shell_test_export.csv', { compress: true });
+
+// Cleanup
+mySession.dropSchema('js_shell_test');
+mySession.close();
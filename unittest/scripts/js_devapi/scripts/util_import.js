@@ -0,0 +1,87 @@
+// Assumptions: ensure_schema_does_not_exist available
+// Assumes __uripwd is defined as <user>:<pwd>@<host>:<plugin_port>
+var mysqlx = require('mysqlx').mysqlx;
+
+var mySession = mysqlx.getNodeSession(__uripwd);
+
+ensure_schema_does_not_exist(mySession, 'js_shell_test');
+
+var schema = mySession.createSchema('js_shell_test');
+mySession.setCurrentSchema('js_shell_test');
+
+// Creates a source table and empty targets with the same structure
+var result = mySession.sql('create table source (id integer primary key, name varchar(50), price decimal(5,2), created datetime);').execute();
+var result = mySession.sql('create table target (id integer primary key, name varchar(50), price decimal(5,2), created datetime);').execute();
+var result = mySession.sql('create table pairs (name varchar(50), id integer);').execute();
+var source = schema.getTable('source');
+var target = schema.getTable('target');
+var collection = schema.createCollection('documents');
+
+var result = source.insert({ id: 1, name: 'jack', price: 1.5, created: '2016-01-02 03:04:05' }).execute();
+var result = source.insert({ id: 2, name: 'adam, "the first"', price: 20, created: '2016-02-03 04:05:06' }).execute();
+var result = source.insert({ id: 5, name: 'brian\tbrown', created: '2016-03-04 05:06:07' }).execute();
+var result = source.insert({ id: 9, name: '', price: 3.25 }).execute();
+var result = mySession.sql("insert into pairs values ('alma', 3), ('carol', 4), ('dave', 6);").execute();
+
+function print_rows(table) {
+  var rows = table.select().orderBy(['id']).execute().fetchAll();
+
+  for (var index = 0; index < rows.length; index++)
+    print(rows[index].id, '[' + rows[index].name + ']', rows[index].price == null, rows[index].created == null, '\n');
+}
+
+//@ Util: importTable csv
+var rows = util.exportTable(source, 'js_shell_test_import.csv', {});
+var rows = util.importTable('js_shell_test_import.csv', target, { threads: 2, batchSize: 1, showProgress: false });
+print('Rows:', rows, '\n');
+print_rows(target);
+
+//@ Util: importTable tsv
+var result = target.delete().execute();
+var rows = util.exportTable(source, 'js_shell_test_import.tsv', { format: 'tsv' });
+var rows = util.importTable('js_shell_test_import.tsv', 'js_shell_test.target', { format: 'tsv', showProgress: false });
+print('Rows:', rows, '\n');
+print_rows(target);
+
+//@ Util: importTable columns and skipRows
+var result = target.delete().execute();
+var rows = util.exportTable(schema.getTable('pairs'), 'js_shell_test_import.csv', {});
+var rows = util.importTable('js_shell_test_import.csv', target, { columns: ['name', 'id'], skipRows: 1, showProgress: false });
+print('Rows:', rows, '\n');
+print_rows(target);
+
+//@ Util: importTable bit and binary columns
+var result = mySession.sql('create table bits (id integer primary key, flags bit(10), data varbinary(10));').execute();
+var result = mySession.sql('create table bits_copy like bits;').execute();
+var result = mySession.sql("insert into bits values (1, b'1000000001', x'00ff0a2c22'), (2, b'0', ''), (3, null, null);").execute();
+var rows = util.exportTable(schema.getTable('bits'), 'js_shell_test_import.csv', {});
+var rows = util.importTable('js_shell_test_import.csv', 'js_shell_test.bits_copy', { showProgress: false });
+print('Rows:', rows, '\n');
+var result = mySession.sql('select count(*) from bits join bits_copy using (id) where bits.flags <=> bits_copy.flags and bits.data <=> bits_copy.data;').execute();
+print('Equal:', result.fetchOne()[0], '\n');
+
+//@ Util: importJson
+var rows = util.exportTable(source, 'js_shell_test_import.json', { format: 'ndjson' });
+var rows = util.importJson('js_shell_test_import.json', collection, { threads: 3, batchSize: 2, showProgress: false });
+print('Rows:', rows, '\n');
+var docs = collection.find().sort(['id']).execute().fetchAll();
+for (var index = 0; index < docs.length; index++)
+  print(docs[index].id, docs[index].name, docs[index]._id.length, '\n');
+
+//@# Util: import errors
+util.importJson();
+util.importJson('js_shell_test_import.json');
+util.importJson('js_shell_test_import.json', target);
+util.importJson('js_shell_test_import.json', 'documents');
+util.importJson('js_shell_test_import.json', collection, { format: 'csv' });
+util.importJson('js_shell_test_import.json', collection, { threads: 0 });
+util.importJson('js_shell_test_import.json', collection, { batchSize: 0 });
+util.importJson('js_shell_test_missing.json', collection, { showProgress: false });
+util.importJson('js_shell_test_import.csv', collection, { showProgress: false });
+util.importTable('js_shell_test_import.csv', collection);
+util.importTable('js_shell_test_import.csv', target, { format: 'ndjson' });
+util.importTable('js_shell_test_import.csv', target, { skipRows: -1 });
+
+// Cleanup
+mySession.dropSchema('js_shell_test');
+mySession.close();
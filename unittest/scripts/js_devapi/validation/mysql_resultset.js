@@ -1,8 +1,10 @@
 //@ Result member validation
 |executionTime: OK|
+|timing: OK|
 |warningCount: OK|
 |warnings: OK|
 |getExecutionTime: OK|
+|getTiming: OK|
 |getWarningCount: OK|
 |getWarnings: OK|
 |columnCount: OK|
@@ -7,6 +7,7 @@
 |getSchemas: OK|
 |getUri: OK|
 |setCurrentSchema: OK|
+|loadLocalInfile: OK|
 |defaultSchema: OK|
 |uri: OK|
 |currentSchema: OK|
@@ -49,6 +50,19 @@
 //@ ClassicSession: Transaction handling: commit
 |Inserted Documents: 3|
 
+//@ ClassicSession: loadLocalInfile from data and generator
+|Affected Rows: 2|
+|Affected Rows: 3|
+
+//@# ClassicSession: loadLocalInfile errors
+||Invalid number of arguments in ClassicSession.loadLocalInfile, expected 2 but got 1
+||The source must have one of file, data or generator
+||Invalid source 'other', allowed values are file, data and generator
+||The generator source must be a function
+||The data function must return strings, got Integer
+||Unable to open unexisting_file.txt
+||LOAD DATA LOCAL INFILE requires a data source, use ClassicSession.loadLocalInfile()
+
 //@ ClassicSession: current schema validations: nodefault, mysql
 |null|
 |<ClassicSchema:mysql>|
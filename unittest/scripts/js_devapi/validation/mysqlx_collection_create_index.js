@@ -47,5 +47,35 @@
 //@ Unique index: creation with required field
 ||MySQL Error (5116): Document contains a field value that is not unique but required to be
 
+// -----------------------------------
+// Multiple index creation
+// -----------------------------------
+//@# Error conditions on createIndexes
+||ArgumentError: Invalid number of arguments in Collection.createIndexes, expected 1 to 2 but got 0
+||ArgumentError: Collection.createIndexes: Argument #1 is expected to be an array
+||ArgumentError: Collection.createIndexes: Argument #1 is expected to be a non empty list of index definitions
+||ArgumentError: Collection.createIndexes: Index definitions require a name
+||ArgumentError: Collection.createIndexes: Index '_age' requires at least one field
+||ArgumentError: Collection.createIndexes: Invalid index field element 'other'
+||ArgumentError: Collection.createIndexes: Invalid index column type 'INTEGER; DROP'
+||ArgumentError: Collection.createIndexes: Index column type TEXT requires a length, as in TEXT(n)
+||ArgumentError: Collection.createIndexes: Duplicate index name '_age'
+||ArgumentError: Collection.createIndexes: Invalid option 'other'
+
+//@ Multiple indexes: creation in a single statement
+|Records: 1|
+
+//@ ERROR: multiple indexes, insertion of document missing required field
+||Document is missing a required field
+
+//@ ERROR: multiple indexes, none is created if one fails
+||MySQL Error (1061): Duplicate key name '_age'
+
+//@ Multiple indexes: dropping one keeps the others
+|Affected Rows: 1|
+
+//@ Multiple indexes: generated columns shared with createIndex
+|Integer columns: 2|
+
 //@ Cleanup
 ||
\ No newline at end of file
@@ -1,8 +1,10 @@
 //@ SqlResult member validation
 |executionTime: OK|
+|timing: OK|
 |warningCount: OK|
 |warnings: OK|
 |getExecutionTime: OK|
+|getTiming: OK|
 |getWarningCount: OK|
 |getWarnings: OK|
 |columnCount: OK|
@@ -22,9 +24,11 @@
 
 //@ Result member validation
 |executionTime: OK|
+|timing: OK|
 |warningCount: OK|
 |warnings: OK|
 |getExecutionTime: OK|
+|getTiming: OK|
 |getWarningCount: OK|
 |getWarnings: OK|
 |affectedItemCount: OK|
@@ -37,9 +41,11 @@
 
 //@ RowResult member validation
 |executionTime: OK|
+|timing: OK|
 |warningCount: OK|
 |warnings: OK|
 |getExecutionTime: OK|
+|getTiming: OK|
 |getWarningCount: OK|
 |getWarnings: OK|
 |columnCount: OK|
@@ -53,9 +59,11 @@
 
 //@ DocResult member validation
 |executionTime: OK|
+|timing: OK|
 |warningCount: OK|
 |warnings: OK|
 |getExecutionTime: OK|
+|getTiming: OK|
 |getWarningCount: OK|
 |getWarnings: OK|
 |fetchOne: OK|
@@ -0,0 +1,39 @@
+//@ Util: exportTable csv
+|Rows: 4|
+|1,jack,1.50,2016-01-02 03:04:05|
+|2,"adam, ""the first""",20.00,2016-02-03 04:05:06|
+|5,brian	brown,,2016-03-04 05:06:07|
+|9,"",3.25,|
+
+//@ Util: exportTable tsv
+|Rows: 4|
+|1	jack	1.50	2016-01-02 03:04:05|
+|2	adam, "the first"	20.00	2016-02-03 04:05:06|
+|5	brian\tbrown	\N	2016-03-04 05:06:07|
+|9		3.25	\N|
+
+//@ Util: exportTable ndjson
+|Rows: 4|
+|{"id":1,"name":"jack","price":1.50,"created":"2016-01-02 03:04:05"}|
+|{"id":2,"name":"adam, \"the first\"","price":20.00,"created":"2016-02-03 04:05:06"}|
+|{"id":5,"name":"brian\tbrown","price":null,"created":"2016-03-04 05:06:07"}|
+|{"id":9,"name":"","price":3.25,"created":null}|
+
+//@ Util: exportTable chunk files
+|Rows: 4|
+|First: 1,jack,1.50,2016-01-02 03:04:05|
+
+//@ Util: exportTable without primary key
+|Rows: 2|
+|alma|
+|carol|
+
+//@# Util: exportTable errors
+||Invalid number of arguments in Util.exportTable, expected 2 to 3 but got 0
+||Invalid number of arguments in Util.exportTable, expected 2 to 3 but got 1
+||Util.exportTable: Argument #1 is expected to be a string
+||Util.exportTable: Invalid table name 'table1', expected schema.table
+||Util.exportTable: Invalid format 'xml', allowed values are csv, tsv and ndjson
+||Util.exportTable: The threads option must be a positive integer
+||Util.exportTable: The chunkSize option must be a positive integer
+||Util.exportTable: Invalid option 'compress'
@@ -0,0 +1,43 @@
+//@ Util: importTable csv
+|Rows: 4|
+|1 [jack] false false|
+|2 [adam, "the first"] false false|
+|5 [brian	brown] true false|
+|9 [] false true|
+
+//@ Util: importTable tsv
+|Rows: 4|
+|1 [jack] false false|
+|2 [adam, "the first"] false false|
+|5 [brian	brown] true false|
+|9 [] false true|
+
+//@ Util: importTable columns and skipRows
+|Rows: 2|
+|4 [carol] true true|
+|6 [dave] true true|
+
+//@ Util: importTable bit and binary columns
+|Rows: 3|
+|Equal: 3|
+
+//@ Util: importJson
+|Rows: 4|
+|1 jack 32|
+|2 adam, "the first" 32|
+|5 brian	brown 32|
+|9  32|
+
+//@# Util: import errors
+||Invalid number of arguments in Util.importJson, expected 2 to 3 but got 0
+||Invalid number of arguments in Util.importJson, expected 2 to 3 but got 1
+||Util.importJson: Argument #2 is expected to be either a string or a Collection object
+||Util.importJson: Invalid collection name 'documents', expected schema.collection
+||Util.importJson: Invalid option 'format'
+||Util.importJson: The threads option must be a positive integer
+||Util.importJson: The batchSize option must be a positive integer
+||Unable to open js_shell_test_missing.json
+||Record #1: Error parsing JSON: Invalid value.
+||Util.importTable: Argument #2 is expected to be either a string or a Table object
+||Util.importTable: Invalid format 'ndjson', allowed values are csv and tsv
+||Util.importTable: The skipRows option can not be negative
@@ -99,6 +99,16 @@ namespace shcore {
       EXPECT_NE(-1, static_cast<int>(output_handler.std_err.find("Table 'unexisting.whatever' doesn't exist")));
       EXPECT_NE(-1, static_cast<int>(output_handler.std_out.find("second_result")));
 
+      // Batched statements stop on the failing one, not at the end of the batch
+      (*Shell_core_options::get())[SHCORE_BATCH_CONTINUE_ON_ERROR] = Value::False();
+      (*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE] = Value(1024);
+      process("sql/sql_err.sql");
+      (*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE] = Value(0);
+      EXPECT_EQ(1, _ret_val);
+      EXPECT_NE(-1, static_cast<int>(output_handler.std_out.find("first_result")));
+      EXPECT_NE(-1, static_cast<int>(output_handler.std_err.find("Table 'unexisting.whatever' doesn't exist")));
+      EXPECT_EQ(-1, static_cast<int>(output_handler.std_out.find("second_result")));
+
       // JS tests: outputs are not validated since in batch mode there's no autoprinting of resultsets
       // Error is also directed to the std::cerr directly
       _interactive_shell->process_line("\\js");
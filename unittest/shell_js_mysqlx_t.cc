@@ -144,4 +144,14 @@ namespace shcore
   {
     validate_interactive("mysqlx_column_metadata.js");
   }
+
+  TEST_F(Shell_js_mysqlx_tests, util_export_table)
+  {
+    validate_interactive("util_export_table.js");
+  }
+
+  TEST_F(Shell_js_mysqlx_tests, util_import)
+  {
+    validate_interactive("util_import.js");
+  }
 }
\ No newline at end of file
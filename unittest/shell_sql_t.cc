@@ -27,6 +27,7 @@
 
 #include "shellcore/shell_core.h"
 #include "shellcore/shell_sql.h"
+#include "shellcore/shell_core_options.h"
 #include "../modules/base_session.h"
 //#include "../modules/mod_session.h"
 //#include "../modules/mod_schema.h"
@@ -237,6 +238,53 @@ namespace shcore {
       EXPECT_EQ("mysql-sql> ", env.shell_sql->prompt());
     }
 
+    TEST_F(Shell_sql_test, batched_statements)
+    {
+      Interactive_input_state state;
+      std::string query = "drop schema if exists shell_sql_batch; create schema shell_sql_batch; "
+                          "create table shell_sql_batch.sample (id int primary key); "
+                          "insert into shell_sql_batch.sample values (1); insert into shell_sql_batch.sample values (1); "
+                          "insert into shell_sql_batch.sample values (2), (3);";
+
+      (*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE] = Value(1024);
+      handle_input(query, state);
+
+      // The duplicate key stops the query, the batch resumes after it
+      EXPECT_EQ(Input_ok, state);
+      EXPECT_EQ("drop schema if exists shell_sql_batch\ncreate schema shell_sql_batch\n"
+                "create table shell_sql_batch.sample (id int primary key)\n"
+                "insert into shell_sql_batch.sample values (1)\ninsert into shell_sql_batch.sample values (1)\n"
+                "insert into shell_sql_batch.sample values (2), (3)", env.shell_sql->get_handled_input());
+      EXPECT_NE(std::string::npos, env.output_handler.std_err.find("Duplicate entry '1'"));
+      EXPECT_EQ("2", _returned_value.as_object()->get_member("affectedRowCount").descr());
+
+      query = "drop schema shell_sql_batch;";
+      handle_input(query, state);
+      (*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE] = Value(0);
+    }
+
+    TEST_F(Shell_sql_test, batched_call_after_comment)
+    {
+      Interactive_input_state state;
+      std::string query = "drop schema if exists shell_sql_batch; create schema shell_sql_batch; "
+                          "create procedure shell_sql_batch.sample() select 1;";
+      handle_input(query, state);
+
+      // The CALL goes on its own query even behind a comment, so its status
+      // is not taken as the result of the statement after it
+      (*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE] = Value(1024);
+      query = "select 1; /* comment */ -- line comment\n call shell_sql_batch.sample(); select 2 as last_result;";
+      handle_input(query, state);
+      (*Shell_core_options::get())[SHCORE_SQL_BATCH_SIZE] = Value(0);
+
+      EXPECT_EQ(Input_ok, state);
+      EXPECT_TRUE(env.output_handler.std_err.empty());
+      EXPECT_TRUE(_returned_value.as_object()->call("hasData", shcore::Argument_list()).as_bool());
+
+      query = "drop schema shell_sql_batch;";
+      handle_input(query, state);
+    }
+
     TEST_F(Shell_sql_test, global_multi_line_statement_ignored)
     {
       Interactive_input_state state;
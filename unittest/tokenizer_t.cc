@@ -0,0 +1,115 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../mysqlxtest/common/tokenizer.h"
+
+namespace mysqlx
+{
+  namespace tests
+  {
+    static std::vector<Token> tokenize(Tokenizer &tokenizer)
+    {
+      tokenizer.get_tokens();
+      return std::vector<Token>(tokenizer.begin(), tokenizer.end());
+    }
+
+    TEST(Tokenizer_tests, reserved_words)
+    {
+      Token::TokenType type;
+
+      EXPECT_TRUE(Tokenizer::map.find_reserved_word("and", 3, type));
+      EXPECT_EQ(Token::AND, type);
+      EXPECT_TRUE(Tokenizer::map.find_reserved_word("MicroSecond", 11, type));
+      EXPECT_EQ(Token::MICROSECOND, type);
+      EXPECT_TRUE(Tokenizer::map.find_reserved_word("INT", 3, type));
+      EXPECT_EQ(Token::INTEGER, type);
+      EXPECT_TRUE(Tokenizer::map.find_reserved_word("integer", 7, type));
+      EXPECT_EQ(Token::INTEGER, type);
+      EXPECT_TRUE(Tokenizer::map.find_reserved_word("Json", 4, type));
+      EXPECT_EQ(Token::JSON, type);
+
+      // Only the given length is looked up
+      EXPECT_TRUE(Tokenizer::map.find_reserved_word("datetime", 4, type));
+      EXPECT_EQ(Token::DATE, type);
+
+      EXPECT_FALSE(Tokenizer::map.find_reserved_word("ints", 4, type));
+      EXPECT_FALSE(Tokenizer::map.find_reserved_word("_and", 4, type));
+      EXPECT_FALSE(Tokenizer::map.find_reserved_word("microseconds", 12, type));
+      EXPECT_FALSE(Tokenizer::map.find_reserved_word("a", 1, type));
+      EXPECT_FALSE(Tokenizer::map.find_reserved_word("", 0, type));
+    }
+
+    TEST(Tokenizer_tests, token_text)
+    {
+      Tokenizer tokenizer("`a``b` <> 'it''s' And x->'$.y' \"q\\\"\" 1.5e3");
+      std::vector<Token> tokens = tokenize(tokenizer);
+
+      ASSERT_EQ(13U, tokens.size());
+      EXPECT_EQ(Token::IDENT, tokens[0].get_type());
+      EXPECT_EQ("a`b", tokens[0].get_text());
+      EXPECT_EQ(Token::NE, tokens[1].get_type());
+      EXPECT_EQ("!=", tokens[1].get_text());
+      EXPECT_EQ(Token::LSTRING, tokens[2].get_type());
+      EXPECT_EQ("it's", tokens[2].get_text());
+      EXPECT_EQ(Token::AND, tokens[3].get_type());
+      EXPECT_EQ("And", tokens[3].get_text());
+      EXPECT_EQ(Token::IDENT, tokens[4].get_type());
+      EXPECT_EQ(Token::ARROW, tokens[5].get_type());
+      EXPECT_EQ("->", tokens[5].get_text());
+      EXPECT_EQ(Token::QUOTE, tokens[6].get_type());
+      EXPECT_EQ(Token::DOLLAR, tokens[7].get_type());
+      EXPECT_EQ(Token::DOT, tokens[8].get_type());
+      EXPECT_EQ("y", tokens[9].get_text());
+      EXPECT_EQ(Token::QUOTE, tokens[10].get_type());
+      EXPECT_EQ(Token::LSTRING, tokens[11].get_type());
+      EXPECT_EQ("q\"", tokens[11].get_text());
+      EXPECT_EQ(Token::LNUM, tokens[12].get_type());
+      EXPECT_EQ("1.5e3", tokens[12].get_text());
+    }
+
+    TEST(Tokenizer_tests, unescaped_strings_are_stable)
+    {
+      // Every escaped string goes to the unescape buffer, the texts of the
+      // previous tokens must stay valid while it grows
+      std::string input;
+      for (int i = 0; i < 200; ++i)
+        input += "'a''b' ";
+
+      Tokenizer tokenizer(input);
+      std::vector<Token> tokens = tokenize(tokenizer);
+
+      ASSERT_EQ(200U, tokens.size());
+      for (size_t i = 0; i < tokens.size(); ++i)
+        EXPECT_EQ("a'b", tokens[i].get_text());
+    }
+
+    TEST(Tokenizer_tests, long_expression)
+    {
+      const std::string expression("name = 'some name' and (age between 18 and 65 or $.address.city in ('x', \"y\")) "
+                                   "and cast(price as decimal) >= 12.5e2 and not `tag``s` like :param");
+      Tokenizer tokenizer(expression);
+
+      EXPECT_EQ(38U, tokenize(tokenizer).size());
+    }
+  }
+}
@@ -17,6 +17,8 @@
 #include <cstdlib>
 #include <fstream>
 #include <string>
+#include <utility>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -133,6 +135,50 @@ namespace shcore
       return Value::Null();
     }
 
+    TEST(ValueTests, MoveSemantics)
+    {
+      shcore::Value s("a string long enough to be kept out of the inline buffer");
+      shcore::Value moved(std::move(s));
+
+      EXPECT_EQ(shcore::String, moved.type);
+      EXPECT_EQ("a string long enough to be kept out of the inline buffer", moved.as_string());
+      EXPECT_EQ(shcore::Undefined, s.type);
+
+      shcore::Value m(shcore::Value::new_map());
+      (*m.as_map())["key"] = shcore::Value(1);
+
+      moved = std::move(m);
+      EXPECT_EQ(shcore::Map, moved.type);
+      EXPECT_EQ(1, (*moved.as_map())["key"].as_int());
+      EXPECT_EQ(shcore::Undefined, m.type);
+
+      // Self assignment keeps the content
+      shcore::Value &self = moved;
+      moved = self;
+      EXPECT_EQ(shcore::Map, moved.type);
+      moved = std::move(self);
+      EXPECT_EQ(shcore::Map, moved.type);
+
+      // Assigning from a value owned by the target itself
+      shcore::Value a(shcore::Value::new_array());
+      a.as_array()->push_back(shcore::Value("inner"));
+      a = (*a.as_array())[0];
+      EXPECT_EQ(shcore::String, a.type);
+      EXPECT_EQ("inner", a.as_string());
+
+      shcore::Value b(shcore::Value::new_array());
+      b.as_array()->push_back(shcore::Value(42));
+      b = std::move((*b.as_array())[0]);
+      EXPECT_EQ(shcore::Integer, b.type);
+      EXPECT_EQ(42, b.as_int());
+
+      shcore::Argument_list args;
+      shcore::Value arg("argument");
+      args.push_back(std::move(arg));
+      EXPECT_EQ("argument", args.string_at(0));
+      EXPECT_EQ(shcore::Undefined, arg.type);
+    }
+
     TEST(Functions, function_wrappers)
     {
       boost::shared_ptr<Function_base> f(Cpp_function::create("test", do_test,
@@ -363,5 +409,75 @@ namespace shcore
       Value::Array_type_ref array2 = v2.as_array();
       EXPECT_EQ(array2->size(), 0);
     }
+
+    TEST(Parsing, Json)
+    {
+      const std::string data = "{\"_id\": \"0001\", \"name\": \"es\\\"ca\\u00f1o\", \"age\": 31, \"big\": 18446744073709551615, "
+                               "\"ratio\": -1.5e3, \"tags\": [true, false, null, {\"nested\": []}]}";
+      shcore::Value v = shcore::Value::parse_json(data.data(), data.size());
+
+      EXPECT_EQ(shcore::Map, v.type);
+      Value::Map_type_ref map = v.as_map();
+
+      EXPECT_EQ("0001", (*map)["_id"].as_string());
+      EXPECT_EQ("es\"ca\xc3\xb1o", (*map)["name"].as_string());
+      EXPECT_EQ(shcore::Integer, (*map)["age"].type);
+      EXPECT_EQ(31, (*map)["age"].as_int());
+      EXPECT_EQ(shcore::UInteger, (*map)["big"].type);
+      EXPECT_EQ(18446744073709551615ULL, (*map)["big"].as_uint());
+      EXPECT_EQ(shcore::Float, (*map)["ratio"].type);
+      EXPECT_EQ(-1500.0, (*map)["ratio"].as_double());
+
+      Value::Array_type_ref tags = (*map)["tags"].as_array();
+      EXPECT_EQ(4U, tags->size());
+      EXPECT_TRUE((*tags)[0].as_bool());
+      EXPECT_FALSE((*tags)[1].as_bool());
+      EXPECT_EQ(shcore::Null, (*tags)[2].type);
+      EXPECT_EQ(0U, (*tags)[3].as_map()->get_array("nested")->size());
+
+      // In situ parsing gives the same result
+      std::vector<char> buffer(data.begin(), data.end());
+      buffer.push_back('\0');
+      EXPECT_EQ(v, shcore::Value::parse_json_in_situ(&buffer[0]));
+
+      // Only the given length is parsed
+      EXPECT_EQ(shcore::Value(1), shcore::Value::parse_json("123", 1));
+
+      EXPECT_THROW(shcore::Value::parse_json("{\"a\": }", 7), shcore::Exception);
+      EXPECT_THROW(shcore::Value::parse_json("[1] 2", 5), shcore::Exception);
+    }
+
+    static std::string make_document(size_t size)
+    {
+      std::string doc = "{\"_id\": \"00000000000000000000000000000001\", \"items\": [";
+
+      for (int i = 0; doc.size() < size; ++i)
+      {
+        if (i)
+          doc.append(", ");
+        doc.append("{\"id\": " + boost::lexical_cast<std::string>(i) +
+                   ", \"name\": \"item name " + boost::lexical_cast<std::string>(i) +
+                   "\", \"price\": 12.5, \"available\": true}");
+      }
+
+      doc.append("]}");
+      return doc;
+    }
+
+    // The JSON parsers give the same value as the generic one
+    TEST(Parsing, JsonDocuments)
+    {
+      const size_t sizes[] = { 1024, 65536 };
+
+      for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+      {
+        const std::string doc = make_document(sizes[s]);
+        std::vector<char> buffer(doc.c_str(), doc.c_str() + doc.size() + 1);
+        const shcore::Value expected = shcore::Value::parse(doc);
+
+        EXPECT_EQ(expected, shcore::Value::parse_json(doc.data(), doc.size()));
+        EXPECT_EQ(expected, shcore::Value::parse_json_in_situ(&buffer[0]));
+      }
+    }
   }
 }
\ No newline at end of file
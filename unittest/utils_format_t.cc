@@ -0,0 +1,160 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#include <boost/format.hpp>
+
+#include "gtest/gtest.h"
+#include "../utils/utils_format.h"
+#include "shellcore/types.h"
+
+namespace shcore
+{
+  namespace tests
+  {
+    static std::string format(double value)
+    {
+      std::string s;
+      return append_double(s, value);
+    }
+
+    TEST(Utils_format, integers)
+    {
+      std::string s;
+
+      EXPECT_EQ("0", append_int(s, 0));
+      s.clear();
+      EXPECT_EQ("-9223372036854775808", append_int(s, std::numeric_limits<int64_t>::min()));
+      s.clear();
+      EXPECT_EQ("9223372036854775807", append_int(s, std::numeric_limits<int64_t>::max()));
+      s.clear();
+      EXPECT_EQ("18446744073709551615", append_uint(s, std::numeric_limits<uint64_t>::max()));
+
+      // Appends to the existing content
+      EXPECT_EQ("1844674407370955161542", append_uint(s, 42));
+    }
+
+    TEST(Utils_format, doubles)
+    {
+      // Same as %g, the way the shell always displayed them
+      EXPECT_EQ("0", format(0.0));
+      EXPECT_EQ("-0", format(-0.0));
+      EXPECT_EQ("1", format(1.0));
+      EXPECT_EQ("-2.5", format(-2.5));
+      EXPECT_EQ("0.1", format(0.1));
+      EXPECT_EQ("0.3", format(0.1 + 0.2));
+      EXPECT_EQ("0.333333", format(1.0 / 3));
+      EXPECT_EQ("123.45", format(123.45));
+      EXPECT_EQ("1.23457e+06", format(1234567.0));
+      EXPECT_EQ("0.0001", format(0.0001));
+      EXPECT_EQ("1e-05", format(0.00001));
+      EXPECT_EQ("1e+16", format(1e16));
+      EXPECT_EQ("inf", format(std::numeric_limits<double>::infinity()));
+      EXPECT_EQ("-inf", format(-std::numeric_limits<double>::infinity()));
+      EXPECT_EQ("nan", format(std::numeric_limits<double>::quiet_NaN()));
+
+      // FLOAT columns are stored in a Value as double
+      EXPECT_EQ("1.1", format(1.1f));
+      EXPECT_EQ("3.14", format(3.14f));
+    }
+
+    TEST(Utils_format, doubles_as_boost_format)
+    {
+      srand(1);
+
+      for (int i = 0; i < 10000; ++i)
+      {
+        const double value = (rand() - RAND_MAX / 2) * 1.0 / (rand() + 1) * std::pow(10.0, rand() % 40 - 20);
+
+        EXPECT_EQ((boost::format("%g") % value).str(), format(value));
+      }
+    }
+
+    TEST(Utils_format, descr_and_repr)
+    {
+      EXPECT_EQ("1.1", Value(1.1f).descr());
+      EXPECT_EQ("3.14", Value(3.14f).repr());
+      EXPECT_EQ("0.3", Value(0.1 + 0.2).descr());
+      EXPECT_EQ("[1,0.5]", Value::parse("[1, 0.5]").descr());
+    }
+
+    TEST(Utils_format, doubles_exact)
+    {
+      std::string s;
+
+      EXPECT_EQ(0.1 + 0.2, strtod(append_double_exact(s, 0.1 + 0.2).c_str(), NULL));
+      s.clear();
+      EXPECT_EQ("0.3333333333333333", append_double_exact(s, 1.0 / 3));
+      s.clear();
+      EXPECT_EQ("1234567", append_double_exact(s, 1234567.0));
+      s.clear();
+      EXPECT_EQ("1.5e-07", append_double_exact(s, 1.5e-7));
+      s.clear();
+      EXPECT_EQ("10000000000000000", append_double_exact(s, 1e16));
+      s.clear();
+      EXPECT_EQ("1e+17", append_double_exact(s, 1e17));
+      s.clear();
+      EXPECT_EQ("1.7976931348623157e+308", append_double_exact(s, std::numeric_limits<double>::max()));
+      s.clear();
+      EXPECT_EQ("5e-324", append_double_exact(s, std::numeric_limits<double>::denorm_min()));
+    }
+
+    TEST(Utils_format, doubles_exact_round_trip)
+    {
+      srand(1);
+
+      for (int i = 0; i < 100000; ++i)
+      {
+        const double value = (rand() - RAND_MAX / 2) * 1.0 / (rand() + 1) * std::pow(10.0, rand() % 40 - 20);
+        std::string text;
+
+        append_double_exact(text, value);
+        EXPECT_EQ(value, strtod(text.c_str(), NULL)) << text;
+      }
+    }
+
+    TEST(Utils_format, floats_exact)
+    {
+      std::string s;
+
+      EXPECT_EQ("1.1", append_float_exact(s, 1.1f));
+      s.clear();
+      EXPECT_EQ("3.14", append_float_exact(s, 3.14f));
+      s.clear();
+      EXPECT_EQ("16777216", append_float_exact(s, 16777216.0f));
+      s.clear();
+      EXPECT_EQ("3.4028235e+38", append_float_exact(s, std::numeric_limits<float>::max()));
+
+      srand(1);
+
+      for (int i = 0; i < 100000; ++i)
+      {
+        const float value = static_cast<float>((rand() - RAND_MAX / 2) * 1.0 / (rand() + 1) * std::pow(10.0, rand() % 20 - 10));
+
+        s.clear();
+        append_float_exact(s, value);
+        EXPECT_EQ(value, strtof(s.c_str(), NULL)) << s;
+      }
+    }
+  }
+}
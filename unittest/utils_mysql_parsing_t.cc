@@ -20,12 +20,248 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/pointer_cast.hpp>
 #include <stack>
+#include <boost/algorithm/string/trim.hpp>
 
 #include "gtest/gtest.h"
 #include "../utils/utils_mysql_parsing.h"
 
 namespace shcore {
   namespace sql_shell_tests {
+    namespace legacy {
+      using shcore::mysql::splitter::skip_leading_whitespace;
+      using shcore::mysql::splitter::is_line_break;
+
+      // Byte by byte implementation of the splitter, the optimized one must give the same results
+      size_t determineStatementRanges(const char *sql, size_t length, std::string &delimiter,
+                                                 std::vector<std::pair<size_t, size_t> > &ranges,
+                                                 const std::string &line_break, std::stack<std::string> &input_context_stack)
+      {
+        int full_statement_count = 0;
+        const unsigned char *delimiter_head = (unsigned char*)delimiter.c_str();
+
+        const unsigned char keyword[] = "delimiter";
+
+        const unsigned char *head = (unsigned char *)sql;
+        const unsigned char *tail = head;
+        const unsigned char *end = head + length;
+        const unsigned char *new_line = (unsigned char*)line_break.c_str();
+        bool have_content = false; // Set when anything else but comments were found for the current statement.
+
+        ranges.clear();
+
+        while (tail < end)
+        {
+          switch (*tail)
+          {
+            case '*': // Comes from a multiline comment and comment is done
+              if (*(tail + 1) == '/' && (!input_context_stack.empty() && input_context_stack.top() == "/*"))
+              {
+                if (!input_context_stack.empty())
+                  input_context_stack.pop();
+
+                tail += 2;
+                head = tail; // Skip over the comment.
+              }
+              break;
+            case '/': // Possible multi line comment or hidden (conditional) command.
+              if (*(tail + 1) == '*')
+              {
+                tail += 2;
+                bool is_hidden_command = (*tail == '!');
+                while (true)
+                {
+                  while (tail < end && *tail != '*')
+                    tail++;
+                  if (tail == end) // Unfinished comment.
+                  {
+                    input_context_stack.push("/*");
+                    break;
+                  }
+                  else
+                  {
+                    if (*++tail == '/')
+                    {
+                      tail++; // Skip the slash too.
+                      break;
+                    }
+                  }
+                }
+
+                if (!is_hidden_command && !have_content)
+                  head = tail; // Skip over the comment.
+
+                break;
+              }
+
+            case '-': // Possible single line comment.
+            {
+                        const unsigned char *end_char = tail + 2;
+                        if (*(tail + 1) == '-' && (*end_char == ' ' || *end_char == '\t' || is_line_break(end_char, new_line) || length == 2))
+                        {
+                          // Skip everything until the end of the line.
+                          tail += 2;
+                          while (tail < end && !is_line_break(tail, new_line))
+                            tail++;
+                          if (!have_content)
+                            head = tail;
+                        }
+                        break;
+            }
+
+            case '#': // MySQL single line comment.
+              while (tail < end && !is_line_break(tail, new_line))
+                tail++;
+              if (!have_content)
+                head = tail;
+              break;
+
+            case '"':
+            case '\'':
+            case '`':
+            {
+                      have_content = true;
+                      char quote = *tail++;
+
+                      if (input_context_stack.empty() || input_context_stack.top() == "-")
+                      {
+                        // Quoted string/id. Skip this in a local loop if is opening quote.
+                        while (tail < end && *tail != quote)
+                        {
+                          // Skip any escaped character too.
+                          if (*tail == '\\')
+                            tail++;
+                          tail++;
+                        }
+                        if (*tail == quote)
+                          tail++; // Skip trailing quote char to if one was there.
+                        else
+                        {
+                          std::string q;
+                          q.assign(&quote, 1);
+                          input_context_stack.push(q); // Sets multiline opening quote to continue processing
+                        }
+                      }
+                      else // Closing quote, clears the multiline flag
+                        input_context_stack.pop();
+
+                      break;
+            }
+
+            case 'd':
+            case 'D':
+            {
+                      have_content = true;
+
+                      // Possible start of the keyword DELIMITER. Must be at the start of the text or a character,
+                      // which is not part of a regular MySQL identifier (0-9, A-Z, a-z, _, $, \u0080-\uffff).
+                      unsigned char previous = tail > (unsigned char *)sql ? *(tail - 1) : 0;
+                      bool is_identifier_char = previous >= 0x80
+                      || (previous >= '0' && previous <= '9')
+                      || ((previous | 0x20) >= 'a' && (previous | 0x20) <= 'z')
+                      || previous == '$'
+                      || previous == '_';
+                      if (tail == (unsigned char *)sql || !is_identifier_char)
+                      {
+                        const unsigned char *run = tail + 1;
+                        const unsigned char *kw = keyword + 1;
+                        int count = 9;
+                        while (count-- > 1 && (*run++ | 0x20) == *kw++)
+                          ;
+                        if (count == 0 && *run == ' ')
+                        {
+                          // Delimiter keyword found. Get the new delimiter (everything until the end of the line).
+                          tail = run++;
+                          while (run < end && !is_line_break(run, new_line))
+                            run++;
+
+                          delimiter = std::string((char *)tail, run - tail);
+                          boost::trim(delimiter);
+
+                          delimiter_head = (unsigned char*)delimiter.c_str();
+
+                          // Skip over the delimiter statement and any following line breaks.
+                          while (is_line_break(run, new_line))
+                            run++;
+                          tail = run;
+                          head = tail;
+                        }
+                      }
+                      break;
+            }
+          }
+
+          if (*tail == *delimiter_head)
+          {
+            // Found possible start of the delimiter. Check if it really is.
+            size_t count = delimiter.size();
+            if (count == 1)
+            {
+              // Most common case. Trim the statement and check if it is not empty before adding the range.
+              head = skip_leading_whitespace(head, tail);
+              if (head < tail || (!input_context_stack.empty() && input_context_stack.top() == "-"))
+              {
+                full_statement_count++;
+
+                if (!input_context_stack.empty())
+                  input_context_stack.pop();
+
+                if (head < tail)
+                  ranges.push_back(std::make_pair<size_t, size_t>(head - (unsigned char *)sql, tail - head));
+              }
+              head = ++tail;
+              have_content = false;
+            }
+            else
+            {
+              const unsigned char *run = tail + 1;
+              const unsigned char *del = delimiter_head + 1;
+              while (count-- > 1 && (*run++ == *del++))
+                ;
+
+              if (count == 0)
+              {
+                // Multi char delimiter is complete. Tail still points to the start of the delimiter.
+                // Run points to the first character after the delimiter.
+                head = skip_leading_whitespace(head, tail);
+                if (head < tail || (!input_context_stack.empty() && input_context_stack.top() == "-"))
+                {
+                  full_statement_count++;
+
+                  if (!input_context_stack.empty())
+                    input_context_stack.pop();
+
+                  if (head < tail)
+                    ranges.push_back(std::make_pair<size_t, size_t>(head - (unsigned char *)sql, tail - head));
+                }
+
+                tail = run;
+                head = run;
+                have_content = false;
+              }
+            }
+          }
+
+          // Multiline comments are ignored, everything else is not
+          if (*tail > ' ' && (input_context_stack.empty() || input_context_stack.top() != "/*"))
+            have_content = true;
+          tail++;
+        }
+
+        // Add remaining text to the range list but ignores it when it is a multiline comment
+        head = skip_leading_whitespace(head, tail);
+        if (head < tail && (input_context_stack.empty() || input_context_stack.top() != "/*"))
+        {
+          ranges.push_back(std::make_pair<size_t, size_t>(head - (unsigned char *)sql, tail - head));
+
+          // If not a multiline string then sets the flag to multiline statement (not terminated)
+          if (input_context_stack.empty())
+            input_context_stack.push("-");
+        }
+
+        return full_statement_count;
+      }
+    }
+
     class TestMySQLSplitter : public ::testing::Test
     {
     protected:
@@ -278,5 +514,103 @@ namespace shcore {
       EXPECT_EQ(1, static_cast<int>(ranges.size()));
       EXPECT_EQ(statement, sql.substr(ranges[0].first, ranges[0].second));
     }
+
+    // Random SQL made of the tokens the splitter cares about
+    static std::string random_sql(size_t tokens)
+    {
+      static const char *pieces[] = {
+        "'", "\"", "`", "\\", "/*", "*/", "/*!", "*", "/", "-- ", "--", "-", "#", "\n", "\t", " ", ";", "$$",
+        "delimiter $$\n", "DELIMITER ;\n", "delimiter ", "d", "D", "a", "x1", "_d", "select * from t", "\xc3\xa9",
+        "insert into t values (1, 'a;b');", "0123456789abcdefghij"
+      };
+      const size_t count = sizeof(pieces) / sizeof(pieces[0]);
+
+      std::string sql;
+      for (size_t i = 0; i < tokens; i++)
+        sql.append(pieces[rand() % count]);
+
+      return sql;
+    }
+
+    static std::string describe(std::stack<std::string> stack)
+    {
+      std::string s;
+      while (!stack.empty())
+      {
+        s.append("[" + stack.top() + "]");
+        stack.pop();
+      }
+      return s;
+    }
+
+    TEST(TestMySQLSplitterDiff, fuzz)
+    {
+      srand(2016);
+
+      for (int i = 0; i < 20000; i++)
+      {
+        std::string delimiter = ";";
+        std::string legacy_delimiter = ";";
+        std::stack<std::string> context;
+        std::stack<std::string> legacy_context;
+
+        // The input is sent in chunks like the shell does line by line
+        const int chunks = 1 + rand() % 4;
+        for (int chunk = 0; chunk < chunks; chunk++)
+        {
+          const std::string sql = random_sql(rand() % 40);
+
+          // Both implementations may look a couple of bytes past the end
+          std::vector<char> buffer(sql.begin(), sql.end());
+          buffer.resize(sql.size() + 4, '\0');
+
+          std::vector<std::pair<size_t, size_t> > ranges;
+          std::vector<std::pair<size_t, size_t> > legacy_ranges;
+
+          size_t count = shcore::mysql::splitter::determineStatementRanges(&buffer[0], sql.size(), delimiter, ranges, "\n", context);
+          size_t legacy_count = legacy::determineStatementRanges(&buffer[0], sql.size(), legacy_delimiter, legacy_ranges, "\n", legacy_context);
+
+          ASSERT_EQ(legacy_count, count) << sql;
+          ASSERT_EQ(legacy_ranges, ranges) << sql;
+          ASSERT_EQ(legacy_delimiter, delimiter) << sql;
+          ASSERT_EQ(describe(legacy_context), describe(context)) << sql;
+        }
+      }
+    }
+
+    // Long statements made mostly of quoted strings, as in a data dump.
+    // Splitting speed is measured by the Splitter benchmarks.
+    TEST(TestMySQLSplitterDiff, generated_dump)
+    {
+      const size_t size = 256 * 1024;
+
+      std::string dump;
+      dump.reserve(size + 1024);
+      dump.append("-- MySQL dump\n/*!40101 SET NAMES utf8 */;\n"
+                  "CREATE TABLE `customers` (\n  `id` int NOT NULL,\n  `name` varchar(64) DEFAULT NULL,\n  PRIMARY KEY (`id`)\n);\n");
+      for (int row = 0; dump.size() < size; row++)
+      {
+        dump.append("INSERT INTO `customers` VALUES (");
+        for (int i = 0; i < 20; i++)
+        {
+          char value[128];
+          snprintf(value, sizeof(value), "%s(%d,'Customer name %d, \\'quoted\\'','2016-01-01 10:00:00',%d.5)",
+                   i ? "," : "", row * 20 + i, row * 20 + i, i);
+          dump.append(value);
+        }
+        dump.append(");\n");
+      }
+
+      std::vector<std::pair<size_t, size_t> > ranges;
+      std::vector<std::pair<size_t, size_t> > legacy_ranges;
+      std::string delimiter = ";";
+      std::stack<std::string> context;
+
+      size_t count = shcore::mysql::splitter::determineStatementRanges(dump.c_str(), dump.size(), delimiter, ranges, "\n", context);
+      size_t legacy_count = legacy::determineStatementRanges(dump.c_str(), dump.size(), delimiter, legacy_ranges, "\n", context);
+
+      EXPECT_EQ(legacy_count, count);
+      EXPECT_TRUE(legacy_ranges == ranges);
+    }
   }
 }
@@ -24,6 +24,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/pointer_cast.hpp>
 #include <stack>
+#include <chrono>
+#include <thread>
 
 #include "gtest/gtest.h"
 #include "../utils/utils_time.h"
@@ -135,5 +137,31 @@ namespace shcore
       formatted = MySQL_timer::format_legacy(raw_time, true);
       EXPECT_EQ("2 days, 3 hours, 5 minutes, 1.50 sec", formatted);
     }
+
+    TEST(MySQL_timer_tests, duration_usec)
+    {
+      MySQL_timer timer;
+
+      timer.start();
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      timer.end();
+
+      // Raw duration is still given in clocks
+      EXPECT_LE(20000U, timer.duration_usec());
+      EXPECT_EQ(timer.duration_usec() * CLOCKS_PER_SEC / 1000000, timer.raw_duration());
+    }
+
+    TEST(MySQL_timer_tests, usec_to_clocks)
+    {
+      const uint64_t clocks_per_second = CLOCKS_PER_SEC;
+
+      EXPECT_EQ(0U, MySQL_timer::usec_to_clocks(0));
+      EXPECT_EQ(clocks_per_second * 3 / 2, MySQL_timer::usec_to_clocks(1500000));
+
+      // A monotonic clock a year after boot
+      const uint64_t seconds = 365ULL * 24 * 3600;
+      EXPECT_EQ((unsigned long)(seconds * clocks_per_second + clocks_per_second / 4),
+                MySQL_timer::usec_to_clocks(seconds * 1000000 + 250000));
+    }
   }
 }
\ No newline at end of file
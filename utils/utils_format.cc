@@ -0,0 +1,152 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#include "utils_format.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rapidjson/rapidjson.h>
+#include <rapidjson/internal/dtoa.h>
+#include <rapidjson/internal/itoa.h>
+
+namespace shcore
+{
+  size_t format_int(char *buffer, int64_t value)
+  {
+    return rapidjson::internal::i64toa(value, buffer) - buffer;
+  }
+
+  size_t format_uint(char *buffer, uint64_t value)
+  {
+    return rapidjson::internal::u64toa(value, buffer) - buffer;
+  }
+
+  size_t format_double(char *buffer, double value)
+  {
+    if (std::isnan(value))
+    {
+      memcpy(buffer, "nan", 3);
+      return 3;
+    }
+
+    return snprintf(buffer, MAX_NUMBER_LENGTH, "%g", value);
+  }
+
+  size_t format_float_exact(char *buffer, float value)
+  {
+    if (std::isnan(value) || std::isinf(value))
+      return format_double(buffer, value);
+
+    // FLT_DIG (6) digits are not always enough, 9 always are
+    int length = 0;
+
+    for (int precision = 6; precision <= 9; ++precision)
+    {
+      length = snprintf(buffer, MAX_NUMBER_LENGTH, "%.*g", precision, value);
+
+      if (strtof(buffer, NULL) == value)
+        break;
+    }
+
+    return length;
+  }
+
+  size_t format_double_exact(char *buffer, double value)
+  {
+    char *p = buffer;
+
+    if (std::isnan(value))
+    {
+      memcpy(p, "nan", 3);
+      return 3;
+    }
+
+    if (value < 0 || (value == 0 && std::signbit(value)))
+    {
+      *p++ = '-';
+      value = -value;
+    }
+
+    if (std::isinf(value))
+    {
+      memcpy(p, "inf", 3);
+      return p + 3 - buffer;
+    }
+
+    if (value == 0)
+    {
+      *p++ = '0';
+      return p - buffer;
+    }
+
+    // Grisu2 gives the shortest digits, value = digits * 10^k
+    int length, k;
+    rapidjson::internal::Grisu2(value, p, &length, &k);
+
+    // Exponent of the first digit
+    const int exponent = length + k - 1;
+
+    if (exponent < -4 || exponent > 16)
+    {
+      // d.ddde+XX
+      if (length > 1)
+      {
+        memmove(p + 2, p + 1, length - 1);
+        p[1] = '.';
+        p += length + 1;
+      }
+      else
+        ++p;
+
+      *p++ = 'e';
+      *p++ = exponent < 0 ? '-' : '+';
+
+      const int abs_exponent = exponent < 0 ? -exponent : exponent;
+      if (abs_exponent < 10)
+        *p++ = '0';
+      p = rapidjson::internal::u32toa(abs_exponent, p);
+    }
+    else if (exponent < 0)
+    {
+      // 0.000ddd
+      const int offset = 1 - exponent;
+      memmove(p + offset, p, length);
+      p[0] = '0';
+      p[1] = '.';
+      memset(p + 2, '0', offset - 2);
+      p += offset + length;
+    }
+    else if (length <= exponent + 1)
+    {
+      // ddd000
+      memset(p + length, '0', exponent + 1 - length);
+      p += exponent + 1;
+    }
+    else
+    {
+      // ddd.ddd
+      memmove(p + exponent + 2, p + exponent + 1, length - exponent - 1);
+      p[exponent + 1] = '.';
+      p += length + 1;
+    }
+
+    return p - buffer;
+  }
+}
@@ -0,0 +1,80 @@
+/*
+* Copyright (c) 2016, Oracle and/or its affiliates. All rights reserved.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation; version 2 of the
+* License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+* 02110-1301  USA
+*/
+
+#ifndef __mysh__utils_format__
+#define __mysh__utils_format__
+
+#include "shellcore/common.h"
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+
+namespace shcore
+{
+  // Size of the buffer needed by the format functions
+  enum { MAX_NUMBER_LENGTH = 32 };
+
+  // Write the number into buffer and return the number of characters written,
+  // the result is not null terminated
+  size_t SHCORE_PUBLIC format_int(char *buffer, int64_t value);
+  size_t SHCORE_PUBLIC format_uint(char *buffer, uint64_t value);
+
+  // Same output as %g, 6 significant digits, used to display values
+  size_t SHCORE_PUBLIC format_double(char *buffer, double value);
+
+  // Shortest representation that reads back as the same double, exponential
+  // notation is used like in %g when the exponent is below -4 or above 16
+  size_t SHCORE_PUBLIC format_double_exact(char *buffer, double value);
+
+  // Shortest %g representation that reads back as the same float, a float
+  // widened to double would otherwise show digits it never had
+  size_t SHCORE_PUBLIC format_float_exact(char *buffer, float value);
+
+  inline std::string &append_int(std::string &s_out, int64_t value)
+  {
+    char buffer[MAX_NUMBER_LENGTH];
+    return s_out.append(buffer, format_int(buffer, value));
+  }
+
+  inline std::string &append_uint(std::string &s_out, uint64_t value)
+  {
+    char buffer[MAX_NUMBER_LENGTH];
+    return s_out.append(buffer, format_uint(buffer, value));
+  }
+
+  inline std::string &append_double(std::string &s_out, double value)
+  {
+    char buffer[MAX_NUMBER_LENGTH];
+    return s_out.append(buffer, format_double(buffer, value));
+  }
+
+  inline std::string &append_double_exact(std::string &s_out, double value)
+  {
+    char buffer[MAX_NUMBER_LENGTH];
+    return s_out.append(buffer, format_double_exact(buffer, value));
+  }
+
+  inline std::string &append_float_exact(std::string &s_out, float value)
+  {
+    char buffer[MAX_NUMBER_LENGTH];
+    return s_out.append(buffer, format_float_exact(buffer, value));
+  }
+}
+
+#endif /* defined(__mysh__utils_format__) */
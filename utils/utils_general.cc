@@ -147,6 +147,7 @@ namespace shcore
   {
     // 
     // format is [dbuser[:dbpassword]@]host[:(port|socket)][/db] like what cmdline utilities use
+    // socket paths that contain '/' are given in parentheses, host:(/path/to/socket)[/db]
     // with SSL [user[:pass]]@host[:port][/db]?ssl_ca=path_to_ca&ssl_cert=path_to_cert&ssl_key=path_to_key
     // with app name format is $app_name
     pwd_found = 0;
@@ -161,7 +162,10 @@ namespace shcore
     }
 
     std::string s = remaining;
-    p = remaining.find('/');
+    std::string::size_type socket_end = remaining.find(":(");
+    if (socket_end != std::string::npos)
+      socket_end = remaining.find(')', socket_end);
+    p = remaining.find('/', socket_end == std::string::npos ? 0 : socket_end);
     p_query = remaining.find('?');
     if (p != std::string::npos)
     {
@@ -232,6 +236,9 @@ namespace shcore
         if (server_part.find(':') != std::string::npos)
           throw Exception::argument_error((boost::format("the socket portion '%s' cannot have ':'") % server_part).str());
         sock = server_part;
+
+        if (sock.size() > 1 && sock[0] == '(' && sock[sock.size() - 1] == ')')
+          sock = sock.substr(1, sock.size() - 2);
       }
     }
     else
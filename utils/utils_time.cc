@@ -19,6 +19,7 @@
 
 #include "utils_time.h"
 #include <boost/format.hpp>
+#include <chrono>
 #include <cmath>
 
 #if defined(WIN32)
@@ -31,24 +32,41 @@
 #endif
 #endif
 
+unsigned long MySQL_timer::usec_to_clocks(uint64_t usec)
+{
+  uint64_t clocks_per_second = CLOCKS_PER_SEC;
+
+  // Whole seconds are converted apart, usec * CLOCKS_PER_SEC would overflow
+  // once the monotonic clock goes past some 213 days
+  return (unsigned long)((usec / 1000000) * clocks_per_second +
+                         (usec % 1000000) * clocks_per_second / 1000000);
+}
+
+uint64_t MySQL_timer::get_time_usec()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 unsigned long MySQL_timer::get_time()
 {
-#if defined(WIN32)
-  return clock();
-#else
-  struct tms tms_tmp;
-  return times(&tms_tmp);
-#endif
+  return usec_to_clocks(get_time_usec());
 }
 
 unsigned long MySQL_timer::start()
 {
-  return (_start = get_time());
+  _start = get_time_usec();
+  return usec_to_clocks(_start);
 }
 
 unsigned long MySQL_timer::end()
 {
-  return (_end = get_time());
+  _end = get_time_usec();
+  return usec_to_clocks(_end);
+}
+
+unsigned long MySQL_timer::raw_duration()
+{
+  return usec_to_clocks(duration_usec());
 }
 
 /**
@@ -23,20 +23,27 @@
 #include "shellcore/types_common.h"
 #include "shellcore/common.h"
 #include <string>
+#include <stdint.h>
 
+// Times are taken from a monotonic clock with microsecond resolution, the
+// raw values are still given in clock ticks (CLOCKS_PER_SEC) for format_legacy
 class SHCORE_PUBLIC MySQL_timer
 {
 public:
   unsigned long get_time();
   unsigned long start();
   unsigned long end();
-  unsigned long raw_duration() { return _end - _start; }
+  unsigned long raw_duration();
+  uint64_t duration_usec() const { return _end - _start; }
+
+  static uint64_t get_time_usec();
+  static unsigned long usec_to_clocks(uint64_t usec);
   static std::string format_legacy(unsigned long raw_time, int part_seconds, bool in_seconds = false);
   static void parse_duration(unsigned long raw_time, int &days, int &hours, int &minutes, float &seconds, bool in_seconds = false);
 
 private:
-  unsigned long _start;
-  unsigned long _end;
+  uint64_t _start;
+  uint64_t _end;
 };
 
 #endif /* defined(__mysh__utils_time__) */